@@ -5,6 +5,8 @@
 #pragma once
 
 #include "app/App.h"
+#include "core/Assert.h"
+#include "core/collection/DynamicArray.h"
 #include "core/concurrent/ThreadPool.h"
 #include <future>
 
@@ -16,4 +18,45 @@ auto async(F &&f, Args &&...args) -> std::future<typename std::invoke_result<F,
 	return app::App::getInstance()->threadPool().enqueue(core::forward<F>(f), core::forward<Args>(args)...);
 }
 
+/**
+ * @brief Executes the given functor in parallel for chunks of the range @c [start,end)
+ * @param func Called with the @c start and @c end (exclusive) of a chunk: @code void(int start, int end) @endcode
+ * @note This is blocking until all chunks are done
+ * @sa core::ThreadPool::parallelFor()
+ */
+template<class F>
+void for_parallel(int start, int end, F &&func, int grainSize = 0) {
+	app::App::getInstance()->threadPool().parallelFor(start, end, core::forward<F>(func), grainSize);
+}
+
+/**
+ * @brief Splits the range @c [start,end) into batches of @c batchSize items and executes the functor for the batches in
+ * parallel. Every batch writes into its own output - no synchronization is needed in the functor.
+ * @param func Called with the range of a batch and its output: @code void(int start, int end, OUT &out) @endcode
+ * @return The outputs of the batches in the order of the input range. The batches don't depend on the amount of
+ * threads.
+ * @note This is blocking until all batches are done
+ */
+template<class OUT, class F>
+core::DynamicArray<OUT> map_parallel(int start, int end, int batchSize, F &&func) {
+	core_assert(batchSize > 0);
+	core::DynamicArray<OUT> outputs;
+	const int n = end - start;
+	if (n <= 0) {
+		return outputs;
+	}
+	const int batches = (n + batchSize - 1) / batchSize;
+	outputs.resize(batches);
+	for_parallel(
+		0, batches,
+		[&](int batchStart, int batchEnd) {
+			for (int batch = batchStart; batch < batchEnd; ++batch) {
+				const int itemStart = start + batch * batchSize;
+				func(itemStart, core_min(itemStart + batchSize, end), outputs[batch]);
+			}
+		},
+		1);
+	return outputs;
+}
+
 } // namespace app
@@ -0,0 +1,36 @@
+/**
+ * @file
+ */
+
+#include "app/Async.h"
+#include "app/tests/AbstractTest.h"
+
+namespace app {
+
+class AsyncTest : public AbstractTest {};
+
+TEST_F(AsyncTest, testMapParallel) {
+	const core::DynamicArray<core::DynamicArray<int>> &batches =
+		app::map_parallel<core::DynamicArray<int>>(3, 1000, 64, [](int start, int end, core::DynamicArray<int> &out) {
+			for (int i = start; i < end; ++i) {
+				out.push_back(i);
+			}
+		});
+	ASSERT_EQ(16u, batches.size());
+	int expected = 3;
+	for (const core::DynamicArray<int> &batch : batches) {
+		for (int i : batch) {
+			ASSERT_EQ(expected, i);
+			++expected;
+		}
+	}
+	EXPECT_EQ(1000, expected);
+}
+
+TEST_F(AsyncTest, testMapParallelEmpty) {
+	const core::DynamicArray<int> &batches =
+		app::map_parallel<int>(0, 0, 16, [](int start, int end, int &out) { out = end - start; });
+	EXPECT_TRUE(batches.empty());
+}
+
+} // namespace app
@@ -12,6 +12,8 @@
 #include "core/StringUtil.h"
 #include "core/collection/Buffer.h"
 #include "core/collection/DynamicArray.h"
+#include "core/concurrent/Atomic.h"
+#include "core/concurrent/ThreadPool.h"
 #include "math/Octree.h"
 #include <glm/ext/scalar_integer.hpp>
 #include <glm/glm.hpp>
@@ -25,7 +27,6 @@
 #include <glm/gtx/type_aligned.hpp>
 
 #include <SDL.h>
-#include <random>
 #include <stdio.h>
 
 namespace core {
@@ -162,131 +163,185 @@ Color::ColorReductionType Color::toColorReductionType(const char *str) {
 	return ColorReductionType::Max;
 }
 
+namespace {
+
+/**
+ * @brief A unique color of the quantizer input and the amount of its occurrences
+ */
+struct WeightedColor {
+	RGBA color;
+	uint32_t count;
+};
+using ColorHistogram = core::DynamicArray<WeightedColor>;
+
+/**
+ * @brief A range of the histogram entries and the bounds of their colors
+ */
 struct ColorBox {
 	RGBA min, max;
-	core::Buffer<RGBA> pixels;
+	size_t start;
+	size_t end;
 };
 
-static int medianCutFindMedian(const core::Buffer<RGBA> &colors, int axis) {
-	core::Buffer<int> values;
-	for (const core::RGBA &color : colors) {
-		if (axis == 0) {
-			values.push_back(color.r);
-		} else if (axis == 1) {
-			values.push_back(color.g);
-		} else {
-			values.push_back(color.b);
-		}
-	}
-	core::sort(values.begin(), values.end(), core::Less<int>());
-	return values[values.size() / 2];
-}
+// limits the refinement of the k-means reduction - there is no wall clock budget to keep the result reproducible
+constexpr int KMeansMaxIterations = 32;
 
-static core::Pair<ColorBox, ColorBox> medianCutSplitBox(const ColorBox &box) {
-	int longestAxis = 0;
-	if ((box.max.g - box.min.g) > (box.max.r - box.min.r)) {
-		longestAxis = 1;
-	}
-	if ((box.max.b - box.min.b) > (box.max.g - box.min.g)) {
-		longestAxis = 2;
+inline uint8_t channel(const RGBA &color, int axis) {
+	switch (axis) {
+	case 0:
+		return color.r;
+	case 1:
+		return color.g;
+	case 2:
+		return color.b;
+	default:
+		return color.a;
 	}
+}
 
-	int median = medianCutFindMedian(box.pixels, longestAxis);
-	ColorBox box1, box2;
-	for (const core::RGBA &color : box.pixels) {
-		if (longestAxis == 0) {
-			if (color.r < median) {
-				box1.pixels.push_back(color);
-			} else {
-				box2.pixels.push_back(color);
-			}
-		} else if (longestAxis == 1) {
-			if (color.g < median) {
-				box1.pixels.push_back(color);
-			} else {
-				box2.pixels.push_back(color);
-			}
-		} else {
-			if (color.b < median) {
-				box1.pixels.push_back(color);
-			} else {
-				box2.pixels.push_back(color);
-			}
+/**
+ * @brief Orders the histogram entries by the given channel - the color value breaks the ties to get the same order on
+ * every platform and to keep the partitioning of the sort balanced
+ */
+struct ChannelLess {
+	int axis;
+	inline bool operator()(const WeightedColor &lhs, const WeightedColor &rhs) const {
+		const uint8_t l = channel(lhs.color, axis);
+		const uint8_t r = channel(rhs.color, axis);
+		if (l != r) {
+			return l < r;
 		}
+		return lhs.color.rgba < rhs.color.rgba;
 	}
+};
 
-	box1.min.r = box.min.r;
-	box1.max.r = box.max.r;
-	box1.min.g = box.min.g;
-	box1.max.g = box.max.g;
-	box1.min.b = box.min.b;
-	box1.max.b = box.max.b;
-
-	box2.min.r = box.min.r;
-	box2.max.r = box.max.r;
-	box2.min.g = box.min.g;
-	box2.max.g = box.max.g;
-	box2.min.b = box.min.b;
-	box2.max.b = box.max.b;
+} // namespace
 
-	if (longestAxis == 0) {
-		box1.max.r = median;
-		box2.min.r = median;
-	} else if (longestAxis == 1) {
-		box1.max.g = median;
-		box2.min.g = median;
-	} else {
-		box1.max.b = median;
-		box2.min.b = median;
+/**
+ * @brief Deduplicates the input colors. The histogram is sorted by the color value and thus doesn't depend on the
+ * order of the input colors.
+ */
+static void createHistogram(const RGBA *inputBuf, size_t inputBufColors, ColorHistogram &histogram) {
+	// radix sort of the color values - the input usually contains a lot of duplicates
+	core::DynamicArray<uint32_t> values;
+	core::DynamicArray<uint32_t> scratch;
+	values.resize(inputBufColors);
+	scratch.resize(inputBufColors);
+	for (size_t i = 0; i < inputBufColors; ++i) {
+		values[i] = inputBuf[i].rgba;
+	}
+	uint32_t *src = values.data();
+	uint32_t *dst = scratch.data();
+	for (int shift = 0; shift < 32; shift += 8) {
+		size_t offsets[257] = {};
+		for (size_t i = 0; i < inputBufColors; ++i) {
+			++offsets[((src[i] >> shift) & 0xFF) + 1];
+		}
+		for (int i = 0; i < 256; ++i) {
+			offsets[i + 1] += offsets[i];
+		}
+		for (size_t i = 0; i < inputBufColors; ++i) {
+			dst[offsets[(src[i] >> shift) & 0xFF]++] = src[i];
+		}
+		core::exchange(src, dst);
 	}
 
-	return core::Pair{box1, box2};
+	histogram.clear();
+	for (size_t i = 0; i < inputBufColors;) {
+		size_t end = i + 1;
+		while (end < inputBufColors && src[end] == src[i]) {
+			++end;
+		}
+		RGBA color;
+		color.rgba = src[i];
+		histogram.push_back({color, (uint32_t)(end - i)});
+		i = end;
+	}
 }
 
-static int quantizeMedianCut(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA *inputBuf, size_t inputBufColors) {
-	core::Buffer<RGBA> pixels;
-	pixels.append(inputBuf, inputBufColors);
+/**
+ * @return The average of the histogram entries weighted by their occurrences
+ */
+static RGBA weightedAverage(const ColorHistogram &histogram, size_t start, size_t end) {
+	uint64_t r = 0, g = 0, b = 0, a = 0, weight = 0;
+	for (size_t i = start; i < end; ++i) {
+		const WeightedColor &entry = histogram[i];
+		r += (uint64_t)entry.color.r * entry.count;
+		g += (uint64_t)entry.color.g * entry.count;
+		b += (uint64_t)entry.color.b * entry.count;
+		a += (uint64_t)entry.color.a * entry.count;
+		weight += entry.count;
+	}
+	if (weight == 0) {
+		return RGBA(0xFFFFFFFFU);
+	}
+	return RGBA((uint8_t)(r / weight), (uint8_t)(g / weight), (uint8_t)(b / weight), (uint8_t)(a / weight));
+}
 
-	core::DynamicArray<ColorBox> boxes;
-	boxes.emplace_back(ColorBox{{0, 0, 0, 255}, {255, 255, 255, 255}, pixels});
+static int quantizeMedianCut(RGBA *targetBuf, size_t maxTargetBufColors, ColorHistogram &histogram) {
+	struct Box {
+		size_t start;
+		size_t end;
+		uint64_t weight;
+	};
+	uint64_t totalWeight = 0;
+	for (const WeightedColor &entry : histogram) {
+		totalWeight += entry.count;
+	}
+	core::DynamicArray<Box> boxes;
+	boxes.reserve(maxTargetBufColors);
+	boxes.push_back({0, histogram.size(), totalWeight});
 
 	while (boxes.size() < maxTargetBufColors) {
-		size_t maxSize = 0;
-		size_t maxIndex = 0;
+		// split the most populated box that still has more than one color
+		size_t maxIndex = boxes.size();
 		for (size_t i = 0; i < boxes.size(); ++i) {
-			if (boxes[i].pixels.size() > maxSize) {
-				maxSize = boxes[i].pixels.size();
+			if (boxes[i].end - boxes[i].start < 2) {
+				continue;
+			}
+			if (maxIndex == boxes.size() || boxes[i].weight > boxes[maxIndex].weight) {
 				maxIndex = i;
 			}
 		}
-
-		// Split the most populated box.
-		core::Pair<ColorBox, ColorBox> boxesPair = medianCutSplitBox(boxes[maxIndex]);
-		boxes.erase(maxIndex);
-		boxes.push_back(boxesPair.first);
-		boxes.push_back(boxesPair.second);
-	}
-
-	size_t n = 0;
-	for (const ColorBox &box : boxes) {
-		if (box.pixels.empty()) {
-			continue;
+		if (maxIndex == boxes.size()) {
+			break;
 		}
-		uint32_t r = 0, g = 0, b = 0, a = 0;
-		for (const core::RGBA &color : box.pixels) {
-			r += color.r;
-			g += color.g;
-			b += color.b;
-			a += color.a;
+		const Box box = boxes[maxIndex];
+
+		int mins[4] = {255, 255, 255, 255};
+		int maxs[4] = {0, 0, 0, 0};
+		for (size_t i = box.start; i < box.end; ++i) {
+			const RGBA &color = histogram[i].color;
+			for (int axis = 0; axis < 4; ++axis) {
+				mins[axis] = core_min(mins[axis], (int)channel(color, axis));
+				maxs[axis] = core_max(maxs[axis], (int)channel(color, axis));
+			}
 		}
-		r /= box.pixels.size();
-		g /= box.pixels.size();
-		b /= box.pixels.size();
-		a /= box.pixels.size();
-		targetBuf[n++] = core::RGBA(r, g, b, a);
-		if (n >= maxTargetBufColors) {
-			return (int)n;
+		int longestAxis = 0;
+		for (int axis = 1; axis < 4; ++axis) {
+			if (maxs[axis] - mins[axis] > maxs[longestAxis] - mins[longestAxis]) {
+				longestAxis = axis;
+			}
 		}
+		core::sort(histogram.begin() + box.start, histogram.begin() + box.end, ChannelLess{longestAxis});
+
+		// the weighted median - both halves keep at least one color
+		uint64_t weight = 0;
+		size_t split = box.start + 1;
+		for (size_t i = box.start; i < box.end - 1; ++i) {
+			weight += histogram[i].count;
+			split = i + 1;
+			if (weight * 2 >= box.weight) {
+				break;
+			}
+		}
+		boxes[maxIndex] = {box.start, split, weight};
+		boxes.push_back({split, box.end, box.weight - weight});
+	}
+
+	size_t n = 0;
+	for (const Box &box : boxes) {
+		targetBuf[n++] = weightedAverage(histogram, box.start, box.end);
 	}
 	for (size_t i = n; i < maxTargetBufColors; ++i) {
 		targetBuf[i] = RGBA(0xFFFFFFFFU);
@@ -294,12 +349,13 @@ static int quantizeMedianCut(RGBA *targetBuf, size_t maxTargetBufColors, const R
 	return (int)n;
 }
 
-static int quantizeOctree(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA *inputBuf, size_t inputBufColors) {
+static int quantizeOctree(RGBA *targetBuf, size_t maxTargetBufColors, const ColorHistogram &histogram) {
 	core_assert(glm::isPowerOfTwo(maxTargetBufColors));
 	using BBox = math::AABB<uint8_t>;
 	struct ColorNode {
-		inline ColorNode(core::RGBA c) : color(c){};
+		inline ColorNode(const WeightedColor &c) : color(c.color), count(c.count){};
 		core::RGBA color;
+		uint32_t count;
 		inline BBox aabb() const {
 			return BBox(color.r, color.g, color.b, color.r + 1, color.g + 1, color.b + 1);
 		}
@@ -307,8 +363,8 @@ static int quantizeOctree(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA
 	const BBox aabb(0, 0, 0, 255, 255, 255);
 	using Tree = math::Octree<ColorNode, uint8_t>;
 	Tree octree(aabb, 32);
-	for (size_t i = 0; i < inputBufColors; ++i) {
-		octree.insert(inputBuf[i]);
+	for (const WeightedColor &entry : histogram) {
+		octree.insert(entry);
 	}
 	size_t n = 0;
 	const glm::ivec3 dim(8);
@@ -321,11 +377,17 @@ static int quantizeOctree(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA
 				Tree::Contents contents;
 				const BBox queryAABB(r, g, b, r + dim.r - 1, g + dim.g - 1, b + dim.b - 1);
 				octree.query(queryAABB, contents);
-				const int k = (int)contents.size();
-				if (k == 0) {
+				if (contents.empty()) {
 					continue;
 				}
-				targetBuf[n++] = contents.front().color;
+				// the most frequent color of the cell - the smaller color value wins a tie
+				const ColorNode *best = &contents.front();
+				for (const ColorNode &node : contents) {
+					if (node.count > best->count || (node.count == best->count && node.color.rgba < best->color.rgba)) {
+						best = &node;
+					}
+				}
+				targetBuf[n++] = best->color;
 				if (n >= maxTargetBufColors) {
 					return (int)n;
 				}
@@ -338,61 +400,166 @@ static int quantizeOctree(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA
 	return (int)n;
 }
 
-static inline float getDistance(const glm::vec4 &p1, const glm::vec4 &p2) {
-	return glm::length(p1 - p2);
+static inline uint32_t getDistanceSquared(const RGBA &c1, const RGBA &c2) {
+	const int r = (int)c1.r - (int)c2.r;
+	const int g = (int)c1.g - (int)c2.g;
+	const int b = (int)c1.b - (int)c2.b;
+	const int a = (int)c1.a - (int)c2.a;
+	return (uint32_t)(r * r + g * g + b * b + a * a);
 }
 
-static int quantizeKMeans(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA *inputBuf, size_t inputBufColors) {
-	core::DynamicArray<glm::vec4> centers;
-	centers.resize(maxTargetBufColors);
-	std::random_device rd;
-	std::mt19937 gen(rd());
-	std::uniform_int_distribution<> dis(0, (int)inputBufColors - 1);
-	for (int i = 0; i < (int)maxTargetBufColors; i++) {
-		centers[i] = core::Color::fromRGBA(inputBuf[dis(gen)]);
-	}
-
-	bool changed = true;
-	while (changed) {
-		changed = false;
-		core::DynamicArray<core::DynamicArray<glm::vec4>> clusters(maxTargetBufColors);
-		for (size_t i = 0; i < inputBufColors; ++i) {
-			const glm::vec4 point = core::Color::fromRGBA(inputBuf[i]);
-			int closest = 0;
-			float closestDistance = getDistance(point, centers[0]);
-			for (int n = 1; n < (int)maxTargetBufColors; n++) {
-				float d = getDistance(point, centers[n]);
-				if (d < closestDistance) {
-					closest = n;
-					closestDistance = d;
+static inline float getDistanceSquared(const glm::vec4 &p1, const glm::vec4 &p2) {
+	const glm::vec4 d = p1 - p2;
+	return glm::dot(d, d);
+}
+
+/**
+ * @brief Executes the given function for the range in parallel if a thread pool is given
+ */
+template<class FUNC>
+static void quantizeParallel(core::ThreadPool *threadPool, int start, int end, FUNC &&func) {
+	if (threadPool == nullptr) {
+		func(start, end);
+		return;
+	}
+	threadPool->parallelFor(start, end, core::forward<FUNC>(func));
+}
+
+static int quantizeKMeans(RGBA *targetBuf, size_t maxTargetBufColors, const ColorHistogram &histogram,
+						  core::ThreadPool *threadPool) {
+	const int k = (int)maxTargetBufColors;
+	const int n = (int)histogram.size();
+
+	// k-means++ seeding with a fixed seed - starting with the most frequent color. The distances are integers, so the
+	// sums and the chosen centers don't depend on the amount of threads.
+	core::DynamicArray<RGBA> seeds;
+	seeds.reserve(k);
+	size_t mostFrequent = 0;
+	for (int i = 1; i < n; ++i) {
+		if (histogram[i].count > histogram[mostFrequent].count) {
+			mostFrequent = i;
+		}
+	}
+	seeds.push_back(histogram[mostFrequent].color);
+	core::DynamicArray<uint64_t> minDistances;
+	minDistances.resize(n);
+	for (int i = 0; i < n; ++i) {
+		minDistances[i] = UINT64_MAX;
+	}
+	uint64_t random = 0x9E3779B97F4A7C15ULL;
+	while ((int)seeds.size() < k) {
+		const RGBA center = seeds.back();
+		quantizeParallel(threadPool, 0, n, [&](int start, int end) {
+			for (int i = start; i < end; ++i) {
+				const uint64_t d = (uint64_t)getDistanceSquared(histogram[i].color, center) * histogram[i].count;
+				if (d < minDistances[i]) {
+					minDistances[i] = d;
 				}
 			}
-			clusters[closest].push_back(point);
+		});
+		uint64_t sum = 0;
+		for (int i = 0; i < n; ++i) {
+			sum += minDistances[i];
 		}
-		for (int i = 0; i < (int)maxTargetBufColors; i++) {
-			if (clusters[i].empty()) {
-				continue;
+		if (sum == 0) {
+			// every color is already a center
+			break;
+		}
+		// xorshift64* - std::uniform_int_distribution is not the same on all platforms
+		random ^= random >> 12;
+		random ^= random << 25;
+		random ^= random >> 27;
+		const uint64_t target = (random * 0x2545F4914F6CDD1DULL) % sum;
+		uint64_t accumulated = 0;
+		int chosen = n - 1;
+		for (int i = 0; i < n; ++i) {
+			accumulated += minDistances[i];
+			if (accumulated > target) {
+				chosen = i;
+				break;
+			}
+		}
+		seeds.push_back(histogram[chosen].color);
+	}
+
+	const int centerCount = (int)seeds.size();
+	core::DynamicArray<glm::vec4> centers;
+	centers.resize(centerCount);
+	for (int c = 0; c < centerCount; ++c) {
+		centers[c] = glm::vec4(seeds[c].r, seeds[c].g, seeds[c].b, seeds[c].a);
+	}
+
+	struct Accumulator {
+		uint64_t r, g, b, a, weight;
+	};
+	core::DynamicArray<Accumulator> accumulators;
+	accumulators.resize(centerCount);
+	core::DynamicArray<int> assignments;
+	assignments.resize(n);
+	for (int i = 0; i < n; ++i) {
+		assignments[i] = -1;
+	}
+	for (int iteration = 0; iteration < KMeansMaxIterations; ++iteration) {
+		core::AtomicInt changed{0};
+		quantizeParallel(threadPool, 0, n, [&](int start, int end) {
+			int localChanged = 0;
+			for (int i = start; i < end; ++i) {
+				const RGBA &color = histogram[i].color;
+				const glm::vec4 point(color.r, color.g, color.b, color.a);
+				int closest = 0;
+				float closestDistance = getDistanceSquared(point, centers[0]);
+				for (int c = 1; c < centerCount; ++c) {
+					const float d = getDistanceSquared(point, centers[c]);
+					if (d < closestDistance) {
+						closest = c;
+						closestDistance = d;
+					}
+				}
+				if (assignments[i] != closest) {
+					assignments[i] = closest;
+					++localChanged;
+				}
 			}
-			glm::vec4 newCenter(0.0f);
-			for (const glm::vec4 &point : clusters[i]) {
-				newCenter += point;
+			if (localChanged > 0) {
+				changed.increment(localChanged);
 			}
-			newCenter /= clusters[i].size();
-			if (getDistance(newCenter, centers[i]) > 0.0001f) {
-				centers[i] = newCenter;
-				changed = true;
+		});
+		if (changed == 0) {
+			break;
+		}
+
+		// integer sums - the new centers don't depend on the order of the additions
+		accumulators.fill(Accumulator{0, 0, 0, 0, 0});
+		for (int i = 0; i < n; ++i) {
+			const WeightedColor &entry = histogram[i];
+			Accumulator &acc = accumulators[assignments[i]];
+			acc.r += (uint64_t)entry.color.r * entry.count;
+			acc.g += (uint64_t)entry.color.g * entry.count;
+			acc.b += (uint64_t)entry.color.b * entry.count;
+			acc.a += (uint64_t)entry.color.a * entry.count;
+			acc.weight += entry.count;
+		}
+		for (int c = 0; c < centerCount; ++c) {
+			const Accumulator &acc = accumulators[c];
+			if (acc.weight == 0) {
+				// keep the center of an empty cluster
+				continue;
 			}
+			const double weight = (double)acc.weight;
+			centers[c] = glm::vec4((float)((double)acc.r / weight), (float)((double)acc.g / weight),
+								   (float)((double)acc.b / weight), (float)((double)acc.a / weight));
 		}
 	}
 
-	size_t n = 0;
+	size_t count = 0;
 	for (const glm::vec4 &c : centers) {
-		targetBuf[n++] = core::Color::getRGBA(c);
+		targetBuf[count++] = RGBA((uint8_t)glm::round(c.r), (uint8_t)glm::round(c.g), (uint8_t)glm::round(c.b),
+								  (uint8_t)glm::round(c.a));
 	}
-	for (size_t i = n; i < maxTargetBufColors; ++i) {
+	for (size_t i = count; i < maxTargetBufColors; ++i) {
 		targetBuf[i] = RGBA(0xFFFFFFFFU);
 	}
-	return (int)n;
+	return (int)count;
 }
 
 // Based on NeuQuant algorithm from jo_gif_quantize
@@ -541,17 +708,14 @@ static int quantizeNeuQuant(RGBA *targetBuf, size_t maxTargetBufColors, const RG
 	return numColors;
 }
 
-static int quantizeWu(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA *inputBuf, size_t inputBufColors) {
-	core::Buffer<RGBA> pixels;
-	pixels.append(inputBuf, inputBufColors);
-
+static int quantizeWu(RGBA *targetBuf, size_t maxTargetBufColors, ColorHistogram &histogram) {
 	// Initialize the set of boxes with the full color range
 	core::DynamicArray<ColorBox> boxes;
-	boxes.emplace_back(ColorBox{{0, 0, 0, 255}, {255, 255, 255, 255}, pixels});
+	boxes.push_back(ColorBox{{0, 0, 0, 255}, {255, 255, 255, 255}, 0, histogram.size()});
 
 	// Iterate until we reach the desired number of boxes
 	while (boxes.size() < maxTargetBufColors) {
-		// Find the box with the largest volume (i.e., the most pixels)
+		// Find the box with the largest volume
 		int maxVolume = std::numeric_limits<int>::min();
 		size_t maxVolumeIndex = 0;
 		for (size_t i = 0; i < boxes.size(); ++i) {
@@ -564,9 +728,8 @@ static int quantizeWu(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA *in
 		}
 
 		// Split the box with the largest volume into two boxes along its longest dimension
-		const ColorBox &box = boxes[maxVolumeIndex];
-		const size_t pixelCount = box.pixels.size();
-		if (pixelCount <= 0) {
+		const ColorBox box = boxes[maxVolumeIndex];
+		if (box.start == box.end) {
 			boxes.erase(maxVolumeIndex);
 			continue;
 		}
@@ -584,71 +747,43 @@ static int quantizeWu(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA *in
 			midpoint = (box.min.b + box.max.b) / 2;
 		}
 
-		ColorBox box1, box2;
-		box1.pixels.reserve(pixelCount / 2);
-		box2.pixels.reserve(pixelCount / 2);
+		// the colors up to the midpoint go into the first box
+		core::sort(histogram.begin() + box.start, histogram.begin() + box.end, ChannelLess{component});
+		size_t split = box.start;
+		while (split < box.end && channel(histogram[split].color, component) <= midpoint) {
+			++split;
+		}
+
+		ColorBox box1{box.min, box.max, box.start, split};
+		ColorBox box2{box.min, box.max, split, box.end};
 		switch (component) {
 		case 0:
-			box1.min = box.min;
 			box1.max = RGBA(midpoint, box.max.g, box.max.b, 255);
 			box2.min = RGBA(midpoint + 1, box.min.g, box.min.b, 255);
-			box2.max = box.max;
-			for (const RGBA &pixel : box.pixels) {
-				if (pixel.r <= midpoint) {
-					box1.pixels.push_back(pixel);
-				} else {
-					box2.pixels.push_back(pixel);
-				}
-			}
 			break;
 		case 1:
-			box1.min = box.min;
 			box1.max = RGBA(box.max.r, midpoint, box.max.b, 255);
 			box2.min = RGBA(box.min.r, midpoint + 1, box.min.b, 255);
-			box2.max = box.max;
-			for (const RGBA &pixel : box.pixels) {
-				if (pixel.g <= midpoint) {
-					box1.pixels.push_back(pixel);
-				} else {
-					box2.pixels.push_back(pixel);
-				}
-			}
 			break;
 		case 2:
-			box1.min = box.min;
 			box1.max = RGBA(box.max.r, box.max.g, midpoint);
 			box2.min = RGBA(box.min.r, box.min.g, midpoint + 1);
-			box2.max = box.max;
-			for (const RGBA &pixel : box.pixels) {
-				if (pixel.b <= midpoint) {
-					box1.pixels.push_back(pixel);
-				} else {
-					box2.pixels.push_back(pixel);
-				}
-			}
 			break;
 		}
 
 		// Replace the original box with the two split boxes
 		boxes.erase(maxVolumeIndex);
-		boxes.emplace_back(core::move(box1));
-		boxes.emplace_back(core::move(box2));
+		boxes.push_back(box1);
+		boxes.push_back(box2);
 	}
 
 	size_t n = 0;
 	for (const ColorBox &box : boxes) {
-		if (box.pixels.empty()) {
+		if (box.start == box.end) {
 			continue;
 		}
-		RGBA average(0, 0, 0, 255);
-		for (const RGBA &pixel : box.pixels) {
-			average.r += pixel.r;
-			average.g += pixel.g;
-			average.b += pixel.b;
-		}
-		average.r /= box.pixels.size();
-		average.g /= box.pixels.size();
-		average.b /= box.pixels.size();
+		RGBA average = weightedAverage(histogram, box.start, box.end);
+		average.a = 255;
 		targetBuf[n++] = average;
 	}
 
@@ -659,7 +794,7 @@ static int quantizeWu(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA *in
 }
 
 int Color::quantize(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA *inputBuf, size_t inputBufColors,
-					ColorReductionType type) {
+					ColorReductionType type, core::ThreadPool *threadPool) {
 	if (inputBufColors <= maxTargetBufColors) {
 		size_t n;
 		for (n = 0; n < inputBufColors; ++n) {
@@ -670,17 +805,36 @@ int Color::quantize(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA *inpu
 		}
 		return (int)n;
 	}
+	if (type == ColorReductionType::NeuQuant) {
+		// learns from the sequence of the input colors - the duplicates are the weights here
+		return quantizeNeuQuant(targetBuf, maxTargetBufColors, inputBuf, inputBufColors);
+	}
+	if (type >= ColorReductionType::Max) {
+		return -1;
+	}
+
+	ColorHistogram histogram;
+	createHistogram(inputBuf, inputBufColors, histogram);
+	if (histogram.size() <= maxTargetBufColors) {
+		// there are not more unique colors than requested
+		size_t n;
+		for (n = 0; n < histogram.size(); ++n) {
+			targetBuf[n] = histogram[n].color;
+		}
+		for (size_t i = n; i < maxTargetBufColors; ++i) {
+			targetBuf[i] = RGBA(255, 255, 255, 255);
+		}
+		return (int)n;
+	}
 	switch (type) {
 	case ColorReductionType::Wu:
-		return quantizeWu(targetBuf, maxTargetBufColors, inputBuf, inputBufColors);
+		return quantizeWu(targetBuf, maxTargetBufColors, histogram);
 	case ColorReductionType::KMeans:
-		return quantizeKMeans(targetBuf, maxTargetBufColors, inputBuf, inputBufColors);
-	case ColorReductionType::NeuQuant:
-		return quantizeNeuQuant(targetBuf, maxTargetBufColors, inputBuf, inputBufColors);
+		return quantizeKMeans(targetBuf, maxTargetBufColors, histogram, threadPool);
 	case ColorReductionType::Octree:
-		return quantizeOctree(targetBuf, maxTargetBufColors, inputBuf, inputBufColors);
+		return quantizeOctree(targetBuf, maxTargetBufColors, histogram);
 	case ColorReductionType::MedianCut:
-		return quantizeMedianCut(targetBuf, maxTargetBufColors, inputBuf, inputBufColors);
+		return quantizeMedianCut(targetBuf, maxTargetBufColors, histogram);
 	default:
 		break;
 	}
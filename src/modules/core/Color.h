@@ -13,6 +13,8 @@
 
 namespace core {
 
+class ThreadPool;
+
 class Color {
 public:
 	static const uint32_t magnitude = 255;
@@ -74,9 +76,15 @@ public:
 	static const char* toColorReductionTypeString(Color::ColorReductionType type);
 
 	/**
+	 * @brief Reduces the input colors to the given amount of colors
+	 *
+	 * The input colors are deduplicated into a histogram first - the amount of occurrences of a color is used as its
+	 * weight. The result only depends on the input colors and not on their order, the platform or the amount of threads.
+	 *
+	 * @param threadPool If given, the expensive steps of the k-means reduction are executed in parallel
 	 * @return @c -1 on error or the amount of @code colors <= maxTargetBufColors @endcode
 	 */
-	static int quantize(RGBA* targetBuf, size_t maxTargetBufColors, const RGBA* inputBuf, size_t inputBufColors, ColorReductionType type = ColorReductionType::MedianCut);
+	static int quantize(RGBA* targetBuf, size_t maxTargetBufColors, const RGBA* inputBuf, size_t inputBufColors, ColorReductionType type = ColorReductionType::MedianCut, core::ThreadPool *threadPool = nullptr);
 
 	static inline glm::vec4 fromRGBA(const RGBA rgba) {
 		return fromRGBA(rgba.r, rgba.g, rgba.b, rgba.a);
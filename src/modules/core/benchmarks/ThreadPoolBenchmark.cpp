@@ -0,0 +1,122 @@
+/**
+ * @file
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "core/concurrent/Atomic.h"
+#include "core/concurrent/ThreadPool.h"
+#include <chrono>
+
+class ThreadPoolBenchmark : public app::AbstractBenchmark {
+protected:
+	core::ThreadPool *_pool = nullptr;
+
+public:
+	void SetUp(::benchmark::State &state) override {
+		app::AbstractBenchmark::SetUp(state);
+		_pool = new core::ThreadPool(4, "Benchmark");
+		_pool->init();
+	}
+
+	void TearDown(::benchmark::State &state) override {
+		_pool->shutdown(true);
+		delete _pool;
+		_pool = nullptr;
+		app::AbstractBenchmark::TearDown(state);
+	}
+
+	void waitFor(const core::AtomicInt &counter, int expected) {
+		while (counter < expected) {
+			std::this_thread::yield();
+		}
+	}
+};
+
+BENCHMARK_DEFINE_F(ThreadPoolBenchmark, throughputEnqueue)(benchmark::State &state) {
+	const int n = (int)state.range(0);
+	for (auto _ : state) {
+		core::AtomicInt counter{0};
+		for (int i = 0; i < n; ++i) {
+			_pool->enqueue([&counter]() { ++counter; });
+		}
+		waitFor(counter, n);
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK_DEFINE_F(ThreadPoolBenchmark, throughputSchedule)(benchmark::State &state) {
+	const int n = (int)state.range(0);
+	for (auto _ : state) {
+		core::AtomicInt counter{0};
+		for (int i = 0; i < n; ++i) {
+			_pool->schedule([&counter]() { ++counter; });
+		}
+		waitFor(counter, n);
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+
+// several threads are submitting tasks at the same time
+BENCHMARK_DEFINE_F(ThreadPoolBenchmark, throughputContention)(benchmark::State &state) {
+	const int n = (int)state.range(0);
+	const int producers = 4;
+	for (auto _ : state) {
+		core::AtomicInt counter{0};
+		core::DynamicArray<std::thread> threads;
+		for (int p = 0; p < producers; ++p) {
+			threads.emplace_back([this, &counter, n]() {
+				for (int i = 0; i < n; ++i) {
+					_pool->schedule([&counter]() { ++counter; });
+				}
+			});
+		}
+		for (std::thread &t : threads) {
+			t.join();
+		}
+		waitFor(counter, n * producers);
+	}
+	state.SetItemsProcessed(state.iterations() * n * producers);
+}
+
+// time between scheduling a task and its execution while the pool is busy with low priority tasks
+BENCHMARK_DEFINE_F(ThreadPoolBenchmark, latencyUnderLoad)(benchmark::State &state) {
+	const int backgroundTasks = (int)state.range(0);
+	for (auto _ : state) {
+		core::AtomicInt background{0};
+		for (int i = 0; i < backgroundTasks; ++i) {
+			_pool->schedule(
+				[&background]() {
+					std::this_thread::sleep_for(std::chrono::microseconds(10));
+					++background;
+				},
+				core::TaskPriority::Low);
+		}
+		core::AtomicInt executed{0};
+		const auto start = std::chrono::high_resolution_clock::now();
+		_pool->schedule([&executed]() { ++executed; }, core::TaskPriority::High);
+		waitFor(executed, 1);
+		const auto end = std::chrono::high_resolution_clock::now();
+		state.SetIterationTime(std::chrono::duration<double>(end - start).count());
+		waitFor(background, backgroundTasks);
+	}
+}
+
+BENCHMARK_DEFINE_F(ThreadPoolBenchmark, parallelFor)(benchmark::State &state) {
+	const int n = (int)state.range(0);
+	core::DynamicArray<float> values;
+	values.resize(n);
+	for (auto _ : state) {
+		_pool->parallelFor(0, n, [&values](int start, int end) {
+			for (int i = start; i < end; ++i) {
+				values[i] = values[i] * 0.5f + 1.0f;
+			}
+		});
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK_REGISTER_F(ThreadPoolBenchmark, throughputEnqueue)->Arg(1000)->Arg(10000);
+BENCHMARK_REGISTER_F(ThreadPoolBenchmark, throughputSchedule)->Arg(1000)->Arg(10000);
+BENCHMARK_REGISTER_F(ThreadPoolBenchmark, throughputContention)->Arg(1000)->Arg(10000);
+BENCHMARK_REGISTER_F(ThreadPoolBenchmark, latencyUnderLoad)->Arg(64)->Arg(512)->UseManualTime();
+BENCHMARK_REGISTER_F(ThreadPoolBenchmark, parallelFor)->Arg(1 << 16)->Arg(1 << 20);
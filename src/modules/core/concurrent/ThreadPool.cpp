@@ -10,20 +10,167 @@
 
 namespace core {
 
+namespace _priv {
+// allows to push tasks that are scheduled from within a task into the queue of the executing worker
+static thread_local const ThreadPool *currentPool = nullptr;
+static thread_local size_t currentWorker = 0u;
+} // namespace _priv
+
+bool ThreadPool::TaskQueue::popFront(Task &task) {
+	if (empty()) {
+		return false;
+	}
+	task = core::move(_tasks[_head]);
+	++_head;
+	if (empty()) {
+		clear();
+	} else if (_head >= 64u && _head * 2u >= _tasks.size()) {
+		// get rid of the already executed tasks if the queue never runs empty
+		_tasks.erase(0, _head);
+		_head = 0u;
+	}
+	return true;
+}
+
+bool ThreadPool::TaskQueue::popBack(Task &task) {
+	if (empty()) {
+		return false;
+	}
+	task = core::move(_tasks.back());
+	_tasks.pop();
+	if (empty()) {
+		clear();
+	}
+	return true;
+}
+
+void ThreadPool::TaskQueue::clear() {
+	_tasks.clear();
+	_head = 0u;
+}
+
 ThreadPool::ThreadPool(size_t threads, const char *name) :
 		_threads(threads), _name(name) {
 	if (_name == nullptr) {
 		_name = "ThreadPool";
 	}
+	_queues = new Worker[core_max(_threads, (size_t)1u)];
 }
 
 void ThreadPool::abort() {
-	core::ScopedLock lock(_queueMutex);
-	while (!_tasks.empty()) {
-		_tasks.pop();
+	const size_t n = core_max(_threads, (size_t)1u);
+	for (size_t i = 0; i < n; ++i) {
+		Worker &worker = _queues[i];
+		core::ScopedLock lock(worker.lock);
+		for (int prio = 0; prio < (int)TaskPriority::Max; ++prio) {
+			_queued.decrement((int)worker.tasks[prio].size());
+			worker.tasks[prio].clear();
+		}
 	}
 }
 
+void ThreadPool::reserve(size_t n) {
+	const size_t queues = core_max(_threads, (size_t)1u);
+	const size_t perQueue = n / queues + 1;
+	for (size_t i = 0; i < queues; ++i) {
+		Worker &worker = _queues[i];
+		core::ScopedLock lock(worker.lock);
+		worker.tasks[(int)TaskPriority::Normal].reserve(perQueue);
+	}
+}
+
+void ThreadPool::schedule(std::function<void()> &&func, TaskPriority priority, const CancellationTokenPtr &token) {
+	if (_stop) {
+		return;
+	}
+	const size_t queues = core_max(_threads, (size_t)1u);
+	size_t idx;
+	if (_priv::currentPool == this) {
+		idx = _priv::currentWorker;
+	} else {
+		idx = (size_t)(uint32_t)_nextQueue.increment(1) % queues;
+	}
+	// increase the counter first - it must never be lower than the amount of queued tasks
+	_queued.increment(1);
+	{
+		Worker &worker = _queues[idx];
+		core::ScopedLock lock(worker.lock);
+		worker.tasks[(int)priority].push({core::move(func), token});
+	}
+	{
+		// don't lose the wakeup of a worker that is just about to wait
+		core::ScopedLock lock(_queueMutex);
+	}
+	_queueCondition.notify_one();
+}
+
+bool ThreadPool::popTask(size_t workerIdx, bool wait, Task &task) {
+	const size_t queues = core_max(_threads, (size_t)1u);
+	for (int prio = 0; prio < (int)TaskPriority::Max; ++prio) {
+		{
+			Worker &own = _queues[workerIdx];
+			core::ScopedLock lock(own.lock);
+			if (own.tasks[prio].popFront(task)) {
+				return true;
+			}
+		}
+		for (size_t i = 1; i < queues; ++i) {
+			Worker &victim = _queues[(workerIdx + i) % queues];
+			if (wait) {
+				victim.lock.lock();
+			} else if (!victim.lock.try_lock()) {
+				continue;
+			}
+			const bool stolen = victim.tasks[prio].popBack(task);
+			victim.lock.unlock();
+			if (stolen) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+void ThreadPool::run(size_t workerIdx) {
+	const core::String n = core::string::format("%s-%i", _name, (int)workerIdx);
+	if (!setThreadName(n.c_str())) {
+		Log::debug("Failed to set thread name for pool thread %i", (int)workerIdx);
+	}
+	core_trace_thread(n.c_str());
+	_priv::currentPool = this;
+	_priv::currentWorker = workerIdx;
+	for (;;) {
+		Task task;
+		// first try without blocking on the queues of the other workers
+		if (popTask(workerIdx, false, task) || (_queued > 0 && popTask(workerIdx, true, task))) {
+			_queued.decrement(1);
+			if (_stop && _force) {
+				continue;
+			}
+			if (task.token && task.token->cancelled()) {
+				continue;
+			}
+			core_trace_begin_frame(n.c_str());
+			core_trace_scoped(ThreadPoolWorker);
+			Log::trace("Execute task in %i", (int)workerIdx);
+			task.func();
+			Log::trace("End of task in %i", (int)workerIdx);
+			core_trace_end_frame(n.c_str());
+			continue;
+		}
+		core::ScopedLock lock(_queueMutex);
+		if (_stop && (_force || _queued == 0)) {
+			Log::debug("Shutdown worker thread for %i", (int)workerIdx);
+			break;
+		}
+		_queueCondition.wait(_queueMutex, [this] {
+			// predicate must return false if the waiting should continue
+			return this->_stop || this->_queued > 0;
+		});
+	}
+	_priv::currentPool = nullptr;
+}
+
 void ThreadPool::init() {
 #ifdef __EMSCRIPTEN__
 #ifndef __EMSCRIPTEN_PTHREADS__
@@ -35,50 +182,13 @@ void ThreadPool::init() {
 	_stop = false;
 	_workers.reserve(_threads);
 	for (size_t i = 0; i < _threads; ++i) {
-		_workers.emplace_back([this, i] {
-			const core::String n = core::string::format("%s-%i", this->_name, (int)i);
-			if (!setThreadName(n.c_str())) {
-				Log::debug("Failed to set thread name for pool thread %i", (int)i);
-			}
-			core_trace_thread(n.c_str());
-			for (;;) {
-				std::function<void()> task;
-				{
-					core::ScopedLock lock(this->_queueMutex);
-					if (!this->_stop) {
-						this->_queueCondition.wait(this->_queueMutex, [this] {
-							// predicate must return false if the waiting should continue
-							if (this->_stop) {
-								return true;
-							}
-							core::ScopedLock queueLock(this->_queueMutex);
-							if (!this->_tasks.empty()) {
-								return true;
-							}
-							return false;
-						});
-					}
-					if (this->_stop && (this->_force || this->_tasks.empty())) {
-						Log::debug("Shutdown worker thread for %i", (int)i);
-						break;
-					}
-					task = core::move(this->_tasks.front());
-					this->_tasks.pop();
-				}
-
-				core_trace_begin_frame(n.c_str());
-				core_trace_scoped(ThreadPoolWorker);
-				Log::trace("Execute task in %i", (int)i);
-				task();
-				Log::trace("End of task in %i", (int)i);
-				core_trace_end_frame(n.c_str());
-			}
-		});
+		_workers.emplace_back([this, i] { run(i); });
 	}
 }
 
 ThreadPool::~ThreadPool() {
 	shutdown();
+	delete[] _queues;
 }
 
 void ThreadPool::shutdown(bool wait) {
@@ -87,11 +197,15 @@ void ThreadPool::shutdown(bool wait) {
 	}
 	_force = !wait;
 	_stop = true;
+	{
+		core::ScopedLock lock(_queueMutex);
+	}
 	_queueCondition.notify_all();
 	for (std::thread &worker : _workers) {
 		worker.join();
 	}
 	_workers.clear();
+	abort();
 }
 
 }
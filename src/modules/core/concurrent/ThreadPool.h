@@ -30,8 +30,8 @@
 #include <thread>
 #include <future>
 #include <functional>
+#include "core/Common.h"
 #include "core/collection/DynamicArray.h"
-#include "core/collection/Queue.h"
 #include "core/concurrent/Atomic.h"
 #include "core/concurrent/Lock.h"
 #include "core/concurrent/ConditionVariable.h"
@@ -40,6 +40,38 @@
 
 namespace core {
 
+/**
+ * @brief The order in which the queued tasks are picked up by the workers of a @c ThreadPool
+ */
+enum class TaskPriority : uint8_t { High, Normal, Low, Max };
+
+/**
+ * @brief Allows to cancel a group of queued tasks without touching the other tasks of the pool
+ * @note Tasks that are already running are not interrupted - but they can check @c cancelled() on their own
+ */
+class CancellationToken {
+private:
+	core::AtomicBool _cancelled{false};
+
+public:
+	void cancel() {
+		_cancelled = true;
+	}
+
+	bool cancelled() const {
+		return _cancelled;
+	}
+};
+
+using CancellationTokenPtr = core::SharedPtr<CancellationToken>;
+
+/**
+ * @brief Work stealing thread pool
+ *
+ * Each worker has its own task queue per @c TaskPriority. Tasks that are scheduled from within a worker end up in the
+ * queue of that worker, all other tasks are distributed over the workers. An idle worker steals tasks from the queues
+ * of the other workers - stealing only uses @c core::Lock::try_lock() to not contend with the owner of the queue.
+ */
 class ThreadPool final {
 public:
 	explicit ThreadPool(size_t, const char *name = nullptr);
@@ -51,40 +83,109 @@ public:
 	template<class F, class ... Args>
 	auto enqueue(F&& f, Args&&... args) -> std::future<typename std::invoke_result<F, Args...>::type>;
 
+	/**
+	 * Enqueue functors or lambdas into the thread pool
+	 * @note If the task gets cancelled before it is executed, the returned future is not valid for @c get()
+	 */
+	template<class F, class ... Args>
+	auto enqueue(TaskPriority priority, const CancellationTokenPtr &token, F &&f, Args &&...args)
+		-> std::future<typename std::invoke_result<F, Args...>::type>;
+
+	/**
+	 * @brief Fire and forget version of @c enqueue() - there is no future and no @c std::packaged_task involved
+	 * @param token Optional token to cancel the task as long as it isn't running yet
+	 */
+	void schedule(std::function<void()> &&task, TaskPriority priority = TaskPriority::Normal,
+				  const CancellationTokenPtr &token = {});
+
+	/**
+	 * @brief Executes the given functor for the range @c [start,end) split into chunks of @c grainSize elements
+	 * @param func Called with the @c start and @c end (exclusive) of a chunk: @code void(int start, int end) @endcode
+	 * @param grainSize The amount of elements per chunk - @c 0 picks the size depending on the amount of workers
+	 * @note The calling thread works on the chunks, too - this method returns once all chunks are done. It can also be
+	 * used from within a task that is executed by this pool.
+	 */
+	template<class FUNC>
+	void parallelFor(int start, int end, FUNC &&func, int grainSize = 0);
+
 	size_t size() const;
 	void init();
 	/**
 	 * @brief Remove queued and not yet executed tasks
 	 * @note This does not abort the current running task
+	 * @sa CancellationToken
 	 */
 	void abort();
 	void shutdown(bool wait = false);
 
 	void reserve(size_t n);
 private:
+	struct Task {
+		std::function<void()> func;
+		CancellationTokenPtr token;
+	};
+
+	/**
+	 * @brief Tasks are taken from the front by the owner and from the back by the thieves
+	 */
+	class TaskQueue {
+	private:
+		core::DynamicArray<Task> _tasks;
+		size_t _head = 0u;
+
+	public:
+		inline bool empty() const {
+			return _head >= _tasks.size();
+		}
+		inline size_t size() const {
+			return _tasks.size() - _head;
+		}
+		inline void reserve(size_t n) {
+			_tasks.reserve(n);
+		}
+		inline void push(Task &&task) {
+			_tasks.emplace_back(core::move(task));
+		}
+		bool popFront(Task &task);
+		bool popBack(Task &task);
+		void clear();
+	};
+
+	struct Worker {
+		core_trace_mutex(core::Lock, lock, "ThreadPoolWorker");
+		TaskQueue tasks[(int)TaskPriority::Max];
+	};
+
 	const size_t _threads;
 	const char *_name;
 	// need to keep track of threads so we can join them
 	core::DynamicArray<std::thread> _workers;
-	// the task queue
-	core::Queue<std::function<void()> > _tasks core_thread_guarded_by(_queueMutex);
+	Worker *_queues;
+	// the amount of tasks in all queues
+	core::AtomicInt _queued{0};
+	// the queue that gets the next task that isn't scheduled from a worker of this pool
+	core::AtomicInt _nextQueue{0};
 
 	// synchronization
 	core_trace_mutex(core::Lock, _queueMutex, "ThreadPoolQueue");
 	core::ConditionVariable _queueCondition;
 	core::AtomicBool _stop { false };
 	core::AtomicBool _force { false };
-};
 
-inline void ThreadPool::reserve(size_t n) {
-	core::ScopedLock lock(_queueMutex);
-	_tasks.reserve(n);
-}
+	bool popTask(size_t workerIdx, bool wait, Task &task);
+	void run(size_t workerIdx);
+};
 
 // add new work item to the pool
 template<class F, class ... Args>
 auto ThreadPool::enqueue(F&& f, Args&&... args)
 -> std::future<typename std::invoke_result<F, Args...>::type> {
+	return enqueue(TaskPriority::Normal, CancellationTokenPtr(), core::forward<F>(f), core::forward<Args>(args)...);
+}
+
+template<class F, class ... Args>
+auto ThreadPool::enqueue(TaskPriority priority, const CancellationTokenPtr &token, F &&f, Args &&...args)
+	-> std::future<typename std::invoke_result<F, Args...>::type> {
 	using return_type = typename std::invoke_result<F, Args...>::type;
 	if (_stop) {
 		return std::future<return_type>();
@@ -93,15 +194,57 @@ auto ThreadPool::enqueue(F&& f, Args&&... args)
 	core::SharedPtr<std::packaged_task<return_type()> > task = core::make_shared<std::packaged_task<return_type()> >(std::bind(core::forward<F>(f), core::forward<Args>(args)...));
 
 	std::future<return_type> res = task->get_future();
-	{
-		core::ScopedLock lock(_queueMutex);
-		if (_stop) {
-			return std::future<return_type>();
+	schedule([task]() {(*task.get())();}, priority, token);
+	return res;
+}
+
+template<class FUNC>
+void ThreadPool::parallelFor(int start, int end, FUNC &&func, int grainSize) {
+	const int n = end - start;
+	if (n <= 0) {
+		return;
+	}
+	if (grainSize <= 0) {
+		grainSize = core_max(1, n / (int)(core_max(_threads, (size_t)1u) * 4u));
+	}
+	const int chunks = (n + grainSize - 1) / grainSize;
+	if (chunks <= 1 || _workers.empty() || _stop) {
+		func(start, end);
+		return;
+	}
+
+	struct State {
+		core::AtomicInt next{0};
+		core::AtomicInt done{0};
+		// signaled by the chunk that finishes last
+		core_trace_mutex(core::Lock, lock, "ParallelFor");
+		core::ConditionVariable finished;
+	};
+	// the helper tasks might get executed after this method returned - they must not touch the functor in that case
+	core::SharedPtr<State> state = core::make_shared<State>();
+	auto work = [&func, state, start, end, grainSize, chunks]() {
+		for (;;) {
+			const int chunk = state->next.increment(1);
+			if (chunk >= chunks) {
+				return;
+			}
+			const int chunkStart = start + chunk * grainSize;
+			const int chunkEnd = core_min(chunkStart + grainSize, end);
+			func(chunkStart, chunkEnd);
+			if (state->done.increment(1) + 1 == chunks) {
+				core::ScopedLock lock(state->lock);
+				state->finished.notify_all();
+			}
 		}
-		_tasks.emplace([task]() {(*task.get())();});
+	};
+	const int helpers = core_min(chunks - 1, (int)_threads);
+	for (int i = 0; i < helpers; ++i) {
+		schedule(work, TaskPriority::High);
 	}
-	_queueCondition.notify_one();
-	return res;
+	work();
+	// the remaining chunks are executed by the helpers - wait for them without burning a core
+	core::ScopedLock lock(state->lock);
+	state->finished.wait(state->lock, [&state, chunks]() { return state->done >= chunks; });
 }
 
 inline size_t ThreadPool::size() const {
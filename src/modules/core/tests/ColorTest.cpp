@@ -9,6 +9,9 @@
 #include "core/StringUtil.h"
 #include "core/collection/BufferView.h"
 #include "core/Endian.h"
+#include "core/collection/DynamicArray.h"
+#include "core/concurrent/ThreadPool.h"
+#include <limits.h>
 
 namespace core {
 
@@ -119,6 +122,76 @@ TEST(ColorTest, testQuantize) {
 	EXPECT_EQ(256, n) << "Failed with k-means.\n" << core::BufferView<RGBA>(targetBuf, n) << "\n" << core::BufferView<RGBA>(buf, lengthof(buf));
 }
 
+static core::DynamicArray<RGBA> quantizeTestColors() {
+	core::DynamicArray<RGBA> colors;
+	uint32_t seed = 1234u;
+	for (int i = 0; i < 3000; ++i) {
+		seed = seed * 1664525u + 1013904223u;
+		const RGBA color(seed >> 24, (seed >> 16) & 0xFF, (seed >> 8) & 0xFF, 255);
+		// some colors appear more than once
+		for (int j = 0; j <= i % 3; ++j) {
+			colors.push_back(color);
+		}
+	}
+	return colors;
+}
+
+TEST(ColorTest, testQuantizeDeterministic) {
+	const core::DynamicArray<RGBA> &colors = quantizeTestColors();
+	core::DynamicArray<RGBA> reversed;
+	for (size_t i = colors.size(); i > 0; --i) {
+		reversed.push_back(colors[i - 1]);
+	}
+	core::ThreadPool threadPool(4, "ColorTest");
+	threadPool.init();
+	for (int type = 0; type < (int)core::Color::ColorReductionType::Max; ++type) {
+		const core::Color::ColorReductionType reductionType = (core::Color::ColorReductionType)type;
+		if (reductionType == core::Color::ColorReductionType::NeuQuant) {
+			// learns from the order of the input colors
+			continue;
+		}
+		RGBA targetBuf1[64];
+		RGBA targetBuf2[64];
+		RGBA targetBuf3[64];
+		const int n1 = core::Color::quantize(targetBuf1, lengthof(targetBuf1), colors.data(), colors.size(), reductionType);
+		const int n2 = core::Color::quantize(targetBuf2, lengthof(targetBuf2), reversed.data(), reversed.size(), reductionType);
+		const int n3 = core::Color::quantize(targetBuf3, lengthof(targetBuf3), colors.data(), colors.size(), reductionType, &threadPool);
+		const char *name = core::Color::toColorReductionTypeString(reductionType);
+		ASSERT_GT(n1, 0) << name;
+		ASSERT_EQ(n1, n2) << name;
+		ASSERT_EQ(n1, n3) << name;
+		for (int i = 0; i < n1; ++i) {
+			EXPECT_EQ(targetBuf1[i], targetBuf2[i]) << name << " differs for the reversed input at " << i;
+			EXPECT_EQ(targetBuf1[i], targetBuf3[i]) << name << " differs for the parallel execution at " << i;
+		}
+	}
+	threadPool.shutdown();
+}
+
+TEST(ColorTest, testQuantizeWeighted) {
+	core::DynamicArray<RGBA> colors = quantizeTestColors();
+	const RGBA frequent(10, 200, 30, 255);
+	for (int i = 0; i < 100000; ++i) {
+		colors.push_back(frequent);
+	}
+	const core::Color::ColorReductionType types[] = {core::Color::ColorReductionType::KMeans,
+													 core::Color::ColorReductionType::MedianCut};
+	for (core::Color::ColorReductionType type : types) {
+		RGBA targetBuf[16];
+		const int n = core::Color::quantize(targetBuf, lengthof(targetBuf), colors.data(), colors.size(), type);
+		ASSERT_GT(n, 0);
+		int minDistance = INT_MAX;
+		for (int i = 0; i < n; ++i) {
+			const int dr = (int)targetBuf[i].r - (int)frequent.r;
+			const int dg = (int)targetBuf[i].g - (int)frequent.g;
+			const int db = (int)targetBuf[i].b - (int)frequent.b;
+			minDistance = core_min(minDistance, dr * dr + dg * dg + db * db);
+		}
+		EXPECT_LE(minDistance, 12) << "The most frequent color is not part of the palette for "
+								   << core::Color::toColorReductionTypeString(type);
+	}
+}
+
 TEST(ColorTest, testDistanceMin) {
 	const core::RGBA color1(255, 0, 0, 255);
 	const core::RGBA color2(255, 0, 0, 255);
@@ -5,6 +5,7 @@
 #include <gtest/gtest.h>
 #include "core/concurrent/ThreadPool.h"
 #include "core/concurrent/Atomic.h"
+#include "core/collection/DynamicArray.h"
 
 namespace core {
 
@@ -42,4 +43,72 @@ TEST_F(ThreadPoolTest, testMultiplePush) {
 	ASSERT_EQ(x, _count) << "Not all threads were executed";
 }
 
+TEST_F(ThreadPoolTest, testPriority) {
+	core::ThreadPool pool(1);
+	core::DynamicArray<int> order;
+	// the tasks are queued before the worker is started
+	pool.schedule([&order]() { order.push_back(3); }, core::TaskPriority::Low);
+	pool.schedule([&order]() { order.push_back(2); }, core::TaskPriority::Normal);
+	pool.schedule([&order]() { order.push_back(1); }, core::TaskPriority::High);
+	pool.init();
+	pool.shutdown(true);
+	ASSERT_EQ(3u, order.size());
+	EXPECT_EQ(1, order[0]);
+	EXPECT_EQ(2, order[1]);
+	EXPECT_EQ(3, order[2]);
+}
+
+TEST_F(ThreadPoolTest, testCancel) {
+	core::ThreadPool pool(2);
+	core::CancellationTokenPtr cancelled = core::make_shared<core::CancellationToken>();
+	core::CancellationTokenPtr token = core::make_shared<core::CancellationToken>();
+	for (int i = 0; i < 100; ++i) {
+		pool.schedule([this]() { _count.increment(1000); }, core::TaskPriority::Normal, cancelled);
+		pool.schedule([this]() { ++_count; }, core::TaskPriority::Normal, token);
+	}
+	cancelled->cancel();
+	pool.init();
+	pool.shutdown(true);
+	EXPECT_EQ(100, _count);
+}
+
+TEST_F(ThreadPoolTest, testScheduleFromTask) {
+	core::ThreadPool pool(2);
+	pool.init();
+	auto future = pool.enqueue([this, &pool]() {
+		for (int i = 0; i < 100; ++i) {
+			pool.schedule([this]() { ++_count; });
+		}
+	});
+	future.get();
+	pool.shutdown(true);
+	EXPECT_EQ(100, _count);
+}
+
+TEST_F(ThreadPoolTest, testParallelFor) {
+	core::ThreadPool pool(3);
+	pool.init();
+	core::DynamicArray<int> values;
+	values.resize(1000);
+	pool.parallelFor(0, (int)values.size(), [&values](int start, int end) {
+		for (int i = start; i < end; ++i) {
+			values[i] += i;
+		}
+	});
+	for (int i = 0; i < (int)values.size(); ++i) {
+		ASSERT_EQ(i, values[i]);
+	}
+}
+
+TEST_F(ThreadPoolTest, testParallelForNested) {
+	core::ThreadPool pool(2);
+	pool.init();
+	pool.parallelFor(0, 8, [&pool, this](int start, int end) {
+		for (int i = start; i < end; ++i) {
+			pool.parallelFor(0, 100, [this](int innerStart, int innerEnd) { _count.increment(innerEnd - innerStart); }, 10);
+		}
+	}, 1);
+	EXPECT_EQ(800, _count);
+}
+
 }
@@ -4,6 +4,7 @@
 
 #include "FileStream.h"
 #include "core/Log.h"
+#include "core/StandardLib.h"
 #include "io/File.h"
 #include <SDL_endian.h>
 #include <SDL_rwops.h>
@@ -17,11 +18,18 @@ FileStream::FileStream(const FilePtr &file) : _file(file) {
 		_rwops = _file->_file;
 		if (_rwops) {
 			_size = SDL_RWsize(_rwops);
+			const FileMode mode = _file->mode();
+			if (mode == FileMode::Read || mode == FileMode::SysRead || mode == FileMode::ReadNoHome) {
+				_readBuffer = (uint8_t *)core_malloc(ReadBufferSize);
+				_readBufferPos = SDL_RWtell(_rwops);
+				_readWindow = _readWindowEnd = _readBuffer;
+			}
 		}
 	}
 }
 
 FileStream::~FileStream() {
+	core_free(_readBuffer);
 }
 
 bool FileStream::valid() const {
@@ -53,21 +61,59 @@ int FileStream::write(const void *buf, size_t size) {
 	return (int)written;
 }
 
+size_t FileStream::readFile(uint8_t *buf, size_t size) {
+	size_t completeBytesRead = 0;
+	while (completeBytesRead < size) {
+		const size_t bytesRead = SDL_RWread(_rwops, buf, 1, (size - completeBytesRead));
+		buf += bytesRead;
+		completeBytesRead += bytesRead;
+		if (bytesRead == 0) {
+			break;
+		}
+	}
+	return completeBytesRead;
+}
+
 int FileStream::read(void *dataPtr, size_t dataSize) {
 	if (_rwops == nullptr) {
 		return -1;
 	}
 	uint8_t *b = (uint8_t*)dataPtr;
-	size_t completeBytesRead = 0;
-	while (completeBytesRead < dataSize) {
-		size_t bytesRead = SDL_RWread(_rwops, b, 1, (dataSize - completeBytesRead));
-		b += bytesRead;
-		completeBytesRead += bytesRead;
-		if (bytesRead == 0) {
-			break;
+	if (_readBuffer == nullptr) {
+		const size_t completeBytesRead = readFile(b, dataSize);
+		_pos = SDL_RWtell(_rwops);
+		if (completeBytesRead == 0) {
+			return -1;
+		}
+		return (int)completeBytesRead;
+	}
+
+	// serve what is left in the read buffer first
+	const size_t buffered = core_min(dataSize, (size_t)(_readWindowEnd - _readWindow));
+	core_memcpy(b, _readWindow, buffered);
+	_readWindow += buffered;
+	size_t completeBytesRead = buffered;
+	if (completeBytesRead < dataSize) {
+		// the file handle is at the end of the buffered data
+		const int64_t filePos = _readBufferPos + (int64_t)(_readWindowEnd - _readBuffer);
+		const size_t left = dataSize - completeBytesRead;
+		if (left >= ReadBufferSize) {
+			// large reads bypass the buffer
+			const size_t bytesRead = readFile(b + completeBytesRead, left);
+			completeBytesRead += bytesRead;
+			_readBufferPos = filePos + (int64_t)bytesRead;
+			_readWindow = _readWindowEnd = _readBuffer;
+		} else {
+			const size_t bytesRead = readFile(_readBuffer, ReadBufferSize);
+			_readBufferPos = filePos;
+			_readWindow = _readBuffer;
+			_readWindowEnd = _readBuffer + bytesRead;
+			const size_t n = core_min(left, bytesRead);
+			core_memcpy(b + completeBytesRead, _readWindow, n);
+			_readWindow += n;
+			completeBytesRead += n;
 		}
 	}
-	_pos = SDL_RWtell(_rwops);
 	if (completeBytesRead == 0) {
 		return -1;
 	}
@@ -78,6 +124,35 @@ int64_t FileStream::seek(int64_t position, int whence) {
 	if (_rwops == nullptr) {
 		return -1;
 	}
+	if (_readBuffer != nullptr) {
+		int64_t target;
+		switch (whence) {
+		case SEEK_SET:
+			target = position;
+			break;
+		case SEEK_CUR:
+			target = pos() + position;
+			break;
+		case SEEK_END:
+			target = _size + position;
+			break;
+		default:
+			return -1;
+		}
+		// seeking inside of the buffered data doesn't touch the file handle
+		const int64_t bufferedEnd = _readBufferPos + (int64_t)(_readWindowEnd - _readBuffer);
+		if (target >= _readBufferPos && target <= bufferedEnd) {
+			_readWindow = _readBuffer + (target - _readBufferPos);
+			return target;
+		}
+		const int64_t p = SDL_RWseek(_rwops, target, SEEK_SET);
+		_readBufferPos = SDL_RWtell(_rwops);
+		_readWindow = _readWindowEnd = _readBuffer;
+		if (p == -1) {
+			return -1;
+		}
+		return _readBufferPos;
+	}
 	int64_t p = SDL_RWseek(_rwops, position, whence);
 	_pos = SDL_RWtell(_rwops);
 	if (p == -1) {
@@ -22,6 +22,9 @@ typedef core::SharedPtr<File> FilePtr;
  *
  * @note the stream is not flushed automatically. This is either done by calling flush() manually - or when the
  * used file instance is closed.
+ * @note Files that are opened for reading are read in chunks of @c ReadBufferSize bytes - the buffer is the read
+ * window for the primitive reads of the @c ReadStream
+ * @see MappedFileReadStream
  * @ingroup IO
  * @see SeekableReadStream
  * @see SeekableWriteStream
@@ -32,6 +35,21 @@ private:
 	FilePtr _file;
 	int64_t _size = -1;
 	int64_t _pos = 0;
+
+	static constexpr size_t ReadBufferSize = 64 * 1024;
+	/**
+	 * @brief Only allocated for files that are opened for reading
+	 */
+	uint8_t *_readBuffer = nullptr;
+	/**
+	 * @brief The offset in the file of the first byte in the read buffer
+	 */
+	int64_t _readBufferPos = 0;
+
+	/**
+	 * @brief Reads from the file handle until the given amount of bytes is read or the end of the file is reached
+	 */
+	size_t readFile(uint8_t *buf, size_t size);
 public:
 	FileStream(const FilePtr &file);
 	virtual ~FileStream();
@@ -54,6 +72,9 @@ inline int64_t FileStream::size() const {
 }
 
 inline int64_t FileStream::pos() const {
+	if (_readBuffer != nullptr) {
+		return _readBufferPos + (int64_t)(_readWindow - _readBuffer);
+	}
 	return _pos;
 }
 
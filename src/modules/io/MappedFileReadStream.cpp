@@ -0,0 +1,25 @@
+/**
+ * @file
+ */
+
+#include "MappedFileReadStream.h"
+#include "io/system/System.h"
+
+namespace io {
+
+MappedFileReadStream::MappedFileReadStream(const core::String &path) : Super(nullptr, 0) {
+	_mapping = fs_mmap(path.c_str(), _mappingSize);
+	if (_mapping == nullptr) {
+		return;
+	}
+	_buf = (const uint8_t *)_mapping;
+	_size = (int64_t)_mappingSize;
+	_readWindow = _buf;
+	_readWindowEnd = _buf + _mappingSize;
+}
+
+MappedFileReadStream::~MappedFileReadStream() {
+	fs_munmap(_mapping, _mappingSize);
+}
+
+} // namespace io
@@ -0,0 +1,40 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/String.h"
+#include "io/MemoryReadStream.h"
+
+namespace io {
+
+/**
+ * @brief Read only stream for a file that is mapped into memory
+ *
+ * Parsers that issue many small reads don't end up in a system call for each of them - the whole file is the read
+ * window of the stream.
+ *
+ * @note Check @c valid() - the mapping might fail (e.g. for empty files or on platforms without support for it). Use a
+ * @c FileStream in this case.
+ * @ingroup IO
+ * @see FileStream
+ */
+class MappedFileReadStream : public MemoryReadStream {
+private:
+	using Super = MemoryReadStream;
+	void *_mapping = nullptr;
+	size_t _mappingSize = 0u;
+
+public:
+	MappedFileReadStream(const core::String &path);
+	virtual ~MappedFileReadStream();
+
+	bool valid() const;
+};
+
+inline bool MappedFileReadStream::valid() const {
+	return _mapping != nullptr;
+}
+
+} // namespace io
@@ -8,52 +8,48 @@
 namespace io {
 
 MemoryReadStream::MemoryReadStream(const void *buf, size_t size) : _buf((const uint8_t*)buf), _size(size) {
+	_readWindow = _buf;
+	_readWindowEnd = _buf + size;
 }
 
 MemoryReadStream::~MemoryReadStream() {
-	core_free(_ownBuf);
 }
 
 int MemoryReadStream::read(void *dataPtr, size_t dataSize) {
-	const int64_t rem = remaining();
+	const int64_t rem = (int64_t)(_readWindowEnd - _readWindow);
 	if (rem == 0) {
 		return 0;
 	}
 	if (dataSize > (size_t)rem) {
 		dataSize = rem;
 	}
-	if (_pos + (int64_t)dataSize > _size) {
-		return -1;
-	}
-	if (_ownBuf) {
-		core_memcpy(dataPtr, &_ownBuf[_pos], dataSize);
-	} else {
-		core_memcpy(dataPtr, &_buf[_pos], dataSize);
-	}
-	_pos += (int64_t)dataSize;
+	core_memcpy(dataPtr, _readWindow, dataSize);
+	_readWindow += dataSize;
 	return (int)dataSize;
 }
 
 int64_t MemoryReadStream::seek(int64_t position, int whence) {
+	int64_t newPos;
 	switch (whence) {
 	case SEEK_SET:
-		_pos = position;
+		newPos = position;
 		break;
 	case SEEK_CUR:
-		_pos += position;
+		newPos = pos() + position;
 		break;
 	case SEEK_END:
-		_pos = _size + position;
+		newPos = _size + position;
 		break;
 	default:
 		return -1;
 	}
-	if (_pos < 0) {
-		_pos = 0;
-	} else if (_pos > _size) {
-		_pos = _size;
+	if (newPos < 0) {
+		newPos = 0;
+	} else if (newPos > _size) {
+		newPos = _size;
 	}
-	return _pos;
+	_readWindow = _buf + newPos;
+	return newPos;
 }
 
 } // namespace io
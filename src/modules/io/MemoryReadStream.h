@@ -9,6 +9,7 @@
 namespace io {
 
 /**
+ * @note The whole buffer is exposed as read window - the primitive reads of @c ReadStream don't need a virtual call
  * @ingroup IO
  * @see SeekableReadStream
  * @see BufferedReadWriteStream
@@ -16,9 +17,7 @@ namespace io {
 class MemoryReadStream : public SeekableReadStream {
 protected:
 	const uint8_t *_buf = nullptr;
-	uint8_t *_ownBuf = nullptr;
 	int64_t _size;
-	int64_t _pos = 0;
 
 public:
 	MemoryReadStream(const void *buf, size_t size);
@@ -35,7 +34,7 @@ inline int64_t MemoryReadStream::size() const {
 }
 
 inline int64_t MemoryReadStream::pos() const {
-	return _pos;
+	return (int64_t)(_readWindow - _buf);
 }
 
 } // namespace io
@@ -351,7 +351,7 @@ bool ReadStream::readLine(core::String &str) {
 			return false;
 		}
 		if (chr == '\r') {
-			if (read(&chr, sizeof(chr)) != sizeof(chr)) {
+			if (!readFast(chr)) {
 				if (chr != '\n') {
 					return false;
 				}
@@ -461,14 +461,14 @@ bool ReadStream::readUTF16BE(uint16_t characters, core::String &str) {
 }
 
 int ReadStream::readUInt8(uint8_t &val) {
-	if (read(&val, sizeof(val)) == sizeof(val)) {
+	if (readFast(val)) {
 		return 0;
 	}
 	return -1;
 }
 
 int ReadStream::readInt8(int8_t &val) {
-	if (read(&val, sizeof(val)) == sizeof(val)) {
+	if (readFast(val)) {
 		return 0;
 	}
 	return -1;
@@ -495,7 +495,7 @@ bool ReadStream::readBool() {
 }
 
 int ReadStream::readUInt16(uint16_t &val) {
-	if (read(&val, sizeof(val)) == sizeof(val)) {
+	if (readFast(val)) {
 		const uint16_t swapped = core_swap16le(val);
 		val = swapped;
 		return 0;
@@ -504,7 +504,7 @@ int ReadStream::readUInt16(uint16_t &val) {
 }
 
 int ReadStream::readInt16(int16_t &val) {
-	if (read(&val, sizeof(val)) == sizeof(val)) {
+	if (readFast(val)) {
 		const int16_t swapped = core_swap16le(val);
 		val = swapped;
 		return 0;
@@ -513,7 +513,7 @@ int ReadStream::readInt16(int16_t &val) {
 }
 
 int ReadStream::readInt16BE(int16_t &val) {
-	if (read(&val, sizeof(val)) == sizeof(val)) {
+	if (readFast(val)) {
 		const int16_t swapped = core_swap16be(val);
 		val = swapped;
 		return 0;
@@ -522,7 +522,7 @@ int ReadStream::readInt16BE(int16_t &val) {
 }
 
 int ReadStream::readUInt16BE(uint16_t &val) {
-	if (read(&val, sizeof(val)) == sizeof(val)) {
+	if (readFast(val)) {
 		const uint16_t swapped = core_swap16be(val);
 		val = swapped;
 		return 0;
@@ -579,7 +579,7 @@ int ReadStream::readDoubleBE(double &val) {
 }
 
 int ReadStream::readUInt32(uint32_t &val) {
-	if (read(&val, sizeof(val)) == sizeof(val)) {
+	if (readFast(val)) {
 		const uint32_t swapped = core_swap32le(val);
 		val = swapped;
 		return 0;
@@ -588,7 +588,7 @@ int ReadStream::readUInt32(uint32_t &val) {
 }
 
 int ReadStream::readInt32(int32_t &val) {
-	if (read(&val, sizeof(val)) == sizeof(val)) {
+	if (readFast(val)) {
 		const int32_t swapped = (int32_t)core_swap32le(val);
 		val = swapped;
 		return 0;
@@ -597,7 +597,7 @@ int ReadStream::readInt32(int32_t &val) {
 }
 
 int ReadStream::readUInt32BE(uint32_t &val) {
-	if (read(&val, sizeof(val)) == sizeof(val)) {
+	if (readFast(val)) {
 		const uint32_t swapped = core_swap32be(val);
 		val = swapped;
 		return 0;
@@ -606,7 +606,7 @@ int ReadStream::readUInt32BE(uint32_t &val) {
 }
 
 int ReadStream::readInt32BE(int32_t &val) {
-	if (read(&val, sizeof(val)) == sizeof(val)) {
+	if (readFast(val)) {
 		const int32_t swapped = core_swap32be(val);
 		val = swapped;
 		return 0;
@@ -615,7 +615,7 @@ int ReadStream::readInt32BE(int32_t &val) {
 }
 
 int ReadStream::readUInt64(uint64_t &val) {
-	if (read(&val, sizeof(val)) == sizeof(val)) {
+	if (readFast(val)) {
 		const uint64_t swapped = core_swap64le(val);
 		val = swapped;
 		return 0;
@@ -624,7 +624,7 @@ int ReadStream::readUInt64(uint64_t &val) {
 }
 
 int ReadStream::readInt64(int64_t &val) {
-	if (read(&val, sizeof(val)) == sizeof(val)) {
+	if (readFast(val)) {
 		const int64_t swapped = core_swap64le(val);
 		val = swapped;
 		return 0;
@@ -633,7 +633,7 @@ int ReadStream::readInt64(int64_t &val) {
 }
 
 int ReadStream::readUInt64BE(uint64_t &val) {
-	if (read(&val, sizeof(val)) == sizeof(val)) {
+	if (readFast(val)) {
 		const uint64_t swapped = core_swap64be(val);
 		val = swapped;
 		return 0;
@@ -642,7 +642,7 @@ int ReadStream::readUInt64BE(uint64_t &val) {
 }
 
 int ReadStream::readInt64BE(int64_t &val) {
-	if (read(&val, sizeof(val)) == sizeof(val)) {
+	if (readFast(val)) {
 		const int64_t swapped = core_swap64be(val);
 		val = swapped;
 		return 0;
@@ -662,7 +662,7 @@ bool SeekableReadStream::readLine(core::String &str) {
 			return false;
 		}
 		if (chr == '\r') {
-			if (read(&chr, sizeof(chr)) != sizeof(chr)) {
+			if (!readFast(chr)) {
 				if (chr != '\n') {
 					seek(-1, SEEK_CUR);
 				}
@@ -688,7 +688,7 @@ bool SeekableReadStream::readLine(int length, char *strbuff) {
 		}
 		if (chr == '\r') {
 			strbuff[i] = '\0';
-			if (read(&chr, sizeof(chr)) != sizeof(chr)) {
+			if (!readFast(chr)) {
 				if (chr != '\n') {
 					seek(-1, SEEK_CUR);
 				}
@@ -7,6 +7,7 @@
 #include "core/Common.h"
 #include "core/String.h"
 #include "core/NonCopyable.h"
+#include "core/StandardLib.h"
 #include <stdio.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -26,6 +27,28 @@ namespace io {
  * @ingroup IO
  */
 class ReadStream : public core::NonCopyable {
+protected:
+	/**
+	 * @brief Streams that are backed by contiguous memory expose the bytes that can be read without calling @c read()
+	 * in this window. The primitive reads copy directly from here and advance @c _readWindow - the stream has to take this
+	 * into account for its position.
+	 */
+	const uint8_t *_readWindow = nullptr;
+	const uint8_t *_readWindowEnd = nullptr;
+
+	/**
+	 * @brief Reads the value from the window if enough bytes are available - falls back to @c read() otherwise
+	 */
+	template<typename T>
+	inline bool readFast(T &val) {
+		if (_readWindowEnd - _readWindow >= (ptrdiff_t)sizeof(T)) {
+			core_memcpy(&val, _readWindow, sizeof(T));
+			_readWindow += sizeof(T);
+			return true;
+		}
+		return read(&val, sizeof(T)) == (int)sizeof(T);
+	}
+
 public:
 	virtual ~ReadStream() {}
 	/**
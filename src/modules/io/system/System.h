@@ -21,5 +21,13 @@ bool fs_stat(const char *path, FilesystemEntry &entry);
 core::DynamicArray<FilesystemEntry> fs_scandir(const char *path);
 core::String fs_readlink(const char *path);
 core::String fs_cwd();
+/**
+ * @brief Maps the given file read-only into memory
+ * @param[out] size The size of the mapping
+ * @return @c nullptr if the file could not get mapped - use the normal file io in this case
+ * @sa fs_munmap()
+ */
+void *fs_mmap(const char *path, size_t &size);
+void fs_munmap(void *data, size_t size);
 
 } // namespace io
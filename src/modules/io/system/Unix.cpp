@@ -17,6 +17,8 @@
 #include <errno.h>
 #include <pwd.h>
 #include <stdlib.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -332,6 +334,35 @@ bool fs_hidden(const char *path) {
 	return path[0] == '.';
 }
 
+void *fs_mmap(const char *path, size_t &size) {
+	size = 0;
+	const int fd = open(path, O_RDONLY);
+	if (fd == -1) {
+		Log::debug("Failed to open %s for mapping: %s", path, strerror(errno));
+		return nullptr;
+	}
+	struct stat s;
+	if (fstat(fd, &s) != 0 || !S_ISREG(s.st_mode) || s.st_size <= 0) {
+		close(fd);
+		return nullptr;
+	}
+	void *data = mmap(nullptr, (size_t)s.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// the mapping stays valid after the file descriptor was closed
+	close(fd);
+	if (data == MAP_FAILED) {
+		Log::debug("Failed to map %s: %s", path, strerror(errno));
+		return nullptr;
+	}
+	size = (size_t)s.st_size;
+	return data;
+}
+
+void fs_munmap(void *data, size_t size) {
+	if (data != nullptr) {
+		munmap(data, size);
+	}
+}
+
 } // namespace io
 
 #endif
@@ -5,6 +5,7 @@
 #include "io/FileStream.h"
 #include "core/FourCC.h"
 #include "io/Filesystem.h"
+#include "io/MappedFileReadStream.h"
 #include <gtest/gtest.h>
 
 namespace io {
@@ -105,6 +106,40 @@ TEST_F(FileStreamTest, testFileStreamRead) {
 	EXPECT_STREQ("owInfo", buf);
 }
 
+TEST_F(FileStreamTest, testFileStreamSeekAndReadMatchesMapping) {
+	const FilePtr &file = _fs.open("iotest.txt");
+	ASSERT_TRUE(file->exists());
+	MappedFileReadStream mapped(file->name());
+	ASSERT_TRUE(mapped.valid());
+	FileStream stream(file);
+	ASSERT_EQ(stream.size(), mapped.size());
+
+	const int64_t offsets[] = {0, 5, 3, 40, 1, 20};
+	for (int64_t offset : offsets) {
+		EXPECT_EQ(offset, stream.seek(offset));
+		EXPECT_EQ(offset, mapped.seek(offset));
+		uint32_t v1 = 0u;
+		uint32_t v2 = 0u;
+		EXPECT_EQ(0, stream.readUInt32(v1));
+		EXPECT_EQ(0, mapped.readUInt32(v2));
+		EXPECT_EQ(v1, v2) << "at offset " << offset;
+		EXPECT_EQ(stream.pos(), mapped.pos());
+	}
+
+	EXPECT_EQ(stream.size() - 2, stream.seek(-2, SEEK_END));
+	EXPECT_EQ(mapped.size() - 2, mapped.seek(-2, SEEK_END));
+	uint16_t v1 = 0u;
+	uint16_t v2 = 0u;
+	EXPECT_EQ(0, stream.readUInt16(v1));
+	EXPECT_EQ(0, mapped.readUInt16(v2));
+	EXPECT_EQ(v1, v2);
+	EXPECT_TRUE(stream.eos());
+	EXPECT_TRUE(mapped.eos());
+	uint8_t chr;
+	EXPECT_EQ(-1, stream.readUInt8(chr));
+	EXPECT_EQ(-1, mapped.readUInt8(chr));
+}
+
 TEST_F(FileStreamTest, testFileStreamWrite) {
 	io::Filesystem fs;
 	EXPECT_TRUE(fs.init("test", "test")) << "Failed to initialize the filesystem";
@@ -0,0 +1,186 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "AABB.h"
+#include "core/Algorithm.h"
+#include "core/Trace.h"
+#include "core/collection/DynamicArray.h"
+#include <float.h>
+#include <glm/common.hpp>
+
+namespace math {
+
+/**
+ * @brief Bounding volume hierarchy to find the items that are hit by a ray
+ *
+ * The hierarchy is built once with a median split on the longest axis of the item centers. It's meant for a
+ * moderate amount of items that are queried a lot more often than they change - e.g. the nodes of a scene for picking.
+ *
+ * @note Given NODE type must implement @c aabb() and return math::AABB<float>
+ */
+template<class NODE>
+class BVH {
+private:
+	static constexpr int MaxLeafItems = 4;
+	static constexpr int MaxDepth = 64;
+
+	struct Node {
+		AABB<float> aabb;
+		// index of the first item for leaves, index of the first child for inner nodes - the second child follows
+		int first = 0;
+		// the amount of items for leaves - 0 for inner nodes
+		int count = 0;
+	};
+
+	core::DynamicArray<NODE> _items;
+	core::DynamicArray<Node> _nodes;
+
+	/**
+	 * @return @c false if the ray misses the box or the box is behind the ray origin
+	 */
+	static bool intersect(const AABB<float> &aabb, const glm::vec3 &rayOrigin, const glm::vec3 &invDirection,
+						  float &tnear) {
+		const glm::vec3 t1 = (aabb.mins() - rayOrigin) * invDirection;
+		const glm::vec3 t2 = (aabb.maxs() - rayOrigin) * invDirection;
+		const glm::vec3 tmin = glm::min(t1, t2);
+		const glm::vec3 tmax = glm::max(t1, t2);
+		tnear = glm::max(glm::max(tmin.x, tmin.y), tmin.z);
+		const float tfar = glm::min(glm::min(tmax.x, tmax.y), tmax.z);
+		return tfar >= tnear && tfar >= 0.0f;
+	}
+
+	void build(int nodeIdx, int first, int count, int depth) {
+		AABB<float> aabb = _items[first].aabb();
+		glm::vec3 centerMins = aabb.getCenter();
+		glm::vec3 centerMaxs = centerMins;
+		for (int i = first + 1; i < first + count; ++i) {
+			const AABB<float> &itemAABB = _items[i].aabb();
+			aabb.accumulate(itemAABB);
+			centerMins = glm::min(centerMins, itemAABB.getCenter());
+			centerMaxs = glm::max(centerMaxs, itemAABB.getCenter());
+		}
+		_nodes[nodeIdx].aabb = aabb;
+		if (count <= MaxLeafItems || depth >= MaxDepth) {
+			_nodes[nodeIdx].first = first;
+			_nodes[nodeIdx].count = count;
+			return;
+		}
+
+		const glm::vec3 extent = centerMaxs - centerMins;
+		int axis = 0;
+		if (extent.y > extent[axis]) {
+			axis = 1;
+		}
+		if (extent.z > extent[axis]) {
+			axis = 2;
+		}
+		core::sort(_items.begin() + first, _items.begin() + first + count, [axis](const NODE &a, const NODE &b) {
+			return a.aabb().getCenter()[axis] < b.aabb().getCenter()[axis];
+		});
+
+		const int childIdx = (int)_nodes.size();
+		_nodes[nodeIdx].first = childIdx;
+		_nodes[nodeIdx].count = 0;
+		_nodes.emplace_back();
+		_nodes.emplace_back();
+		const int half = count / 2;
+		build(childIdx, first, half, depth + 1);
+		build(childIdx + 1, first + half, count - half, depth + 1);
+	}
+
+public:
+	/**
+	 * @brief Rebuilds the hierarchy for the given items
+	 */
+	void build(const core::DynamicArray<NODE> &items) {
+		core_trace_scoped(BVHBuild);
+		_items = items;
+		_nodes.clear();
+		if (_items.empty()) {
+			return;
+		}
+		_nodes.reserve(2 * _items.size() / MaxLeafItems + 1);
+		_nodes.emplace_back();
+		build(0, 0, (int)_items.size(), 0);
+	}
+
+	void clear() {
+		_items.clear();
+		_nodes.clear();
+	}
+
+	inline bool empty() const {
+		return _items.empty();
+	}
+
+	inline size_t size() const {
+		return _items.size();
+	}
+
+	/**
+	 * @brief Visits the items whose bounding box is hit by the ray nearer than @c closest - the nearer subtrees are
+	 * visited first.
+	 *
+	 * @param func Called as @c func(const NODE &item, float &closest) - it has to perform the exact intersection test
+	 * and should lower @c closest on a hit to prune the remaining subtrees.
+	 */
+	template<class FUNC>
+	void intersect(const glm::vec3 &rayOrigin, const glm::vec3 &rayDirection, float closest, FUNC &&func) const {
+		if (_nodes.empty()) {
+			return;
+		}
+		core_trace_scoped(BVHIntersect);
+		const glm::vec3 invDirection(
+			rayDirection.x == 0.0f ? FLT_MAX : 1.0f / rayDirection.x,
+			rayDirection.y == 0.0f ? FLT_MAX : 1.0f / rayDirection.y,
+			rayDirection.z == 0.0f ? FLT_MAX : 1.0f / rayDirection.z);
+
+		float tnear;
+		if (!intersect(_nodes[0].aabb, rayOrigin, invDirection, tnear) || tnear > closest) {
+			return;
+		}
+		struct Entry {
+			int nodeIdx;
+			float tnear;
+		};
+		Entry stack[MaxDepth + 2];
+		int stackSize = 0;
+		stack[stackSize++] = {0, tnear};
+		while (stackSize > 0) {
+			const Entry entry = stack[--stackSize];
+			if (entry.tnear > closest) {
+				continue;
+			}
+			const Node &node = _nodes[entry.nodeIdx];
+			if (node.count > 0) {
+				for (int i = node.first; i < node.first + node.count; ++i) {
+					func(_items[i], closest);
+				}
+				continue;
+			}
+			float tnearA;
+			float tnearB;
+			const bool hitA = intersect(_nodes[node.first].aabb, rayOrigin, invDirection, tnearA) && tnearA <= closest;
+			const bool hitB = intersect(_nodes[node.first + 1].aabb, rayOrigin, invDirection, tnearB) && tnearB <= closest;
+			if (hitA && hitB) {
+				// push the farther child first to visit the nearer one next
+				if (tnearA <= tnearB) {
+					stack[stackSize++] = {node.first + 1, tnearB};
+					stack[stackSize++] = {node.first, tnearA};
+				} else {
+					stack[stackSize++] = {node.first, tnearA};
+					stack[stackSize++] = {node.first + 1, tnearB};
+				}
+			} else if (hitA) {
+				stack[stackSize++] = {node.first, tnearA};
+			} else if (hitB) {
+				stack[stackSize++] = {node.first + 1, tnearB};
+			}
+		}
+	}
+};
+
+} // namespace math
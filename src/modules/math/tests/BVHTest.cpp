@@ -0,0 +1,79 @@
+/**
+ * @file
+ */
+
+#include "app/tests/AbstractTest.h"
+#include "math/BVH.h"
+#include "math/Random.h"
+#include <glm/geometric.hpp>
+
+namespace math {
+
+class BVHTest : public app::AbstractTest {
+protected:
+	struct Item {
+		AABB<float> bounds;
+		int id;
+
+		const AABB<float> &aabb() const {
+			return bounds;
+		}
+	};
+
+	static bool hit(const Item &item, const glm::vec3 &origin, const glm::vec3 &dir, float &distance) {
+		return item.bounds.intersect(origin, dir, 1000.0f, distance);
+	}
+};
+
+TEST_F(BVHTest, testEmpty) {
+	BVH<Item> bvh;
+	bvh.build({});
+	EXPECT_TRUE(bvh.empty());
+	int visited = 0;
+	bvh.intersect(glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), 1000.0f, [&](const Item &, float &) { ++visited; });
+	EXPECT_EQ(0, visited);
+}
+
+TEST_F(BVHTest, testNearestHit) {
+	Random random(42);
+	core::DynamicArray<Item> items;
+	for (int i = 0; i < 200; ++i) {
+		const glm::vec3 mins(random.randomf(-100.0f, 100.0f), random.randomf(-100.0f, 100.0f),
+							 random.randomf(-100.0f, 100.0f));
+		const glm::vec3 size(random.randomf(1.0f, 10.0f), random.randomf(1.0f, 10.0f), random.randomf(1.0f, 10.0f));
+		items.push_back({AABB<float>(mins, mins + size), i});
+	}
+	BVH<Item> bvh;
+	bvh.build(items);
+	ASSERT_EQ(items.size(), bvh.size());
+
+	for (int i = 0; i < 100; ++i) {
+		const glm::vec3 origin(random.randomf(-150.0f, 150.0f), 150.0f, random.randomf(-150.0f, 150.0f));
+		const glm::vec3 target(random.randomf(-100.0f, 100.0f), random.randomf(-100.0f, 100.0f),
+							   random.randomf(-100.0f, 100.0f));
+		const glm::vec3 dir = glm::normalize(target - origin);
+
+		// the intersection distance of AABB::intersect() is the far distance - this is enough to compare the results
+		int expectedId = -1;
+		float expectedDistance = 1000.0f;
+		for (const Item &item : items) {
+			float distance;
+			if (hit(item, origin, dir, distance) && distance < expectedDistance) {
+				expectedDistance = distance;
+				expectedId = item.id;
+			}
+		}
+
+		int id = -1;
+		bvh.intersect(origin, dir, 1000.0f, [&](const Item &item, float &closest) {
+			float distance;
+			if (hit(item, origin, dir, distance) && distance < closest) {
+				closest = distance;
+				id = item.id;
+			}
+		});
+		EXPECT_EQ(expectedId, id) << "ray " << i;
+	}
+}
+
+} // namespace math
@@ -125,128 +125,125 @@ MementoState::MementoState(MementoType _type, const core::DynamicArray<core::Str
 	: type(_type), stringList(_stringList) {
 }
 
-MementoData::MementoData(uint8_t *buf, size_t bufSize, const voxel::Region &region)
-	: _compressedSize(bufSize), _region(region) {
-	if (buf != nullptr) {
-		core_assert(_compressedSize > 0);
-		_buffer = buf;
-	} else {
-		core_assert(_compressedSize == 0);
-	}
+MementoData::Buffer::~Buffer() {
+	core_free(data);
 }
 
-MementoData::MementoData(const uint8_t *buf, size_t bufSize, const voxel::Region &region)
-	: _compressedSize(bufSize), _region(region) {
-	if (buf != nullptr) {
-		core_assert(_compressedSize > 0);
-		_buffer = (uint8_t *)core_malloc(_compressedSize);
-		core_memcpy(_buffer, buf, _compressedSize);
-	} else {
-		core_assert(_compressedSize == 0);
-	}
+MementoData::MementoData(std::shared_future<BufferPtr> &&buffer, size_t uncompressedSize,
+						 const voxel::Region &region, const voxel::Region &modifiedRegion)
+	: _buffer(core::move(buffer)), _uncompressedSize(uncompressedSize), _region(region),
+	  _modifiedRegion(modifiedRegion) {
 }
 
-MementoData::MementoData(MementoData &&o) noexcept
-	: _compressedSize(o._compressedSize), _buffer(o._buffer), _region(o._region) {
-	o._compressedSize = 0;
-	o._buffer = nullptr;
+const MementoData::Buffer *MementoData::buffer() const {
+	if (!_buffer.valid()) {
+		return nullptr;
+	}
+	return _buffer.get().get();
 }
 
-MementoData::~MementoData() {
-	if (_buffer != nullptr) {
-		core_free(_buffer);
-		_buffer = nullptr;
+size_t MementoData::size() const {
+	const Buffer *b = buffer();
+	if (b == nullptr) {
+		return 0u;
 	}
+	return b->size;
 }
 
-MementoData::MementoData(const MementoData &o) : _compressedSize(o._compressedSize), _region(o._region) {
-	if (o._buffer != nullptr) {
-		core_assert(_compressedSize > 0);
-		_buffer = (uint8_t *)core_malloc(_compressedSize);
-		core_memcpy(_buffer, o._buffer, _compressedSize);
-	} else {
-		core_assert(_compressedSize == 0);
+size_t MementoData::memory() const {
+	if (!_buffer.valid()) {
+		return 0u;
 	}
+	if (_buffer.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+		return _uncompressedSize;
+	}
+	return size();
 }
 
-MementoData &MementoData::operator=(MementoData &&o) noexcept {
-	if (this != &o) {
-		_compressedSize = o._compressedSize;
-		o._compressedSize = 0;
-		if (_buffer) {
-			core_free(_buffer);
-		}
-		_buffer = o._buffer;
-		o._buffer = nullptr;
-		_region = o._region;
+static MementoData::BufferPtr compress(const voxel::RawVolume &volume) {
+	const size_t uncompressedSize = voxel::RawVolume::size(volume.region());
+	io::BufferedReadWriteStream outStream(uncompressedSize);
+	{
+		io::ZipWriteStream stream(outStream);
+		stream.write(volume.data(), uncompressedSize);
+		stream.flush();
 	}
-	return *this;
+	const size_t size = (size_t)outStream.size();
+	// don't keep the capacity for the uncompressed data
+	uint8_t *data = (uint8_t *)core_realloc(outStream.release(), size);
+	return core::make_shared<MementoData::Buffer>(data, size);
 }
 
-MementoData &MementoData::operator=(const MementoData &o) noexcept {
-	if (this != &o) {
-		_compressedSize = o._compressedSize;
-		if (_buffer) {
-			core_free(_buffer);
-			_buffer = nullptr;
-		}
-		if (o._buffer != nullptr) {
-			core_assert(_compressedSize > 0);
-			_buffer = (uint8_t *)core_malloc(_compressedSize);
-			core_memcpy(_buffer, o._buffer, _compressedSize);
-		} else {
-			core_assert(_compressedSize == 0);
-		}
-		_region = o._region;
+/**
+ * @brief Executes the given compression task in the thread pool - or directly if no thread pool is given
+ */
+template<class FUNC>
+static std::shared_future<MementoData::BufferPtr> scheduleCompression(core::ThreadPool *threadPool, FUNC func) {
+	std::shared_future<MementoData::BufferPtr> buffer;
+	if (threadPool != nullptr) {
+		buffer = threadPool->enqueue(func).share();
 	}
-	return *this;
+	if (!buffer.valid()) {
+		std::promise<MementoData::BufferPtr> promise;
+		promise.set_value(func());
+		buffer = promise.get_future().share();
+	}
+	return buffer;
 }
 
-MementoData MementoData::fromVolume(const voxel::RawVolume *volume, const voxel::Region &region) {
+MementoData MementoData::fromVolume(const voxel::RawVolume *volume, const voxel::Region &region,
+									core::ThreadPool *threadPool) {
 	if (volume == nullptr) {
 		return MementoData();
 	}
-	voxel::Region mementoRegion = region;
-	// TODO: MEMENTO: see issue https://github.com/vengi-voxel/vengi/issues/200
-	// const bool partialMemento = mementoRegion.isValid();
-	const bool partialMemento = false;
-	if (!partialMemento) {
-		mementoRegion = volume->region();
+	const voxel::Region &volumeRegion = volume->region();
+	voxel::Region modifiedRegion = region;
+	if (!modifiedRegion.isValid() || !modifiedRegion.cropTo(volumeRegion)) {
+		modifiedRegion = volumeRegion;
 	}
+	// the voxels are copied here - the volume might get modified while the compression is running
+	core::SharedPtr<voxel::RawVolume> copy = core::make_shared<voxel::RawVolume>(*volume, modifiedRegion);
+	std::shared_future<BufferPtr> buffer = scheduleCompression(threadPool, [copy]() { return compress(*copy.get()); });
+	return {core::move(buffer), voxel::RawVolume::size(modifiedRegion), volumeRegion, modifiedRegion};
+}
 
-	const int allVoxels = volume->region().voxels();
-	io::BufferedReadWriteStream outStream(allVoxels * sizeof(voxel::Voxel));
-	io::ZipWriteStream stream(outStream);
-	if (partialMemento) {
-		voxel::RawVolume v(volume, region);
-		stream.write(v.data(), allVoxels * sizeof(voxel::Voxel));
-	} else {
-		stream.write(volume->data(), allVoxels * sizeof(voxel::Voxel));
-	}
-	stream.flush();
-	const size_t size = (size_t)outStream.size();
-	return {outStream.release(), size, mementoRegion};
+MementoData MementoData::rebase(const MementoData &base, const MementoData &mementoData,
+								core::ThreadPool *threadPool) {
+	core_assert(!base.isPartial());
+	core_assert(base.region() == mementoData.region());
+	std::shared_future<BufferPtr> buffer = scheduleCompression(threadPool, [base, mementoData]() {
+		voxel::RawVolume volume(base.region());
+		toVolume(&volume, base);
+		toVolume(&volume, mementoData);
+		return compress(volume);
+	});
+	return {core::move(buffer), voxel::RawVolume::size(base.region()), base.region(), base.region()};
 }
 
 bool MementoData::toVolume(voxel::RawVolume *volume, const MementoData &mementoData) {
-	if (mementoData._buffer == nullptr) {
+	const Buffer *buffer = mementoData.buffer();
+	if (buffer == nullptr) {
 		return false;
 	}
 	core_assert_always(volume != nullptr);
 	if (volume == nullptr) {
 		return false;
 	}
-	const size_t uncompressedBufferSize = mementoData.region().voxels() * sizeof(voxel::Voxel);
-	io::MemoryReadStream dataStream(mementoData._buffer, mementoData._compressedSize);
+	const voxel::Region &modifiedRegion = mementoData.modifiedRegion();
+	voxel::Region targetRegion = modifiedRegion;
+	if (!targetRegion.cropTo(volume->region())) {
+		return false;
+	}
+	const size_t uncompressedBufferSize = voxel::RawVolume::size(modifiedRegion);
+	io::MemoryReadStream dataStream(buffer->data, buffer->size);
 	io::ZipReadStream stream(dataStream, (int)dataStream.size());
 	uint8_t *uncompressedBuf = (uint8_t *)core_malloc(uncompressedBufferSize);
 	if (stream.read(uncompressedBuf, uncompressedBufferSize) == -1) {
 		core_free(uncompressedBuf);
 		return false;
 	}
-	core::ScopedPtr<voxel::RawVolume> v(
-		voxel::RawVolume::createRaw((voxel::Voxel *)uncompressedBuf, mementoData.region()));
-	voxelutil::copyIntoRegion(*v, *volume, mementoData.region());
+	core::ScopedPtr<voxel::RawVolume> v(voxel::RawVolume::createRaw((voxel::Voxel *)uncompressedBuf, modifiedRegion));
+	voxelutil::copy(*v, targetRegion, *volume, targetRegion);
 	return true;
 }
 
@@ -257,13 +254,28 @@ MementoHandler::~MementoHandler() {
 }
 
 bool MementoHandler::init() {
+	if (!_threadPoolRunning) {
+		_threadPool.init();
+		_threadPoolRunning = true;
+	}
 	return true;
 }
 
 void MementoHandler::shutdown() {
+	if (_threadPoolRunning) {
+		_threadPool.shutdown(true);
+		_threadPoolRunning = false;
+	}
 	clearStates();
 }
 
+core::ThreadPool *MementoHandler::threadPool() {
+	if (!_threadPoolRunning) {
+		return nullptr;
+	}
+	return &_threadPool;
+}
+
 void MementoHandler::lock() {
 	++_locked;
 }
@@ -281,8 +293,7 @@ void MementoHandler::beginGroup(const core::String &name) {
 	Log::debug("Begin memento group: %i (%s)", _groupState, name.c_str());
 	if (_groupState <= 0) {
 		cutFromGroupStatePosition();
-		_groups.emplace_back(MementoStateGroup{name, {}});
-		_groupStatePosition = stateSize() - 1;
+		addGroup(MementoStateGroup{name, {}});
 	}
 	++_groupState;
 }
@@ -325,10 +336,14 @@ void MementoHandler::printState(const MementoState &state) const {
 	Log::info("%s: node id: %s", typeToString(state.type), state.nodeUUID.c_str());
 	Log::info(" - parent: %s", state.parentUUID.c_str());
 	Log::info(" - name: %s", state.name.c_str());
-	Log::info(" - volume: %s", state.data._buffer == nullptr ? "empty" : "volume");
+	Log::info(" - volume: %s", state.hasVolumeData() ? "volume" : "empty");
 	const glm::ivec3 &mins = state.dataRegion().getLowerCorner();
 	const glm::ivec3 &maxs = state.dataRegion().getUpperCorner();
 	Log::info(" - region: mins(%i:%i:%i)/maxs(%i:%i:%i)", mins.x, mins.y, mins.z, maxs.x, maxs.y, maxs.z);
+	const glm::ivec3 &modifiedMins = state.data.modifiedRegion().getLowerCorner();
+	const glm::ivec3 &modifiedMaxs = state.data.modifiedRegion().getUpperCorner();
+	Log::info(" - modified region: mins(%i:%i:%i)/maxs(%i:%i:%i)", modifiedMins.x, modifiedMins.y, modifiedMins.z,
+			  modifiedMaxs.x, modifiedMaxs.y, modifiedMaxs.z);
 	Log::info(" - size: %ib", (int)state.data.size());
 	Log::info(" - palette: %s", palHash.c_str());
 	Log::info(" - normalPalette: %s", normalPalHash.c_str());
@@ -378,33 +393,91 @@ void MementoHandler::construct() {
 
 void MementoHandler::clearStates() {
 	core_assert_msg(_groupState <= 0, "You should not clear the states while you are recording a group state");
-	_groups.clear();
+	eraseBack(_groups.size());
 	_groupStatePosition = 0u;
+	_memory = 0u;
 }
 
-void MementoHandler::undoModification(MementoState &s) {
-	core_assert(s.hasVolumeData());
-	for (int i = _groupStatePosition; i >= 0; --i) {
+static inline bool isVolumeState(const MementoState &state) {
+	return state.type == MementoType::Modification || state.type == MementoType::SceneNodeAdded;
+}
+
+const MementoState *MementoHandler::findVolumeState(const core::String &nodeUUID, int groupIndex) const {
+	for (int i = groupIndex; i >= 0; --i) {
 		const MementoStateGroup &group = _groups[i];
-		for (const MementoState &prevS : group.states) {
-			if (prevS.nodeUUID != s.nodeUUID) {
+		for (int j = (int)group.states.size() - 1; j >= 0; --j) {
+			const MementoState &state = group.states[j];
+			if (state.nodeUUID == nodeUUID && isVolumeState(state)) {
+				return &state;
+			}
+		}
+	}
+	return nullptr;
+}
+
+MementoData MementoHandler::restoreRegion(const core::String &nodeUUID, int groupIndex,
+										  const voxel::Region &region) const {
+	// collect the states back to the last state with the whole volume
+	core::DynamicArray<const MementoState *> states;
+	for (int i = groupIndex; i >= 0; --i) {
+		const MementoStateGroup &group = _groups[i];
+		for (int j = (int)group.states.size() - 1; j >= 0; --j) {
+			const MementoState &state = group.states[j];
+			if (state.nodeUUID != nodeUUID || !isVolumeState(state)) {
 				continue;
 			}
-			if (prevS.type == MementoType::Modification || prevS.type == MementoType::SceneNodeAdded) {
-				core_assert(prevS.hasVolumeData() || !prevS.referenceUUID.empty());
-				s.data = prevS.data;
-				// undo for un-reference node - so we have to make it a reference node again
-				if (s.nodeType != prevS.nodeType) {
-					core_assert(prevS.nodeType == scenegraph::SceneGraphNodeType::ModelReference);
-					s.nodeType = prevS.nodeType;
-					s.referenceUUID = prevS.referenceUUID;
-				}
-				return;
+			if (!state.hasVolumeData()) {
+				Log::warn("Missing volume data for node %s", nodeUUID.c_str());
+				return MementoData();
+			}
+			states.push_back(&state);
+			if (!state.data.isPartial()) {
+				i = 0;
+				break;
 			}
 		}
 	}
+	if (states.empty() || states.back()->data.isPartial()) {
+		Log::warn("No full volume state found for node %s", nodeUUID.c_str());
+		return MementoData();
+	}
+	voxel::RawVolume volume(region);
+	for (int i = (int)states.size() - 1; i >= 0; --i) {
+		const MementoData &data = states[i]->data;
+		if (voxel::intersects(data.modifiedRegion(), region)) {
+			MementoData::toVolume(&volume, data);
+		}
+	}
+	MementoData data = MementoData::fromVolume(&volume, voxel::Region::InvalidRegion);
+	data._region = states[0]->data.region();
+	return data;
+}
 
-	Log::warn("No previous modification state found for node %s", s.nodeUUID.c_str());
+void MementoHandler::undoModification(MementoState &s) {
+	core_assert(s.hasVolumeData());
+	const MementoState *prevS = findVolumeState(s.nodeUUID, _groupStatePosition);
+	if (prevS == nullptr) {
+		Log::warn("No previous modification state found for node %s", s.nodeUUID.c_str());
+		return;
+	}
+	core_assert(prevS->hasVolumeData() || !prevS->referenceUUID.empty());
+	if (!prevS->hasVolumeData() || (!s.data.isPartial() && !prevS->data.isPartial())) {
+		s.data = prevS->data;
+	} else {
+		// the voxels of the previous states must be combined - either for the modified region of the state or for
+		// the whole volume if the previous state only contains a part of the volume
+		const voxel::Region &region = s.data.isPartial() ? s.data.modifiedRegion() : prevS->data.region();
+		MementoData data = restoreRegion(s.nodeUUID, _groupStatePosition, region);
+		if (data.hasVolume()) {
+			s.data = core::move(data);
+		}
+	}
+	// undo for un-reference node - so we have to make it a reference node again
+	if (s.nodeType != prevS->nodeType) {
+		core_assert(prevS->nodeType == scenegraph::SceneGraphNodeType::ModelReference);
+		s.nodeType = prevS->nodeType;
+		s.referenceUUID = prevS->referenceUUID;
+	}
 }
 
 void MementoHandler::undoPaletteChange(MementoState &s) {
@@ -685,7 +758,7 @@ bool MementoHandler::markUndoPreamble() {
 		// every other state that follows the new one (everything after
 		// the current state position)
 		const size_t n = _groups.size() - (_groupStatePosition + 1);
-		_groups.erase_back(n);
+		eraseBack(n);
 	}
 	return true;
 }
@@ -697,7 +770,7 @@ bool MementoHandler::removeLast() {
 	if (_groupStatePosition == stateSize() - 1) {
 		--_groupStatePosition;
 	}
-	_groups.erase_back(1);
+	eraseBack(1);
 	return true;
 }
 
@@ -727,7 +800,18 @@ bool MementoHandler::markUndo(const core::String &parentId, const core::String &
 		!recordVolumeStates(volume)) {
 		volume = nullptr;
 	}
-	const MementoData &data = MementoData::fromVolume(volume, modifiedRegion);
+	voxel::Region dataRegion = voxel::Region::InvalidRegion;
+	if (volume != nullptr && type == MementoType::Modification) {
+		// only the modified voxels are stored if the previous state of the node is for the same volume region - the
+		// undo step combines the voxels of the previous states then
+		const MementoState *prevState = findVolumeState(nodeId, (int)stateSize() - 1);
+		// without a valid modified region inside the volume the whole volume is recorded
+		if (prevState != nullptr && prevState->hasVolumeData() && prevState->data.region() == volume->region() &&
+			modifiedRegion.isValid() && volume->region().containsRegion(modifiedRegion)) {
+			dataRegion = modifiedRegion;
+		}
+	}
+	const MementoData &data = MementoData::fromVolume(volume, dataRegion, threadPool());
 	MementoState state(type, data, parentId, nodeId, referenceId, name, nodeType, pivot, allKeyFrames, palette,
 					   normalPalette, properties);
 	addState(core::move(state));
@@ -737,21 +821,114 @@ bool MementoHandler::markUndo(const core::String &parentId, const core::String &
 void MementoHandler::cutFromGroupStatePosition() {
 	const int cutOff = core_max(0, (int)(stateSize() - _groupStatePosition - 1));
 	Log::debug("Cut off %i states", cutOff);
-	_groups.erase_back(cutOff);
+	eraseBack(cutOff);
+}
+
+static size_t groupMemory(const MementoStateGroup &group) {
+	size_t bytes = 0u;
+	for (const MementoState &state : group.states) {
+		bytes += state.data.memory();
+	}
+	return bytes;
+}
+
+void MementoHandler::eraseBack(size_t n) {
+	// the ring buffer doesn't destroy the elements - release the volume data here
+	const size_t size = _groups.size();
+	for (size_t i = size - core_min(n, size); i < size; ++i) {
+		_memory -= _groups[i].memory;
+		_groups[i] = MementoStateGroup{};
+	}
+	_groups.erase_back(n);
+}
+
+void MementoHandler::evictFront() {
+	core_assert(!_groups.empty());
+	MementoStateGroup &front = _groups[0];
+	for (size_t i = 0; i < front.states.size(); ++i) {
+		const MementoState &state = front.states[i];
+		if (!isVolumeState(state) || !state.hasVolumeData()) {
+			continue;
+		}
+		// the next volume state of the node might only contain the modified voxels - in that case it must get
+		// the whole volume now
+		MementoState *next = nullptr;
+		MementoStateGroup *nextGroup = nullptr;
+		for (size_t g = 0; g < _groups.size() && next == nullptr; ++g) {
+			MementoStateGroup &group = _groups[g];
+			for (size_t j = g == 0 ? i + 1 : 0; j < group.states.size(); ++j) {
+				MementoState &candidate = group.states[j];
+				if (candidate.nodeUUID == state.nodeUUID && isVolumeState(candidate)) {
+					next = &candidate;
+					nextGroup = &group;
+					break;
+				}
+			}
+		}
+		if (next == nullptr || !next->hasVolumeData() || !next->data.isPartial()) {
+			continue;
+		}
+		Log::debug("Rebase the volume state of node %s", state.nodeUUID.c_str());
+		// the state might be compressed meanwhile - so it might be accounted with a bigger size
+		const size_t oldMemory = core_min(nextGroup->memory, next->data.memory());
+		next->data = MementoData::rebase(state.data, next->data, threadPool());
+		const size_t newMemory = next->data.memory();
+		nextGroup->memory = nextGroup->memory - oldMemory + newMemory;
+		_memory = _memory - oldMemory + newMemory;
+	}
+	_memory -= front.memory;
+	front = MementoStateGroup{};
+	_groups.pop();
+	if (_groupStatePosition > 0) {
+		--_groupStatePosition;
+	}
+}
+
+void MementoHandler::enforceMemoryBudget() {
+	if (_maxMemory == 0u || _memory <= _maxMemory) {
+		return;
+	}
+	// the running total contains the uncompressed sizes of the states that were added while their compression was
+	// still running - get the real sizes before states are evicted
+	_memory = 0u;
+	for (size_t i = 0; i < _groups.size(); ++i) {
+		MementoStateGroup &group = _groups[i];
+		group.memory = groupMemory(group);
+		_memory += group.memory;
+	}
+	// the current state must stay
+	while (_groupStatePosition > 0 && _memory > _maxMemory) {
+		Log::debug("Memento states exceed the memory budget of %i bytes", (int)_maxMemory);
+		evictFront();
+	}
+}
+
+void MementoHandler::addGroup(MementoStateGroup &&group) {
+	if (_groups.size() >= _groups.capacity()) {
+		evictFront();
+	}
+	group.memory = groupMemory(group);
+	_memory += group.memory;
+	_groups.emplace_back(core::move(group));
+	_groupStatePosition = stateSize() - 1;
 }
 
 void MementoHandler::addState(MementoState &&state) {
 	if (_groupState > 0) {
 		Log::debug("add group state: %i", _groupState);
+		const size_t bytes = state.data.memory();
+		_groups.back().memory += bytes;
+		_memory += bytes;
 		_groups.back().states.emplace_back(state);
+		enforceMemoryBudget();
 		return;
 	}
 	MementoStateGroup group;
 	group.name = "single";
 	group.states.emplace_back(state);
 	cutFromGroupStatePosition();
-	_groups.emplace_back(core::move(group));
-	_groupStatePosition = stateSize() - 1;
+	addGroup(core::move(group));
+	enforceMemoryBudget();
 }
 
 void MementoHandler::setMaxUndoRegion(const voxel::Region &region) {
@@ -762,6 +939,19 @@ const voxel::Region &MementoHandler::maxUndoRegion() const {
 	return _maxUndoRegion;
 }
 
+void MementoHandler::setMaxMemory(size_t bytes) {
+	_maxMemory = bytes;
+	enforceMemoryBudget();
+}
+
+size_t MementoHandler::maxMemory() const {
+	return _maxMemory;
+}
+
+size_t MementoHandler::memory() const {
+	return _memory;
+}
+
 bool MementoHandler::recordVolumeStates(const voxel::RawVolume *volume) const {
 	// the max region is not set, we accept everything
 	if (!_maxUndoRegion.isValid()) {
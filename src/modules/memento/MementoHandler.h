@@ -6,8 +6,10 @@
 
 #include "core/IComponent.h"
 #include "core/Optional.h"
+#include "core/SharedPtr.h"
 #include "core/String.h"
 #include "core/collection/RingBuffer.h"
+#include "core/concurrent/ThreadPool.h"
 #include "palette/NormalPalette.h"
 #include "palette/Palette.h"
 #include "scenegraph/SceneGraph.h"
@@ -16,6 +18,7 @@
 #include "voxel/Voxel.h"
 #include <stddef.h>
 #include <stdint.h>
+#include <future>
 
 namespace voxel {
 class RawVolume;
@@ -45,54 +48,101 @@ enum class MementoType {
 /**
  * @brief Holds the data of a memento state
  *
- * The given buffer is owned by this class and represents a compressed volume
+ * The voxels are stored in a compressed form. This is either the whole volume or only the part of the volume that was
+ * modified (see @c modifiedRegion()). The compression might still run on a worker thread - the accessors that need the
+ * compressed data wait for it. Copies share the compressed data.
  */
 class MementoData {
 	friend struct MementoState;
 	friend class MementoHandler;
 
+public:
+	struct Buffer {
+		uint8_t *data;
+		size_t size;
+
+		Buffer(uint8_t *_data, size_t _size) : data(_data), size(_size) {
+		}
+		~Buffer();
+	};
+	using BufferPtr = core::SharedPtr<Buffer>;
+
 private:
 	/**
-	 * @brief How big is the buffer with the compressed volume data
+	 * @brief The compressed volume data
 	 */
-	size_t _compressedSize = 0;
+	std::shared_future<BufferPtr> _buffer;
 	/**
-	 * @brief The compressed volume data
+	 * @brief How big is the volume data before the compression
 	 */
-	uint8_t *_buffer = nullptr;
+	size_t _uncompressedSize = 0;
 	/**
-	 * The region the given volume data is for
+	 * The region of the volume the given data was taken from
 	 */
 	voxel::Region _region{};
+	/**
+	 * The region the given volume data is for - either the whole volume region or a part of it
+	 */
+	voxel::Region _modifiedRegion{};
+
+	MementoData(std::shared_future<BufferPtr> &&buffer, size_t uncompressedSize, const voxel::Region &region,
+				const voxel::Region &modifiedRegion);
 
-	MementoData(const uint8_t *buf, size_t bufSize, const voxel::Region &region);
-	MementoData(uint8_t *buf, size_t bufSize, const voxel::Region &region);
+	/**
+	 * @note Blocks until the compression is done
+	 */
+	const Buffer *buffer() const;
+
+	/**
+	 * @brief Applies the voxels of the partial @c mementoData to the whole volume data of @c base
+	 * @return A @c MementoData with the whole volume
+	 */
+	static MementoData rebase(const MementoData &base, const MementoData &mementoData, core::ThreadPool *threadPool);
 
 public:
 	MementoData() {
 	}
-	MementoData(MementoData &&o) noexcept;
-	MementoData(const MementoData &o);
-	~MementoData();
-
-	inline size_t size() const {
-		return _compressedSize;
-	}
 
-	MementoData &operator=(MementoData &&o) noexcept;
-	MementoData &operator=(const MementoData &o) noexcept;
+	/**
+	 * @brief The size of the compressed data
+	 * @note Blocks until the compression is done
+	 */
+	size_t size() const;
+	/**
+	 * @brief The memory that is used by this state - doesn't block, but returns the uncompressed size as long as the
+	 * compression is not yet done
+	 */
+	size_t memory() const;
 
+	/**
+	 * @brief The region of the volume
+	 */
 	inline const voxel::Region &region() const {
 		return _region;
 	}
 
+	/**
+	 * @brief The region of the volume the data is stored for
+	 * @sa isPartial()
+	 */
+	inline const voxel::Region &modifiedRegion() const {
+		return _modifiedRegion;
+	}
+
+	/**
+	 * @return @c true if only a part of the volume is stored
+	 */
+	inline bool isPartial() const {
+		return _modifiedRegion != _region;
+	}
+
 	inline bool hasVolume() const {
-		return _buffer != nullptr;
+		return _buffer.valid();
 	}
 
 	/**
 	 * @brief Converts the given @c mementoData back into a voxels
-	 * @note Inserts the voxels from the memento data into the given volume at the given region.
+	 * @note Inserts the voxels from the memento data into the given volume at the modified region.
 	 */
 	static bool toVolume(voxel::RawVolume *volume, const MementoData &mementoData);
 	/**
@@ -100,8 +150,11 @@ public:
 	 * @param[in] volume The volume to create the memento state for. This might be @c null.
 	 * @param[in] region The region of the volume to create the memento data for - if this is not a valid region,
 	 * the whole volume is going to added to the memento data.
+	 * @param[in] threadPool If given, the compression is executed in this pool. The voxels are copied before this
+	 * method returns.
 	 */
-	static MementoData fromVolume(const voxel::RawVolume *volume, const voxel::Region &region);
+	static MementoData fromVolume(const voxel::RawVolume *volume, const voxel::Region &region,
+								  core::ThreadPool *threadPool = nullptr);
 };
 
 struct MementoState {
@@ -148,7 +201,7 @@ struct MementoState {
 	 * Some types (@c MementoType) don't have a volume attached.
 	 */
 	inline bool hasVolumeData() const {
-		return data._buffer != nullptr;
+		return data.hasVolume();
 	}
 
 	inline const voxel::Region &dataRegion() const {
@@ -159,13 +212,17 @@ struct MementoState {
 struct MementoStateGroup {
 	core::String name;
 	core::DynamicArray<MementoState> states;
+	/** the memory of the states that is part of the running total of the @c MementoHandler */
+	size_t memory = 0u;
 };
 
 using MementoStates = core::RingBuffer<MementoStateGroup, 64u>;
 /**
  * @brief Class that manages the undo and redo steps for the scene
  *
- * @note For the volumes only the dirty regions are stored in a compressed form.
+ * @note For the volumes only the dirty regions are stored in a compressed form. The first volume state of a node is
+ * always the whole volume, the following modifications only store the modified region as long as the volume region
+ * doesn't change. The compression is done on a worker thread.
  */
 class MementoHandler : public core::IComponent {
 private:
@@ -174,9 +231,43 @@ private:
 	uint8_t _groupStatePosition = 0u;
 	int _locked = 0;
 	voxel::Region _maxUndoRegion = voxel::Region::InvalidRegion;
+	size_t _maxMemory = 0u;
+	/**
+	 * @brief Running total of the memory of all state groups - the states that were still compressed when they were
+	 * added are counted with their uncompressed size until the total is refreshed
+	 * @sa enforceMemoryBudget()
+	 * @sa MementoStateGroup::memory
+	 */
+	size_t _memory = 0u;
+	// only one thread to keep the order of the compression and rebase tasks
+	core::ThreadPool _threadPool{1, "Memento"};
+	bool _threadPoolRunning = false;
 
 	void cutFromGroupStatePosition();
+	void eraseBack(size_t n);
+	void addGroup(MementoStateGroup &&group);
 	void addState(MementoState &&state);
+	/**
+	 * @brief Removes the oldest state group - the volume states of the following groups that depend on it are
+	 * converted into full volume states
+	 */
+	void evictFront();
+	/**
+	 * @brief Removes the oldest state groups until the memory budget is met
+	 * @note The states are only walked to get the real compressed sizes if the running total exceeds the budget
+	 * @sa setMaxMemory()
+	 */
+	void enforceMemoryBudget();
+	/**
+	 * @brief Searches the last state with volume data for the given node before (and including) the given group index
+	 */
+	const MementoState *findVolumeState(const core::String &nodeUUID, int groupIndex) const;
+	/**
+	 * @brief Restores the voxels of the given region from the volume states that were recorded before (and including)
+	 * the given group index
+	 */
+	MementoData restoreRegion(const core::String &nodeUUID, int groupIndex, const voxel::Region &region) const;
+	core::ThreadPool *threadPool();
 	/**
 	 * @return @c true if it's allowed to create an undo state
 	 */
@@ -227,6 +318,17 @@ public:
 	 */
 	void setMaxUndoRegion(const voxel::Region &region);
 	const voxel::Region &maxUndoRegion() const;
+	/**
+	 * @brief Allow to set the max amount of bytes the compressed volume states may use. If this is exceeded, the
+	 * oldest states are removed. @c 0 means no limit.
+	 */
+	void setMaxMemory(size_t bytes);
+	size_t maxMemory() const;
+	/**
+	 * @brief The memory the volume states are using
+	 * @note States that are still compressed are counted with their uncompressed size
+	 */
+	size_t memory() const;
 	/**
 	 * @brief Checks if the given volume states are recorded
 	 */
@@ -260,6 +362,10 @@ public:
 	bool markNodeRemove(const scenegraph::SceneGraph &sceneGraph, const scenegraph::SceneGraphNode &node);
 	bool markNodeAdded(const scenegraph::SceneGraph &sceneGraph, const scenegraph::SceneGraphNode &node);
 	bool markNodeTransform(const scenegraph::SceneGraph &sceneGraph, const scenegraph::SceneGraphNode &node);
+	/**
+	 * @param modifiedRegion Must contain all voxels that were modified since the last state of the node - only the
+	 * voxels of this region might get recorded. Use @c voxel::Region::InvalidRegion to record the whole volume.
+	 */
 	bool markModification(const scenegraph::SceneGraph &sceneGraph, const scenegraph::SceneGraphNode &node,
 						  const voxel::Region &modifiedRegion);
 	bool markInitialNodeState(const scenegraph::SceneGraph &sceneGraph, const scenegraph::SceneGraphNode &node);
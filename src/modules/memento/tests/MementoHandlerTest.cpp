@@ -777,4 +777,95 @@ TEST_F(MementoHandlerTest, testAllAnimations) {
 	_sceneGraph.setAnimations(*stateRedo.stringList.value());
 }
 
+TEST_F(MementoHandlerTest, testPartialModification) {
+	voxel::RawVolume volume(voxel::Region(0, 7));
+	ASSERT_TRUE(_mementoHandler.markUndo(0, 0, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model, &volume,
+										 MementoType::SceneNodeAdded));
+	ASSERT_FALSE(_mementoHandler.stateGroup().states[0].data.isPartial());
+
+	const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, 1);
+	volume.setVoxel(1, 1, 1, voxel);
+	ASSERT_TRUE(_mementoHandler.markUndo(0, 0, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model, &volume,
+										 MementoType::Modification, voxel::Region(1, 1, 1, 1, 1, 1)));
+	ASSERT_TRUE(_mementoHandler.stateGroup().states[0].data.isPartial());
+	volume.setVoxel(5, 5, 5, voxel);
+	ASSERT_TRUE(_mementoHandler.markUndo(0, 0, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model, &volume,
+										 MementoType::Modification, voxel::Region(5, 5, 5, 5, 5, 5)));
+	ASSERT_TRUE(_mementoHandler.stateGroup().states[0].data.isPartial());
+
+	MementoState state = firstState(_mementoHandler.undo());
+	EXPECT_EQ(volume.region(), state.dataRegion());
+	EXPECT_EQ(voxel::Region(5, 5, 5, 5, 5, 5), state.data.modifiedRegion());
+	ASSERT_TRUE(MementoData::toVolume(&volume, state.data));
+	EXPECT_TRUE(voxel::isAir(volume.voxel(5, 5, 5).getMaterial()));
+	EXPECT_FALSE(voxel::isAir(volume.voxel(1, 1, 1).getMaterial()));
+
+	state = firstState(_mementoHandler.undo());
+	EXPECT_EQ(voxel::Region(1, 1, 1, 1, 1, 1), state.data.modifiedRegion());
+	ASSERT_TRUE(MementoData::toVolume(&volume, state.data));
+	EXPECT_TRUE(voxel::isAir(volume.voxel(1, 1, 1).getMaterial()));
+
+	state = firstState(_mementoHandler.redo());
+	ASSERT_TRUE(MementoData::toVolume(&volume, state.data));
+	EXPECT_FALSE(voxel::isAir(volume.voxel(1, 1, 1).getMaterial()));
+	EXPECT_TRUE(voxel::isAir(volume.voxel(5, 5, 5).getMaterial()));
+}
+
+TEST_F(MementoHandlerTest, testPartialModificationRebase) {
+	voxel::RawVolume volume(voxel::Region(0, 7));
+	ASSERT_TRUE(_mementoHandler.markUndo(0, 0, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model, &volume,
+										 MementoType::SceneNodeAdded));
+	const int n = (int)_mementoHandler.states().capacity() + 8;
+	for (int i = 1; i <= n; ++i) {
+		const glm::ivec3 pos(i % 8, (i / 8) % 8, i / 64);
+		volume.setVoxel(pos, voxel::createVoxel(voxel::VoxelType::Generic, i));
+		ASSERT_TRUE(_mementoHandler.markUndo(0, 0, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model, &volume,
+											 MementoType::Modification, voxel::Region(pos, pos)));
+	}
+	ASSERT_EQ(_mementoHandler.states().capacity(), _mementoHandler.stateSize());
+	// the oldest state must contain the whole volume now
+	const MementoState &oldest = _mementoHandler.states()[0].states[0];
+	ASSERT_TRUE(oldest.hasVolumeData());
+	EXPECT_FALSE(oldest.data.isPartial());
+
+	// undo the last modification
+	const MementoState &state = firstState(_mementoHandler.undo());
+	ASSERT_TRUE(MementoData::toVolume(&volume, state.data));
+	const glm::ivec3 pos(n % 8, (n / 8) % 8, n / 64);
+	EXPECT_TRUE(voxel::isAir(volume.voxel(pos).getMaterial()));
+	const glm::ivec3 prevPos((n - 1) % 8, ((n - 1) / 8) % 8, (n - 1) / 64);
+	EXPECT_EQ(n - 1, (int)volume.voxel(prevPos).getColor());
+}
+
+TEST_F(MementoHandlerTest, testMaxMemory) {
+	core::SharedPtr<voxel::RawVolume> first = create(4);
+	_mementoHandler.setMaxMemory(1);
+	for (int i = 0; i < 3; ++i) {
+		ASSERT_TRUE(_mementoHandler.markUndo(0, 0, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model,
+											 first.get(), MementoType::Modification));
+	}
+	EXPECT_EQ(1, (int)_mementoHandler.stateSize());
+	EXPECT_FALSE(_mementoHandler.canUndo());
+	EXPECT_GT(_mementoHandler.memory(), 0u);
+}
+
+TEST_F(MementoHandlerTest, testMemory) {
+	core::SharedPtr<voxel::RawVolume> first = create(4);
+	EXPECT_EQ(0u, _mementoHandler.memory());
+	ASSERT_TRUE(_mementoHandler.markUndo(0, 0, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model, first.get(),
+										 MementoType::Modification));
+	const size_t memory = _mementoHandler.memory();
+	EXPECT_GT(memory, 0u);
+	ASSERT_TRUE(_mementoHandler.markUndo(0, 0, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model, first.get(),
+										 MementoType::Modification));
+	EXPECT_GT(_mementoHandler.memory(), memory);
+	// the states after the current position are removed with the next state
+	_mementoHandler.undo();
+	ASSERT_TRUE(_mementoHandler.markUndo(0, 0, InvalidNodeId, "", scenegraph::SceneGraphNodeType::Model, nullptr,
+										 MementoType::SceneNodeRenamed));
+	EXPECT_EQ(memory, _mementoHandler.memory());
+	_mementoHandler.clearStates();
+	EXPECT_EQ(0u, _mementoHandler.memory());
+}
+
 } // namespace memento
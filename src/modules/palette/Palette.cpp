@@ -128,7 +128,8 @@ void Palette::reduce(uint8_t targetColors) {
 		core::Color::toColorReductionType(core::Var::getSafe(cfg::CoreColorReduction)->strVal().c_str());
 	PaletteColorArray oldcolors;
 	core_memcpy(oldcolors, _colors, sizeof(PaletteColorArray));
-	_colorCount = core::Color::quantize(_colors, targetColors, oldcolors, _colorCount, reductionType);
+	_colorCount = core::Color::quantize(_colors, targetColors, oldcolors, _colorCount, reductionType,
+										&app::App::getInstance()->threadPool());
 	markDirty();
 }
 
@@ -136,7 +137,8 @@ void Palette::quantize(const core::RGBA *inputColors, const size_t inputColorCou
 	Log::debug("quantize %i colors", (int)inputColorCount);
 	core::Color::ColorReductionType reductionType =
 		core::Color::toColorReductionType(core::Var::getSafe(cfg::CoreColorReduction)->strVal().c_str());
-	_colorCount = core::Color::quantize(_colors, lengthof(_colors), inputColors, inputColorCount, reductionType);
+	_colorCount = core::Color::quantize(_colors, lengthof(_colors), inputColors, inputColorCount, reductionType,
+										&app::App::getInstance()->threadPool());
 	markDirty();
 }
 
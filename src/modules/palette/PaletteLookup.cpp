@@ -0,0 +1,117 @@
+/**
+ * @file
+ */
+
+#include "PaletteLookup.h"
+#include "core/Trace.h"
+#include <float.h>
+#include <limits.h>
+
+namespace palette {
+
+void PaletteLookup::update() {
+	if (_paletteColorCount == _palette.colorCount() && _paletteHash == _palette.hash()) {
+		return;
+	}
+	core_trace_scoped(PaletteLookupUpdate);
+	_paletteColorCount = _palette.colorCount();
+	_paletteHash = _palette.hash();
+	_exactMatches.clear();
+	_transparentIndex = PaletteColorNotFound;
+	for (int i = _paletteColorCount - 1; i >= 0; --i) {
+		const core::RGBA rgba = _palette.color(i);
+		_exactMatches.put(rgba, (uint8_t)i);
+		if (rgba.a == 0) {
+			_transparentIndex = i;
+		}
+	}
+	_cells.resize(CellsPerChannel * CellsPerChannel * CellsPerChannel);
+	_cells.fill(Cell());
+	_candidates.clear();
+}
+
+/**
+ * @brief The distance range of a color channel value to all values in the cell
+ */
+static inline void channelDistance(int value, int cellMin, int cellMax, int &minDist, int &maxDist) {
+	if (value < cellMin) {
+		minDist = cellMin - value;
+	} else if (value > cellMax) {
+		minDist = value - cellMax;
+	} else {
+		minDist = 0;
+	}
+	maxDist = core_max(value - cellMin, cellMax - value);
+}
+
+const PaletteLookup::Cell &PaletteLookup::cell(core::RGBA rgba) {
+	const int r = rgba.r >> CellShift;
+	const int g = rgba.g >> CellShift;
+	const int b = rgba.b >> CellShift;
+	Cell &c = _cells[r + g * CellsPerChannel + b * CellsPerChannel * CellsPerChannel];
+	if (c.offset != -1) {
+		return c;
+	}
+
+	// the distances of core::Color::Distance::Approximation weight the red and blue channel with a factor in
+	// [2,3) - and the green channel with 4. The integer rounding makes the distance up to 2 smaller.
+	const int cellSize = 1 << CellShift;
+	int lowerBounds[PaletteMaxColors];
+	int minUpperBound = INT_MAX;
+	for (int i = 0; i < _paletteColorCount; ++i) {
+		const core::RGBA &color = _palette.color(i);
+		if (color.a == 0) {
+			continue;
+		}
+		int minR, maxR, minG, maxG, minB, maxB;
+		channelDistance(color.r, r * cellSize, r * cellSize + cellSize - 1, minR, maxR);
+		channelDistance(color.g, g * cellSize, g * cellSize + cellSize - 1, minG, maxG);
+		channelDistance(color.b, b * cellSize, b * cellSize + cellSize - 1, minB, maxB);
+		lowerBounds[i] = 2 * minR * minR + 4 * minG * minG + 2 * minB * minB - 2;
+		const int upperBound = 3 * maxR * maxR + 4 * maxG * maxG + 3 * maxB * maxB;
+		minUpperBound = core_min(minUpperBound, upperBound);
+	}
+
+	c.offset = (int32_t)_candidates.size();
+	for (int i = 0; i < _paletteColorCount; ++i) {
+		if (_palette.color(i).a == 0) {
+			continue;
+		}
+		if (lowerBounds[i] <= minUpperBound) {
+			_candidates.push_back((uint8_t)i);
+		}
+	}
+	c.count = (uint16_t)(_candidates.size() - c.offset);
+	return c;
+}
+
+uint8_t PaletteLookup::findClosestIndex(core::RGBA rgba) {
+	if (_palette.size() == 0) {
+		return (uint8_t)PaletteColorNotFound;
+	}
+	update();
+	uint8_t paletteIndex = 0;
+	if (_exactMatches.get(rgba, paletteIndex)) {
+		return paletteIndex;
+	}
+	if (rgba.a == 0) {
+		return (uint8_t)_transparentIndex;
+	}
+
+	// the candidates are sorted by palette index - the first color with the smallest distance wins just like in
+	// Palette::getClosestMatch()
+	const Cell &c = cell(rgba);
+	float minDistance = FLT_MAX;
+	int minIndex = PaletteColorNotFound;
+	for (uint16_t n = 0; n < c.count; ++n) {
+		const int i = _candidates[c.offset + n];
+		const float val = core::Color::getDistance(_palette.color(i), rgba, core::Color::Distance::Approximation);
+		if (val < minDistance) {
+			minDistance = val;
+			minIndex = i;
+		}
+	}
+	return (uint8_t)minIndex;
+}
+
+} // namespace palette
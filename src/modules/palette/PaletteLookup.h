@@ -5,22 +5,50 @@
 #pragma once
 
 #include "core/Color.h"
+#include "core/collection/DynamicArray.h"
 #include "core/collection/Map.h"
 #include "palette/Palette.h"
 
 namespace palette {
 
+/**
+ * @brief Finds the closest palette color for rgba values. The rgb color space is split into cells - and every cell
+ * knows the palette colors that can be the closest match for any color inside of it. This gives the same results as
+ * @c Palette::getClosestMatch() without looking at all palette colors for every query.
+ *
+ * @note The cells are computed on first access and recomputed if the palette colors change.
+ * @note Not thread safe - use one instance per thread.
+ */
 class PaletteLookup {
 private:
+	static constexpr int CellShift = 3;
+	static constexpr int CellsPerChannel = 256 >> CellShift;
+
+	struct Cell {
+		/** offset into @c _candidates or @c -1 if not yet computed */
+		int32_t offset = -1;
+		uint16_t count = 0u;
+	};
+
 	palette::Palette _palette;
-	core::Map<core::RGBA, uint8_t, 521> _paletteMap;
+	uint64_t _paletteHash = 0u;
+	int _paletteColorCount = -1;
+	/** the first palette index for every palette color */
+	core::Map<core::RGBA, uint8_t, 521> _exactMatches{PaletteMaxColors};
+	int _transparentIndex = PaletteColorNotFound;
+	core::DynamicArray<Cell> _cells;
+	core::DynamicArray<uint8_t> _candidates;
+
+	void update();
+	const Cell &cell(core::RGBA rgba);
+
 public:
-	PaletteLookup(const palette::Palette &palette, int maxSize = 32768) : _palette(palette), _paletteMap(maxSize) {
+	PaletteLookup(const palette::Palette &palette) : _palette(palette) {
 		if (_palette.colorCount() <= 0) {
 			_palette.nippon();
 		}
 	}
-	PaletteLookup(int maxSize = 32768) : _paletteMap(maxSize) {
+	PaletteLookup() {
 		_palette.nippon();
 	}
 
@@ -45,16 +73,7 @@ public:
 	 * @brief Find the closed index in the currently in-use palette for the given color
 	 * @sa core::Color::getClosestMatch()
 	 */
-	uint8_t findClosestIndex(core::RGBA rgba) {
-		uint8_t paletteIndex = 0;
-		if (!_paletteMap.get(rgba, paletteIndex)) {
-			paletteIndex = _palette.getClosestMatch(rgba);
-			if (_paletteMap.size() < _paletteMap.capacity()) {
-				_paletteMap.put(rgba, paletteIndex);
-			}
-		}
-		return paletteIndex;
-	}
+	uint8_t findClosestIndex(core::RGBA rgba);
 };
 
 } // namespace voxel
@@ -0,0 +1,32 @@
+/**
+ * @file
+ */
+
+#include "PaletteRemap.h"
+#include "core/Trace.h"
+
+namespace palette {
+
+PaletteRemap::PaletteRemap() {
+	for (int i = 0; i < PaletteMaxColors; ++i) {
+		_indices[i] = (int16_t)i;
+	}
+}
+
+PaletteRemap::PaletteRemap(const Palette &source, const Palette &target, int skipColorIndex) {
+	core_trace_scoped(PaletteRemap);
+	for (int i = 0; i < PaletteMaxColors; ++i) {
+		_indices[i] = (int16_t)target.getClosestMatch(source.color(i), skipColorIndex);
+	}
+}
+
+bool PaletteRemap::isIdentity() const {
+	for (int i = 0; i < PaletteMaxColors; ++i) {
+		if (_indices[i] != i) {
+			return false;
+		}
+	}
+	return true;
+}
+
+} // namespace palette
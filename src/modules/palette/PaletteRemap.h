@@ -0,0 +1,50 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "palette/Palette.h"
+
+namespace palette {
+
+/**
+ * @brief Maps the color indices of a source palette to the color indices of a target palette
+ *
+ * A volume can only reference @c PaletteMaxColors different colors - so the closest match is computed once per
+ * palette index instead of once per voxel.
+ *
+ * @sa Palette::getClosestMatch()
+ */
+class PaletteRemap {
+private:
+	int16_t _indices[PaletteMaxColors];
+
+public:
+	/**
+	 * @brief Creates the identity mapping
+	 */
+	PaletteRemap();
+	/**
+	 * @param skipColorIndex The target palette index that should not be used - see @c Palette::getClosestMatch()
+	 */
+	PaletteRemap(const Palette &source, const Palette &target, int skipColorIndex = -1);
+
+	/**
+	 * @return The target palette index or @c PaletteColorNotFound
+	 */
+	inline int remap(uint8_t colorIndex) const {
+		return _indices[colorIndex];
+	}
+
+	inline void set(uint8_t colorIndex, int targetColorIndex) {
+		_indices[colorIndex] = (int16_t)targetColorIndex;
+	}
+
+	/**
+	 * @return @c true if every color index is mapped onto itself
+	 */
+	bool isIdentity() const;
+};
+
+} // namespace palette
@@ -8,6 +8,7 @@
 #include "core/ConfigVar.h"
 #include "core/Var.h"
 #include "palette/PaletteLookup.h"
+#include "palette/PaletteRemap.h"
 
 namespace palette {
 
@@ -26,6 +27,50 @@ TEST_F(PaletteTest, testPaletteLookup) {
 	EXPECT_EQ(0, pal.findClosestIndex(rgba));
 }
 
+TEST_F(PaletteTest, testPaletteLookupMatchesClosestMatch) {
+	PaletteLookup lookup;
+	const Palette &pal = lookup.palette();
+	for (int r = 0; r < 256; r += 7) {
+		for (int g = 0; g < 256; g += 5) {
+			for (int b = 0; b < 256; b += 3) {
+				const core::RGBA rgba(r, g, b, 255);
+				ASSERT_EQ((uint8_t)pal.getClosestMatch(rgba), lookup.findClosestIndex(rgba))
+					<< "color " << r << ":" << g << ":" << b;
+			}
+		}
+	}
+}
+
+TEST_F(PaletteTest, testPaletteLookupPaletteChange) {
+	PaletteLookup lookup;
+	const core::RGBA rgba(1, 2, 3, 255);
+	const uint8_t index = lookup.findClosestIndex(rgba);
+	const uint8_t otherIndex = index == 0 ? 1 : 0;
+	lookup.palette().setColor(otherIndex, rgba);
+	EXPECT_EQ(otherIndex, lookup.findClosestIndex(rgba));
+}
+
+TEST_F(PaletteTest, testPaletteRemap) {
+	Palette source;
+	source.nippon();
+	Palette target;
+	target.minecraft();
+	const PaletteRemap remap(source, target);
+	for (int i = 0; i < PaletteMaxColors; ++i) {
+		ASSERT_EQ(target.getClosestMatch(source.color(i)), remap.remap(i)) << "index " << i;
+	}
+	EXPECT_FALSE(remap.isIdentity());
+	EXPECT_TRUE(PaletteRemap().isIdentity());
+}
+
+TEST_F(PaletteTest, testPaletteRemapSkipColorIndex) {
+	Palette palette;
+	palette.nippon();
+	const PaletteRemap remap(palette, palette, 1);
+	EXPECT_NE(1, remap.remap(1));
+	EXPECT_EQ(palette.getClosestMatch(palette.color(1), 1), remap.remap(1));
+}
+
 TEST_F(PaletteTest, testGimpPalette) {
 	Palette pal;
 	pal.nippon();
@@ -11,6 +11,7 @@
 #include "core/StringUtil.h"
 #include "core/collection/DynamicArray.h"
 #include "palette/Palette.h"
+#include "palette/PaletteRemap.h"
 #include "scenegraph/FrameTransform.h"
 #include "scenegraph/SceneGraphAnimation.h"
 #include "scenegraph/SceneGraphKeyFrame.h"
@@ -64,6 +65,7 @@ SceneGraph::SceneGraph(SceneGraph &&other) noexcept
 	  _cachedMaxFrame(other._cachedMaxFrame) {
 	other._nextNodeId = 0;
 	other._activeNodeId = InvalidNodeId;
+	other.markTransformsDirty();
 	_dirty = other.dirty();
 }
 
@@ -78,6 +80,8 @@ SceneGraph &SceneGraph::operator=(SceneGraph &&other) noexcept {
 		_activeAnimation = core::move(other._activeAnimation);
 		_cachedMaxFrame = other._cachedMaxFrame;
 		_dirty = other.dirty();
+		markTransformsDirty();
+		other.markTransformsDirty();
 	}
 	return *this;
 }
@@ -224,6 +228,7 @@ const core::String &SceneGraph::activeAnimation() const {
 
 void SceneGraph::markMaxFramesDirty() {
 	_cachedMaxFrame = -1;
+	markTransformsDirty();
 }
 
 FrameIndex SceneGraph::maxFrames() const {
@@ -391,12 +396,48 @@ FrameTransform SceneGraph::transformForFrame(const SceneGraphNode &node, FrameIn
 	return transformForFrame(node, _activeAnimation, frameIdx);
 }
 
+/**
+ * @brief The local matrix of the node for the given frame - interpolated between the surrounding key frames if needed
+ */
+static glm::mat4 localMatrixForFrame(const SceneGraphNode &node, FrameIndex frameIdx) {
+	KeyFrameIndex keyFrameIdx = InvalidKeyFrame;
+	if (node.keyFrames().size() == 1) {
+		return node.keyFrame(0)->transform().localMatrix();
+	}
+	if (node.hasKeyFrameForFrame(frameIdx, &keyFrameIdx)) {
+		return node.keyFrame(keyFrameIdx)->transform().localMatrix();
+	}
+	const KeyFrameIndex start = node.previousKeyFrameForFrame(frameIdx);
+	const KeyFrameIndex end = node.nextKeyFrameForFrame(frameIdx);
+	if (start == end) {
+		return node.keyFrame(start)->transform().localMatrix();
+	}
+	const SceneGraphKeyFrame *source = node.keyFrame(start);
+	const SceneGraphKeyFrame *target = node.keyFrame(end);
+	core_assert_always(source && target);
+	const InterpolationType interpolationType = source->interpolation;
+	const double deltaFrame = scenegraph::interpolate(interpolationType, (double)frameIdx, (double)source->frameIdx, (double)target->frameIdx);
+	const float lerpFactor = glm::clamp((float)(deltaFrame - (double)source->frameIdx), 0.0f, 1.0f);
+
+	const glm::vec3 translation = glm::mix(source->transform().localTranslation(), target->transform().localTranslation(), lerpFactor);
+	const glm::quat orientation = glm::slerp(source->transform().localOrientation(), target->transform().localOrientation(), lerpFactor);
+	const glm::vec3 scale = glm::mix(source->transform().localScale(), target->transform().localScale(), lerpFactor);
+	return glm::translate(translation) * glm::mat4_cast(orientation) * glm::scale(scale);
+}
+
 FrameTransform SceneGraph::transformForFrame(const SceneGraphNode &node, const core::String &animation,
 											 FrameIndex frameIdx) const {
 	// TODO: SCENEGRAPH: ik solver https://github.com/vengi-voxel/vengi/issues/182
 	// and https://github.com/vengi-voxel/vengi/issues/265
 	// TODO: SCENEGRAPH: solve flipping of child transforms if parent has rotation applied - see
 	// https://github.com/vengi-voxel/vengi/issues/420
+	const int nodeId = node.id();
+	if (nodeId != InvalidNodeId && hasNode(nodeId) && &this->node(nodeId) == &node) {
+		const FrameTransformsPtr &transforms = transformsForFrame(frameIdx);
+		return (*transforms.get())[nodeId];
+	}
+
+	// the node is not (yet) part of this scene graph - evaluate the parent chain without the cache
 	FrameTransform parentTransform;
 	if (node.parent() == InvalidNodeId) {
 		parentTransform.matrix = glm::mat4(1.0f);
@@ -405,34 +446,69 @@ FrameTransform SceneGraph::transformForFrame(const SceneGraphNode &node, const c
 	}
 
 	FrameTransform transform;
-	KeyFrameIndex keyFrameIdx = InvalidKeyFrame;
-	if (node.keyFrames().size() == 1) {
-		const SceneGraphKeyFrame *kf = node.keyFrame(0);
-		transform.matrix = parentTransform.matrix * kf->transform().localMatrix();
-	} else if (node.hasKeyFrameForFrame(frameIdx, &keyFrameIdx)) {
-		const SceneGraphKeyFrame *kf = node.keyFrame(keyFrameIdx);
-		transform.matrix = parentTransform.matrix * kf->transform().localMatrix();
-	} else {
-		const KeyFrameIndex start = node.previousKeyFrameForFrame(frameIdx);
-		const KeyFrameIndex end = node.nextKeyFrameForFrame(frameIdx);
-		if (start == end) {
-			const SceneGraphKeyFrame *kf = node.keyFrame(start);
-			transform.matrix = parentTransform.matrix * kf->transform().localMatrix();
+	transform.matrix = parentTransform.matrix * localMatrixForFrame(node, frameIdx);
+	return transform;
+}
+
+FrameTransformsPtr SceneGraph::evaluateTransforms(FrameIndex frameIdx) const {
+	core_trace_scoped(EvaluateTransforms);
+	if (_topologicalOrder.empty()) {
+		_topologicalOrder.reserve(_nodes.size());
+		for (const auto &entry : _nodes) {
+			if (entry->value.parent() == InvalidNodeId) {
+				_topologicalOrder.push_back(entry->key);
+			}
+		}
+		for (size_t i = 0; i < _topologicalOrder.size(); ++i) {
+			for (int childId : node(_topologicalOrder[i]).children()) {
+				_topologicalOrder.push_back(childId);
+			}
+		}
+	}
+
+	FrameTransform identity;
+	identity.matrix = glm::mat4(1.0f);
+	FrameTransformsPtr transforms = core::make_shared<FrameTransforms>();
+	FrameTransforms &t = *transforms.get();
+	t.resize(_nextNodeId);
+	t.fill(identity);
+	for (int nodeId : _topologicalOrder) {
+		const SceneGraphNode &n = node(nodeId);
+		const glm::mat4 &localMatrix = localMatrixForFrame(n, frameIdx);
+		if (n.parent() == InvalidNodeId) {
+			t[nodeId].matrix = localMatrix;
 		} else {
-			const SceneGraphKeyFrame *source = node.keyFrame(start);
-			const SceneGraphKeyFrame *target = node.keyFrame(end);
-			core_assert_always(source && target);
-			const InterpolationType interpolationType = source->interpolation;
-			const double deltaFrame = scenegraph::interpolate(interpolationType, (double)frameIdx, (double)source->frameIdx, (double)target->frameIdx);
-			const float lerpFactor = glm::clamp((float)(deltaFrame - (double)source->frameIdx), 0.0f, 1.0f);
-
-			const glm::vec3 translation = glm::mix(source->transform().localTranslation(), target->transform().localTranslation(), lerpFactor);
-			const glm::quat orientation = glm::slerp(source->transform().localOrientation(), target->transform().localOrientation(), lerpFactor);
-			const glm::vec3 scale = glm::mix(source->transform().localScale(), target->transform().localScale(), lerpFactor);
-			transform.matrix = parentTransform.matrix * (glm::translate(translation) * glm::mat4_cast(orientation) * glm::scale(scale));
+			t[nodeId].matrix = t[n.parent()].matrix * localMatrix;
 		}
 	}
-	return transform;
+	return transforms;
+}
+
+FrameTransformsPtr SceneGraph::transformsForFrame(FrameIndex frameIdx) const {
+	core::ScopedLock lock(_transformCacheLock);
+	for (const TransformCacheEntry &entry : _transformCache) {
+		if (entry.frameIdx == frameIdx && entry.animation == _activeAnimation) {
+			return entry.transforms;
+		}
+	}
+	TransformCacheEntry entry;
+	entry.animation = _activeAnimation;
+	entry.frameIdx = frameIdx;
+	entry.transforms = evaluateTransforms(frameIdx);
+	if (_transformCache.size() < MaxTransformCacheEntries) {
+		_transformCache.push_back(entry);
+	} else {
+		_transformCache[_transformCacheNext] = entry;
+		_transformCacheNext = (_transformCacheNext + 1) % MaxTransformCacheEntries;
+	}
+	return entry.transforms;
+}
+
+void SceneGraph::markTransformsDirty() const {
+	core::ScopedLock lock(_transformCacheLock);
+	_transformCache.clear();
+	_transformCacheNext = 0u;
+	_topologicalOrder.clear();
 }
 
 void SceneGraph::updateTransforms_r(SceneGraphNode &n) {
@@ -451,6 +527,7 @@ void SceneGraph::updateTransforms() {
 		updateTransforms_r(node(0));
 	}
 	core_assert_always(setAnimation(animId));
+	markTransformsDirty();
 }
 
 voxel::Region SceneGraph::calcRegion() const {
@@ -674,6 +751,7 @@ bool SceneGraph::changeParent(int nodeId, int newParentId, bool updateTransform)
 		return false;
 	}
 	n.setParent(newParentId);
+	markTransformsDirty();
 	if (updateTransform) {
 		for (const core::String &animation : animations()) {
 			for (SceneGraphKeyFrame &keyframe : n.keyFrames(animation)) {
@@ -726,6 +804,7 @@ bool SceneGraph::removeNode(int nodeId, bool recursive) {
 		listener->onNodeRemove(nodeId);
 	}
 	core_assert_always(_nodes.erase(iter));
+	markTransformsDirty();
 	if (_activeNodeId == nodeId) {
 		if (!empty(SceneGraphNodeType::Model)) {
 			// get the first model node
@@ -750,6 +829,7 @@ void SceneGraph::setAllKeyFramesForNode(SceneGraphNode &node, const SceneGraphKe
 			}
 		}
 	});
+	markTransformsDirty();
 }
 
 void SceneGraph::reserve(size_t size) {
@@ -797,6 +877,7 @@ void SceneGraph::clear() {
 	node.setParent(InvalidNodeId);
 	_nodes.emplace(0, core::move(node));
 	_region = voxel::Region::InvalidRegion;
+	markTransformsDirty();
 }
 
 bool SceneGraph::hasMoreThanOnePalette() const {
@@ -960,19 +1041,24 @@ SceneGraph::MergeResult SceneGraph::merge(bool skipHidden) const {
 		if (skipHidden && !node.visible()) {
 			continue;
 		}
-		const voxel::Region &sourceRegion = resolveRegion(node);
-		const voxel::Region &destRegion = sceneRegion(node, keyFrameIdx);
+		const voxel::RawVolume *v = resolveVolume(node);
+		// only the solid part of the volume is merged
+		voxel::Region sourceRegion = v->solidRegion();
+		if (!sourceRegion.isValid()) {
+			continue;
+		}
+		voxel::Region destRegion = sceneRegion(node, keyFrameIdx);
+		destRegion.shift(sourceRegion.getLowerCorner() - resolveRegion(node).getLowerCorner());
 
-		auto func = [&node, &mergedPalette](voxel::Voxel &voxel) {
+		const palette::PaletteRemap remap(node.palette(), mergedPalette);
+		auto func = [&remap](voxel::Voxel &voxel) {
 			if (isAir(voxel.getMaterial())) {
 				return false;
 			}
-			const core::RGBA color = node.palette().color(voxel.getColor());
-			const uint8_t index = mergedPalette.getClosestMatch(color);
+			const uint8_t index = remap.remap(voxel.getColor());
 			voxel.setColor(index);
 			return true;
 		};
-		const voxel::RawVolume *v = resolveVolume(node);
 		// TODO: SCENEGRAPH: rotation
 		voxelutil::mergeVolumes(merged, v, destRegion, sourceRegion, func);
 	}
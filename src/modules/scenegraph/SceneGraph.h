@@ -11,7 +11,10 @@
 #include "SceneGraphNode.h"
 #include "FrameTransform.h"
 #include "core/DirtyState.h"
+#include "core/SharedPtr.h"
+#include "core/Trace.h"
 #include "core/collection/DynamicArray.h"
+#include "core/concurrent/Lock.h"
 #include "math/AABB.h"
 #include "palette/NormalPalette.h"
 #include "palette/Palette.h"
@@ -27,6 +30,12 @@ namespace scenegraph {
 
 using SceneGraphAnimationIds = core::DynamicArray<core::String>;
 using SceneGraphNodes = core::Map<int, SceneGraphNode, 251>;
+/**
+ * @brief The world transforms of all nodes for one frame - indexed by the node id
+ * @sa SceneGraph::transformsForFrame()
+ */
+using FrameTransforms = core::DynamicArray<FrameTransform>;
+using FrameTransformsPtr = core::SharedPtr<FrameTransforms>;
 
 /**
  * @brief The internal format for the save/load methods.
@@ -47,7 +56,21 @@ protected:
 	const core::String _emptyUUID;
 	core::DynamicArray<SceneGraphListener*> _listeners;
 
+	struct TransformCacheEntry {
+		core::String animation;
+		FrameIndex frameIdx = 0;
+		FrameTransformsPtr transforms;
+	};
+	static constexpr size_t MaxTransformCacheEntries = 64;
+	// the evaluated world transforms of the recently requested frames
+	mutable core::DynamicArray<TransformCacheEntry> _transformCache;
+	mutable size_t _transformCacheNext = 0u;
+	// all node ids - parents are always before their children
+	mutable core::DynamicArray<int> _topologicalOrder;
+	mutable core_trace_mutex(core::Lock, _transformCacheLock, "SceneGraphTransformCache");
+
 	void updateTransforms_r(SceneGraphNode &node);
+	FrameTransformsPtr evaluateTransforms(FrameIndex frameIdx) const;
 	voxel::Region calcRegion() const;
 
 public:
@@ -134,9 +157,25 @@ public:
 	 * @brief Interpolates the transforms for the given frame. It searches the keyframe before and after
 	 * the given input frame and interpolates according to the given delta frames between the particular
 	 * keyframes.
+	 * @note The transforms of all nodes for the frame are evaluated once and cached - see @c transformsForFrame()
 	 */
 	FrameTransform transformForFrame(const SceneGraphNode &node, FrameIndex frameIdx) const;
 	FrameTransform transformForFrame(const SceneGraphNode &node, const core::String &animation, FrameIndex frameIdx) const;
+	/**
+	 * @brief Evaluates the world transforms of all nodes for the given frame of the active animation
+	 * @return The transforms indexed by node id. The entries of the ids that are not part of the scene graph are
+	 * the identity. The result stays valid even if the cache is invalidated.
+	 * @note The result is cached per animation and frame until @c markTransformsDirty() is called. This happens
+	 * automatically when nodes are added, removed or moved to a different parent, when @c markMaxFramesDirty() is
+	 * called and when a @c SceneGraphTransform is updated.
+	 */
+	FrameTransformsPtr transformsForFrame(FrameIndex frameIdx) const;
+	/**
+	 * @brief Drop the cached world transforms of @c transformsForFrame()
+	 * @note Must be called if key frames are modified without calling @c SceneGraphTransform::update() or
+	 * @c markMaxFramesDirty() afterwards.
+	 */
+	void markTransformsDirty() const;
 
 	/**
 	 * Calculate the region for the whole scene having the transform for the given frame applied
@@ -264,6 +264,7 @@ void SceneGraphTransform::update(const SceneGraph &sceneGraph, SceneGraphNode &n
 		Log::warn("Node not yet part of the scene graph - don't perform any update");
 		return;
 	}
+	sceneGraph.markTransformsDirty();
 
 	if (_dirty & DIRTY_WORLDVALUES) {
 		core_assert_msg((_dirty & DIRTY_LOCALVALUES) == 0u, "local and world were modified");
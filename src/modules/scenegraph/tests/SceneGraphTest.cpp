@@ -614,6 +614,52 @@ TEST_F(SceneGraphTest, testKeyFrameTransformParentRotation2) {
 	}
 }
 
+TEST_F(SceneGraphTest, testTransformsForFrame) {
+	SceneGraph sceneGraph;
+	voxel::RawVolume v(voxel::Region(0, 0));
+	int parentNodeId;
+	int childNodeId;
+	{
+		SceneGraphNode node(SceneGraphNodeType::Model);
+		node.setVolume(&v, false);
+		node.setName("Parent");
+		node.keyFrame(0).transform().setWorldTranslation(glm::vec3(0.0f));
+		const KeyFrameIndex keyFrameIdx = node.addKeyFrame(10);
+		node.keyFrame(keyFrameIdx).transform().setWorldTranslation(glm::vec3(10.0f, 0.0f, 0.0f));
+		parentNodeId = sceneGraph.emplace(core::move(node));
+	}
+	{
+		SceneGraphNode node(SceneGraphNodeType::Model);
+		node.setVolume(&v, false);
+		node.setName("Child");
+		node.keyFrame(0).transform().setWorldTranslation(glm::vec3(0.0f, 5.0f, 0.0f));
+		childNodeId = sceneGraph.emplace(core::move(node), parentNodeId);
+	}
+	sceneGraph.updateTransforms();
+
+	const FrameTransformsPtr &transforms = sceneGraph.transformsForFrame(5);
+	ASSERT_EQ((size_t)(childNodeId + 1), transforms->size());
+	EXPECT_VEC_NEAR(glm::vec3(5.0f, 0.0f, 0.0f), (*transforms.get())[parentNodeId].translation(), 0.0001f);
+	EXPECT_VEC_NEAR(glm::vec3(5.0f, 5.0f, 0.0f), (*transforms.get())[childNodeId].translation(), 0.0001f);
+	EXPECT_EQ(transforms.get(), sceneGraph.transformsForFrame(5).get()) << "Expected the cached transforms";
+	const FrameTransform &childTransform = sceneGraph.transformForFrame(sceneGraph.node(childNodeId), 5);
+	EXPECT_VEC_NEAR((*transforms.get())[childNodeId].translation(), childTransform.translation(), 0.0001f);
+
+	SceneGraphNode &parentNode = sceneGraph.node(parentNodeId);
+	SceneGraphKeyFrame &keyFrame = parentNode.keyFrame(parentNode.keyFrameForFrame(10));
+	keyFrame.transform().setWorldTranslation(glm::vec3(20.0f, 0.0f, 0.0f));
+	keyFrame.transform().update(sceneGraph, parentNode, keyFrame.frameIdx, true);
+	const FrameTransformsPtr &updated = sceneGraph.transformsForFrame(5);
+	EXPECT_NE(transforms.get(), updated.get()) << "The update of the transform should invalidate the cache";
+	EXPECT_VEC_NEAR(glm::vec3(10.0f, 5.0f, 0.0f), (*updated.get())[childNodeId].translation(), 0.0001f);
+	EXPECT_VEC_NEAR(glm::vec3(5.0f, 5.0f, 0.0f), (*transforms.get())[childNodeId].translation(), 0.0001f)
+		<< "The previous result must stay untouched";
+
+	ASSERT_TRUE(sceneGraph.changeParent(childNodeId, sceneGraph.root().id(), false));
+	const FrameTransformsPtr &reparented = sceneGraph.transformsForFrame(5);
+	EXPECT_VEC_NEAR(glm::vec3(0.0f, 5.0f, 0.0f), (*reparented.get())[childNodeId].translation(), 0.0001f);
+}
+
 TEST_F(SceneGraphTest, testSceneRegion) {
 	SceneGraph sceneGraph;
 	voxel::RawVolume v(voxel::Region(-3, 3));
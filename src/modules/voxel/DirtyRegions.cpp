@@ -0,0 +1,151 @@
+/**
+ * @file
+ */
+
+#include "DirtyRegions.h"
+#include "core/Algorithm.h"
+
+namespace voxel {
+
+void DirtyRegions::compact(core::DynamicArray<glm::ivec3> &cells) {
+	core::sort(cells.begin(), cells.end(), [](const glm::ivec3 &a, const glm::ivec3 &b) {
+		if (a.z != b.z) {
+			return a.z < b.z;
+		}
+		if (a.y != b.y) {
+			return a.y < b.y;
+		}
+		return a.x < b.x;
+	});
+	size_t unique = 0;
+	const size_t n = cells.size();
+	for (size_t i = 0; i < n; ++i) {
+		if (unique > 0 && cells[unique - 1] == cells[i]) {
+			continue;
+		}
+		cells[unique++] = cells[i];
+	}
+	cells.erase(unique, n - unique);
+}
+
+void DirtyRegions::setOverflow() {
+	_overflow = true;
+	_cells.release();
+}
+
+void DirtyRegions::addCell(const glm::ivec3 &c) {
+	if (_overflow) {
+		return;
+	}
+	if (_hasLastCell && _lastCell == c) {
+		return;
+	}
+	_lastCell = c;
+	_hasLastCell = true;
+	_cells.push_back(c);
+	if (_cells.size() > 2 * MaxCells) {
+		compact(_cells);
+		if (_cells.size() > MaxCells) {
+			setOverflow();
+		}
+	}
+}
+
+void DirtyRegions::add(const glm::ivec3 &pos) {
+	if (_bounds.isValid()) {
+		_bounds.accumulate(pos);
+	} else {
+		_bounds = Region(pos, pos);
+	}
+	addCell(cell(pos));
+}
+
+void DirtyRegions::add(const Region &region) {
+	if (!region.isValid()) {
+		return;
+	}
+	if (_bounds.isValid()) {
+		_bounds.accumulate(region);
+	} else {
+		_bounds = region;
+	}
+	if (_overflow) {
+		return;
+	}
+	const glm::ivec3 &mins = cell(region.getLowerCorner());
+	const glm::ivec3 &maxs = cell(region.getUpperCorner());
+	const glm::i64vec3 cells = glm::i64vec3(maxs - mins) + (int64_t)1;
+	if (cells.x * cells.y * cells.z > MaxCells) {
+		setOverflow();
+		return;
+	}
+	for (int z = mins.z; z <= maxs.z && !_overflow; ++z) {
+		for (int y = mins.y; y <= maxs.y && !_overflow; ++y) {
+			for (int x = mins.x; x <= maxs.x && !_overflow; ++x) {
+				addCell(glm::ivec3(x, y, z));
+			}
+		}
+	}
+}
+
+void DirtyRegions::add(const DirtyRegions &other) {
+	if (other.empty()) {
+		return;
+	}
+	if (_bounds.isValid()) {
+		_bounds.accumulate(other._bounds);
+	} else {
+		_bounds = other._bounds;
+	}
+	if (other._overflow) {
+		setOverflow();
+		return;
+	}
+	for (const glm::ivec3 &c : other._cells) {
+		addCell(c);
+	}
+}
+
+void DirtyRegions::clear() {
+	_cells.clear();
+	_bounds = Region::InvalidRegion;
+	_hasLastCell = false;
+	_overflow = false;
+}
+
+core::DynamicArray<Region> DirtyRegions::regions() const {
+	core::DynamicArray<Region> regions;
+	if (empty()) {
+		return regions;
+	}
+	if (_overflow) {
+		regions.push_back(_bounds);
+		return regions;
+	}
+	core::DynamicArray<glm::ivec3> cells(_cells);
+	compact(cells);
+	if (cells.size() > MaxCells) {
+		regions.push_back(_bounds);
+		return regions;
+	}
+
+	// merge the runs of neighbouring cells along the x axis
+	const size_t n = cells.size();
+	for (size_t i = 0; i < n;) {
+		const glm::ivec3 &first = cells[i];
+		size_t end = i + 1;
+		while (end < n && cells[end].z == first.z && cells[end].y == first.y &&
+			   cells[end].x == cells[end - 1].x + 1) {
+			++end;
+		}
+		const glm::ivec3 &last = cells[end - 1];
+		Region region(first * CellSize, (last + 1) * CellSize - 1);
+		if (region.cropTo(_bounds)) {
+			regions.push_back(region);
+		}
+		i = end;
+	}
+	return regions;
+}
+
+} // namespace voxel
@@ -0,0 +1,79 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/GLM.h"
+#include "core/collection/DynamicArray.h"
+#include "voxel/Region.h"
+
+namespace voxel {
+
+/**
+ * @brief Sparse set of modified voxel positions
+ *
+ * Instead of accumulating every modification into one axis aligned bounding box, the positions are tracked in cells
+ * of 16x16x16 voxels. Two edits in opposite corners of a volume only produce two small regions - not one region that
+ * spans the whole volume. The bounding box of all modifications is still available via @c bounds().
+ *
+ * The cells are appended to a plain array (consecutive modifications in the same cell are only recorded once) and
+ * the array is compacted from time to time. This keeps the wrapper construction cheap - there is no hash map that
+ * must be allocated up front. If too many cells get modified, the tracking falls back to the bounding box only.
+ */
+class DirtyRegions {
+public:
+	static constexpr int CellBits = 4;
+	static constexpr int CellSize = 1 << CellBits;
+	static constexpr int MaxCells = 4096;
+
+private:
+	core::DynamicArray<glm::ivec3> _cells;
+	Region _bounds = Region::InvalidRegion;
+	glm::ivec3 _lastCell{0};
+	bool _hasLastCell = false;
+	bool _overflow = false;
+
+	static inline glm::ivec3 cell(const glm::ivec3 &pos) {
+		return pos >> CellBits;
+	}
+
+	void addCell(const glm::ivec3 &c);
+	void setOverflow();
+	/**
+	 * @brief Sort the cells and remove the duplicates
+	 */
+	static void compact(core::DynamicArray<glm::ivec3> &cells);
+
+public:
+	void add(const glm::ivec3 &pos);
+	void add(const Region &region);
+	void add(const DirtyRegions &other);
+	void clear();
+
+	inline bool empty() const {
+		return !_bounds.isValid();
+	}
+
+	/**
+	 * @return The bounding box of all modifications or @c Region::InvalidRegion if nothing was modified
+	 */
+	inline const Region &bounds() const {
+		return _bounds;
+	}
+
+	/**
+	 * @return @c true if the cell tracking was given up in favour of the bounding box
+	 */
+	inline bool overflow() const {
+		return _overflow;
+	}
+
+	/**
+	 * @return Disjoint regions that cover all modifications - neighbouring cells along the x axis are merged. The
+	 * regions are cropped to the bounds.
+	 */
+	core::DynamicArray<Region> regions() const;
+};
+
+} // namespace voxel
@@ -8,6 +8,7 @@
 #include "palette/NormalPalette.h"
 #include "voxel/MaterialColor.h"
 #include "voxel/Mesh.h"
+#include "voxel/RawVolumeSnapshot.h"
 #include "voxel/SurfaceExtractor.h"
 
 namespace voxel {
@@ -213,27 +214,43 @@ bool MeshState::runScheduledExtractions(size_t maxExtraction) {
 			continue;
 		}
 		const voxel::Region &finalRegion = extractRegion.region;
-		bool onlyAir = true;
 		const voxel::Region copyRegion(finalRegion.getLowerCorner() - 2, finalRegion.getUpperCorner() + 2);
 		if (!copyRegion.isValid()) {
 			continue;
 		}
-		voxel::RawVolume copy(v, copyRegion, &onlyAir);
 		const glm::ivec3 &mins = finalRegion.getLowerCorner();
-		if (!onlyAir) {
+		// the occupancy summary of the volume answers this without copying the voxels
+		if (isAir(v->borderValue().getMaterial()) && v->isEmpty(copyRegion)) {
+			_pendingQueue.emplace(mins, idx, core::move(voxel::ChunkMesh(0, 0)));
+		} else if (voxel::intersects(v->region(), copyRegion)) {
+			// the voxels are copied in the worker - or by the volume itself if it gets modified before that happens
+			core::SharedPtr<voxel::RawVolumeSnapshot> snapshot = core::make_shared<voxel::RawVolumeSnapshot>(v, copyRegion);
 			const palette::Palette &pal = palette(resolveIdx(idx));
+			// visible volumes are extracted first
+			const core::TaskPriority priority = hidden(idx) ? core::TaskPriority::Low : core::TaskPriority::High;
 			++_pendingExtractorTasks;
-			_threadPool.enqueue([type, movedPal = core::move(pal), movedCopy = core::move(copy), mins, idx,
-								 finalRegion, this]() {
+			const core::CancellationTokenPtr &token = _cancelToken;
+			_threadPool.schedule([type, movedPal = core::move(pal), snapshot, mins, idx, finalRegion, token, this]() {
 				++_runningExtractorTasks;
-				voxel::ChunkMesh mesh(65536, 65536, true);
-				voxel::SurfaceExtractionContext ctx = voxel::createContext(type, &movedCopy, finalRegion, movedPal, mesh, mins);
-				voxel::extractSurface(ctx);
-				_pendingQueue.emplace(mins, idx, core::move(mesh));
+				if (token->cancelled()) {
+					--_runningExtractorTasks;
+					return;
+				}
+				bool onlyAir = true;
+				const voxel::RawVolume *copy = snapshot->materialize(&onlyAir);
+				if (onlyAir) {
+					_pendingQueue.emplace(mins, idx, core::move(voxel::ChunkMesh(0, 0)));
+				} else {
+					voxel::ChunkMesh mesh(65536, 65536, true);
+					voxel::SurfaceExtractionContext ctx =
+						voxel::createContext(type, copy, finalRegion, movedPal, mesh, mins);
+					voxel::extractSurface(ctx);
+					_pendingQueue.emplace(mins, idx, core::move(mesh));
+				}
 				Log::debug("Enqueue mesh for idx: %i (%i:%i:%i)", idx, mins.x, mins.y, mins.z);
 				--_runningExtractorTasks;
 				--_pendingExtractorTasks;
-			});
+			}, priority, token);
 		} else {
 			_pendingQueue.emplace(mins, idx, core::move(voxel::ChunkMesh(0, 0)));
 		}
@@ -319,7 +336,8 @@ void MeshState::waitForPendingExtractions() {
 }
 
 void MeshState::clearPendingExtractions() {
-	_threadPool.abort();
+	_cancelToken->cancel();
+	_cancelToken = core::make_shared<core::CancellationToken>();
 	while (_runningExtractorTasks > 0) {
 		app::App::getInstance()->wait(1);
 	}
@@ -104,6 +104,8 @@ private:
 	core::AtomicInt _pendingExtractorTasks{0};
 	voxel::Region calculateExtractRegion(int x, int y, int z, const glm::ivec3 &meshSize) const;
 	core::ThreadPool _threadPool{core::halfcpus(), "VolumeRndr"};
+	// cancels the queued extractions on clearPendingExtractions()
+	core::CancellationTokenPtr _cancelToken = core::make_shared<core::CancellationToken>();
 	core::ConcurrentPriorityQueue<MeshState::ExtractionCtx> _pendingQueue;
 	core::VarPtr _meshMode;
 	bool deleteMeshes(const glm::ivec3 &pos, int idx);
@@ -0,0 +1,474 @@
+/**
+ * @file
+ */
+
+#include "PagedVolume.h"
+#include "core/Assert.h"
+#include "core/Log.h"
+#include "core/StandardLib.h"
+#include "core/collection/DynamicArray.h"
+#include "io/BufferedReadWriteStream.h"
+#include "io/MemoryReadStream.h"
+#include "io/ZipReadStream.h"
+#include "io/ZipWriteStream.h"
+
+namespace voxel {
+
+static inline bool isSameVoxel(const Voxel &a, const Voxel &b) {
+	return a.isSame(b) && a.getFlags() == b.getFlags();
+}
+
+PagedVolume::Chunk::~Chunk() {
+	core_free(_voxels);
+	core_free(_compressed);
+}
+
+void PagedVolume::Chunk::setVoxel(int index, const Voxel &voxel) {
+	core_assert(!isCompressed());
+	_accessed = true;
+	if (_voxels == nullptr) {
+		if (isSameVoxel(_uniform, voxel)) {
+			return;
+		}
+		_voxels = (Voxel *)core_malloc(ChunkVoxels * sizeof(Voxel));
+		for (int i = 0; i < ChunkVoxels; ++i) {
+			_voxels[i] = _uniform;
+		}
+	}
+	_voxels[index] = voxel;
+}
+
+void PagedVolume::Chunk::decompress() {
+	if (!isCompressed()) {
+		return;
+	}
+	const size_t uncompressedSize = ChunkVoxels * sizeof(Voxel);
+	Voxel *voxels = (Voxel *)core_malloc(uncompressedSize);
+	io::MemoryReadStream dataStream(_compressed, _compressedSize);
+	io::ZipReadStream stream(dataStream, (int)dataStream.size());
+	if (stream.read(voxels, uncompressedSize) == -1) {
+		Log::error("Failed to decompress volume chunk");
+		for (int i = 0; i < ChunkVoxels; ++i) {
+			voxels[i] = _uniform;
+		}
+	}
+	core_free(_compressed);
+	_compressed = nullptr;
+	_compressedSize = 0u;
+	_voxels = voxels;
+	_accessed = true;
+	_isCompressed = false;
+}
+
+bool PagedVolume::Chunk::optimize() {
+	if (isCompressed()) {
+		return false;
+	}
+	if (_voxels == nullptr) {
+		return true;
+	}
+	const Voxel first = _voxels[0];
+	for (int i = 1; i < ChunkVoxels; ++i) {
+		if (!isSameVoxel(first, _voxels[i])) {
+			return false;
+		}
+	}
+	_uniform = first;
+	core_free(_voxels);
+	_voxels = nullptr;
+	return true;
+}
+
+bool PagedVolume::Chunk::compress() {
+	if (_voxels == nullptr) {
+		return false;
+	}
+	if (_accessed) {
+		// give the chunk another round - it's still in use
+		_accessed = false;
+		return false;
+	}
+	const size_t uncompressedSize = ChunkVoxels * sizeof(Voxel);
+	io::BufferedReadWriteStream outStream(uncompressedSize / 4);
+	{
+		io::ZipWriteStream stream(outStream);
+		if (stream.write(_voxels, uncompressedSize) == -1) {
+			return false;
+		}
+		stream.flush();
+	}
+	_compressedSize = (size_t)outStream.size();
+	_compressed = (uint8_t *)core_realloc(outStream.release(), _compressedSize);
+	core_free(_voxels);
+	_voxels = nullptr;
+	_isCompressed = true;
+	return true;
+}
+
+size_t PagedVolume::Chunk::memory() const {
+	if (isCompressed()) {
+		return _compressedSize;
+	}
+	if (_voxels != nullptr) {
+		return ChunkVoxels * sizeof(Voxel);
+	}
+	return 0u;
+}
+
+PagedVolume::PagedVolume(const voxel::Region &region) : _region(region), _isRegionValid(_region.isValid()) {
+}
+
+PagedVolume::~PagedVolume() {
+	clear();
+}
+
+PagedVolume::Chunk *PagedVolume::chunk(const glm::ivec3 &chunkPos) const {
+	auto iter = _chunks.find(chunkPos);
+	if (iter == _chunks.end()) {
+		return nullptr;
+	}
+	Chunk *chunk = iter->second;
+	if (chunk->isCompressed()) {
+		core::ScopedLock lock(_lock);
+		chunk->decompress();
+	}
+	return chunk;
+}
+
+bool PagedVolume::setVoxel(const glm::ivec3 &pos, const voxel::Voxel &voxel) {
+	if (_isRegionValid && !_region.containsPoint(pos)) {
+		return false;
+	}
+	const glm::ivec3 &cpos = chunkPos(pos);
+	Chunk *c = chunk(cpos);
+	if (c == nullptr) {
+		if (isAir(voxel.getMaterial())) {
+			return true;
+		}
+		c = new Chunk(_emptyVoxel);
+		_chunks.put(cpos, c);
+	}
+	c->setVoxel(chunkIndex(pos), voxel);
+	return true;
+}
+
+const Voxel &PagedVolume::voxel(const glm::ivec3 &pos) const {
+	if (const Chunk *c = chunk(chunkPos(pos))) {
+		return c->voxel(chunkIndex(pos));
+	}
+	return _emptyVoxel;
+}
+
+void PagedVolume::clear() {
+	for (auto *e : _chunks) {
+		delete e->value;
+	}
+	_chunks.clear();
+}
+
+void PagedVolume::optimize() {
+	core::DynamicArray<glm::ivec3> airChunks;
+	for (auto *e : _chunks) {
+		Chunk *c = e->value;
+		if (c->optimize() && isAir(c->uniform().getMaterial())) {
+			airChunks.push_back(e->key);
+		}
+	}
+	for (const glm::ivec3 &cpos : airChunks) {
+		auto iter = _chunks.find(cpos);
+		delete iter->second;
+		_chunks.remove(cpos);
+	}
+}
+
+int PagedVolume::compress() {
+	int compressed = 0;
+	for (auto *e : _chunks) {
+		if (e->value->compress()) {
+			++compressed;
+		}
+	}
+	Log::debug("Compressed %i of %i volume chunks", compressed, (int)_chunks.size());
+	return compressed;
+}
+
+size_t PagedVolume::memory() const {
+	size_t bytes = 0u;
+	for (auto *e : _chunks) {
+		bytes += sizeof(Chunk) + e->value->memory();
+	}
+	return bytes;
+}
+
+Region PagedVolume::chunkRegion() const {
+	if (_chunks.empty()) {
+		return Region::InvalidRegion;
+	}
+	Region region = Region::InvalidRegion;
+	for (auto *e : _chunks) {
+		const glm::ivec3 mins = e->key * ChunkSideLength;
+		const Region chunkRegion(mins, mins + ChunkMask);
+		if (region.isValid()) {
+			region.accumulate(chunkRegion);
+		} else {
+			region = chunkRegion;
+		}
+	}
+	return region;
+}
+
+Region PagedVolume::calculateRegion() const {
+	Region region = Region::InvalidRegion;
+	for (auto *e : _chunks) {
+		const glm::ivec3 mins = e->key * ChunkSideLength;
+		const Chunk *c = chunk(e->key);
+		Region voxelRegion = Region::InvalidRegion;
+		if (c->isUniform()) {
+			if (isAir(c->uniform().getMaterial())) {
+				continue;
+			}
+			voxelRegion = Region(mins, mins + ChunkMask);
+		} else {
+			int index = 0;
+			for (int z = 0; z < ChunkSideLength; ++z) {
+				for (int y = 0; y < ChunkSideLength; ++y) {
+					for (int x = 0; x < ChunkSideLength; ++x, ++index) {
+						if (isAir(c->voxel(index).getMaterial())) {
+							continue;
+						}
+						const glm::ivec3 pos(mins.x + x, mins.y + y, mins.z + z);
+						if (voxelRegion.isValid()) {
+							voxelRegion.accumulate(pos);
+						} else {
+							voxelRegion = Region(pos, pos);
+						}
+					}
+				}
+			}
+			if (!voxelRegion.isValid()) {
+				continue;
+			}
+		}
+		if (region.isValid()) {
+			region.accumulate(voxelRegion);
+		} else {
+			region = voxelRegion;
+		}
+	}
+	return region;
+}
+
+PagedVolume::Sampler::Sampler(const PagedVolume *volume) : _volume(const_cast<PagedVolume *>(volume)) {
+}
+
+PagedVolume::Sampler::Sampler(const PagedVolume &volume) : _volume(const_cast<PagedVolume *>(&volume)) {
+}
+
+PagedVolume::Sampler::~Sampler() {
+}
+
+void PagedVolume::Sampler::updateVoxel() {
+	const glm::ivec3 &cpos = chunkPos(_posInVolume);
+	if (_chunk != nullptr && cpos == _chunkPos) {
+		return;
+	}
+	_chunkPos = cpos;
+	_chunk = _volume->chunk(cpos);
+}
+
+bool PagedVolume::Sampler::setVoxel(const Voxel &voxel) {
+	if (_currentPositionInvalid) {
+		return false;
+	}
+	_volume->setVoxel(_posInVolume, voxel);
+	// the chunk might have been created
+	updateVoxel();
+	return true;
+}
+
+bool PagedVolume::Sampler::setPosition(int32_t xPos, int32_t yPos, int32_t zPos) {
+	_posInVolume.x = xPos;
+	_posInVolume.y = yPos;
+	_posInVolume.z = zPos;
+
+	const voxel::Region &region = this->region();
+	_currentPositionInvalid = 0u;
+	if (region.isValid()) {
+		if (!region.containsPointInX(xPos)) {
+			_currentPositionInvalid |= SAMPLER_INVALIDX;
+		}
+		if (!region.containsPointInY(yPos)) {
+			_currentPositionInvalid |= SAMPLER_INVALIDY;
+		}
+		if (!region.containsPointInZ(zPos)) {
+			_currentPositionInvalid |= SAMPLER_INVALIDZ;
+		}
+	}
+
+	// Then we update the chunk pointer
+	if (currentPositionValid()) {
+		updateVoxel();
+		return true;
+	}
+	return false;
+}
+
+void PagedVolume::Sampler::movePositive(math::Axis axis, uint32_t offset) {
+	switch (axis) {
+	case math::Axis::X:
+		movePositiveX(offset);
+		break;
+	case math::Axis::Y:
+		movePositiveY(offset);
+		break;
+	case math::Axis::Z:
+		movePositiveZ(offset);
+		break;
+	default:
+		break;
+	}
+}
+
+void PagedVolume::Sampler::movePositiveX(uint32_t offset) {
+	const bool bIsOldPositionValid = currentPositionValid();
+
+	_posInVolume.x += (int)offset;
+
+	if (region().isValid()) {
+		if (!region().containsPointInX(_posInVolume.x)) {
+			_currentPositionInvalid |= SAMPLER_INVALIDX;
+		} else {
+			_currentPositionInvalid &= ~SAMPLER_INVALIDX;
+		}
+	}
+
+	// Then we update the chunk pointer
+	if (!bIsOldPositionValid) {
+		setPosition(_posInVolume);
+	} else if (currentPositionValid()) {
+		updateVoxel();
+	}
+}
+
+void PagedVolume::Sampler::movePositiveY(uint32_t offset) {
+	const bool bIsOldPositionValid = currentPositionValid();
+
+	_posInVolume.y += (int)offset;
+
+	if (region().isValid()) {
+		if (!region().containsPointInY(_posInVolume.y)) {
+			_currentPositionInvalid |= SAMPLER_INVALIDY;
+		} else {
+			_currentPositionInvalid &= ~SAMPLER_INVALIDY;
+		}
+	}
+
+	// Then we update the chunk pointer
+	if (!bIsOldPositionValid) {
+		setPosition(_posInVolume);
+	} else if (currentPositionValid()) {
+		updateVoxel();
+	}
+}
+
+void PagedVolume::Sampler::movePositiveZ(uint32_t offset) {
+	const bool bIsOldPositionValid = currentPositionValid();
+
+	_posInVolume.z += (int)offset;
+
+	if (region().isValid()) {
+		if (!region().containsPointInZ(_posInVolume.z)) {
+			_currentPositionInvalid |= SAMPLER_INVALIDZ;
+		} else {
+			_currentPositionInvalid &= ~SAMPLER_INVALIDZ;
+		}
+	}
+
+	// Then we update the chunk pointer
+	if (!bIsOldPositionValid) {
+		setPosition(_posInVolume);
+	} else if (currentPositionValid()) {
+		updateVoxel();
+	}
+}
+
+void PagedVolume::Sampler::moveNegative(math::Axis axis, uint32_t offset) {
+	switch (axis) {
+	case math::Axis::X:
+		moveNegativeX(offset);
+		break;
+	case math::Axis::Y:
+		moveNegativeY(offset);
+		break;
+	case math::Axis::Z:
+		moveNegativeZ(offset);
+		break;
+	default:
+		break;
+	}
+}
+
+void PagedVolume::Sampler::moveNegativeX(uint32_t offset) {
+	const bool bIsOldPositionValid = currentPositionValid();
+
+	_posInVolume.x -= (int)offset;
+
+	if (region().isValid()) {
+		if (!region().containsPointInX(_posInVolume.x)) {
+			_currentPositionInvalid |= SAMPLER_INVALIDX;
+		} else {
+			_currentPositionInvalid &= ~SAMPLER_INVALIDX;
+		}
+	}
+
+	// Then we update the chunk pointer
+	if (!bIsOldPositionValid) {
+		setPosition(_posInVolume);
+	} else if (currentPositionValid()) {
+		updateVoxel();
+	}
+}
+
+void PagedVolume::Sampler::moveNegativeY(uint32_t offset) {
+	const bool bIsOldPositionValid = currentPositionValid();
+
+	_posInVolume.y -= (int)offset;
+
+	if (region().isValid()) {
+		if (!region().containsPointInY(_posInVolume.y)) {
+			_currentPositionInvalid |= SAMPLER_INVALIDY;
+		} else {
+			_currentPositionInvalid &= ~SAMPLER_INVALIDY;
+		}
+	}
+
+	// Then we update the chunk pointer
+	if (!bIsOldPositionValid) {
+		setPosition(_posInVolume);
+	} else if (currentPositionValid()) {
+		updateVoxel();
+	}
+}
+
+void PagedVolume::Sampler::moveNegativeZ(uint32_t offset) {
+	const bool bIsOldPositionValid = currentPositionValid();
+
+	_posInVolume.z -= (int)offset;
+
+	if (region().isValid()) {
+		if (!region().containsPointInZ(_posInVolume.z)) {
+			_currentPositionInvalid |= SAMPLER_INVALIDZ;
+		} else {
+			_currentPositionInvalid &= ~SAMPLER_INVALIDZ;
+		}
+	}
+
+	// Then we update the chunk pointer
+	if (!bIsOldPositionValid) {
+		setPosition(_posInVolume);
+	} else if (currentPositionValid()) {
+		updateVoxel();
+	}
+}
+
+} // namespace voxel
@@ -0,0 +1,438 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "Region.h"
+#include "Voxel.h"
+#include "core/GLM.h"
+#include "core/Trace.h"
+#include "core/collection/DynamicMap.h"
+#include "core/concurrent/Atomic.h"
+#include "core/concurrent/Lock.h"
+#include "math/Axis.h"
+#include "voxelutil/VolumeVisitor.h"
+
+namespace voxel {
+
+/**
+ * Volume implementation which stores the voxels in chunks of @c ChunkSideLength^3 voxels. Chunks that only contain
+ * one voxel value are stored as this single value, chunks that only contain air are not stored at all. This is
+ * useful for large volumes where most of the voxels are empty.
+ *
+ * Chunks that were not modified or decompressed since the last call to @c compress() can get compressed in memory.
+ * They are decompressed on the next access.
+ */
+class PagedVolume {
+public:
+	static constexpr int ChunkSideLengthPower = 5;
+	static constexpr int ChunkSideLength = 1 << ChunkSideLengthPower;
+	static constexpr int ChunkMask = ChunkSideLength - 1;
+	static constexpr int ChunkVoxels = ChunkSideLength * ChunkSideLength * ChunkSideLength;
+
+private:
+	class Chunk {
+	private:
+		/** the value of all voxels if the chunk is neither dense nor compressed */
+		Voxel _uniform;
+		Voxel *_voxels = nullptr;
+		uint8_t *_compressed = nullptr;
+		size_t _compressedSize = 0u;
+		core::AtomicBool _isCompressed{false};
+		/** modified or decompressed since the last @c compress() call */
+		bool _accessed = true;
+
+	public:
+		Chunk(const Voxel &uniform) : _uniform(uniform) {
+		}
+		~Chunk();
+
+		inline bool isUniform() const {
+			return _voxels == nullptr && !isCompressed();
+		}
+		inline bool isCompressed() const {
+			return _isCompressed;
+		}
+		inline const Voxel &uniform() const {
+			return _uniform;
+		}
+		/**
+		 * @note The chunk must not be compressed
+		 */
+		inline const Voxel &voxel(int index) const {
+			if (_voxels != nullptr) {
+				return _voxels[index];
+			}
+			return _uniform;
+		}
+
+		void setVoxel(int index, const Voxel &voxel);
+		void decompress();
+		/**
+		 * @brief Converts the chunk into the uniform representation if all voxels are the same
+		 * @return @c true if the chunk is uniform
+		 */
+		bool optimize();
+		/**
+		 * @return @c true if the chunk was compressed
+		 */
+		bool compress();
+		size_t memory() const;
+	};
+
+	core::DynamicMap<glm::ivec3, Chunk *, 1031, glm::hash<glm::ivec3>> _chunks;
+	static const constexpr voxel::Voxel _emptyVoxel{VoxelType::Air, 0, 0, 0};
+	const voxel::Region _region;
+	const bool _isRegionValid;
+	/** guards the decompression of chunks in the const accessors */
+	core_trace_mutex(core::Lock, _lock, "PagedVolume");
+
+	static inline glm::ivec3 chunkPos(const glm::ivec3 &pos) {
+		return {pos.x >> ChunkSideLengthPower, pos.y >> ChunkSideLengthPower, pos.z >> ChunkSideLengthPower};
+	}
+	static inline int chunkIndex(const glm::ivec3 &pos) {
+		return (pos.x & ChunkMask) + (pos.y & ChunkMask) * ChunkSideLength +
+			   (pos.z & ChunkMask) * ChunkSideLength * ChunkSideLength;
+	}
+	/**
+	 * @return The decompressed chunk at the given chunk position or @c nullptr if there is no such chunk
+	 */
+	Chunk *chunk(const glm::ivec3 &chunkPos) const;
+
+public:
+	class Sampler {
+	private:
+		static const uint8_t SAMPLER_INVALIDX = 1 << 0;
+		static const uint8_t SAMPLER_INVALIDY = 1 << 1;
+		static const uint8_t SAMPLER_INVALIDZ = 1 << 2;
+
+		void updateVoxel();
+
+	public:
+		Sampler(const PagedVolume &volume);
+		Sampler(const PagedVolume *volume);
+		virtual ~Sampler();
+
+		const Voxel &voxel() const;
+		virtual const Region region() const;
+
+		bool currentPositionValid() const;
+
+		bool setPosition(const glm::ivec3 &pos);
+		bool setPosition(int32_t x, int32_t y, int32_t z);
+		virtual bool setVoxel(const Voxel &voxel);
+		const glm::ivec3 &position() const;
+
+		void movePositiveX(uint32_t offset = 1);
+		void movePositiveY(uint32_t offset = 1);
+		void movePositiveZ(uint32_t offset = 1);
+		void movePositive(math::Axis axis, uint32_t offset = 1);
+
+		void moveNegativeX(uint32_t offset = 1);
+		void moveNegativeY(uint32_t offset = 1);
+		void moveNegativeZ(uint32_t offset = 1);
+		void moveNegative(math::Axis axis, uint32_t offset = 1);
+
+		const Voxel &peekVoxel1nx1ny1nz() const;
+		const Voxel &peekVoxel1nx1ny0pz() const;
+		const Voxel &peekVoxel1nx1ny1pz() const;
+		const Voxel &peekVoxel1nx0py1nz() const;
+		const Voxel &peekVoxel1nx0py0pz() const;
+		const Voxel &peekVoxel1nx0py1pz() const;
+		const Voxel &peekVoxel1nx1py1nz() const;
+		const Voxel &peekVoxel1nx1py0pz() const;
+		const Voxel &peekVoxel1nx1py1pz() const;
+
+		const Voxel &peekVoxel0px1ny1nz() const;
+		const Voxel &peekVoxel0px1ny0pz() const;
+		const Voxel &peekVoxel0px1ny1pz() const;
+		const Voxel &peekVoxel0px0py1nz() const;
+		const Voxel &peekVoxel0px0py0pz() const;
+		const Voxel &peekVoxel0px0py1pz() const;
+		const Voxel &peekVoxel0px1py1nz() const;
+		const Voxel &peekVoxel0px1py0pz() const;
+		const Voxel &peekVoxel0px1py1pz() const;
+
+		const Voxel &peekVoxel1px1ny1nz() const;
+		const Voxel &peekVoxel1px1ny0pz() const;
+		const Voxel &peekVoxel1px1ny1pz() const;
+		const Voxel &peekVoxel1px0py1nz() const;
+		const Voxel &peekVoxel1px0py0pz() const;
+		const Voxel &peekVoxel1px0py1pz() const;
+		const Voxel &peekVoxel1px1py1nz() const;
+		const Voxel &peekVoxel1px1py0pz() const;
+		const Voxel &peekVoxel1px1py1pz() const;
+
+	protected:
+		PagedVolume *_volume;
+
+		// The current position in the volume
+		glm::ivec3 _posInVolume{0, 0, 0};
+
+		// the chunk of the current position - @c nullptr if the chunk doesn't exist (yet)
+		Chunk *_chunk = nullptr;
+		glm::ivec3 _chunkPos{0, 0, 0};
+
+		/** Whether the current position is inside the volume */
+		uint8_t _currentPositionInvalid = 0u;
+	};
+
+	// invalid region means unlimited size
+	PagedVolume(const voxel::Region &limitRegion = voxel::Region::InvalidRegion);
+	~PagedVolume();
+
+	PagedVolume(const PagedVolume &) = delete;
+	PagedVolume &operator=(const PagedVolume &) = delete;
+
+	[[nodiscard]] inline const voxel::Region &region() const {
+		return _region;
+	}
+
+	/**
+	 * @brief The region of the chunks that contain voxels - this is aligned to the chunk size
+	 * @sa calculateRegion()
+	 */
+	[[nodiscard]] Region chunkRegion() const;
+	/**
+	 * @brief The region of the non-air voxels
+	 */
+	[[nodiscard]] Region calculateRegion() const;
+
+	inline bool setVoxel(int x, int y, int z, const voxel::Voxel &voxel) {
+		return setVoxel({x, y, z}, voxel);
+	}
+
+	bool setVoxel(const glm::ivec3 &pos, const voxel::Voxel &voxel);
+
+	/**
+	 * @note Invalidates all samplers
+	 */
+	void clear();
+
+	/**
+	 * Gets a voxel at the position given by @c x,y,z coordinates
+	 */
+	[[nodiscard]] const Voxel &voxel(int32_t x, int32_t y, int32_t z) const {
+		return voxel({x, y, z});
+	}
+
+	/**
+	 * @param pos The 3D position of the voxel
+	 * @return The voxel value
+	 */
+	[[nodiscard]] const Voxel &voxel(const glm::ivec3 &pos) const;
+
+	/**
+	 * @brief Stores the chunks that only contain one voxel value as this value and removes the air chunks
+	 * @note Invalidates all samplers
+	 */
+	void optimize();
+	/**
+	 * @brief Compresses the chunks that weren't modified or decompressed since the last call
+	 * @note Invalidates all samplers
+	 * @return The amount of chunks that were compressed
+	 */
+	int compress();
+
+	/**
+	 * @return The amount of allocated chunks
+	 */
+	[[nodiscard]] inline size_t chunks() const {
+		return _chunks.size();
+	}
+
+	/**
+	 * @return The amount of bytes the chunks are using
+	 */
+	[[nodiscard]] size_t memory() const;
+
+	[[nodiscard]] inline bool empty() const {
+		return _chunks.empty();
+	}
+
+	/**
+	 * @return The width of the volume in voxels. Note that this value is inclusive, so that if the valid range is e.g.
+	 * 0 to 63 then the width is 64.
+	 * @sa height(), getDepth()
+	 */
+	int32_t width() const;
+
+	/**
+	 * @return The height of the volume in voxels. Note that this value is inclusive, so that if the valid range is e.g.
+	 * 0 to 63 then the height is 64.
+	 * @sa width(), getDepth()
+	 */
+	int32_t height() const;
+
+	/**
+	 * @return The depth of the volume in voxels. Note that this value is inclusive, so that if the valid range is e.g.
+	 * 0 to 63 then the depth is 64.
+	 * @sa width(), height()
+	 */
+	int32_t depth() const;
+
+	/**
+	 * @brief Copies the non-air voxels into the given volume
+	 */
+	template<class Volume>
+	void copyTo(Volume &target) const {
+		const Region &region = calculateRegion();
+		if (!region.isValid()) {
+			return;
+		}
+		auto visitor = [&target](int x, int y, int z, const voxel::Voxel &voxel) { target.setVoxel(x, y, z, voxel); };
+		voxelutil::visitVolume(*this, region, visitor);
+	}
+
+	template<class Volume>
+	void copyFrom(const Volume &source) {
+		auto visitor = [this](int x, int y, int z, const voxel::Voxel &voxel) { setVoxel(x, y, z, voxel); };
+		voxelutil::visitVolume(source, visitor);
+	}
+};
+
+inline int32_t PagedVolume::width() const {
+	return _region.getWidthInVoxels();
+}
+
+inline int32_t PagedVolume::height() const {
+	return _region.getHeightInVoxels();
+}
+
+inline int32_t PagedVolume::depth() const {
+	return _region.getDepthInVoxels();
+}
+
+inline const Region PagedVolume::Sampler::region() const {
+	return _volume->region();
+}
+
+inline const glm::ivec3 &PagedVolume::Sampler::position() const {
+	return _posInVolume;
+}
+
+inline const Voxel &PagedVolume::Sampler::voxel() const {
+	if (this->currentPositionValid() && _chunk != nullptr) {
+		return _chunk->voxel(chunkIndex(_posInVolume));
+	}
+	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y, this->_posInVolume.z);
+}
+
+inline bool PagedVolume::Sampler::currentPositionValid() const {
+	return !_currentPositionInvalid;
+}
+
+inline bool PagedVolume::Sampler::setPosition(const glm::ivec3 &v3dNewPos) {
+	return setPosition(v3dNewPos.x, v3dNewPos.y, v3dNewPos.z);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1nx1ny1nz() const {
+	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y - 1, this->_posInVolume.z - 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1nx1ny0pz() const {
+	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y - 1, this->_posInVolume.z);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1nx1ny1pz() const {
+	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y - 1, this->_posInVolume.z + 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1nx0py1nz() const {
+	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y, this->_posInVolume.z - 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1nx0py0pz() const {
+	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y, this->_posInVolume.z);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1nx0py1pz() const {
+	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y, this->_posInVolume.z + 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1nx1py1nz() const {
+	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y + 1, this->_posInVolume.z - 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1nx1py0pz() const {
+	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y + 1, this->_posInVolume.z);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1nx1py1pz() const {
+	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y + 1, this->_posInVolume.z + 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel0px1ny1nz() const {
+	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y - 1, this->_posInVolume.z - 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel0px1ny0pz() const {
+	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y - 1, this->_posInVolume.z);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel0px1ny1pz() const {
+	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y - 1, this->_posInVolume.z + 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel0px0py1nz() const {
+	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y, this->_posInVolume.z - 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel0px0py0pz() const {
+	return voxel();
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel0px0py1pz() const {
+	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y, this->_posInVolume.z + 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel0px1py1nz() const {
+	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y + 1, this->_posInVolume.z - 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel0px1py0pz() const {
+	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y + 1, this->_posInVolume.z);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel0px1py1pz() const {
+	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y + 1, this->_posInVolume.z + 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1px1ny1nz() const {
+	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y - 1, this->_posInVolume.z - 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1px1ny0pz() const {
+	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y - 1, this->_posInVolume.z);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1px1ny1pz() const {
+	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y - 1, this->_posInVolume.z + 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1px0py1nz() const {
+	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y, this->_posInVolume.z - 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1px0py0pz() const {
+	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y, this->_posInVolume.z);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1px0py1pz() const {
+	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y, this->_posInVolume.z + 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1px1py1nz() const {
+	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y + 1, this->_posInVolume.z - 1);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1px1py0pz() const {
+	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y + 1, this->_posInVolume.z);
+}
+
+inline const Voxel &PagedVolume::Sampler::peekVoxel1px1py1pz() const {
+	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y + 1, this->_posInVolume.z + 1);
+}
+
+} // namespace voxel
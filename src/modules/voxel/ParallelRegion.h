@@ -0,0 +1,37 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "app/Async.h"
+#include "voxel/Region.h"
+
+namespace voxel {
+
+/**
+ * @brief Splits the region into slices along the z axis and executes the given functor for them in parallel
+ *
+ * The slices follow the memory layout of the @c RawVolume - so each of them is a contiguous block of voxels.
+ *
+ * @param func Called with the sub region of a slice: @code void(const voxel::Region &region) @endcode
+ * @param sliceDepth The amount of z layers per slice - @c 0 picks the size depending on the amount of workers
+ * @note This is blocking until all slices are done
+ */
+template<class FUNC>
+void parallelFor(const Region &region, FUNC &&func, int sliceDepth = 0) {
+	if (!region.isValid()) {
+		return;
+	}
+	const glm::ivec3 &mins = region.getLowerCorner();
+	const glm::ivec3 &maxs = region.getUpperCorner();
+	app::for_parallel(
+		mins.z, maxs.z + 1,
+		[&func, &mins, &maxs](int start, int end) {
+			const Region slice(mins.x, mins.y, start, maxs.x, maxs.y, end - 1);
+			func(slice);
+		},
+		sliceDepth);
+}
+
+} // namespace voxel
@@ -3,8 +3,10 @@
  */
 
 #include "RawVolume.h"
+#include "RawVolumeSnapshot.h"
 #include "core/Assert.h"
 #include "core/StandardLib.h"
+#include "core/Trace.h"
 #include <glm/common.hpp>
 #include <limits>
 
@@ -29,6 +31,7 @@ RawVolume::RawVolume(const RawVolume *copy) : _region(copy->region()) {
 	_data = (Voxel *)core_malloc(size);
 	_borderVoxel = copy->_borderVoxel;
 	core_memcpy((void*)_data, (void*)copy->_data, size);
+	copyOccupancy(*copy);
 }
 
 RawVolume::RawVolume(const RawVolume &copy) : _region(copy.region()) {
@@ -37,6 +40,7 @@ RawVolume::RawVolume(const RawVolume &copy) : _region(copy.region()) {
 	_data = (Voxel *)core_malloc(size);
 	_borderVoxel = copy._borderVoxel;
 	core_memcpy((void*)_data, (void*)copy._data, size);
+	copyOccupancy(copy);
 }
 
 static inline voxel::Region accumulate(const core::DynamicArray<Region> &regions) {
@@ -86,18 +90,17 @@ RawVolume::RawVolume(const RawVolume& src, const Region& region, bool *onlyAir)
 			*onlyAir = true;
 		}
 		core_memset((void *)_data, 0, size);
+		resetOccupancy();
 	} else if (src.region() == _region) {
 		core_memcpy((void *)_data, (void *)src._data, size);
+		copyOccupancy(src);
 		if (onlyAir) {
-			*onlyAir = false;
+			*onlyAir = isEmpty();
 		}
 	} else {
 		if (!src.region().containsRegion(_region)) {
 			_region.cropTo(src._region);
 		}
-		if (onlyAir) {
-			*onlyAir = true;
-		}
 		const glm::ivec3 &tgtMins = _region.getLowerCorner();
 		const glm::ivec3 &tgtMaxs = _region.getUpperCorner();
 		const glm::ivec3 &srcMins = src._region.getLowerCorner();
@@ -119,41 +122,49 @@ RawVolume::RawVolume(const RawVolume& src, const Region& region, bool *onlyAir)
 					const int tgtindex = tgtStrideLocal + tgtZPos * tgtZStride;
 					const int srcindex = srcStrideLocal + srcZPos * srcZStride;
 					_data[tgtindex] = src._data[srcindex];
-					if (onlyAir && !voxel::isAir(_data[tgtindex].getMaterial())) {
-						*onlyAir = false;
-						onlyAir = nullptr;
-					}
 				}
 			}
 		}
+		buildOccupancy();
+		if (onlyAir) {
+			*onlyAir = isEmpty();
+		}
 	}
 }
 
 RawVolume::RawVolume(RawVolume &&move) noexcept {
+	move.detachSnapshots();
 	_data = move._data;
 	move._data = nullptr;
 	_region = move._region;
 	_borderVoxel = move._borderVoxel;
+	_occupancy = core::move(move._occupancy);
+	_occupancyDims = move._occupancyDims;
+	move._occupancyDims = glm::ivec3(0);
 }
 
 RawVolume::RawVolume(const Voxel *data, const voxel::Region &region) {
 	initialise(region);
 	const size_t size = RawVolume::size(_region);
 	core_memcpy((void *)_data, (const void *)data, size);
+	buildOccupancy();
 }
 
 RawVolume::RawVolume(Voxel *data, const voxel::Region &region) : _region(region), _data(data) {
 	core_assert_msg(width() > 0, "Volume width must be greater than zero.");
 	core_assert_msg(height() > 0, "Volume height must be greater than zero.");
 	core_assert_msg(depth() > 0, "Volume depth must be greater than zero.");
+	buildOccupancy();
 }
 
 RawVolume::~RawVolume() {
+	detachSnapshots();
 	core_free(_data);
 	_data = nullptr;
 }
 
 bool RawVolume::move(const glm::ivec3 &shift) {
+	detachSnapshots();
 	const int w = width();
 	const int h = height();
 	const int d = depth();
@@ -178,6 +189,7 @@ bool RawVolume::move(const glm::ivec3 &shift) {
 	}
 
 	core::rotate(_data, _data + t.z * hwstride, _data + d * hwstride);
+	buildOccupancy();
 
 	return true;
 }
@@ -245,17 +257,219 @@ bool RawVolume::setVoxel(const glm::ivec3 &pos, const Voxel &voxel) {
 	if (_data[index].isSame(voxel)) {
 		return false;
 	}
+	prepareModification(pos);
+	updateOccupancy(localPos, _data[index], voxel);
 	_data[index] = voxel;
 	return true;
 }
 
 void RawVolume::setVoxelUnsafe(const glm::ivec3 &pos, const Voxel &voxel) {
+	prepareModification(pos);
 	const glm::ivec3 &lowerCorner = _region.getLowerCorner();
 	const glm::ivec3 localPos = pos - lowerCorner;
 	const int index = localPos.x + localPos.y * width() + localPos.z * width() * height();
+	updateOccupancy(localPos, _data[index], voxel);
 	_data[index] = voxel;
 }
 
+void RawVolume::resetOccupancy() {
+	_occupancyDims = ((_region.getDimensionsInVoxels() - 1) >> OccupancyBrickBits) + 1;
+	_occupancy.resize((size_t)_occupancyDims.x * _occupancyDims.y * _occupancyDims.z);
+	_occupancy.fill(0u);
+}
+
+void RawVolume::buildOccupancy() {
+	core_trace_scoped(RawVolumeBuildOccupancy);
+	resetOccupancy();
+	const int w = width();
+	const int h = height();
+	const int d = depth();
+	// the counts of one brick layer are summed up without atomics before they are stored
+	core::DynamicArray<int> counts;
+	counts.resize((size_t)_occupancyDims.x * _occupancyDims.y);
+	const Voxel *voxel = _data;
+	for (int bz = 0; bz < _occupancyDims.z; ++bz) {
+		counts.fill(0);
+		const int zEnd = core_min(d, (bz + 1) * OccupancyBrickSize);
+		for (int z = bz * OccupancyBrickSize; z < zEnd; ++z) {
+			for (int y = 0; y < h; ++y) {
+				int *row = counts.data() + (size_t)(y >> OccupancyBrickBits) * _occupancyDims.x;
+				for (int x = 0; x < w; ++x, ++voxel) {
+					if (!isAir(voxel->getMaterial())) {
+						++row[x >> OccupancyBrickBits];
+					}
+				}
+			}
+		}
+		const size_t layerStart = occupancyIndex(glm::ivec3(0, 0, bz * OccupancyBrickSize));
+		for (size_t i = 0; i < counts.size(); ++i) {
+			_occupancy[layerStart + i] = (uint16_t)counts[i];
+		}
+	}
+}
+
+void RawVolume::copyOccupancy(const RawVolume &src) {
+	core_assert(src._region.getDimensionsInVoxels() == _region.getDimensionsInVoxels());
+	_occupancyDims = src._occupancyDims;
+	_occupancy = src._occupancy;
+}
+
+bool RawVolume::isEmpty() const {
+	for (uint16_t cnt : _occupancy) {
+		if (cnt != 0u) {
+			return false;
+		}
+	}
+	return true;
+}
+
+int64_t RawVolume::solidVoxels() const {
+	int64_t voxels = 0;
+	for (uint16_t cnt : _occupancy) {
+		voxels += cnt;
+	}
+	return voxels;
+}
+
+bool RawVolume::isEmpty(const Region &region) const {
+	Region cropped = region;
+	if (!cropped.isValid() || !cropped.cropTo(_region)) {
+		return true;
+	}
+	const glm::ivec3 &lowerCorner = _region.getLowerCorner();
+	const glm::ivec3 localMins = cropped.getLowerCorner() - lowerCorner;
+	const glm::ivec3 localMaxs = cropped.getUpperCorner() - lowerCorner;
+	const glm::ivec3 volumeMaxs = _region.getDimensionsInVoxels() - 1;
+	const glm::ivec3 brickMins = localMins >> OccupancyBrickBits;
+	const glm::ivec3 brickMaxs = localMaxs >> OccupancyBrickBits;
+	const int w = width();
+	const int wh = w * height();
+	for (int bz = brickMins.z; bz <= brickMaxs.z; ++bz) {
+		for (int by = brickMins.y; by <= brickMaxs.y; ++by) {
+			for (int bx = brickMins.x; bx <= brickMaxs.x; ++bx) {
+				const glm::ivec3 brickLower = glm::ivec3(bx, by, bz) * OccupancyBrickSize;
+				if (_occupancy[occupancyIndex(brickLower)] == 0u) {
+					continue;
+				}
+				const glm::ivec3 brickUpper = glm::min(brickLower + (OccupancyBrickSize - 1), volumeMaxs);
+				const glm::ivec3 mins = glm::max(brickLower, localMins);
+				const glm::ivec3 maxs = glm::min(brickUpper, localMaxs);
+				if (mins == brickLower && maxs == brickUpper) {
+					return false;
+				}
+				// the brick is only partially covered - check the covered voxels
+				for (int z = mins.z; z <= maxs.z; ++z) {
+					for (int y = mins.y; y <= maxs.y; ++y) {
+						const Voxel *voxel = _data + z * wh + y * w + mins.x;
+						for (int x = mins.x; x <= maxs.x; ++x, ++voxel) {
+							if (!isAir(voxel->getMaterial())) {
+								return false;
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+	return true;
+}
+
+Region RawVolume::solidRegion() const {
+	glm::ivec3 brickMins((std::numeric_limits<int>::max)());
+	glm::ivec3 brickMaxs((std::numeric_limits<int>::min)());
+	for (int bz = 0; bz < _occupancyDims.z; ++bz) {
+		for (int by = 0; by < _occupancyDims.y; ++by) {
+			for (int bx = 0; bx < _occupancyDims.x; ++bx) {
+				const glm::ivec3 brick(bx, by, bz);
+				if (_occupancy[occupancyIndex(brick * OccupancyBrickSize)] == 0u) {
+					continue;
+				}
+				brickMins = glm::min(brickMins, brick);
+				brickMaxs = glm::max(brickMaxs, brick);
+			}
+		}
+	}
+	if (brickMins.x > brickMaxs.x) {
+		return Region::InvalidRegion;
+	}
+	// the extreme voxels can only be found in the bricks at the borders of the solid bricks
+	const glm::ivec3 volumeMaxs = _region.getDimensionsInVoxels() - 1;
+	const int w = width();
+	const int wh = w * height();
+	glm::ivec3 mins((std::numeric_limits<int>::max)());
+	glm::ivec3 maxs((std::numeric_limits<int>::min)());
+	for (int bz = brickMins.z; bz <= brickMaxs.z; ++bz) {
+		for (int by = brickMins.y; by <= brickMaxs.y; ++by) {
+			for (int bx = brickMins.x; bx <= brickMaxs.x; ++bx) {
+				const glm::ivec3 brick(bx, by, bz);
+				if (glm::all(glm::greaterThan(brick, brickMins)) && glm::all(glm::lessThan(brick, brickMaxs))) {
+					continue;
+				}
+				const glm::ivec3 brickLower = brick * OccupancyBrickSize;
+				if (_occupancy[occupancyIndex(brickLower)] == 0u) {
+					continue;
+				}
+				const glm::ivec3 brickUpper = glm::min(brickLower + (OccupancyBrickSize - 1), volumeMaxs);
+				for (int z = brickLower.z; z <= brickUpper.z; ++z) {
+					for (int y = brickLower.y; y <= brickUpper.y; ++y) {
+						const Voxel *voxel = _data + z * wh + y * w + brickLower.x;
+						for (int x = brickLower.x; x <= brickUpper.x; ++x, ++voxel) {
+							if (isAir(voxel->getMaterial())) {
+								continue;
+							}
+							const glm::ivec3 pos(x, y, z);
+							mins = glm::min(mins, pos);
+							maxs = glm::max(maxs, pos);
+						}
+					}
+				}
+			}
+		}
+	}
+	const glm::ivec3 &lowerCorner = _region.getLowerCorner();
+	return Region(lowerCorner + mins, lowerCorner + maxs);
+}
+
+glm::ivec3 RawVolume::mins() const {
+	const Region &region = solidRegion();
+	if (!region.isValid()) {
+		return _region.getLowerCorner();
+	}
+	return region.getLowerCorner();
+}
+
+glm::ivec3 RawVolume::maxs() const {
+	const Region &region = solidRegion();
+	if (!region.isValid()) {
+		return _region.getUpperCorner();
+	}
+	return region.getUpperCorner();
+}
+
+int32_t RawVolume::nextOccupiedX(int32_t x, int32_t y, int32_t z, int32_t &checkX) const {
+	if (!_region.containsPointInY(y) || !_region.containsPointInZ(z) || x > _region.getUpperX()) {
+		// outside of the volume - the border voxel is returned
+		checkX = (std::numeric_limits<int32_t>::max)();
+		return x;
+	}
+	const glm::ivec3 &lowerCorner = _region.getLowerCorner();
+	if (x < lowerCorner.x) {
+		checkX = lowerCorner.x;
+		return x;
+	}
+	const size_t rowStart = occupancyIndex(glm::ivec3(0, y - lowerCorner.y, z - lowerCorner.z));
+	int32_t brickX = (x - lowerCorner.x) >> OccupancyBrickBits;
+	while (brickX < _occupancyDims.x && _occupancy[rowStart + brickX] == 0u) {
+		++brickX;
+	}
+	if (brickX == _occupancyDims.x) {
+		checkX = _region.getUpperX() + 1;
+		return checkX;
+	}
+	checkX = lowerCorner.x + (brickX + 1) * OccupancyBrickSize;
+	return core_max(x, lowerCorner.x + brickX * OccupancyBrickSize);
+}
+
 /**
  * This function should probably be made internal...
  */
@@ -277,15 +491,33 @@ void RawVolume::initialise(const Region &regValidRegion) {
 }
 
 void RawVolume::clear() {
+	detachSnapshots();
 	const size_t size = RawVolume::size(_region);
 	core_memset(_data, 0, size);
+	resetOccupancy();
 }
 
 void RawVolume::fill(const voxel::Voxel &voxel) {
+	detachSnapshots();
 	const size_t size = width() * height() * depth();
 	for (size_t i = 0; i < size; ++i) {
 		_data[i] = voxel;
 	}
+	resetOccupancy();
+	if (isAir(voxel.getMaterial())) {
+		return;
+	}
+	// every brick is full - only the bricks at the upper borders might be smaller
+	const glm::ivec3 dimensions = _region.getDimensionsInVoxels();
+	for (int bz = 0; bz < _occupancyDims.z; ++bz) {
+		for (int by = 0; by < _occupancyDims.y; ++by) {
+			for (int bx = 0; bx < _occupancyDims.x; ++bx) {
+				const glm::ivec3 brickLower = glm::ivec3(bx, by, bz) * OccupancyBrickSize;
+				const glm::ivec3 brickSize = glm::min(dimensions - brickLower, glm::ivec3(OccupancyBrickSize));
+				_occupancy[occupancyIndex(brickLower)] = (uint16_t)(brickSize.x * brickSize.y * brickSize.z);
+			}
+		}
+	}
 }
 
 RawVolume::Sampler::Sampler(const RawVolume *volume)
@@ -303,6 +535,8 @@ bool RawVolume::Sampler::setVoxel(const Voxel &voxel) {
 	if (_currentPositionInvalid) {
 		return false;
 	}
+	_volume->prepareModification(_posInVolume);
+	_volume->updateOccupancy(_posInVolume - _volume->_region.getLowerCorner(), *_currentVoxel, voxel);
 	*_currentVoxel = voxel;
 	return true;
 }
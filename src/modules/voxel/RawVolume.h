@@ -6,12 +6,20 @@
 
 #include "Region.h"
 #include "Voxel.h"
+#include "core/SharedPtr.h"
+#include "core/Trace.h"
 #include "core/collection/DynamicArray.h"
+#include "core/concurrent/Atomic.h"
+#include "core/concurrent/Lock.h"
 #include "math/Axis.h"
+#include <atomic>
 #include <glm/vec3.hpp>
 
 namespace voxel {
 
+class RawVolumeSnapshot;
+struct RawVolumeSnapshotState;
+
 /**
  * Simple volume implementation which stores data in a single large 3D array.
  */
@@ -97,6 +105,17 @@ public:
 	RawVolume(Voxel *data, const voxel::Region &region);
 
 public:
+	/**
+	 * @brief The occupancy summary counts the solid voxels in bricks of this size. The bricks start at the lower
+	 * corner of the volume region.
+	 *
+	 * The counts are always up to date. They are plain counters to keep @c setVoxel() cheap - threads that modify
+	 * the volume concurrently must write into distinct occupancy bricks. Like the voxel queries, the summary queries
+	 * must not run while other threads modify the volume.
+	 */
+	static constexpr int OccupancyBrickBits = 4;
+	static constexpr int OccupancyBrickSize = 1 << OccupancyBrickBits;
+
 	/// Constructor for creating a fixed size volume.
 	RawVolume(const Region &region);
 	RawVolume(const RawVolume *copy);
@@ -166,15 +185,38 @@ public:
 
 	/**
 	 * the vector that describes the mins value of an aabb where a voxel is set in this volume
-	 * deleting a voxel afterwards might lead to invalid results
+	 * @sa solidRegion()
 	 */
 	glm::ivec3 mins() const;
 	/**
 	 * the vector that describes the maxs value of an aabb where a voxel is set in this volume
-	 * deleting a voxel afterwards might lead to invalid results
+	 * @sa solidRegion()
 	 */
 	glm::ivec3 maxs() const;
 
+	/**
+	 * @return The smallest region that contains all solid voxels - or @c Region::InvalidRegion if there are none
+	 * @note Only the bricks of the occupancy summary at the borders of the solid region are scanned
+	 */
+	Region solidRegion() const;
+	/**
+	 * @return @c true if there is no solid voxel in the given region - positions outside of the volume are ignored
+	 * @note Only the bricks of the occupancy summary that are partially covered by the region and contain solid
+	 * voxels are scanned
+	 */
+	bool isEmpty(const Region &region) const;
+	bool isEmpty() const;
+	/**
+	 * @return The amount of solid voxels in the volume
+	 */
+	int64_t solidVoxels() const;
+	/**
+	 * @brief Skips the bricks of the occupancy summary that only contain air in the row at @c y and @c z
+	 * @param[out] checkX The next @c x coordinate where the skipping has to be performed again
+	 * @return The first @c x coordinate that is equal to or bigger than the given one and not part of an empty brick
+	 */
+	int32_t nextOccupiedX(int32_t x, int32_t y, int32_t z, int32_t &checkX) const;
+
 	/**
 	 * Gets a voxel at the position given by <tt>x,y,z</tt> coordinates
 	 */
@@ -212,6 +254,7 @@ public:
 	 * @brief Shift the region of the volume by the given coordinates
 	 */
 	void translate(const glm::ivec3 &t) {
+		detachSnapshots();
 		_region.shift(t.x, t.y, t.z);
 	}
 
@@ -223,8 +266,62 @@ public:
 	bool move(const glm::ivec3 &t);
 
 private:
+	friend class RawVolumeSnapshot;
+
 	void initialise(const Region &region);
 
+	/**
+	 * @brief Hands the current voxels over to all registered snapshots that overlap the given region
+	 * @note Must be called before the voxels in the given region are modified
+	 * @sa RawVolumeSnapshot
+	 */
+	void detachSnapshots(const Region &region) const;
+	/**
+	 * @brief Hands the current voxels over to all registered snapshots
+	 */
+	void detachSnapshots() const;
+	/**
+	 * @brief Hands the current voxels over to all registered snapshots that overlap the occupancy brick of the given
+	 * position
+	 * @note The last checked brick is remembered per thread - further modifications in the same brick don't look at
+	 * the snapshots again until a new snapshot is registered.
+	 */
+	void detachSnapshots(const glm::ivec3 &pos) const;
+	inline void prepareModification(const glm::ivec3 &pos) const {
+		if (_snapshotCount > 0) {
+			detachSnapshots(pos);
+		}
+	}
+
+	static_assert(OccupancyBrickSize * OccupancyBrickSize * OccupancyBrickSize <= UINT16_MAX,
+				  "The occupancy counts don't fit into 16 bit");
+
+	/**
+	 * @brief Sets all counts of the occupancy summary to zero
+	 */
+	void resetOccupancy();
+	/**
+	 * @brief Counts the solid voxels of all bricks after the voxel data was modified in bulk
+	 */
+	void buildOccupancy();
+	void copyOccupancy(const RawVolume &src);
+	inline size_t occupancyIndex(const glm::ivec3 &localPos) const {
+		const glm::ivec3 brick = localPos >> OccupancyBrickBits;
+		return ((size_t)brick.z * _occupancyDims.y + brick.y) * _occupancyDims.x + brick.x;
+	}
+	inline void updateOccupancy(const glm::ivec3 &localPos, const Voxel &oldVoxel, const Voxel &newVoxel) {
+		const bool oldAir = isAir(oldVoxel.getMaterial());
+		if (oldAir == isAir(newVoxel.getMaterial())) {
+			return;
+		}
+		uint16_t &cnt = _occupancy[occupancyIndex(localPos)];
+		if (oldAir) {
+			++cnt;
+		} else {
+			--cnt;
+		}
+	}
+
 	/** The size of the volume */
 	Region _region;
 
@@ -233,6 +330,18 @@ private:
 
 	/** The voxel data */
 	Voxel *_data;
+
+	/** The snapshots that might still read from @c _data - detached and destroyed ones are removed lazily */
+	mutable core::DynamicArray<core::SharedPtr<RawVolumeSnapshotState>> _snapshots;
+	mutable core_trace_mutex(core::Lock, _snapshotLock, "RawVolumeSnapshot");
+	/** the amount of snapshots that still read from @c _data */
+	mutable std::atomic<int> _snapshotCount{0};
+	/** changes whenever a snapshot is registered - invalidates the brick that was checked last */
+	mutable core::AtomicInt _snapshotGeneration{0};
+
+	/** the amount of solid voxels per brick */
+	core::DynamicArray<uint16_t> _occupancy;
+	glm::ivec3 _occupancyDims{0};
 };
 
 inline const Region &RawVolume::region() const {
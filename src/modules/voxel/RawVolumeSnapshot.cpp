@@ -0,0 +1,129 @@
+/**
+ * @file
+ */
+
+#include "RawVolumeSnapshot.h"
+#include "core/Trace.h"
+#include "voxel/RawVolume.h"
+
+namespace voxel {
+
+namespace _priv {
+
+static core::AtomicInt _snapshotGeneration{0};
+
+/**
+ * @brief The occupancy brick of the last modification check of this thread
+ */
+struct SnapshotCheck {
+	const RawVolume *volume = nullptr;
+	int generation = 0;
+	Region region = Region::InvalidRegion;
+};
+static thread_local SnapshotCheck _lastCheck;
+
+} // namespace _priv
+
+RawVolumeSnapshot::RawVolumeSnapshot(const RawVolume *volume, const Region &region)
+	: _state(core::make_shared<RawVolumeSnapshotState>()) {
+	_state->volume = volume;
+	_state->region = region;
+	core::ScopedLock lock(volume->_snapshotLock);
+	if (volume->_snapshots.size() > 2u * (size_t)(int)volume->_snapshotCount + 16u) {
+		// remove the states of the snapshots that were already detached or destroyed
+		for (size_t i = 0; i < volume->_snapshots.size();) {
+			if ((const RawVolume *)volume->_snapshots[i]->volume == nullptr) {
+				volume->_snapshots[i] = volume->_snapshots.back();
+				volume->_snapshots.pop();
+			} else {
+				++i;
+			}
+		}
+	}
+	volume->_snapshots.push_back(_state);
+	++volume->_snapshotCount;
+	volume->_snapshotGeneration = _priv::_snapshotGeneration.increment() + 1;
+}
+
+RawVolumeSnapshot::~RawVolumeSnapshot() {
+	// the volume removes the state lazily - but it can't be destroyed while we hold the lock of the state
+	core::ScopedLock lock(_state->lock);
+	const RawVolume *volume = _state->volume;
+	if (volume != nullptr) {
+		--volume->_snapshotCount;
+		_state->volume = nullptr;
+	}
+	delete _state->copy;
+	_state->copy = nullptr;
+}
+
+void RawVolumeSnapshot::detach(RawVolumeSnapshotState &state) {
+	core_trace_scoped(RawVolumeSnapshotDetach);
+	const RawVolume *volume = state.volume;
+	state.copy = new RawVolume(*volume, state.region, &state.onlyAir);
+	state.volume = nullptr;
+	--volume->_snapshotCount;
+}
+
+const RawVolume *RawVolumeSnapshot::materialize(bool *onlyAir) {
+	// only the lock of this snapshot is held while copying - other snapshots can be materialized in parallel
+	core::ScopedLock lock(_state->lock);
+	if ((const RawVolume *)_state->volume != nullptr) {
+		detach(*_state.get());
+	}
+	if (onlyAir) {
+		*onlyAir = _state->onlyAir;
+	}
+	return _state->copy;
+}
+
+void RawVolume::detachSnapshots(const Region &region) const {
+	core::ScopedLock lock(_snapshotLock);
+	for (size_t i = 0; i < _snapshots.size();) {
+		RawVolumeSnapshotState *state = _snapshots[i].get();
+		if ((const RawVolume *)state->volume != nullptr) {
+			if (!voxel::intersects(state->region, region)) {
+				++i;
+				continue;
+			}
+			core::ScopedLock stateLock(state->lock);
+			if ((const RawVolume *)state->volume != nullptr) {
+				RawVolumeSnapshot::detach(*state);
+			}
+		}
+		_snapshots[i] = _snapshots.back();
+		_snapshots.pop();
+	}
+}
+
+void RawVolume::detachSnapshots(const glm::ivec3 &pos) const {
+	_priv::SnapshotCheck &lastCheck = _priv::_lastCheck;
+	const int generation = _snapshotGeneration;
+	if (lastCheck.volume == this && lastCheck.generation == generation && lastCheck.region.containsPoint(pos)) {
+		return;
+	}
+	const glm::ivec3 &mins = _region.getLowerCorner();
+	const glm::ivec3 lower = mins + (((pos - mins) >> OccupancyBrickBits) << OccupancyBrickBits);
+	const Region brick(lower, lower + (OccupancyBrickSize - 1));
+	detachSnapshots(brick);
+	// a snapshot that is registered meanwhile changes the generation - so the brick is checked again
+	lastCheck.volume = this;
+	lastCheck.generation = generation;
+	lastCheck.region = brick;
+}
+
+void RawVolume::detachSnapshots() const {
+	if (_snapshotCount == 0) {
+		return;
+	}
+	core::ScopedLock lock(_snapshotLock);
+	for (const core::SharedPtr<RawVolumeSnapshotState> &state : _snapshots) {
+		core::ScopedLock stateLock(state->lock);
+		if ((const RawVolume *)state->volume != nullptr) {
+			RawVolumeSnapshot::detach(*state.get());
+		}
+	}
+	_snapshots.clear();
+}
+
+} // namespace voxel
@@ -0,0 +1,78 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/NonCopyable.h"
+#include "core/SharedPtr.h"
+#include "core/Trace.h"
+#include "core/concurrent/Atomic.h"
+#include "core/concurrent/Lock.h"
+#include "voxel/Region.h"
+
+namespace voxel {
+
+class RawVolume;
+
+/**
+ * @brief The part of a @c RawVolumeSnapshot that is shared with the volume it reads from
+ *
+ * Each snapshot has its own lock - so copying the voxels of one snapshot doesn't block the other snapshots or the
+ * volume. Lock order is volume before snapshot.
+ */
+struct RawVolumeSnapshotState {
+	core_trace_mutex(core::Lock, lock, "RawVolumeSnapshotState");
+	/** the volume we read from - @c nullptr once the voxels were copied or the snapshot was destroyed */
+	core::AtomicPtr<const RawVolume> volume;
+	RawVolume *copy = nullptr;
+	Region region;
+	bool onlyAir = true;
+};
+
+/**
+ * @brief Read-only view to a region of a @c RawVolume that doesn't copy the voxels when it is created
+ *
+ * The voxels of the region are copied once @c materialize() is called - usually from a worker thread. If the volume
+ * is modified or destroyed before that happens, the region is copied right before the modification is applied. So the
+ * snapshot always sees the voxels of the time it was created, but the creator (e.g. the main thread) doesn't have to
+ * pay for the copy as long as nobody touches the region.
+ *
+ * @note The snapshot registers itself at the volume - it must not outlive the call to @c materialize() for too long
+ * to keep the modification overhead of the volume low. Modifications that are not done via the @c RawVolume api or its
+ * @c RawVolume::Sampler (e.g. shifting the @c RawVolume::region() directly) are not detected.
+ */
+class RawVolumeSnapshot : public core::NonCopyable {
+private:
+	friend class RawVolume;
+
+	core::SharedPtr<RawVolumeSnapshotState> _state;
+
+	/**
+	 * @brief Copies the voxels and detaches the snapshot from the volume
+	 * @note The lock of the state must be held and the volume must still be set
+	 */
+	static void detach(RawVolumeSnapshotState &state);
+
+public:
+	/**
+	 * @param[in] volume The volume to read the voxels from
+	 * @param[in] region The region to snapshot - this might exceed the volume region. In that case the region is
+	 * cropped to the volume region - the border value of the volume is used for everything outside.
+	 */
+	RawVolumeSnapshot(const RawVolume *volume, const Region &region);
+	~RawVolumeSnapshot();
+
+	/**
+	 * @brief Get a volume with the voxels of the snapshot region - the voxels are copied if that didn't happen yet
+	 * @param[out] onlyAir Set to @c true if there are no solid voxels in the snapshot region
+	 * @note This is thread safe
+	 */
+	const RawVolume *materialize(bool *onlyAir = nullptr);
+
+	const Region &region() const {
+		return _state->region;
+	}
+};
+
+} // namespace voxel
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "voxel/DirtyRegions.h"
 #include "voxel/RawVolume.h"
 
 namespace voxel {
@@ -15,7 +16,7 @@ class RawVolumeWrapper {
 protected:
 	RawVolume* _volume;
 	Region _region;
-	Region _dirtyRegion = Region::InvalidRegion;
+	DirtyRegions _dirtyRegions;
 
 public:
 	class Sampler : public RawVolume::Sampler {
@@ -41,13 +42,7 @@ public:
 
 		bool setVoxel(const Voxel& voxel) override {
 			if (Super::setVoxel(voxel)) {
-				voxel::Region &dirtyRegion = _rawVolumeWrapper->_dirtyRegion;
-				const glm::ivec3 &pos = position();
-				if (dirtyRegion.isValid()) {
-					dirtyRegion.accumulate(pos);
-				} else {
-					dirtyRegion = Region(pos, pos);
-				}
+				_rawVolumeWrapper->_dirtyRegions.add(position());
 				return true;
 			}
 			return false;
@@ -87,11 +82,11 @@ public:
 
 	void fill(const voxel::Voxel &voxel) {
 		_volume->fill(voxel);
-		_dirtyRegion = _volume->region();
+		_dirtyRegions.add(_volume->region());
 	}
 
 	void clear() {
-		_dirtyRegion = _volume->region();
+		_dirtyRegions.add(_volume->region());
 		_volume->clear();
 	}
 
@@ -100,7 +95,7 @@ public:
 			return;
 		}
 		_volume = v;
-		_dirtyRegion = Region::InvalidRegion;
+		_dirtyRegions.clear();
 		if (_volume == nullptr) {
 			_region = Region::InvalidRegion;
 		} else {
@@ -132,8 +127,19 @@ public:
 		return setVoxel(pos.x, pos.y, pos.z, voxel);
 	}
 
+	/**
+	 * @return The bounding box of all modified voxels
+	 */
 	inline const Region& dirtyRegion() const {
-		return _dirtyRegion;
+		return _dirtyRegions.bounds();
+	}
+
+	/**
+	 * @return The modified voxels tracked per cell - use this to only update the parts of the volume that were
+	 * really touched
+	 */
+	inline const DirtyRegions& dirtyRegions() const {
+		return _dirtyRegions;
 	}
 
 	/**
@@ -147,11 +153,7 @@ public:
 			return false;
 		}
 		if (_volume->setVoxel(p, voxel)) {
-			if (_dirtyRegion.isValid()) {
-				_dirtyRegion.accumulate(p);
-			} else {
-				_dirtyRegion = Region(p, p);
-			}
+			_dirtyRegions.add(p);
 		}
 		return true;
 	}
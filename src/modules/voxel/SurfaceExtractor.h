@@ -15,7 +15,18 @@ class RawVolume;
 class Region;
 struct ChunkMesh;
 
-enum class SurfaceExtractionType { Cubic, MarchingCubes, Max };
+/**
+ * @brief The mesh extraction algorithms
+ * @note @c Binary produces the same kind of mesh as @c Cubic by using bitmasks to find and merge the quads
+ */
+enum class SurfaceExtractionType { Cubic, MarchingCubes, Binary, Max };
+
+/**
+ * @return @c true if the given type produces meshes where each voxel appears to be rendered as a cube
+ */
+inline bool isCubicMesh(SurfaceExtractionType type) {
+	return type == SurfaceExtractionType::Cubic || type == SurfaceExtractionType::Binary;
+}
 
 struct SurfaceExtractionContext {
 	SurfaceExtractionContext(const RawVolume *_volume, const palette::Palette &_palette, const Region &_region,
@@ -30,15 +41,18 @@ struct SurfaceExtractionContext {
 	ChunkMesh &mesh;
 	const glm::ivec3 translate;
 	const SurfaceExtractionType type;
-	const bool mergeQuads;		 // used only for Cubic
-	const bool reuseVertices;	 // used only for Cubic
-	const bool ambientOcclusion; // used only for Cubic
+	const bool mergeQuads;		 // used only for Cubic and Binary
+	const bool reuseVertices;	 // used only for Cubic and Binary
+	const bool ambientOcclusion; // used only for Cubic and Binary
 	const bool optimize;
 };
 
 SurfaceExtractionContext buildCubicContext(const RawVolume *volume, const Region &region, ChunkMesh &mesh,
 										   const glm::ivec3 &translate = glm::ivec3(0), bool mergeQuads = true,
 										   bool reuseVertices = true, bool ambientOcclusion = true, bool optimize = false);
+SurfaceExtractionContext buildBinaryContext(const RawVolume *volume, const Region &region, ChunkMesh &mesh,
+											const glm::ivec3 &translate = glm::ivec3(0), bool mergeQuads = true,
+											bool reuseVertices = true, bool ambientOcclusion = true, bool optimize = false);
 SurfaceExtractionContext buildMarchingCubesContext(const RawVolume *volume, const Region &region, ChunkMesh &mesh,
 												   const palette::Palette &palette, bool optimize = false);
 
@@ -0,0 +1,54 @@
+/**
+ * @file
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "voxel/RawVolume.h"
+
+class RawVolumeBenchmark : public app::AbstractBenchmark {
+protected:
+	voxel::RawVolume v{voxel::Region{0, 127}};
+};
+
+// every call changes the occupancy count of the brick
+BENCHMARK_DEFINE_F(RawVolumeBenchmark, SetVoxel)(benchmark::State &state) {
+	const voxel::Voxel solid = voxel::createVoxel(voxel::VoxelType::Generic, 1);
+	const voxel::Voxel air;
+	bool fill = true;
+	for (auto _ : state) {
+		const voxel::Voxel &voxel = fill ? solid : air;
+		for (int z = 0; z < 128; ++z) {
+			for (int y = 0; y < 128; ++y) {
+				for (int x = 0; x < 128; ++x) {
+					v.setVoxel(x, y, z, voxel);
+				}
+			}
+		}
+		fill = !fill;
+	}
+	state.SetItemsProcessed(state.iterations() * 128 * 128 * 128);
+}
+
+BENCHMARK_DEFINE_F(RawVolumeBenchmark, SamplerSetVoxel)(benchmark::State &state) {
+	const voxel::Voxel solid = voxel::createVoxel(voxel::VoxelType::Generic, 1);
+	const voxel::Voxel air;
+	bool fill = true;
+	for (auto _ : state) {
+		const voxel::Voxel &voxel = fill ? solid : air;
+		voxel::RawVolume::Sampler sampler(v);
+		for (int z = 0; z < 128; ++z) {
+			for (int y = 0; y < 128; ++y) {
+				sampler.setPosition(0, y, z);
+				for (int x = 0; x < 128; ++x) {
+					sampler.setVoxel(voxel);
+					sampler.movePositiveX();
+				}
+			}
+		}
+		fill = !fill;
+	}
+	state.SetItemsProcessed(state.iterations() * 128 * 128 * 128);
+}
+
+BENCHMARK_REGISTER_F(RawVolumeBenchmark, SetVoxel);
+BENCHMARK_REGISTER_F(RawVolumeBenchmark, SamplerSetVoxel);
@@ -4,6 +4,7 @@
 
 #include "app/benchmark/AbstractBenchmark.h"
 #include "voxel/ChunkMesh.h"
+#include "voxel/MaterialColor.h"
 #include "voxel/RawVolume.h"
 #include "voxel/SurfaceExtractor.h"
 
@@ -91,20 +92,89 @@ public:
 	}
 };
 
+static void extract(const voxel::RawVolume &v, voxel::SurfaceExtractionType type, bool ambientOcclusion) {
+	const bool mergeQuads = true;
+	const bool reuseVertices = true;
+
+	voxel::ChunkMesh mesh;
+
+	voxel::Region region = v.region();
+	region.shiftUpperCorner(1, 1, 1);
+	voxel::SurfaceExtractionContext ctx = voxel::createContext(type, &v, region, voxel::getPalette(), mesh,
+															   glm::ivec3(0), mergeQuads, reuseVertices, ambientOcclusion);
+	voxel::extractSurface(ctx);
+}
+
 BENCHMARK_DEFINE_F(SurfaceExtractorBenchmark, Visit)(benchmark::State &state) {
 	for (auto _ : state) {
-		const bool mergeQuads = true;
-		const bool reuseVertices = true;
-		const bool ambientOcclusion = false;
+		extract(v, voxel::SurfaceExtractionType::Cubic, false);
+	}
+}
+
+BENCHMARK_DEFINE_F(SurfaceExtractorBenchmark, VisitBinary)(benchmark::State &state) {
+	for (auto _ : state) {
+		extract(v, voxel::SurfaceExtractionType::Binary, false);
+	}
+}
+
+/**
+ * @brief A chunk of the size that is used by the @c MeshState with a terrain like surface and some holes
+ */
+class SurfaceExtractorTerrainBenchmark : public app::AbstractBenchmark {
+protected:
+	voxel::RawVolume v{voxel::Region{0, 0, 0, 63, 63, 63}};
+
+public:
+	void SetUp(::benchmark::State &state) override {
+		app::AbstractBenchmark::SetUp(state);
+		for (int x = 0; x < 64; ++x) {
+			for (int z = 0; z < 64; ++z) {
+				const int height = 24 + (x * 3 + z * 5) % 17 + ((x / 8 + z / 8) % 2) * 8;
+				for (int y = 0; y < height; ++y) {
+					if ((x * 7 + y * 13 + z * 3) % 23 == 0) {
+						continue;
+					}
+					const uint8_t color = (uint8_t)(1 + y / 8);
+					if (y > height - 3 && (x + z) % 9 == 0) {
+						v.setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Transparent, color));
+					} else {
+						v.setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, color));
+					}
+				}
+			}
+		}
+	}
+};
+
+BENCHMARK_DEFINE_F(SurfaceExtractorTerrainBenchmark, Cubic)(benchmark::State &state) {
+	for (auto _ : state) {
+		extract(v, voxel::SurfaceExtractionType::Cubic, false);
+	}
+}
+
+BENCHMARK_DEFINE_F(SurfaceExtractorTerrainBenchmark, CubicAO)(benchmark::State &state) {
+	for (auto _ : state) {
+		extract(v, voxel::SurfaceExtractionType::Cubic, true);
+	}
+}
 
-		voxel::ChunkMesh mesh;
+BENCHMARK_DEFINE_F(SurfaceExtractorTerrainBenchmark, Binary)(benchmark::State &state) {
+	for (auto _ : state) {
+		extract(v, voxel::SurfaceExtractionType::Binary, false);
+	}
+}
 
-		voxel::SurfaceExtractionContext ctx =
-			voxel::buildCubicContext(&v, v.region(), mesh, glm::ivec3(0), mergeQuads, reuseVertices, ambientOcclusion);
-		voxel::extractSurface(ctx);
+BENCHMARK_DEFINE_F(SurfaceExtractorTerrainBenchmark, BinaryAO)(benchmark::State &state) {
+	for (auto _ : state) {
+		extract(v, voxel::SurfaceExtractionType::Binary, true);
 	}
 }
 
 BENCHMARK_REGISTER_F(SurfaceExtractorBenchmark, Visit);
+BENCHMARK_REGISTER_F(SurfaceExtractorBenchmark, VisitBinary);
+BENCHMARK_REGISTER_F(SurfaceExtractorTerrainBenchmark, Cubic);
+BENCHMARK_REGISTER_F(SurfaceExtractorTerrainBenchmark, CubicAO);
+BENCHMARK_REGISTER_F(SurfaceExtractorTerrainBenchmark, Binary);
+BENCHMARK_REGISTER_F(SurfaceExtractorTerrainBenchmark, BinaryAO);
 
 BENCHMARK_MAIN();
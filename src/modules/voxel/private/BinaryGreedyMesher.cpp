@@ -0,0 +1,455 @@
+/**
+ * @file
+ */
+
+#include "BinaryGreedyMesher.h"
+#include "core/Assert.h"
+#include "core/Bits.h"
+#include "core/Common.h"
+#include "core/NonCopyable.h"
+#include "core/StandardLib.h"
+#include "core/Trace.h"
+#include "voxel/ChunkMesh.h"
+#include "voxel/RawVolume.h"
+#include "voxel/Region.h"
+#include "voxel/Voxel.h"
+#include "voxel/VoxelVertex.h"
+#include <glm/common.hpp>
+#include <glm/vec3.hpp>
+
+namespace voxel {
+
+/**
+ * The amount of voxels per axis that are meshed in one tile. The tile is extended by one voxel on each side to be
+ * able to check the neighbours - and this must fit into the 64 bits of a column.
+ */
+static constexpr int TileSize = 62;
+static constexpr int PaddedSize = TileSize + 2;
+
+enum VoxelClass { VoxelClassOpaque, VoxelClassTransparent, VoxelClassMax };
+
+/**
+ * The two in-plane axes for each axis. The bits of the face rows are along the first of them.
+ */
+static constexpr int UAxis[3] = {1, 0, 0};
+static constexpr int VAxis[3] = {2, 2, 1};
+
+/**
+ * The corners of the quads (in u and v direction) in the same order as @c extractCubicMesh() is adding them. The
+ * negative x, positive y and negative z faces are using the first order - the other faces the second one.
+ */
+static constexpr int QuadCorners[2][4][2] = {{{0, 0}, {0, 1}, {1, 1}, {1, 0}}, {{0, 0}, {1, 0}, {1, 1}, {0, 1}}};
+
+struct TileData {
+	// [class][axis][v * PaddedSize + u] - bit n is set if the voxel at index n along the axis is of the class
+	uint64_t columns[VoxelClassMax][3][PaddedSize * PaddedSize];
+	// [plane][v] - bit u is set if a face is needed at this position of the plane
+	uint64_t faces[PaddedSize][PaddedSize];
+	// [v * PaddedSize + u] - the value that must be equal to be able to merge two faces
+	uint32_t keys[PaddedSize * PaddedSize];
+	// [v * PaddedSize + u] - the four ambient occlusion values of a face (two bits per corner)
+	uint8_t ao[PaddedSize * PaddedSize];
+	Voxel voxels[PaddedSize * PaddedSize * PaddedSize];
+};
+
+static constexpr int VoxelStride[3] = {1, PaddedSize, PaddedSize * PaddedSize};
+
+static CORE_FORCE_INLINE bool isOpaque(const Voxel &voxel) {
+	const VoxelType material = voxel.getMaterial();
+	return !isAir(material) && !isTransparent(material);
+}
+
+/**
+ * @sa vertexAmbientOcclusion() in the CubicSurfaceExtractor
+ */
+static CORE_FORCE_INLINE uint8_t cornerAmbientOcclusion(bool side1, bool side2, bool corner) {
+	if (side1 && side2) {
+		return 0;
+	}
+	return 3 - (side1 + side2 + corner);
+}
+
+/**
+ * @brief Open addressing hash table to find vertices that can get re-used. The key is the position in the region and
+ * the attributes of the vertex.
+ */
+class VertexCache : public core::NonCopyable {
+private:
+	struct Entry {
+		uint64_t pos;
+		uint32_t attributes;
+		// the index in the mesh plus one - 0 means the slot is empty
+		uint32_t index;
+	};
+	Entry *_entries = nullptr;
+	uint32_t _mask = 0u;
+	uint32_t _size = 0u;
+
+	static inline uint32_t hash(uint64_t pos, uint32_t attributes) {
+		uint64_t h = (pos ^ ((uint64_t)attributes << 40)) * UINT64_C(0x9E3779B97F4A7C15);
+		return (uint32_t)(h >> 32);
+	}
+
+	void grow() {
+		Entry *old = _entries;
+		const uint32_t oldCapacity = _mask + 1u;
+		const uint32_t capacity = old == nullptr ? 1024u : oldCapacity * 2u;
+		_entries = (Entry *)core_malloc(capacity * sizeof(Entry));
+		core_memset(_entries, 0, capacity * sizeof(Entry));
+		_mask = capacity - 1u;
+		if (old == nullptr) {
+			return;
+		}
+		for (uint32_t i = 0; i < oldCapacity; ++i) {
+			if (old[i].index == 0u) {
+				continue;
+			}
+			uint32_t slot = hash(old[i].pos, old[i].attributes) & _mask;
+			while (_entries[slot].index != 0u) {
+				slot = (slot + 1u) & _mask;
+			}
+			_entries[slot] = old[i];
+		}
+		core_free(old);
+	}
+
+public:
+	~VertexCache() {
+		core_free(_entries);
+	}
+
+	/**
+	 * @return The pointer to the index slot - if the value is @c 0 the vertex must be added and the index must be set
+	 */
+	uint32_t *find(uint64_t pos, uint32_t attributes) {
+		if ((_size + 1u) * 2u > _mask + 1u) {
+			grow();
+		}
+		uint32_t slot = hash(pos, attributes) & _mask;
+		for (;;) {
+			Entry &entry = _entries[slot];
+			if (entry.index == 0u) {
+				entry.pos = pos;
+				entry.attributes = attributes;
+				++_size;
+				return &entry.index;
+			}
+			if (entry.pos == pos && entry.attributes == attributes) {
+				return &entry.index;
+			}
+			slot = (slot + 1u) & _mask;
+		}
+	}
+};
+
+struct MeshTarget {
+	Mesh *mesh;
+	VertexCache cache;
+};
+
+struct MeshingContext {
+	const glm::ivec3 &translate;
+	bool mergeQuads;
+	bool reuseVertices;
+	bool ambientOcclusion;
+	MeshTarget targets[VoxelClassMax];
+};
+
+static IndexType addVertex(MeshingContext &ctx, MeshTarget &target, const glm::ivec3 &pos, const Voxel &voxel,
+						   uint8_t ambientOcclusion) {
+	uint32_t *cachedIndex = nullptr;
+	if (ctx.reuseVertices) {
+		const uint64_t posKey = (uint64_t)(uint32_t)pos.x | ((uint64_t)(uint32_t)pos.y << 21) |
+								((uint64_t)(uint32_t)pos.z << 42);
+		const uint32_t attributes = (uint32_t)voxel.getColor() | ((uint32_t)voxel.getNormal() << 8) |
+									((uint32_t)voxel.getFlags() << 16) | ((uint32_t)ambientOcclusion << 17);
+		cachedIndex = target.cache.find(posKey, attributes);
+		if (*cachedIndex != 0u) {
+			return *cachedIndex - 1u;
+		}
+	}
+	VoxelVertex vertex;
+	vertex.position = pos + ctx.translate;
+	vertex.colorIndex = voxel.getColor();
+	vertex.normalIndex = voxel.getNormal();
+	vertex.ambientOcclusion = ambientOcclusion;
+	vertex.flags = voxel.getFlags();
+	vertex.padding = 0u; // Voxel::_unused
+	vertex.padding2 = 0u;
+	const IndexType index = target.mesh->addVertex(vertex);
+	if (cachedIndex != nullptr) {
+		*cachedIndex = index + 1u;
+	}
+	return index;
+}
+
+/**
+ * @brief Copy the voxels of the padded tile and build the occupancy columns for each axis
+ * @return @c false if there are no solid voxels in the tile
+ */
+static bool fillTile(const RawVolume *volData, const glm::ivec3 &tileMins, const glm::ivec3 &paddedSize,
+					 TileData &tile) {
+	core_trace_scoped(BinaryMesherFillTile);
+	const Voxel &border = volData->borderValue();
+	const Region &volumeRegion = volData->region();
+	const glm::ivec3 &volumeMins = volumeRegion.getLowerCorner();
+	const glm::ivec3 tileMaxs = tileMins + paddedSize - 1;
+	const glm::ivec3 copyMins = glm::max(tileMins, volumeMins);
+	const glm::ivec3 copyMaxs = glm::min(tileMaxs, volumeRegion.getUpperCorner());
+	const bool inside = glm::all(glm::lessThanEqual(copyMins, copyMaxs));
+	if (!inside && isAir(border.getMaterial())) {
+		return false;
+	}
+
+	for (int z = 0; z < paddedSize.z; ++z) {
+		for (int y = 0; y < paddedSize.y; ++y) {
+			Voxel *row = &tile.voxels[y * VoxelStride[1] + z * VoxelStride[2]];
+			for (int x = 0; x < paddedSize.x; ++x) {
+				row[x] = border;
+			}
+		}
+	}
+	if (inside) {
+		const Voxel *data = (const Voxel *)volData->data();
+		const int width = volumeRegion.getWidthInVoxels();
+		const int stride = volumeRegion.stride();
+		const int copyWidth = copyMaxs.x - copyMins.x + 1;
+		for (int z = copyMins.z; z <= copyMaxs.z; ++z) {
+			for (int y = copyMins.y; y <= copyMaxs.y; ++y) {
+				const Voxel *src = data + (copyMins.x - volumeMins.x) + (y - volumeMins.y) * width +
+								   (z - volumeMins.z) * stride;
+				Voxel *dst = &tile.voxels[(copyMins.x - tileMins.x) + (y - tileMins.y) * VoxelStride[1] +
+										  (z - tileMins.z) * VoxelStride[2]];
+				core_memcpy(dst, src, copyWidth * sizeof(Voxel));
+			}
+		}
+	}
+
+	core_memset(tile.columns, 0, sizeof(tile.columns));
+	bool solid = false;
+	for (int z = 0; z < paddedSize.z; ++z) {
+		for (int y = 0; y < paddedSize.y; ++y) {
+			const Voxel *row = &tile.voxels[y * VoxelStride[1] + z * VoxelStride[2]];
+			for (int x = 0; x < paddedSize.x; ++x) {
+				const VoxelType material = row[x].getMaterial();
+				if (isAir(material)) {
+					continue;
+				}
+				const int voxelClass = isTransparent(material) ? VoxelClassTransparent : VoxelClassOpaque;
+				uint64_t(*columns)[PaddedSize * PaddedSize] = tile.columns[voxelClass];
+				columns[0][z * PaddedSize + y] |= UINT64_C(1) << x;
+				columns[1][z * PaddedSize + x] |= UINT64_C(1) << y;
+				columns[2][y * PaddedSize + x] |= UINT64_C(1) << z;
+				solid = true;
+			}
+		}
+	}
+	return solid;
+}
+
+/**
+ * @brief Compute the merge keys and the ambient occlusion values for all faces of the given plane
+ */
+static void prepareFaces(const MeshingContext &ctx, TileData &tile, int axis, bool negative, int plane) {
+	const int ua = UAxis[axis];
+	const int va = VAxis[axis];
+	const int ownerPlane = negative ? plane : plane - 1;
+	const int frontPlane = negative ? plane - 1 : plane;
+	const int du = VoxelStride[ua];
+	const int dv = VoxelStride[va];
+	for (int v = 0; v < PaddedSize; ++v) {
+		uint64_t row = tile.faces[plane][v];
+		while (row != 0u) {
+			const int u = core::countTrailingZeros(row);
+			row &= row - 1u;
+			const Voxel &owner = tile.voxels[ownerPlane * VoxelStride[axis] + u * du + v * dv];
+			const int front = frontPlane * VoxelStride[axis] + u * du + v * dv;
+			// 0: -u, 1: +u, 2: -v, 3: +v and the diagonals
+			const bool sideNU = isOpaque(tile.voxels[front - du]);
+			const bool sidePU = isOpaque(tile.voxels[front + du]);
+			const bool sideNV = isOpaque(tile.voxels[front - dv]);
+			const bool sidePV = isOpaque(tile.voxels[front + dv]);
+			const uint8_t ao00 = cornerAmbientOcclusion(sideNU, sideNV, isOpaque(tile.voxels[front - du - dv]));
+			const uint8_t ao10 = cornerAmbientOcclusion(sidePU, sideNV, isOpaque(tile.voxels[front + du - dv]));
+			const uint8_t ao01 = cornerAmbientOcclusion(sideNU, sidePV, isOpaque(tile.voxels[front - du + dv]));
+			const uint8_t ao11 = cornerAmbientOcclusion(sidePU, sidePV, isOpaque(tile.voxels[front + du + dv]));
+			const uint8_t ao = ao00 | (ao10 << 2) | (ao01 << 4) | (ao11 << 6);
+			uint32_t key = (uint32_t)owner.getColor() | ((uint32_t)owner.getNormal() << 8) |
+						   ((uint32_t)owner.getFlags() << 16);
+			if (ctx.ambientOcclusion) {
+				key |= (uint32_t)ao << 17;
+			}
+			tile.keys[v * PaddedSize + u] = key;
+			tile.ao[v * PaddedSize + u] = ao;
+		}
+	}
+}
+
+static void addQuad(MeshingContext &ctx, MeshTarget &target, const TileData &tile, const glm::ivec3 &tileOffset,
+					int axis, bool negative, int plane, int u0, int v0, int uSize, int vSize) {
+	const int ua = UAxis[axis];
+	const int va = VAxis[axis];
+	const int ownerPlane = negative ? plane : plane - 1;
+	const Voxel &owner = tile.voxels[ownerPlane * VoxelStride[axis] + u0 * VoxelStride[ua] + v0 * VoxelStride[va]];
+	const int cornerOrder = ((axis == 1) == negative) ? 1 : 0;
+
+	IndexType indices[4];
+	uint8_t aos[4];
+	for (int i = 0; i < 4; ++i) {
+		const int cu = QuadCorners[cornerOrder][i][0];
+		const int cv = QuadCorners[cornerOrder][i][1];
+		const int cellU = cu ? u0 + uSize - 1 : u0;
+		const int cellV = cv ? v0 + vSize - 1 : v0;
+		const uint8_t ao = (tile.ao[cellV * PaddedSize + cellU] >> ((cu + cv * 2) * 2)) & 3u;
+		glm::ivec3 pos;
+		pos[axis] = plane + tileOffset[axis];
+		pos[ua] = (cu ? u0 + uSize : u0) + tileOffset[ua];
+		pos[va] = (cv ? v0 + vSize : v0) + tileOffset[va];
+		indices[i] = addVertex(ctx, target, pos, owner, ao);
+		aos[i] = ao;
+	}
+
+	// see isQuadFlipped() in the CubicSurfaceExtractor
+	if (aos[3] + aos[1] > aos[0] + aos[2]) {
+		target.mesh->addTriangle(indices[1], indices[2], indices[3]);
+		target.mesh->addTriangle(indices[1], indices[3], indices[0]);
+	} else {
+		target.mesh->addTriangle(indices[0], indices[1], indices[2]);
+		target.mesh->addTriangle(indices[0], indices[2], indices[3]);
+	}
+}
+
+/**
+ * @brief Greedy merge of the faces of one plane. The faces of a row are collected as bits and the runs of faces with
+ * the same key are extended to the following rows as long as they contain the same run.
+ */
+static void meshPlane(MeshingContext &ctx, MeshTarget &target, TileData &tile, const glm::ivec3 &tileOffset, int axis,
+					  bool negative, int plane) {
+	uint64_t *rows = tile.faces[plane];
+	for (int v = 0; v < PaddedSize; ++v) {
+		while (rows[v] != 0u) {
+			const int u0 = core::countTrailingZeros(rows[v]);
+			const uint32_t *keys = &tile.keys[v * PaddedSize];
+			const uint32_t key = keys[u0];
+			int uSize = 1;
+			if (ctx.mergeQuads) {
+				while (u0 + uSize < PaddedSize && (rows[v] & (UINT64_C(1) << (u0 + uSize))) != 0u &&
+					   keys[u0 + uSize] == key) {
+					++uSize;
+				}
+			}
+			const uint64_t runMask = ((UINT64_C(1) << uSize) - 1u) << u0;
+			rows[v] &= ~runMask;
+
+			int vSize = 1;
+			if (ctx.mergeQuads) {
+				for (int nextV = v + 1; nextV < PaddedSize; ++nextV) {
+					if ((rows[nextV] & runMask) != runMask) {
+						break;
+					}
+					const uint32_t *nextKeys = &tile.keys[nextV * PaddedSize];
+					bool same = true;
+					for (int u = u0; u < u0 + uSize; ++u) {
+						if (nextKeys[u] != key) {
+							same = false;
+							break;
+						}
+					}
+					if (!same) {
+						break;
+					}
+					rows[nextV] &= ~runMask;
+					++vSize;
+				}
+			}
+			addQuad(ctx, target, tile, tileOffset, axis, negative, plane, u0, v, uSize, vSize);
+		}
+	}
+}
+
+static void meshTile(MeshingContext &ctx, TileData &tile, const glm::ivec3 &paddedSize, const glm::ivec3 &tileOffset) {
+	core_trace_scoped(BinaryMesherTile);
+	for (int voxelClass = 0; voxelClass < VoxelClassMax; ++voxelClass) {
+		MeshTarget &target = ctx.targets[voxelClass];
+		for (int axis = 0; axis < 3; ++axis) {
+			const int ua = UAxis[axis];
+			const int va = VAxis[axis];
+			// only the inner voxels are meshed - the first and the last one are the border voxels
+			const uint64_t planeMask = ((UINT64_C(1) << (paddedSize[axis] - 1)) - 1u) & ~UINT64_C(1);
+			const uint64_t *columns = tile.columns[voxelClass][axis];
+			for (int n = 0; n < 2; ++n) {
+				const bool negative = n == 0;
+				core_memset(tile.faces, 0, sizeof(tile.faces));
+				uint64_t planes = 0u;
+				for (int v = 1; v < paddedSize[va] - 1; ++v) {
+					for (int u = 1; u < paddedSize[ua] - 1; ++u) {
+						const uint64_t column = columns[v * PaddedSize + u];
+						// a face is needed if the neighbour voxel in face direction is not of the same class
+						uint64_t faceBits = negative ? column & ~(column << 1) : (column << 1) & ~column;
+						faceBits &= planeMask;
+						planes |= faceBits;
+						while (faceBits != 0u) {
+							const int plane = core::countTrailingZeros(faceBits);
+							faceBits &= faceBits - 1u;
+							tile.faces[plane][v] |= UINT64_C(1) << u;
+						}
+					}
+				}
+				while (planes != 0u) {
+					const int plane = core::countTrailingZeros(planes);
+					planes &= planes - 1u;
+					prepareFaces(ctx, tile, axis, negative, plane);
+					meshPlane(ctx, target, tile, tileOffset, axis, negative, plane);
+				}
+			}
+		}
+	}
+}
+
+void extractBinaryGreedyMesh(const voxel::RawVolume *volData, const Region &region, ChunkMesh *result,
+							 const glm::ivec3 &translate, bool mergeQuads, bool reuseVertices, bool ambientOcclusion,
+							 bool optimize) {
+	core_trace_scoped(ExtractBinaryGreedyMesh);
+
+	result->clear();
+	const glm::ivec3 &offset = region.getLowerCorner();
+	const glm::ivec3 &upper = region.getUpperCorner();
+	result->setOffset(offset);
+
+	MeshingContext ctx{translate, mergeQuads, reuseVertices, ambientOcclusion, {}};
+	ctx.targets[VoxelClassOpaque].mesh = &result->mesh[0];
+	ctx.targets[VoxelClassTransparent].mesh = &result->mesh[1];
+
+	// split the region into tiles of (almost) equal size
+	const glm::ivec3 dimensions = upper - offset + 1;
+	const glm::ivec3 tileCount = (dimensions + TileSize - 1) / TileSize;
+	const glm::ivec3 tileDimensions = (dimensions + tileCount - 1) / tileCount;
+
+	TileData *tile = (TileData *)core_malloc(sizeof(TileData));
+	for (int tz = 0; tz < tileCount.z; ++tz) {
+		for (int ty = 0; ty < tileCount.y; ++ty) {
+			for (int tx = 0; tx < tileCount.x; ++tx) {
+				const glm::ivec3 tileLower = offset + glm::ivec3(tx, ty, tz) * tileDimensions;
+				const glm::ivec3 tileUpper = glm::min(tileLower + tileDimensions - 1, upper);
+				// the padded tile starts one voxel before the lower corner
+				const glm::ivec3 tileMins = tileLower - 1;
+				const glm::ivec3 paddedSize = tileUpper - tileLower + 3;
+				core_assert(glm::all(glm::lessThanEqual(paddedSize, glm::ivec3(PaddedSize))));
+				if (!fillTile(volData, tileMins, paddedSize, *tile)) {
+					continue;
+				}
+				// converts the tile coordinates into region coordinates
+				meshTile(ctx, *tile, paddedSize, tileMins - offset);
+			}
+		}
+	}
+	core_free(tile);
+
+	if (optimize) {
+		result->optimize();
+	}
+	result->removeUnusedVertices();
+	result->compressIndices();
+}
+
+} // namespace voxel
@@ -0,0 +1,34 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include <glm/fwd.hpp>
+
+namespace voxel {
+
+class RawVolume;
+class Region;
+struct ChunkMesh;
+
+/**
+ * @brief Cubic mesh extraction that is based on binary greedy meshing
+ *
+ * The region is processed in tiles of at most 62 voxels per axis. The occupancy of the opaque and the transparent
+ * voxels of a tile (plus a border of one voxel) is stored as 64 bit columns along each axis. The visible faces are
+ * found by shifting and masking these columns and the quads of a plane are merged by operating on the bits of the
+ * face rows. There are no per quad allocations like in @c extractCubicMesh().
+ *
+ * The output follows the same rules as @c extractCubicMesh() - the boundary handling of the region, the ambient
+ * occlusion values and the separation of opaque and transparent voxels into the two meshes of the @c ChunkMesh are
+ * the same. The quads are merged in a different order though - so the amount of vertices and indices might differ
+ * if @c mergeQuads is @c true. Quads are not merged across tile boundaries.
+ *
+ * @sa extractCubicMesh()
+ */
+void extractBinaryGreedyMesh(const voxel::RawVolume *volData, const Region &region, ChunkMesh *result,
+							 const glm::ivec3 &translate, bool mergeQuads = true, bool reuseVertices = true,
+							 bool ambientOcclusion = true, bool optimize = false);
+
+} // namespace voxel
@@ -0,0 +1,60 @@
+/**
+ * @file
+ */
+
+#include "voxel/DirtyRegions.h"
+#include "app/tests/AbstractTest.h"
+#include "voxel/RawVolume.h"
+#include "voxel/RawVolumeWrapper.h"
+
+namespace voxel {
+
+class DirtyRegionsTest : public app::AbstractTest {};
+
+TEST_F(DirtyRegionsTest, testEmpty) {
+	DirtyRegions dirty;
+	EXPECT_TRUE(dirty.empty());
+	EXPECT_FALSE(dirty.bounds().isValid());
+	EXPECT_TRUE(dirty.regions().empty());
+}
+
+TEST_F(DirtyRegionsTest, testScatteredEdits) {
+	DirtyRegions dirty;
+	dirty.add(glm::ivec3(0, 0, 0));
+	dirty.add(glm::ivec3(200, 100, 200));
+	EXPECT_EQ(dirty.bounds(), Region(glm::ivec3(0), glm::ivec3(200, 100, 200)));
+	const core::DynamicArray<Region> &regions = dirty.regions();
+	ASSERT_EQ(2u, regions.size());
+	EXPECT_EQ(regions[0], Region(glm::ivec3(0), glm::ivec3(DirtyRegions::CellSize - 1)));
+	EXPECT_EQ(regions[1], Region(glm::ivec3(192, 96, 192), glm::ivec3(200, 100, 200)));
+}
+
+TEST_F(DirtyRegionsTest, testMergeNeighbours) {
+	DirtyRegions dirty;
+	dirty.add(Region(glm::ivec3(0), glm::ivec3(40, 0, 0)));
+	const core::DynamicArray<Region> &regions = dirty.regions();
+	ASSERT_EQ(1u, regions.size());
+	EXPECT_EQ(regions[0], Region(glm::ivec3(0), glm::ivec3(40, 0, 0)));
+}
+
+TEST_F(DirtyRegionsTest, testOverflow) {
+	DirtyRegions dirty;
+	const Region region(glm::ivec3(-1000), glm::ivec3(1000));
+	dirty.add(region);
+	EXPECT_TRUE(dirty.overflow());
+	const core::DynamicArray<Region> &regions = dirty.regions();
+	ASSERT_EQ(1u, regions.size());
+	EXPECT_EQ(regions[0], region);
+}
+
+TEST_F(DirtyRegionsTest, testRawVolumeWrapper) {
+	RawVolume v(Region(0, 127));
+	RawVolumeWrapper wrapper(&v);
+	const voxel::Voxel voxel = voxel::createVoxel(VoxelType::Generic, 1);
+	wrapper.setVoxel(1, 1, 1, voxel);
+	wrapper.setVoxel(126, 126, 126, voxel);
+	EXPECT_EQ(wrapper.dirtyRegion(), Region(1, 126));
+	EXPECT_EQ(2u, wrapper.dirtyRegions().regions().size());
+}
+
+} // namespace voxel
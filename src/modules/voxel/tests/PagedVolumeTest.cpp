@@ -0,0 +1,137 @@
+/**
+ * @file
+ */
+
+#include "voxel/PagedVolume.h"
+#include "app/tests/AbstractTest.h"
+#include "voxel/RawVolume.h"
+#include "voxel/RawVolumeWrapper.h"
+#include "voxel/Region.h"
+#include "voxel/Voxel.h"
+
+namespace voxel {
+
+class PagedVolumeTest : public app::AbstractTest {};
+
+TEST_F(PagedVolumeTest, testSetVoxels) {
+	voxel::PagedVolume v(voxel::Region(0, 40));
+	ASSERT_EQ(0u, v.chunks());
+	ASSERT_TRUE(v.empty());
+	ASSERT_TRUE(v.setVoxel(0, 0, 0, voxel::createVoxel(VoxelType::Generic, 1)));
+	ASSERT_EQ(1u, v.chunks());
+	ASSERT_TRUE(v.setVoxel(40, 40, 40, voxel::createVoxel(VoxelType::Generic, 2)));
+	ASSERT_EQ(2u, v.chunks());
+	ASSERT_FALSE(v.setVoxel(41, 41, 41, voxel::createVoxel(VoxelType::Generic, 2)));
+	ASSERT_EQ(2u, v.chunks());
+	ASSERT_FALSE(v.setVoxel(-1, 0, 0, voxel::createVoxel(VoxelType::Generic, 1)));
+	EXPECT_EQ(1, v.voxel(0, 0, 0).getColor());
+	EXPECT_EQ(2, v.voxel(40, 40, 40).getColor());
+	EXPECT_TRUE(voxel::isAir(v.voxel(1, 0, 0).getMaterial()));
+	EXPECT_TRUE(voxel::isAir(v.voxel(100, 0, 0).getMaterial()));
+}
+
+TEST_F(PagedVolumeTest, testNegativeCoordinates) {
+	voxel::PagedVolume v;
+	ASSERT_TRUE(v.setVoxel(-1, -33, -64, voxel::createVoxel(VoxelType::Generic, 3)));
+	EXPECT_EQ(3, v.voxel(-1, -33, -64).getColor());
+	EXPECT_TRUE(voxel::isAir(v.voxel(0, -33, -64).getMaterial()));
+	const voxel::Region &region = v.calculateRegion();
+	EXPECT_EQ(glm::ivec3(-1, -33, -64), region.getLowerCorner());
+	EXPECT_EQ(glm::ivec3(-1, -33, -64), region.getUpperCorner());
+	const voxel::Region &chunkRegion = v.chunkRegion();
+	EXPECT_EQ(glm::ivec3(-32, -64, -64), chunkRegion.getLowerCorner());
+	EXPECT_EQ(glm::ivec3(-1, -33, -33), chunkRegion.getUpperCorner());
+}
+
+TEST_F(PagedVolumeTest, testOptimizeUniformChunks) {
+	const voxel::Region region(0, PagedVolume::ChunkSideLength * 2 - 1);
+	voxel::PagedVolume v(region);
+	const voxel::Voxel voxel = voxel::createVoxel(VoxelType::Generic, 1);
+	for (int z = 0; z < PagedVolume::ChunkSideLength; ++z) {
+		for (int y = 0; y < PagedVolume::ChunkSideLength; ++y) {
+			for (int x = 0; x < PagedVolume::ChunkSideLength; ++x) {
+				ASSERT_TRUE(v.setVoxel(x, y, z, voxel));
+			}
+		}
+	}
+	// set and reset a voxel in another chunk - this chunk only contains air afterwards
+	ASSERT_TRUE(v.setVoxel(40, 40, 40, voxel));
+	ASSERT_TRUE(v.setVoxel(40, 40, 40, voxel::Voxel()));
+	ASSERT_EQ(2u, v.chunks());
+	const size_t memoryBefore = v.memory();
+	v.optimize();
+	ASSERT_EQ(1u, v.chunks());
+	EXPECT_LT(v.memory(), memoryBefore);
+	EXPECT_EQ(voxel, v.voxel(5, 6, 7));
+	EXPECT_TRUE(voxel::isAir(v.voxel(40, 40, 40).getMaterial()));
+	const voxel::Region &voxelRegion = v.calculateRegion();
+	EXPECT_EQ(glm::ivec3(0), voxelRegion.getLowerCorner());
+	EXPECT_EQ(glm::ivec3(PagedVolume::ChunkSideLength - 1), voxelRegion.getUpperCorner());
+
+	// modifying a uniform chunk converts it back
+	ASSERT_TRUE(v.setVoxel(1, 1, 1, voxel::createVoxel(VoxelType::Generic, 2)));
+	EXPECT_EQ(2, v.voxel(1, 1, 1).getColor());
+	EXPECT_EQ(1, v.voxel(1, 1, 2).getColor());
+}
+
+TEST_F(PagedVolumeTest, testCompressColdChunks) {
+	voxel::PagedVolume v;
+	ASSERT_TRUE(v.setVoxel(1, 2, 3, voxel::createVoxel(VoxelType::Generic, 1)));
+	ASSERT_TRUE(v.setVoxel(100, 2, 3, voxel::createVoxel(VoxelType::Generic, 2)));
+	// the chunks were just modified
+	EXPECT_EQ(0, v.compress());
+	const size_t memoryBefore = v.memory();
+	EXPECT_EQ(2, v.compress());
+	EXPECT_LT(v.memory(), memoryBefore);
+	// accessing the voxel decompresses the chunk
+	EXPECT_EQ(1, v.voxel(1, 2, 3).getColor());
+	EXPECT_TRUE(voxel::isAir(v.voxel(1, 2, 4).getMaterial()));
+	EXPECT_EQ(0, v.compress());
+	EXPECT_EQ(2, v.voxel(100, 2, 3).getColor());
+	EXPECT_EQ(1, v.compress());
+}
+
+TEST_F(PagedVolumeTest, testCopyToRawVolume) {
+	const voxel::Region region(0, 40);
+	const voxel::Voxel voxel = voxel::createVoxel(VoxelType::Generic, 0);
+	voxel::PagedVolume v(region);
+	voxel::RawVolume rv(region);
+	for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+		for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+			for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+				ASSERT_TRUE(v.setVoxel(x, y, z, voxel));
+			}
+		}
+	}
+	voxel::RawVolumeWrapper rvw(&rv);
+	v.copyTo(rvw);
+	for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+		for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+			for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+				ASSERT_EQ(voxel, rv.voxel(x, y, z));
+			}
+		}
+	}
+}
+
+TEST_F(PagedVolumeTest, testSampler) {
+	voxel::PagedVolume v;
+	ASSERT_TRUE(v.setVoxel(31, 0, 0, voxel::createVoxel(VoxelType::Generic, 1)));
+	ASSERT_TRUE(v.setVoxel(32, 0, 0, voxel::createVoxel(VoxelType::Generic, 2)));
+	PagedVolume::Sampler sampler(v);
+	ASSERT_TRUE(sampler.setPosition(30, 0, 0));
+	EXPECT_TRUE(voxel::isAir(sampler.voxel().getMaterial()));
+	EXPECT_EQ(1, sampler.peekVoxel1px0py0pz().getColor());
+	sampler.movePositiveX();
+	EXPECT_EQ(1, sampler.voxel().getColor());
+	sampler.movePositiveX();
+	EXPECT_EQ(2, sampler.voxel().getColor());
+	EXPECT_EQ(1, sampler.peekVoxel1nx0py0pz().getColor());
+	sampler.movePositiveY(40);
+	EXPECT_TRUE(voxel::isAir(sampler.voxel().getMaterial()));
+	ASSERT_TRUE(sampler.setVoxel(voxel::createVoxel(VoxelType::Generic, 3)));
+	EXPECT_EQ(3, sampler.voxel().getColor());
+	EXPECT_EQ(3, v.voxel(32, 40, 0).getColor());
+}
+
+} // namespace voxel
@@ -0,0 +1,103 @@
+/**
+ * @file
+ */
+
+#include "voxel/ParallelRegion.h"
+#include "AbstractVoxelTest.h"
+#include "core/Trace.h"
+#include "core/collection/DynamicArray.h"
+#include "core/concurrent/Lock.h"
+
+namespace voxel {
+
+class ParallelRegionTest : public AbstractVoxelTest {
+protected:
+	core::DynamicArray<Region> slices(const Region &region, int sliceDepth) {
+		core::DynamicArray<Region> result;
+		core_trace_mutex(core::Lock, lock, "ParallelRegionTest");
+		parallelFor(
+			region,
+			[&](const Region &slice) {
+				core::ScopedLock scoped(lock);
+				result.push_back(slice);
+			},
+			sliceDepth);
+		return result;
+	}
+
+	// every z layer of the region must be part of exactly one slice - and the slices must span the whole x and y range
+	void checkSlices(const Region &region, int sliceDepth) {
+		const core::DynamicArray<Region> &result = slices(region, sliceDepth);
+		ASSERT_FALSE(result.empty());
+		core::DynamicArray<int> visits;
+		visits.resize(region.getDepthInVoxels());
+		visits.fill(0);
+		for (const Region &slice : result) {
+			ASSERT_TRUE(slice.isValid()) << slice.toString().c_str();
+			EXPECT_EQ(region.getLowerX(), slice.getLowerX());
+			EXPECT_EQ(region.getLowerY(), slice.getLowerY());
+			EXPECT_EQ(region.getUpperX(), slice.getUpperX());
+			EXPECT_EQ(region.getUpperY(), slice.getUpperY());
+			ASSERT_GE(slice.getLowerZ(), region.getLowerZ()) << slice.toString().c_str();
+			ASSERT_LE(slice.getUpperZ(), region.getUpperZ()) << slice.toString().c_str();
+			if (sliceDepth > 0) {
+				EXPECT_EQ(0, (slice.getLowerZ() - region.getLowerZ()) % sliceDepth) << slice.toString().c_str();
+				if (slice.getUpperZ() != region.getUpperZ()) {
+					EXPECT_EQ(sliceDepth, slice.getDepthInVoxels()) << slice.toString().c_str();
+				} else {
+					EXPECT_LE(slice.getDepthInVoxels(), sliceDepth) << slice.toString().c_str();
+				}
+			}
+			for (int z = slice.getLowerZ(); z <= slice.getUpperZ(); ++z) {
+				++visits[z - region.getLowerZ()];
+			}
+		}
+		for (int i = 0; i < (int)visits.size(); ++i) {
+			EXPECT_EQ(1, visits[i]) << "z layer " << region.getLowerZ() + i;
+		}
+	}
+};
+
+TEST_F(ParallelRegionTest, testDefaultSliceDepth) {
+	checkSlices(Region(0, 0, 0, 15, 7, 63), 0);
+}
+
+TEST_F(ParallelRegionTest, testSliceDepth) {
+	const Region region(0, 0, 0, 15, 7, 63);
+	checkSlices(region, 1);
+	checkSlices(region, 16);
+	// the last slice is smaller
+	checkSlices(region, 10);
+	EXPECT_EQ(7u, slices(region, 10).size());
+	// a single slice for the whole region
+	checkSlices(region, 64);
+	checkSlices(region, 100);
+}
+
+TEST_F(ParallelRegionTest, testNegativeLowerCorner) {
+	const Region region(-5, -3, -33, 4, 2, 30);
+	checkSlices(region, 0);
+	checkSlices(region, 8);
+	checkSlices(Region(-20, -20, -20, -10, -10, -10), 3);
+}
+
+TEST_F(ParallelRegionTest, testUpperBounds) {
+	// the upper z layer is part of the last slice - and not beyond it
+	const Region region(0, 0, 5, 3, 3, 9);
+	const core::DynamicArray<Region> &result = slices(region, 2);
+	ASSERT_EQ(3u, result.size());
+	int upperZ = region.getLowerZ() - 1;
+	for (const Region &slice : result) {
+		upperZ = core_max(upperZ, slice.getUpperZ());
+	}
+	EXPECT_EQ(region.getUpperZ(), upperZ);
+	checkSlices(Region(0, 0, 7, 3, 3, 7), 0);
+	checkSlices(Region(0, 0, 7, 3, 3, 7), 4);
+}
+
+TEST_F(ParallelRegionTest, testInvalidRegion) {
+	EXPECT_TRUE(slices(Region::InvalidRegion, 0).empty());
+	EXPECT_TRUE(slices(Region(0, 0, 10, 3, 3, 5), 1).empty());
+}
+
+} // namespace voxel
@@ -5,7 +5,9 @@
 #include "AbstractVoxelTest.h"
 #include "core/collection/DynamicArray.h"
 #include "voxel/RawVolume.h"
+#include "voxel/RawVolumeSnapshot.h"
 #include "voxel/Voxel.h"
+#include <thread>
 
 namespace voxel {
 
@@ -245,4 +247,188 @@ TEST_F(RawVolumeTest, testFullSamplerLoop) {
 	}
 }
 
+TEST_F(RawVolumeTest, testSnapshot) {
+	RawVolume v(_region);
+	pageIn(v.region(), v);
+	RawVolumeSnapshot snapshot(&v, Region(0, 0, 0, 2, 0, 2));
+	bool onlyAir = true;
+	const RawVolume *copy = snapshot.materialize(&onlyAir);
+	ASSERT_NE(nullptr, copy);
+	EXPECT_FALSE(onlyAir);
+	EXPECT_EQ(Region(0, 0, 0, 2, 0, 2), copy->region());
+	EXPECT_EQ(5, copy->voxel(1, 0, 1).getColor());
+	// modifications after materializing the snapshot are not visible
+	EXPECT_TRUE(v.setVoxel(1, 0, 1, voxel::createVoxel(VoxelType::Generic, 42)));
+	EXPECT_EQ(5, copy->voxel(1, 0, 1).getColor());
+	EXPECT_EQ(copy, snapshot.materialize());
+}
+
+TEST_F(RawVolumeTest, testSnapshotDetachOnModification) {
+	RawVolume v(_region);
+	pageIn(v.region(), v);
+	RawVolumeSnapshot snapshot(&v, Region(0, 0, 0, 1, 0, 1));
+	RawVolumeSnapshot samplerSnapshot(&v, Region(2, 0, 2, 2, 0, 2));
+	RawVolumeSnapshot untouched(&v, Region(0, 1, 0, 2, 2, 2));
+	// the voxels of the snapshot are copied before the volume is modified
+	EXPECT_TRUE(v.setVoxel(1, 0, 1, voxel::createVoxel(VoxelType::Generic, 42)));
+	RawVolume::Sampler sampler(v);
+	ASSERT_TRUE(sampler.setPosition(2, 0, 2));
+	EXPECT_TRUE(sampler.setVoxel(voxel::createVoxel(VoxelType::Generic, 43)));
+	EXPECT_EQ(5, snapshot.materialize()->voxel(1, 0, 1).getColor());
+	EXPECT_EQ(9, samplerSnapshot.materialize()->voxel(2, 0, 2).getColor());
+	v.clear();
+	EXPECT_EQ(VoxelType::Generic, untouched.materialize()->voxel(1, 2, 1).getMaterial());
+}
+
+TEST_F(RawVolumeTest, testSnapshotOutlivesVolume) {
+	RawVolume *v = new RawVolume(_region);
+	pageIn(v->region(), *v);
+	const Region region(v->region().getLowerCorner() - 2, v->region().getLowerCorner() + 2);
+	RawVolumeSnapshot snapshot(v, region);
+	RawVolumeSnapshot air(v, Region(10, 10, 10, 12, 12, 12));
+	delete v;
+	const RawVolume *copy = snapshot.materialize();
+	ASSERT_NE(nullptr, copy);
+	EXPECT_EQ(1, copy->voxel(0, 0, 0).getColor());
+	bool onlyAir = false;
+	air.materialize(&onlyAir);
+	EXPECT_TRUE(onlyAir);
+}
+
+TEST_F(RawVolumeTest, testSnapshotRegisteredAfterModification) {
+	RawVolume v(_region);
+	pageIn(v.region(), v);
+	RawVolumeSnapshot first(&v, Region(0, 0, 0, 0, 0, 0));
+	// the brick of this position is checked against the snapshots once
+	EXPECT_TRUE(v.setVoxel(1, 0, 1, voxel::createVoxel(VoxelType::Generic, 42)));
+	// a snapshot that is registered afterwards must still see the old voxels of the same brick
+	RawVolumeSnapshot second(&v, Region(2, 0, 2, 2, 0, 2));
+	EXPECT_TRUE(v.setVoxel(2, 0, 2, voxel::createVoxel(VoxelType::Generic, 43)));
+	EXPECT_EQ(9, second.materialize()->voxel(2, 0, 2).getColor());
+	EXPECT_EQ(1, first.materialize()->voxel(0, 0, 0).getColor());
+}
+
+TEST_F(RawVolumeTest, testSnapshotParallelMaterialize) {
+	RawVolume v(Region(0, 47));
+	for (int i = 0; i < 48; ++i) {
+		v.setVoxel(i, i, i, voxel::createVoxel(VoxelType::Generic, 1));
+	}
+	core::DynamicArray<RawVolumeSnapshot *> snapshots;
+	for (int i = 0; i < 48; i += 4) {
+		snapshots.push_back(new RawVolumeSnapshot(&v, Region(i, i + 3)));
+	}
+	core::DynamicArray<std::thread> threads;
+	for (size_t t = 0; t < snapshots.size(); ++t) {
+		threads.emplace_back([&snapshots, t]() { snapshots[t]->materialize(); });
+	}
+	// the main thread modifies the volume while the snapshots are copied
+	for (int i = 0; i < 48; ++i) {
+		v.setVoxel(i, i, i, voxel::createVoxel(VoxelType::Generic, 2));
+	}
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+	for (size_t t = 0; t < snapshots.size(); ++t) {
+		const int i = (int)t * 4;
+		EXPECT_EQ(1, snapshots[t]->materialize()->voxel(i, i, i).getColor());
+		delete snapshots[t];
+	}
 }
+
+TEST_F(RawVolumeTest, testOccupancy) {
+	RawVolume v(Region(-20, 0, 0, 40, 40, 40));
+	EXPECT_TRUE(v.isEmpty());
+	EXPECT_EQ(0, v.solidVoxels());
+	EXPECT_FALSE(v.solidRegion().isValid());
+	EXPECT_TRUE(v.setVoxel(-3, 5, 7, voxel::createVoxel(VoxelType::Generic, 1)));
+	EXPECT_TRUE(v.setVoxel(30, 6, 33, voxel::createVoxel(VoxelType::Generic, 1)));
+	EXPECT_FALSE(v.isEmpty());
+	EXPECT_EQ(2, v.solidVoxels());
+	EXPECT_EQ(Region(-3, 5, 7, 30, 6, 33), v.solidRegion());
+	EXPECT_EQ(glm::ivec3(-3, 5, 7), v.mins());
+	EXPECT_EQ(glm::ivec3(30, 6, 33), v.maxs());
+	EXPECT_TRUE(v.isEmpty(Region(-2, 0, 0, 29, 40, 40)));
+	EXPECT_FALSE(v.isEmpty(Region(-3, 5, 7, -3, 5, 7)));
+
+	// overwriting a solid voxel doesn't change the counts
+	EXPECT_TRUE(v.setVoxel(-3, 5, 7, voxel::createVoxel(VoxelType::Generic, 2)));
+	EXPECT_EQ(2, v.solidVoxels());
+	EXPECT_TRUE(v.setVoxel(-3, 5, 7, voxel::Voxel()));
+	EXPECT_EQ(1, v.solidVoxels());
+	EXPECT_EQ(Region(30, 6, 33, 30, 6, 33), v.solidRegion());
+
+	// the summary of a copy is kept
+	RawVolume copy(v);
+	EXPECT_EQ(1, copy.solidVoxels());
+	RawVolume::Sampler sampler(copy);
+	ASSERT_TRUE(sampler.setPosition(0, 0, 0));
+	EXPECT_TRUE(sampler.setVoxel(voxel::createVoxel(VoxelType::Generic, 1)));
+	EXPECT_EQ(2, copy.solidVoxels());
+	EXPECT_EQ(1, v.solidVoxels());
+
+	v.fill(voxel::createVoxel(VoxelType::Generic, 1));
+	EXPECT_EQ((int64_t)v.region().voxels(), v.solidVoxels());
+	v.clear();
+	EXPECT_TRUE(v.isEmpty());
+}
+
+TEST_F(RawVolumeTest, testOccupancyParallelWriters) {
+	RawVolume v(Region(0, 47));
+	core::DynamicArray<std::thread> threads;
+	const int threadCount = 4;
+	// the threads write into distinct occupancy bricks
+	for (int i = 0; i < threadCount; ++i) {
+		threads.emplace_back([&v, i] {
+			for (int z = 0; z < 48; ++z) {
+				for (int y = 0; y < 48; ++y) {
+					for (int x = 0; x < 48; ++x) {
+						const glm::ivec3 brick = glm::ivec3(x, y, z) / RawVolume::OccupancyBrickSize;
+						if ((brick.x + brick.y * 3 + brick.z * 9) % threadCount != i) {
+							continue;
+						}
+						v.setVoxel(x, y, z, voxel::createVoxel(VoxelType::Generic, 1));
+						if ((x + y + z) % 3 == 0) {
+							v.setVoxel(x, y, z, voxel::Voxel());
+						}
+					}
+				}
+			}
+		});
+	}
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+	int64_t solid = 0;
+	for (int z = 0; z < 48; ++z) {
+		for (int y = 0; y < 48; ++y) {
+			for (int x = 0; x < 48; ++x) {
+				solid += (x + y + z) % 3 != 0;
+			}
+		}
+	}
+	EXPECT_EQ(solid, v.solidVoxels());
+}
+
+TEST_F(RawVolumeTest, testOccupancyMove) {
+	RawVolume v(Region(0, 0, 0, 39, 9, 9));
+	EXPECT_TRUE(v.setVoxel(1, 1, 1, voxel::createVoxel(VoxelType::Generic, 1)));
+	// the voxels wrap around - the voxel ends up in another brick
+	ASSERT_TRUE(v.move(glm::ivec3(30, 0, 0)));
+	EXPECT_EQ(VoxelType::Generic, v.voxel(11, 1, 1).getMaterial());
+	EXPECT_EQ(1, v.solidVoxels());
+	EXPECT_EQ(Region(11, 1, 1, 11, 1, 1), v.solidRegion());
+}
+
+TEST_F(RawVolumeTest, testNextOccupiedX) {
+	RawVolume v(Region(0, 0, 0, 63, 31, 3));
+	EXPECT_TRUE(v.setVoxel(40, 1, 2, voxel::createVoxel(VoxelType::Generic, 1)));
+	int32_t checkX = 0;
+	// the empty bricks in front of the voxel are skipped
+	EXPECT_EQ(2 * RawVolume::OccupancyBrickSize, v.nextOccupiedX(0, 1, 2, checkX));
+	EXPECT_EQ(3 * RawVolume::OccupancyBrickSize, checkX);
+	// the row behind the last solid voxel is empty
+	EXPECT_EQ(64, v.nextOccupiedX(48, 1, 2, checkX));
+	EXPECT_EQ(64, v.nextOccupiedX(0, 20, 2, checkX));
+}
+
+} // namespace voxel
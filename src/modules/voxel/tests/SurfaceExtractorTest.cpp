@@ -5,11 +5,61 @@
 #include "voxel/SurfaceExtractor.h"
 #include "app/tests/AbstractTest.h"
 #include "voxel/ChunkMesh.h"
+#include "voxel/MaterialColor.h"
 #include "voxel/RawVolume.h"
+#include <glm/geometric.hpp>
 
 namespace voxel {
 
-class SurfaceExtractorTest : public app::AbstractTest {};
+class SurfaceExtractorTest : public app::AbstractTest {
+protected:
+	/**
+	 * @brief Fill a volume that is bigger than one tile of the binary mesher with a pattern of opaque and transparent
+	 * voxels
+	 */
+	void fillPattern(voxel::RawVolume &v) const {
+		const voxel::Region &region = v.region();
+		for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+			for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+					const int n = x * 7 + y * 13 + z * 3 + (x * z) % 5;
+					if (n % 4 == 0) {
+						continue;
+					}
+					if (n % 11 == 0) {
+						v.setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Transparent, 3));
+					} else {
+						v.setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, (x / 8 + y / 4) % 3));
+					}
+				}
+			}
+		}
+	}
+
+	void extract(voxel::SurfaceExtractionType type, const voxel::RawVolume &v, voxel::ChunkMesh &mesh,
+				 bool mergeQuads, bool reuseVertices) const {
+		voxel::Region region = v.region();
+		region.shiftUpperCorner(1, 1, 1);
+		SurfaceExtractionContext ctx = voxel::createContext(type, &v, region, voxel::getPalette(), mesh,
+															glm::ivec3(0), mergeQuads, reuseVertices, true);
+		voxel::extractSurface(ctx);
+	}
+
+	float area(const voxel::Mesh &mesh, uint8_t colorIndex) const {
+		float sum = 0.0f;
+		const voxel::IndexArray &indices = mesh.getIndexVector();
+		for (size_t i = 0; i < indices.size(); i += 3) {
+			const voxel::VoxelVertex &v0 = mesh.getVertex(indices[i + 0]);
+			if (v0.colorIndex != colorIndex) {
+				continue;
+			}
+			const voxel::VoxelVertex &v1 = mesh.getVertex(indices[i + 1]);
+			const voxel::VoxelVertex &v2 = mesh.getVertex(indices[i + 2]);
+			sum += glm::length(glm::cross(v1.position - v0.position, v2.position - v0.position)) * 0.5f;
+		}
+		return sum;
+	}
+};
 
 // https://github.com/vengi-voxel/vengi/issues/389
 // 63 vertices mesh object. When you import this one into Blender, then when manually merged (Mesh > Merge > By Distance
@@ -133,4 +183,72 @@ TEST_F(SurfaceExtractorTest, testMeshExtractionIssue445) {
 	EXPECT_EQ(8, (int)mesh.mesh[0].getNoOfVertices());
 }
 
+TEST_F(SurfaceExtractorTest, testBinaryMeshExtractionIssue445) {
+	glm::ivec3 mins(-1, -1, -1);
+	glm::ivec3 maxs(1, -1, 1);
+	voxel::Region region(mins, maxs);
+	voxel::RawVolume v(region);
+	for (int x = mins.x; x <= maxs.x; ++x) {
+		for (int y = mins.y; y <= maxs.y; ++y) {
+			for (int z = mins.z; z <= maxs.z; ++z) {
+				v.setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+			}
+		}
+	}
+
+	voxel::ChunkMesh mesh;
+	region.shiftUpperCorner(1, 1, 1);
+	SurfaceExtractionContext ctx = voxel::buildBinaryContext(&v, region, mesh, glm::ivec3(0), true, true, true);
+	voxel::extractSurface(ctx);
+	EXPECT_EQ(8, (int)mesh.mesh[0].getNoOfVertices());
+	EXPECT_EQ(36, (int)mesh.mesh[0].getNoOfIndices());
+}
+
+TEST_F(SurfaceExtractorTest, testBinaryMatchesCubicWithoutMerging) {
+	voxel::RawVolume v(voxel::Region(-3, 0, 2, 96, 20, 70));
+	fillPattern(v);
+
+	voxel::ChunkMesh cubic;
+	extract(voxel::SurfaceExtractionType::Cubic, v, cubic, false, true);
+	voxel::ChunkMesh binary;
+	extract(voxel::SurfaceExtractionType::Binary, v, binary, false, true);
+
+	for (int i = 0; i < voxel::ChunkMesh::Meshes; ++i) {
+		const voxel::Mesh &cubicMesh = cubic.mesh[i];
+		const voxel::Mesh &binaryMesh = binary.mesh[i];
+		ASSERT_GT(cubicMesh.getNoOfIndices(), 0u);
+		EXPECT_EQ(cubicMesh.getNoOfVertices(), binaryMesh.getNoOfVertices()) << "mesh " << i;
+		EXPECT_EQ(cubicMesh.getNoOfIndices(), binaryMesh.getNoOfIndices()) << "mesh " << i;
+		int cubicAO[4]{0, 0, 0, 0};
+		int binaryAO[4]{0, 0, 0, 0};
+		for (const voxel::VoxelVertex &vertex : cubicMesh.getVertexVector()) {
+			++cubicAO[vertex.ambientOcclusion];
+		}
+		for (const voxel::VoxelVertex &vertex : binaryMesh.getVertexVector()) {
+			++binaryAO[vertex.ambientOcclusion];
+		}
+		for (int ao = 0; ao < 4; ++ao) {
+			EXPECT_EQ(cubicAO[ao], binaryAO[ao]) << "mesh " << i << " ao " << ao;
+		}
+	}
+}
+
+TEST_F(SurfaceExtractorTest, testBinaryMergedSurfaceArea) {
+	voxel::RawVolume v(voxel::Region(0, 0, 0, 70, 16, 66));
+	fillPattern(v);
+
+	voxel::ChunkMesh cubic;
+	extract(voxel::SurfaceExtractionType::Cubic, v, cubic, true, true);
+	voxel::ChunkMesh binary;
+	extract(voxel::SurfaceExtractionType::Binary, v, binary, true, true);
+
+	for (int i = 0; i < voxel::ChunkMesh::Meshes; ++i) {
+		for (uint8_t colorIndex = 0; colorIndex < 4; ++colorIndex) {
+			EXPECT_FLOAT_EQ(area(cubic.mesh[i], colorIndex), area(binary.mesh[i], colorIndex))
+				<< "mesh " << i << " color " << (int)colorIndex;
+		}
+		EXPECT_LE(binary.mesh[i].getNoOfIndices(), cubic.mesh[i].getNoOfIndices()) << "mesh " << i;
+	}
+}
+
 } // namespace voxel
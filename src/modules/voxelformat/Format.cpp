@@ -26,6 +26,65 @@
 
 namespace voxelformat {
 
+bool LoadContext::loadModel(const core::String &name, voxel::Region &nodeRegion) const {
+	if (!nodeNames.empty()) {
+		bool found = false;
+		for (const core::String &nodeName : nodeNames) {
+			if (nodeName == name) {
+				found = true;
+				break;
+			}
+		}
+		if (!found) {
+			return false;
+		}
+	}
+	if (region.isValid()) {
+		return nodeRegion.cropTo(region);
+	}
+	return true;
+}
+
+const ProbeNode *ProbeResult::node(int nodeId) const {
+	for (const ProbeNode &probeNode : nodes) {
+		if (probeNode.id == nodeId) {
+			return &probeNode;
+		}
+	}
+	return nullptr;
+}
+
+int ProbeResult::addPalette(const palette::Palette &palette) {
+	for (size_t i = 0; i < palettes.size(); ++i) {
+		if (palettes[i].hash() == palette.hash() && palettes[i].colorCount() == palette.colorCount()) {
+			return (int)i;
+		}
+	}
+	palettes.push_back(palette);
+	return (int)palettes.size() - 1;
+}
+
+size_t ProbeResult::size(scenegraph::SceneGraphNodeType type) const {
+	size_t n = 0;
+	for (const ProbeNode &probeNode : nodes) {
+		if (type == scenegraph::SceneGraphNodeType::All || probeNode.type == type) {
+			++n;
+		} else if (type == scenegraph::SceneGraphNodeType::AllModels &&
+				   (probeNode.type == scenegraph::SceneGraphNodeType::Model ||
+					probeNode.type == scenegraph::SceneGraphNodeType::ModelReference)) {
+			++n;
+		}
+	}
+	return n;
+}
+
+void ProbeResult::clear() {
+	nodes.clear();
+	palettes.clear();
+	animations.clear();
+	thumbnail = image::ImagePtr();
+}
+
 core::String Format::stringProperty(const scenegraph::SceneGraphNode *node, const core::String &name,
 									const core::String &defaultVal) {
 	if (node == nullptr) {
@@ -100,6 +159,64 @@ size_t PaletteFormat::loadPalette(const core::String &filename, const io::Archiv
 	return palette.size();
 }
 
+void Format::fillProbeResult(const scenegraph::SceneGraph &sceneGraph, const ProbeModels &models, bool palettes,
+							 ProbeResult &result) {
+	result.animations = sceneGraph.animations();
+	// depth first to put the parents in front of their children
+	core::DynamicArray<int> stack;
+	stack.push_back(sceneGraph.root().id());
+	while (!stack.empty()) {
+		const scenegraph::SceneGraphNode &node = sceneGraph.node(stack.back());
+		stack.pop();
+		ProbeNode probeNode;
+		probeNode.id = node.id();
+		probeNode.parent = node.parent();
+		probeNode.type = node.type();
+		probeNode.name = node.name();
+		probeNode.visible = node.visible();
+		if (node.isReference()) {
+			probeNode.reference = node.reference();
+		}
+		if (node.isModelNode()) {
+			ProbeModel model;
+			if (models.get(node.id(), model)) {
+				probeNode.region = model.region;
+				probeNode.voxels = model.voxels;
+			} else {
+				probeNode.region = node.region();
+			}
+			if (palettes) {
+				probeNode.palette = result.addPalette(node.palette());
+			}
+		}
+		result.nodes.push_back(probeNode);
+		const scenegraph::SceneGraphNodeChildren &children = node.children();
+		for (int i = (int)children.size() - 1; i >= 0; --i) {
+			stack.push_back(children[i]);
+		}
+	}
+}
+
+bool Format::probe(const core::String &filename, const io::ArchivePtr &archive, ProbeResult &result,
+				   const LoadContext &ctx) {
+	Log::debug("Format doesn't support probing - load the whole scene graph of %s", filename.c_str());
+	scenegraph::SceneGraph sceneGraph;
+	if (!load(filename, archive, sceneGraph, ctx)) {
+		return false;
+	}
+	// the voxels are loaded anyway - so count them
+	ProbeModels models;
+	for (auto iter = sceneGraph.beginModel(); iter != sceneGraph.end(); ++iter) {
+		const scenegraph::SceneGraphNode &node = *iter;
+		ProbeModel model;
+		model.region = node.region();
+		model.voxels = voxelutil::visitVolume(*node.volume(), voxelutil::EmptyVisitor());
+		models.put(node.id(), model);
+	}
+	fillProbeResult(sceneGraph, models, true, result);
+	return true;
+}
+
 image::ImagePtr Format::loadScreenshot(const core::String &filename, const io::ArchivePtr &, const LoadContext &) {
 	Log::debug("%s doesn't have a supported embedded screenshot", filename.c_str());
 	return image::ImagePtr();
@@ -177,6 +294,9 @@ bool Format::save(const scenegraph::SceneGraph &sceneGraph, const core::String &
 
 bool Format::load(const core::String &filename, const io::ArchivePtr &archive, scenegraph::SceneGraph &sceneGraph,
 				  const LoadContext &ctx) {
+	_streamedNodes.clear();
+	_streamedMemory = 0u;
+	_emittedNodes = 0;
 	if (!loadGroups(filename, archive, sceneGraph, ctx)) {
 		return false;
 	}
@@ -195,6 +315,56 @@ bool Format::stopExecution() {
 	return app::App::getInstance()->shouldQuit();
 }
 
+bool Format::emitNode(scenegraph::SceneGraph &sceneGraph, int nodeId, const LoadContext &ctx) {
+	if (ctx.nodeLoaded == nullptr) {
+		return true;
+	}
+	scenegraph::SceneGraphNode &node = sceneGraph.node(nodeId);
+	finalizeNode(node);
+	++_emittedNodes;
+	if (!ctx.nodeLoaded(sceneGraph, nodeId, ctx.userdata)) {
+		Log::debug("Loading was aborted by the node callback");
+		return false;
+	}
+	if (ctx.maxMemory == 0u) {
+		return true;
+	}
+	if (const voxel::RawVolume *v = node.volume()) {
+		_streamedMemory += (size_t)v->region().voxels() * sizeof(voxel::Voxel);
+	}
+	_streamedNodes.push_back(nodeId);
+	if (_streamedMemory > ctx.maxMemory) {
+		Log::debug("Remove %i streamed nodes from the scene graph to free %i bytes", (int)_streamedNodes.size(),
+				   (int)_streamedMemory);
+		for (int streamedNodeId : _streamedNodes) {
+			sceneGraph.removeNode(streamedNodeId, false);
+		}
+		_streamedNodes.clear();
+		_streamedMemory = 0u;
+	}
+	return true;
+}
+
+void Format::finalizeNode(scenegraph::SceneGraphNode &) const {
+}
+
+void PaletteFormat::finalizeNode(scenegraph::SceneGraphNode &node) const {
+	if (!node.isAnyModelNode()) {
+		return;
+	}
+	const bool createPalette = core::Var::getSafe(cfg::VoxelCreatePalette)->boolVal();
+	if (createPalette) {
+		return;
+	}
+	const palette::Palette &palette = voxel::getPalette();
+	// already done by emitNode()
+	if (node.palette().hash() == palette.hash()) {
+		return;
+	}
+	node.remapToPalette(palette);
+	node.setPalette(palette);
+}
+
 bool PaletteFormat::loadGroups(const core::String &filename, const io::ArchivePtr &archive,
 							   scenegraph::SceneGraph &sceneGraph, const LoadContext &ctx) {
 	palette::Palette palette;
@@ -206,11 +376,7 @@ bool PaletteFormat::loadGroups(const core::String &filename, const io::ArchivePt
 	if (!createPalette) {
 		Log::info("Remap the palette to %s", voxel::getPalette().name().c_str());
 		for (const auto &e :sceneGraph.nodes()) {
-			scenegraph::SceneGraphNode &node = e->value;
-			if (node.isAnyModelNode()) {
-				node.remapToPalette(voxel::getPalette());
-				node.setPalette(voxel::getPalette());
-			}
+			finalizeNode(e->value);
 		}
 	}
 
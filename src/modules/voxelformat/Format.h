@@ -8,13 +8,16 @@
 
 #pragma once
 
+#include "core/collection/DynamicArray.h"
 #include "core/collection/DynamicMap.h"
+#include "core/collection/Map.h"
 #include "image/Image.h"
 #include "io/Archive.h"
 #include "io/FormatDescription.h"
 #include "io/Stream.h"
 #include "palette/Palette.h"
 #include "voxel/RawVolume.h"
+#include "voxelformat/FormatProbe.h"
 #include "voxelformat/FormatThumbnail.h"
 #include <glm/fwd.hpp>
 
@@ -44,9 +47,45 @@ using RGBAMap = core::DynamicMap<core::RGBA, bool, 1031, core::RGBAHasher>;
 using RGBAMaterialMap = core::DynamicMap<core::RGBA, const palette::Material*, 1031, core::RGBAHasher>;
 
 typedef void (*ProgressMonitor)(const char *name, int cur, int max);
+/**
+ * @brief Called for a model node that was completely loaded while the format is still parsing the rest of the file
+ * @param nodeId The id of the node in the given scene graph
+ * @return @c false to abort the loading
+ */
+typedef bool (*NodeLoadedCallback)(const scenegraph::SceneGraph &sceneGraph, int nodeId, void *userdata);
 
 struct LoadContext {
 	ProgressMonitor monitor = nullptr;
+	/**
+	 * Optional callback for the formats that are able to stream their models (see @c Format::emitNode()). This
+	 * allows to work with the models before the whole file is parsed.
+	 */
+	NodeLoadedCallback nodeLoaded = nullptr;
+	void *userdata = nullptr;
+	/**
+	 * The max amount of bytes the voxels of the streamed model nodes may occupy in the scene graph. If this is
+	 * exceeded, the nodes that were already handed to @c nodeLoaded are removed from the scene graph. @c 0 means
+	 * no limit - the scene graph contains all nodes after loading.
+	 */
+	size_t maxMemory = 0u;
+	/**
+	 * For the formats that support partial loading (see @c VENGIFormat): only the model nodes with these names are
+	 * loaded. Empty means all model nodes. The children of skipped nodes are attached to the parent of the skipped
+	 * node.
+	 */
+	core::DynamicArray<core::String> nodeNames;
+	/**
+	 * For the formats that support partial loading: only the voxels inside this region are loaded. Model nodes that
+	 * don't intersect the region are skipped. An invalid region means no restriction.
+	 */
+	voxel::Region region = voxel::Region::InvalidRegion;
+
+	/**
+	 * @return @c true if the voxels of the given model node should get loaded
+	 * @param[in,out] nodeRegion The region of the model node - cropped to @c region
+	 */
+	bool loadModel(const core::String &name, voxel::Region &nodeRegion) const;
+
 	inline void progress(const char *name, int cur, int max) const {
 		if (monitor == nullptr) {
 			return;
@@ -78,8 +117,36 @@ static constexpr int MaxRegionSize = 256;
  * @ingroup Formats
  */
 class Format {
+private:
+	// the streamed model nodes that are still part of the scene graph - see emitNode()
+	core::DynamicArray<int> _streamedNodes;
+	size_t _streamedMemory = 0u;
+	// the amount of model nodes that were handed to LoadContext::nodeLoaded - see emitNode()
+	int _emittedNodes = 0;
+
 protected:
 	uint8_t _flattenFactor;
+
+	/**
+	 * @brief The region and the amount of voxels of a model node that was added to the scene graph with a placeholder
+	 * volume while probing a file
+	 * @sa probe()
+	 */
+	struct ProbeModel {
+		voxel::Region region;
+		int64_t voxels = -1;
+	};
+	// key is the node id
+	using ProbeModels = core::Map<int, ProbeModel>;
+
+	/**
+	 * @brief Converts the scene graph that was loaded without voxels into the probe result
+	 * @param[in] models The model nodes with placeholder volumes - the model nodes that are not in this map take their
+	 * region from the volume
+	 * @param[in] palettes @c false for formats that create the palette from the voxel colors
+	 */
+	static void fillProbeResult(const scenegraph::SceneGraph &sceneGraph, const ProbeModels &models, bool palettes,
+								ProbeResult &result);
 	/**
 	 * @brief If you have to split the volumes in the scene graph because the format only supports a certain size, you
 	 * can return the max size here. If the returned value is not a valid volume size (<= 0) the value is ignored.
@@ -129,6 +196,20 @@ protected:
 	 */
 	static bool stopExecution();
 
+	/**
+	 * @brief Formats that load their models one after another call this for every model node once it was added to
+	 * the scene graph. This hands the node to @c LoadContext::nodeLoaded and keeps the memory of the streamed nodes
+	 * below @c LoadContext::maxMemory.
+	 * @note The node must not be modified by the format afterwards - it might already be removed from the scene graph
+	 * @return @c false if the loading should be aborted
+	 */
+	bool emitNode(scenegraph::SceneGraph &sceneGraph, int nodeId, const LoadContext &ctx);
+	/**
+	 * @brief Applies the modifications to a loaded model node that are otherwise done after all nodes were loaded
+	 * @sa emitNode()
+	 */
+	virtual void finalizeNode(scenegraph::SceneGraphNode &node) const;
+
 	static core::String stringProperty(const scenegraph::SceneGraphNode *node, const core::String &name,
 									   const core::String &defaultVal = "");
 	static bool boolProperty(const scenegraph::SceneGraphNode *node, const core::String &name, bool defaultVal = false);
@@ -186,11 +267,30 @@ public:
 	 */
 	virtual size_t loadPalette(const core::String &filename, const io::ArchivePtr &archive, palette::Palette &palette,
 							   const LoadContext &ctx);
+	/**
+	 * @brief Only load the structure of the scene graph - the nodes, the regions of the model nodes, the palettes and
+	 * the animations - without loading the voxels
+	 * @note Formats that don't implement this go the expensive route like @c loadPalette() does. They load the whole
+	 * scene graph including all voxels and only report its structure.
+	 * @note The embedded screenshot is not loaded here - see @c loadScreenshot()
+	 * @note The node name and region filters of the @c LoadContext are optional: only the formats that support
+	 * partial loading apply them (see @c LoadContext::nodeNames). All other formats report every model node with its
+	 * full region - just like their @c load() does.
+	 */
+	virtual bool probe(const core::String &filename, const io::ArchivePtr &archive, ProbeResult &result,
+					   const LoadContext &ctx);
 	/**
 	 * @todo don't use a stream, but an archive for formats that are split over several files
 	 */
 	virtual bool load(const core::String &filename, const io::ArchivePtr &archive, scenegraph::SceneGraph &sceneGraph,
 					  const LoadContext &ctx);
+	/**
+	 * @return The amount of model nodes that were handed to @c LoadContext::nodeLoaded by the last @c load() call.
+	 * With a @c LoadContext::maxMemory limit these nodes might no longer be part of the scene graph.
+	 */
+	int emittedNodes() const {
+		return _emittedNodes;
+	}
 	/**
 	 * @todo don't use a stream, but an archive for formats that are split over several files
 	 */
@@ -227,6 +327,7 @@ protected:
 	 * @return A palette index of @c -1 means that the format doesn't support this feature. Otherwise an index between @c [0,palette::PaletteMaxColors] must be used
 	 */
 	virtual int emptyPaletteIndex() const;
+	void finalizeNode(scenegraph::SceneGraphNode &node) const override;
 	bool loadGroups(const core::String &filename, const io::ArchivePtr &archive, scenegraph::SceneGraph &sceneGraph,
 					const LoadContext &ctx) override final;
 
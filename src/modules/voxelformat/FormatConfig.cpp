@@ -26,7 +26,7 @@ bool FormatConfig::init() {
 	core::Var::get(cfg::VoxformatMergequads, "true", core::CV_NOPERSIST, _("Merge similar quads to optimize the mesh"),
 				   core::Var::boolValidator);
 	core::Var::get(cfg::VoxelMeshMode, core::string::toString((int)voxel::SurfaceExtractionType::Cubic),
-				   core::CV_SHADER, _("0 = cubes, 1 = marching cubes"),
+				   core::CV_SHADER, _("0 = cubes, 1 = marching cubes, 2 = binary cubes"),
 				   core::Var::minMaxValidator<(int)voxel::SurfaceExtractionType::Cubic,
 											  (int)voxel::SurfaceExtractionType::Max - 1>);
 	core::Var::get(cfg::VoxformatReusevertices, "true", core::CV_NOPERSIST,
@@ -0,0 +1,57 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/String.h"
+#include "core/collection/DynamicArray.h"
+#include "image/Image.h"
+#include "palette/Palette.h"
+#include "scenegraph/SceneGraphNode.h"
+#include "voxel/Region.h"
+
+namespace voxelformat {
+
+/**
+ * @brief A node of a file that was probed without loading the voxels - see @c Format::probe()
+ */
+struct ProbeNode {
+	/** the id the node gets when the file is loaded into a scene graph */
+	int id = InvalidNodeId;
+	int parent = InvalidNodeId;
+	/** the id of the referenced model node for model references */
+	int reference = InvalidNodeId;
+	scenegraph::SceneGraphNodeType type = scenegraph::SceneGraphNodeType::Max;
+	core::String name;
+	bool visible = true;
+	/** the region of the volume for model nodes - invalid for all other node types */
+	voxel::Region region = voxel::Region::InvalidRegion;
+	/** the amount of solid voxels of a model node - @c -1 if the format doesn't store it */
+	int64_t voxels = -1;
+	/** index into @c ProbeResult::palettes - @c -1 if the palette is created from the voxel colors */
+	int palette = -1;
+};
+
+/**
+ * @brief The structure of a scene graph without the voxels
+ */
+struct ProbeResult {
+	/** the root node is the first entry and the parents are always in front of their children */
+	core::DynamicArray<ProbeNode> nodes;
+	/** the distinct palettes of the nodes */
+	core::DynamicArray<palette::Palette> palettes;
+	core::DynamicArray<core::String> animations;
+	/** the embedded screenshot of the formats that support it */
+	image::ImagePtr thumbnail;
+
+	const ProbeNode *node(int nodeId) const;
+	/**
+	 * @return The index of the palette in @c palettes - equal palettes are only added once
+	 */
+	int addPalette(const palette::Palette &palette);
+	size_t size(scenegraph::SceneGraphNodeType type = scenegraph::SceneGraphNodeType::Model) const;
+	void clear();
+};
+
+} // namespace voxelformat
@@ -31,6 +31,8 @@ struct ThumbnailContext {
 	double deltaFrameSeconds = 0.001;
 	bool useSceneCamera = false;
 	bool useWorldPosition = false;
+	/** render on the cpu - this doesn't need an OpenGL context */
+	bool useSoftwareRenderer = false;
 };
 
 /**
@@ -322,6 +322,38 @@ size_t loadPalette(const core::String &filename, const io::ArchivePtr &archive,
 	return 0;
 }
 
+bool probeFormat(const io::FileDescription &fileDesc, const io::ArchivePtr &archive, ProbeResult &result,
+				 const LoadContext &ctx) {
+	core_trace_scoped(ProbeVolumeFormat);
+	core::ScopedPtr<io::SeekableReadStream> stream(archive->readStream(fileDesc.name));
+	if (!stream) {
+		Log::warn("Failed to open file at %s", fileDesc.name.c_str());
+		return false;
+	}
+	const uint32_t magic = loadMagic(*stream);
+	const io::FormatDescription *desc = io::getDescription(fileDesc, magic, voxelLoad());
+	if (desc == nullptr) {
+		return false;
+	}
+	const core::String &filename = fileDesc.name;
+	const core::SharedPtr<Format> &f = getFormat(*desc, magic);
+	if (!f) {
+		Log::error("Failed to probe model file %s - unsupported file format", filename.c_str());
+		return false;
+	}
+	result.clear();
+	if (!f->probe(filename, archive, result, ctx)) {
+		Log::error("Error while probing %s", filename.c_str());
+		result.clear();
+		return false;
+	}
+	if (desc->flags & VOX_FORMAT_FLAG_SCREENSHOT_EMBEDDED) {
+		result.thumbnail = f->loadScreenshot(filename, archive, ctx);
+	}
+	Log::debug("Probed file %s with %i model nodes", filename.c_str(), (int)result.size());
+	return true;
+}
+
 bool loadFormat(const io::FileDescription &fileDesc, const io::ArchivePtr &archive,
 				scenegraph::SceneGraph &newSceneGraph, const LoadContext &ctx) {
 	core_trace_scoped(LoadVolumeFormat);
@@ -341,6 +373,7 @@ bool loadFormat(const io::FileDescription &fileDesc, const io::ArchivePtr &archi
 		if (!f->load(filename, archive, newSceneGraph, ctx)) {
 			Log::error("Error while loading %s", filename.c_str());
 			newSceneGraph.clear();
+			return false;
 		}
 	} else {
 		Log::error("Failed to load model file %s - unsupported "
@@ -350,7 +383,8 @@ bool loadFormat(const io::FileDescription &fileDesc, const io::ArchivePtr &archi
 	}
 	const int models = (int)newSceneGraph.size(scenegraph::SceneGraphNodeType::Model);
 	const int points = (int)newSceneGraph.size(scenegraph::SceneGraphNodeType::Point);
-	if (models == 0 && points == 0) {
+	// with a memory limit the streamed nodes might already be removed from the scene graph again
+	if (models == 0 && points == 0 && f->emittedNodes() == 0) {
 		Log::error("Failed to load model file %s. Scene graph "
 				   "doesn't contain models.",
 				   filename.c_str());
@@ -30,6 +30,13 @@ bool importPalette(const core::String &filename, palette::Palette &palette);
  */
 size_t loadPalette(const core::String &filename, const io::ArchivePtr &archive, palette::Palette &palette,
 				   const LoadContext &ctx);
+/**
+ * @brief Loads the structure of the scene graph without the voxels - and the embedded screenshot if the format
+ * supports it
+ * @sa Format::probe()
+ */
+bool probeFormat(const io::FileDescription &fileDesc, const io::ArchivePtr &archive, ProbeResult &result,
+				 const LoadContext &ctx);
 image::ImagePtr loadScreenshot(const core::String &filename, const io::ArchivePtr &archive, const LoadContext &ctx);
 bool loadFormat(const io::FileDescription &fileDesc, const io::ArchivePtr &archive, scenegraph::SceneGraph &sceneGraph,
 				const LoadContext &ctx);
@@ -195,6 +195,7 @@ bool GoxFormat::loadChunk_LAYR(State &state, const GoxChunk &c, io::SeekableRead
 		return false;
 	}
 	Log::debug("Found LAYR chunk with %i blocks", blockCount);
+	voxel::Region blocksRegion = voxel::Region::InvalidRegion;
 	for (uint32_t i = 0; i < blockCount; ++i) {
 		uint32_t index;
 		if ((stream.readUInt32(index)) != 0) {
@@ -207,20 +208,6 @@ bool GoxFormat::loadChunk_LAYR(State &state, const GoxChunk &c, io::SeekableRead
 			delete modelVolume;
 			return false;
 		}
-		const image::ImagePtr &img = state.images[index];
-		if (!img) {
-			Log::error("Invalid image index: %u", index);
-			delete modelVolume;
-			return false;
-		}
-		Log::debug("LAYR references BL16 image with index %i", index);
-		const uint8_t *rgba = img->data();
-		int bpp = img->depth();
-		int w = img->width();
-		int h = img->height();
-		core_assert(w == 64 && h == 64 && bpp == 4);
-		(void)bpp;(void)w;(void)h;
-
 		int32_t x, y, z;
 		if (stream.readInt32(x) != 0) {
 			Log::error("Could not load gox file: Failure to read block coordinate");
@@ -251,6 +238,28 @@ bool GoxFormat::loadChunk_LAYR(State &state, const GoxChunk &c, io::SeekableRead
 		}
 		const voxel::Region blockRegion(x, z, y, x + (BlockSize - 1), z + (BlockSize - 1), y + (BlockSize - 1));
 		core_assert(blockRegion.isValid());
+		if (state.probeModels != nullptr) {
+			if (blocksRegion.isValid()) {
+				blocksRegion.accumulate(blockRegion);
+			} else {
+				blocksRegion = blockRegion;
+			}
+			continue;
+		}
+		const image::ImagePtr &img = state.images[index];
+		if (!img) {
+			Log::error("Invalid image index: %u", index);
+			delete modelVolume;
+			return false;
+		}
+		Log::debug("LAYR references BL16 image with index %i", index);
+		const uint8_t *rgba = img->data();
+		int bpp = img->depth();
+		int w = img->width();
+		int h = img->height();
+		core_assert(w == 64 && h == 64 && bpp == 4);
+		(void)bpp;(void)w;(void)h;
+
 		voxel::RawVolume *blockVolume = new voxel::RawVolume(blockRegion);
 		const uint8_t *v = rgba;
 		bool empty = true;
@@ -334,6 +343,31 @@ bool GoxFormat::loadChunk_LAYR(State &state, const GoxChunk &c, io::SeekableRead
 		}
 	}
 
+	if (state.probeModels != nullptr) {
+		ProbeModel model;
+		model.region = voxel::Region(0, 0);
+		glm::ivec3 mins(0);
+		if (blocksRegion.isValid()) {
+			// the blocks are mirrored inside the model volume that always contains the origin
+			voxel::Region destReg(modelVolume->region());
+			destReg.accumulate(blocksRegion);
+			mins = blocksRegion.getLowerCorner();
+			mins.x = destReg.getLowerX() + destReg.getUpperX() - blocksRegion.getUpperX();
+			model.region = voxel::Region(glm::ivec3(0), blocksRegion.getDimensionsInVoxels() - 1);
+		}
+		scenegraph::SceneGraphTransform &transform = node.transform(keyFrameIdx);
+		transform.setWorldTranslation(mins);
+		node.setVolume(new voxel::RawVolume(voxel::Region(0, 0)), true);
+		node.setVisible(visible);
+		const int nodeId = sceneGraph.emplace(core::move(node));
+		delete modelVolume;
+		if (nodeId == InvalidNodeId) {
+			return false;
+		}
+		state.probeModels->put(nodeId, model);
+		return true;
+	}
+
 	voxel::RawVolume *mirrored = voxelutil::mirrorAxis(modelVolume, math::Axis::X);
 	voxel::RawVolume *cropped = voxelutil::cropVolume(mirrored);
 	const glm::ivec3 mins = cropped->region().getLowerCorner();
@@ -352,6 +386,15 @@ bool GoxFormat::loadChunk_LAYR(State &state, const GoxChunk &c, io::SeekableRead
 }
 
 bool GoxFormat::loadChunk_BL16(State &state, const GoxChunk &c, io::SeekableReadStream &stream) {
+	if (state.probeModels != nullptr) {
+		// only the index of the block is needed
+		if (stream.skip(c.length) == -1) {
+			Log::error("Failed to skip the png chunk");
+			return false;
+		}
+		state.images.push_back(image::ImagePtr());
+		return true;
+	}
 	uint8_t *png = (uint8_t *)core_malloc(c.length);
 	wrapBool(loadChunk_ReadData(stream, (char *)png, c.length))
 	image::ImagePtr img = image::createEmptyImage("gox-voxeldata");
@@ -572,9 +615,8 @@ size_t GoxFormat::loadPalette(const core::String &filename, const io::ArchivePtr
 	return createPalette(colors, palette);
 }
 
-bool GoxFormat::loadGroupsRGBA(const core::String &filename, const io::ArchivePtr &archive,
-							   scenegraph::SceneGraph &sceneGraph, const palette::Palette &palette,
-							   const LoadContext &ctx) {
+bool GoxFormat::loadScene(const core::String &filename, const io::ArchivePtr &archive,
+						  scenegraph::SceneGraph &sceneGraph, const palette::Palette &palette, State &state) {
 	core::ScopedPtr<io::SeekableReadStream> stream(archive->readStream(filename));
 	if (!stream) {
 		Log::error("Could not open file %s", filename.c_str());
@@ -588,7 +630,6 @@ bool GoxFormat::loadGroupsRGBA(const core::String &filename, const io::ArchivePt
 		return false;
 	}
 
-	State state;
 	wrap(stream->readInt32(state.version))
 
 	if (state.version > 2) {
@@ -615,9 +656,30 @@ bool GoxFormat::loadGroupsRGBA(const core::String &filename, const io::ArchivePt
 		}
 		loadChunk_ValidateCRC(*stream);
 	}
+	return true;
+}
+
+bool GoxFormat::loadGroupsRGBA(const core::String &filename, const io::ArchivePtr &archive,
+							   scenegraph::SceneGraph &sceneGraph, const palette::Palette &palette,
+							   const LoadContext &ctx) {
+	State state;
+	wrapBool(loadScene(filename, archive, sceneGraph, palette, state))
 	return !sceneGraph.empty();
 }
 
+bool GoxFormat::probe(const core::String &filename, const io::ArchivePtr &archive, ProbeResult &result,
+					  const LoadContext &ctx) {
+	ProbeModels models;
+	State state;
+	state.probeModels = &models;
+
+	scenegraph::SceneGraph sceneGraph;
+	const palette::Palette palette;
+	wrapBool(loadScene(filename, archive, sceneGraph, palette, state))
+	fillProbeResult(sceneGraph, models, false, result);
+	return true;
+}
+
 bool GoxFormat::saveChunk_DictEntryHeader(io::WriteStream &stream, const core::String &key, size_t valueSize) {
 	const int keyLength = (int)key.size();
 	wrapBool(stream.writeUInt32(keyLength))
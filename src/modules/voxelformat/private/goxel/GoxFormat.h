@@ -85,6 +85,8 @@ private:
 		int32_t version = 0;
 		core::DynamicArray<image::ImagePtr> images;
 		core::StringMap<palette::Material> materials;
+		/** if this is set, the block images are not decoded - see @c probe() */
+		ProbeModels *probeModels = nullptr;
 	};
 
 	bool loadChunk_Header(GoxChunk &c, io::SeekableReadStream &stream);
@@ -102,6 +104,11 @@ private:
 					   scenegraph::SceneGraph &sceneGraph);
 	bool loadChunk_LIGH(State &state, const GoxChunk &c, io::SeekableReadStream &stream,
 						scenegraph::SceneGraph &sceneGraph);
+	/**
+	 * @brief Reads the header and all chunks of the file - shared by @c loadGroupsRGBA() and @c probe()
+	 */
+	bool loadScene(const core::String &filename, const io::ArchivePtr &archive, scenegraph::SceneGraph &sceneGraph,
+				   const palette::Palette &palette, State &state);
 
 	bool saveChunk_DictEntryHeader(io::WriteStream &stream, const core::String &key, size_t valueSize);
 	bool saveChunk_DictString(io::WriteStream &stream, const core::String &key, const core::String &value);
@@ -137,6 +144,12 @@ public:
 					   const LoadContext &ctx) override;
 	image::ImagePtr loadScreenshot(const core::String &filename, const io::ArchivePtr &archive,
 								   const LoadContext &ctx) override;
+	/**
+	 * @brief The block images are not decoded - the region of a model is the bounding box of all its blocks and
+	 * the voxel counts are not known
+	 */
+	bool probe(const core::String &filename, const io::ArchivePtr &archive, ProbeResult &result,
+			   const LoadContext &ctx) override;
 
 	static const io::FormatDescription &format() {
 		static io::FormatDescription f{"Goxel",
@@ -50,8 +50,23 @@ size_t VoxFormat::loadPalette(const core::String &filename, const io::ArchivePtr
 	return palette.colorCount();
 }
 
+/**
+ * @brief The amount of solid voxels in the dense voxel grid of a model
+ */
+static int64_t countVoxels(const ogt_vox_model *ogtModel) {
+	const uint32_t n = ogtModel->size_x * ogtModel->size_y * ogtModel->size_z;
+	int64_t voxels = 0;
+	for (uint32_t i = 0; i < n; ++i) {
+		if (ogtModel->voxel_data[i] != 0) {
+			++voxels;
+		}
+	}
+	return voxels;
+}
+
 bool VoxFormat::loadInstance(const ogt_vox_scene *scene, uint32_t ogt_instanceIdx, scenegraph::SceneGraph &sceneGraph,
-							 int parent, core::DynamicArray<MVModelToNode> &models, const palette::Palette &palette) {
+							 int parent, core::DynamicArray<MVModelToNode> &models, const palette::Palette &palette,
+							 ProbeModels *probeModels) {
 	const ogt_vox_instance &ogtInstance = scene->instances[ogt_instanceIdx];
 	const ogt_vox_model *ogtModel = scene->models[ogtInstance.model_index];
 	const glm::mat4 &ogtMat = ogtTransformToMat(ogtInstance, 0, scene, ogtModel);
@@ -62,21 +77,26 @@ bool VoxFormat::loadInstance(const ogt_vox_scene *scene, uint32_t ogt_instanceId
 	voxel::Region region(glm::min(mins, maxs), glm::max(mins, maxs));
 	const glm::ivec3 shift = region.getLowerCorner();
 	region.shift(-shift);
-	voxel::RawVolume *v = new voxel::RawVolume(region);
 	scenegraph::SceneGraphTransform transform;
 	transform.setWorldTranslation(shift);
 
-	const uint8_t *ogtVoxel = ogtModel->voxel_data;
-	for (uint32_t k = 0; k < ogtModel->size_z; ++k) {
-		for (uint32_t j = 0; j < ogtModel->size_y; ++j) {
-			for (uint32_t i = 0; i < ogtModel->size_x; ++i, ++ogtVoxel) {
-				if (ogtVoxel[0] == 0) {
-					continue;
+	voxel::RawVolume *v;
+	if (probeModels != nullptr) {
+		v = new voxel::RawVolume(voxel::Region(0, 0));
+	} else {
+		v = new voxel::RawVolume(region);
+		const uint8_t *ogtVoxel = ogtModel->voxel_data;
+		for (uint32_t k = 0; k < ogtModel->size_z; ++k) {
+			for (uint32_t j = 0; j < ogtModel->size_y; ++j) {
+				for (uint32_t i = 0; i < ogtModel->size_x; ++i, ++ogtVoxel) {
+					if (ogtVoxel[0] == 0) {
+						continue;
+					}
+					const voxel::Voxel voxel = voxel::createVoxel(palette, ogtVoxel[0] - 1);
+					const glm::ivec3 &ogtPos = calcTransform(ogtMat, glm::vec3(i, j, k));
+					const glm::ivec3 pos(-(ogtPos.x + 1), ogtPos.z, ogtPos.y);
+					v->setVoxel(pos - shift, voxel);
 				}
-				const voxel::Voxel voxel = voxel::createVoxel(palette, ogtVoxel[0] - 1);
-				const glm::ivec3 &ogtPos = calcTransform(ogtMat, glm::vec3(i, j, k));
-				const glm::ivec3 pos(-(ogtPos.x + 1), ogtPos.z, ogtPos.y);
-				v->setVoxel(pos - shift, voxel);
 			}
 		}
 	}
@@ -103,12 +123,22 @@ bool VoxFormat::loadInstance(const ogt_vox_scene *scene, uint32_t ogt_instanceId
 	// TODO: VOXELFORMAT: node.setPivot({ogtPivot.x / (float)ogtModel->size_x, ogtPivot.z / (float)ogtModel->size_z, ogtPivot.y / (float)ogtModel->size_y});
 	// TODO: VOXELFORMAT: node.setPivot({(ogtPivot.x + 0.5f) / (float)ogtModel->size_x, (ogtPivot.z + 0.5f) / (float)ogtModel->size_z, (ogtPivot.y + 0.5f) / (float)ogtModel->size_y});
 	node.setPalette(palette);
-	return sceneGraph.emplace(core::move(node), parent) != -1;
+	const int nodeId = sceneGraph.emplace(core::move(node), parent);
+	if (nodeId == InvalidNodeId) {
+		return false;
+	}
+	if (probeModels != nullptr) {
+		ProbeModel model;
+		model.region = region;
+		model.voxels = countVoxels(ogtModel);
+		probeModels->put(nodeId, model);
+	}
+	return true;
 }
 
 bool VoxFormat::loadGroup(const ogt_vox_scene *scene, uint32_t ogt_groupIdx, scenegraph::SceneGraph &sceneGraph,
 						  int parent, core::DynamicArray<MVModelToNode> &models, core::Set<uint32_t> &addedInstances,
-						  const palette::Palette &palette) {
+						  const palette::Palette &palette, ProbeModels *probeModels) {
 	const ogt_vox_group &ogt_group = scene->groups[ogt_groupIdx];
 	bool hidden = ogt_group.hidden;
 	const char *name = ogt_group.name ? ogt_group.name : "Group";
@@ -138,7 +168,7 @@ bool VoxFormat::loadGroup(const ogt_vox_scene *scene, uint32_t ogt_groupIdx, sce
 			continue;
 		}
 		Log::debug("Found matching group (%u) with scene graph parent: %i", groupIdx, groupId);
-		if (!loadGroup(scene, groupIdx, sceneGraph, groupId, models, addedInstances, palette)) {
+		if (!loadGroup(scene, groupIdx, sceneGraph, groupId, models, addedInstances, palette, probeModels)) {
 			return false;
 		}
 	}
@@ -151,7 +181,7 @@ bool VoxFormat::loadGroup(const ogt_vox_scene *scene, uint32_t ogt_groupIdx, sce
 		if (!addedInstances.insert(n)) {
 			continue;
 		}
-		if (!loadInstance(scene, n, sceneGraph, groupId, models, palette)) {
+		if (!loadInstance(scene, n, sceneGraph, groupId, models, palette, probeModels)) {
 			return false;
 		}
 	}
@@ -159,18 +189,17 @@ bool VoxFormat::loadGroup(const ogt_vox_scene *scene, uint32_t ogt_groupIdx, sce
 	return true;
 }
 
-bool VoxFormat::loadGroupsPalette(const core::String &filename, const io::ArchivePtr &archive,
-								  scenegraph::SceneGraph &sceneGraph, palette::Palette &palette, const LoadContext &ctx) {
+const ogt_vox_scene *VoxFormat::readScene(const core::String &filename, const io::ArchivePtr &archive) {
 	core::ScopedPtr<io::SeekableReadStream> stream(archive->readStream(filename));
 	if (!stream) {
 		Log::error("Could not open file %s", filename.c_str());
-		return 0;
+		return nullptr;
 	}
 	const size_t size = stream->size();
 	uint8_t *buffer = (uint8_t *)core_malloc(size);
 	if (stream->read(buffer, size) == -1) {
 		core_free(buffer);
-		return false;
+		return nullptr;
 	}
 	const uint32_t ogt_vox_flags = k_read_scene_flags_keyframes | k_read_scene_flags_groups |
 								   k_read_scene_flags_keep_empty_models_instances |
@@ -179,10 +208,19 @@ bool VoxFormat::loadGroupsPalette(const core::String &filename, const io::Archiv
 	core_free(buffer);
 	if (scene == nullptr) {
 		Log::error("Could not load scene %s", filename.c_str());
+		return nullptr;
+	}
+	printDetails(scene);
+	return scene;
+}
+
+bool VoxFormat::loadGroupsPalette(const core::String &filename, const io::ArchivePtr &archive,
+								  scenegraph::SceneGraph &sceneGraph, palette::Palette &palette, const LoadContext &ctx) {
+	const ogt_vox_scene *scene = readScene(filename, archive);
+	if (scene == nullptr) {
 		return false;
 	}
 
-	printDetails(scene);
 	loadPaletteFromScene(scene, palette);
 	if (!loadScene(scene, sceneGraph, palette)) {
 		ogt_vox_destroy_scene(scene);
@@ -201,9 +239,32 @@ bool VoxFormat::loadGroupsPalette(const core::String &filename, const io::Archiv
 	return true;
 }
 
+bool VoxFormat::probe(const core::String &filename, const io::ArchivePtr &archive, ProbeResult &result,
+					  const LoadContext &ctx) {
+	const ogt_vox_scene *scene = readScene(filename, archive);
+	if (scene == nullptr) {
+		return false;
+	}
+	palette::Palette palette;
+	loadPaletteFromScene(scene, palette);
+	scenegraph::SceneGraph sceneGraph;
+	ProbeModels models;
+	const bool success = loadScene(scene, sceneGraph, palette, &models);
+	ogt_vox_destroy_scene(scene);
+	if (!success) {
+		return false;
+	}
+	fillProbeResult(sceneGraph, models, true, result);
+	return true;
+}
+
 bool VoxFormat::loadScene(const ogt_vox_scene *scene, scenegraph::SceneGraph &sceneGraph,
-						  const palette::Palette &palette) {
-	core::DynamicArray<MVModelToNode> models = loadModels(scene, palette);
+						  const palette::Palette &palette, ProbeModels *probeModels) {
+	// the volumes of the models are only needed if there are no instances
+	core::DynamicArray<MVModelToNode> models;
+	if (probeModels == nullptr) {
+		models = loadModels(scene, palette);
+	}
 	core::Set<uint32_t> addedInstances;
 	for (uint32_t i = 0; i < scene->num_groups; ++i) {
 		const ogt_vox_group &group = scene->groups[i];
@@ -212,7 +273,7 @@ bool VoxFormat::loadScene(const ogt_vox_scene *scene, scenegraph::SceneGraph &sc
 			continue;
 		}
 		Log::debug("Add root group %u/%u", i, scene->num_groups);
-		if (!loadGroup(scene, i, sceneGraph, -1, models, addedInstances, palette)) {
+		if (!loadGroup(scene, i, sceneGraph, -1, models, addedInstances, palette, probeModels)) {
 			return false;
 		}
 		break;
@@ -222,11 +283,31 @@ bool VoxFormat::loadScene(const ogt_vox_scene *scene, scenegraph::SceneGraph &sc
 			continue;
 		}
 		// TODO: VOXELFORMAT: the parent is wrong
-		if (!loadInstance(scene, n, sceneGraph, sceneGraph.root().id(), models, palette)) {
+		if (!loadInstance(scene, n, sceneGraph, sceneGraph.root().id(), models, palette, probeModels)) {
 			return false;
 		}
 	}
 	if (scene->num_instances == 0 && scene->num_models > 0) {
+		if (probeModels != nullptr) {
+			for (uint32_t i = 0; i < scene->num_models; ++i) {
+				const ogt_vox_model *ogtModel = scene->models[i];
+				if (ogtModel == nullptr) {
+					continue;
+				}
+				scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+				node.setVolume(new voxel::RawVolume(voxel::Region(0, 0)), true);
+				node.setPalette(palette);
+				const int nodeId = sceneGraph.emplace(core::move(node), sceneGraph.root().id());
+				if (nodeId == InvalidNodeId) {
+					continue;
+				}
+				ProbeModel model;
+				model.region = voxel::Region(glm::ivec3(0), glm::ivec3(ogtModel->size_x - 1, ogtModel->size_z - 1,
+																	  ogtModel->size_y - 1));
+				model.voxels = countVoxels(ogtModel);
+				probeModels->put(nodeId, model);
+			}
+		}
 		for (MVModelToNode &m : models) {
 			scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
 			node.setVolume(m.volume, true);
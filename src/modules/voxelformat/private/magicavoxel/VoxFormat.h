@@ -32,12 +32,18 @@ private:
 
 	void saveInstance(const scenegraph::SceneGraph &sceneGraph, scenegraph::SceneGraphNode &node, MVSceneContext &ctx,
 					 uint32_t parentGroupIdx, uint32_t layerIdx, uint32_t modelIdx);
-	bool loadScene(const ogt_vox_scene *scene, scenegraph::SceneGraph &sceneGraph, const palette::Palette &palette);
+	/**
+	 * @param probeModels If this is not @c null, the model nodes only get a placeholder volume - see @c probe()
+	 */
+	bool loadScene(const ogt_vox_scene *scene, scenegraph::SceneGraph &sceneGraph, const palette::Palette &palette,
+				   ProbeModels *probeModels = nullptr);
 	bool loadInstance(const ogt_vox_scene *scene, uint32_t ogt_instanceIdx, scenegraph::SceneGraph &sceneGraph,
-					  int parent, core::DynamicArray<MVModelToNode> &models, const palette::Palette &palette);
+					  int parent, core::DynamicArray<MVModelToNode> &models, const palette::Palette &palette,
+					  ProbeModels *probeModels);
 	bool loadGroup(const ogt_vox_scene *scene, uint32_t ogt_parentGroupIdx, scenegraph::SceneGraph &sceneGraph,
 				   int parent, core::DynamicArray<MVModelToNode> &models, core::Set<uint32_t> &addedInstances,
-				   const palette::Palette &palette);
+				   const palette::Palette &palette, ProbeModels *probeModels);
+	const ogt_vox_scene *readScene(const core::String &filename, const io::ArchivePtr &archive);
 	bool loadGroupsPalette(const core::String &filename, const io::ArchivePtr &archive,
 						   scenegraph::SceneGraph &sceneGraph, palette::Palette &palette,
 						   const LoadContext &ctx) override;
@@ -50,6 +56,11 @@ public:
 	VoxFormat();
 	size_t loadPalette(const core::String &filename, const io::ArchivePtr &archive, palette::Palette &palette,
 					   const LoadContext &ctx) override;
+	/**
+	 * @brief The vox chunks are still parsed - but the volumes of the model nodes are not created
+	 */
+	bool probe(const core::String &filename, const io::ArchivePtr &archive, ProbeResult &result,
+			   const LoadContext &ctx) override;
 
 	static const io::FormatDescription &format() {
 		static io::FormatDescription f{
@@ -11,8 +11,10 @@
 #include "core/Log.h"
 #include "core/RGBA.h"
 #include "core/StringUtil.h"
+#include "core/Trace.h"
 #include "core/Var.h"
 #include "core/collection/DynamicArray.h"
+#include "core/collection/DynamicMap.h"
 #include "core/collection/Map.h"
 #include "core/concurrent/Lock.h"
 #include "io/Archive.h"
@@ -121,64 +123,163 @@ void MeshFormat::addToPosMap(PosMap &posMap, core::RGBA rgba, uint32_t area, uin
 	}
 }
 
-void MeshFormat::transformTris(const voxel::Region &region, const MeshTriCollection &tris, PosMap &posMap,
-							   const palette::NormalPalette &normalPalette) {
-	Log::debug("subdivided into %i triangles", (int)tris.size());
-	for (const voxelformat::MeshTri &meshTri : tris) {
-		if (stopExecution()) {
-			return;
-		}
-		const core::RGBA rgba = meshTri.centerColor();
-		if (rgba.a <= AlphaThreshold) {
-			continue;
+static_assert(MeshFormat::VoxelizeTileSize % voxel::RawVolume::OccupancyBrickSize == 0,
+			  "The voxelize tiles must not share the occupancy bricks of the volume");
+
+/**
+ * @brief Bins the triangles into the tiles of the volume. A triangle is added to every tile that its voxels might
+ * touch - the triangles of a tile keep the input order. The tiles are aligned to the lower corner of the given region,
+ * which must be the region of the volume the tiles are written to.
+ * @sa MeshFormat::VoxelizeTileSize
+ */
+class TriangleTiles {
+private:
+	core::DynamicArray<voxel::Region> _regions;
+	core::DynamicArray<core::DynamicArray<int>> _tris;
+
+public:
+	/**
+	 * @param bounds Computes the voxel bounds (inclusive) of the triangle with the given index:
+	 * @code void(int triIdx, glm::ivec3 &mins, glm::ivec3 &maxs) @endcode
+	 */
+	template<class FUNC>
+	TriangleTiles(const voxel::Region &region, int triCount, FUNC &&bounds) {
+		const glm::ivec3 &lower = region.getLowerCorner();
+		const glm::ivec3 &upper = region.getUpperCorner();
+		const glm::ivec3 tiles =
+			(region.getDimensionsInVoxels() + MeshFormat::VoxelizeTileSize - 1) / MeshFormat::VoxelizeTileSize;
+		core::DynamicArray<int> slots;
+		slots.resize((size_t)tiles.x * tiles.y * tiles.z);
+		slots.fill(-1);
+		for (int i = 0; i < triCount; ++i) {
+			glm::ivec3 mins;
+			glm::ivec3 maxs;
+			bounds(i, mins, maxs);
+			mins = glm::max(mins, lower);
+			maxs = glm::min(maxs, upper);
+			if (glm::any(glm::greaterThan(mins, maxs))) {
+				continue;
+			}
+			const glm::ivec3 tileMins = (mins - lower) / MeshFormat::VoxelizeTileSize;
+			const glm::ivec3 tileMaxs = (maxs - lower) / MeshFormat::VoxelizeTileSize;
+			for (int z = tileMins.z; z <= tileMaxs.z; ++z) {
+				for (int y = tileMins.y; y <= tileMaxs.y; ++y) {
+					for (int x = tileMins.x; x <= tileMaxs.x; ++x) {
+						int &slot = slots[x + y * tiles.x + z * tiles.x * tiles.y];
+						if (slot == -1) {
+							slot = (int)_tris.size();
+							const glm::ivec3 tileLower = lower + glm::ivec3(x, y, z) * MeshFormat::VoxelizeTileSize;
+							const glm::ivec3 tileUpper =
+								glm::min(tileLower + MeshFormat::VoxelizeTileSize - 1, upper);
+							_regions.emplace_back(tileLower, tileUpper);
+							_tris.emplace_back();
+						}
+						_tris[slot].push_back(i);
+					}
+				}
+			}
 		}
-		const uint32_t area = (uint32_t)(meshTri.area() * 1000.0f);
-		glm::vec3 c = meshTri.center();
-		convertToVoxelGrid(c);
+	}
+
+	/**
+	 * @return The amount of tiles that have triangles
+	 */
+	inline int size() const {
+		return (int)_tris.size();
+	}
 
-		const uint8_t normalIdx = normalPalette.getClosestMatch(meshTri.normal());
+	inline const voxel::Region &region(int tile) const {
+		return _regions[tile];
+	}
 
-		const glm::ivec3 p(c);
-		core_assert_msg(region.containsPoint(p), "Failed to transform tri %i:%i:%i (region: %s)", p.x, p.y, p.z,
-						region.toString().c_str());
-		addToPosMap(posMap, rgba, area, normalIdx, p, meshTri.material);
+	inline const core::DynamicArray<int> &tris(int tile) const {
+		return _tris[tile];
 	}
+};
+
+static glm::ivec3 voxelPos(const voxelformat::MeshTri &meshTri) {
+	glm::vec3 c = meshTri.center();
+	convertToVoxelGrid(c);
+	return glm::ivec3(c);
 }
 
-void MeshFormat::transformTrisAxisAligned(const voxel::Region &region, const MeshTriCollection &tris, PosMap &posMap, const palette::NormalPalette &normalPalette) {
-	Log::debug("axis aligned %i triangles", (int)tris.size());
-	for (const voxelformat::MeshTri &meshTri : tris) {
-		if (stopExecution()) {
-			return;
-		}
-		const core::RGBA rgba = meshTri.centerColor();
-		if (rgba.a <= AlphaThreshold) {
-			continue;
+void MeshFormat::transformTris(const voxel::Region &region, const MeshTriCollection &tris, PosMaps &posMaps,
+							   const palette::NormalPalette &normalPalette) {
+	Log::debug("subdivided into %i triangles", (int)tris.size());
+	const TriangleTiles tiles(region, (int)tris.size(), [&tris](int triIdx, glm::ivec3 &mins, glm::ivec3 &maxs) {
+		mins = maxs = voxelPos(tris[triIdx]);
+	});
+	posMaps.reserve(tiles.size());
+	for (int tile = 0; tile < tiles.size(); ++tile) {
+		posMaps.emplace_back((int)tiles.tris(tile).size());
+	}
+	app::for_parallel(0, tiles.size(), [&](int start, int end) {
+		for (int tile = start; tile < end; ++tile) {
+			PosMap &posMap = posMaps[tile];
+			for (int triIdx : tiles.tris(tile)) {
+				if (stopExecution()) {
+					return;
+				}
+				const voxelformat::MeshTri &meshTri = tris[triIdx];
+				const core::RGBA rgba = meshTri.centerColor();
+				if (rgba.a <= AlphaThreshold) {
+					continue;
+				}
+				const uint32_t area = (uint32_t)(meshTri.area() * 1000.0f);
+				const uint8_t normalIdx = normalPalette.getClosestMatch(meshTri.normal());
+				addToPosMap(posMap, rgba, area, normalIdx, voxelPos(meshTri), meshTri.material);
+			}
 		}
-		const uint32_t area = (uint32_t)(meshTri.area() * 1000.0f);
-		const glm::vec3 &normal = glm::normalize(meshTri.normal());
-		const glm::ivec3 sideDelta(normal.x <= 0 ? 0 : -1, normal.y <= 0 ? 0 : -1, normal.z <= 0 ? 0 : -1);
-		const glm::ivec3 mins = meshTri.roundedMins();
-		const glm::ivec3 maxs = meshTri.roundedMaxs() + glm::ivec3(glm::round(glm::abs(normal)));
-		Log::trace("mins: %i:%i:%i", mins.x, mins.y, mins.z);
-		Log::trace("maxs: %i:%i:%i", maxs.x, maxs.y, maxs.z);
-		Log::trace("normal: %f:%f:%f", normal.x, normal.y, normal.z);
-		Log::trace("sideDelta: %i:%i:%i", sideDelta.x, sideDelta.y, sideDelta.z);
-		const uint8_t normalIdx = normalPalette.getClosestMatch(normal);
-		for (int x = mins.x; x < maxs.x; x++) {
-			for (int y = mins.y; y < maxs.y; y++) {
-				for (int z = mins.z; z < maxs.z; z++) {
-					const glm::ivec3 p(x + sideDelta.x, y + sideDelta.y, z + sideDelta.z);
-					if (!region.containsPoint(p)) {
-						Log::debug("Failed to transform tri %i:%i:%i (region: %s), (sideDelta: %i:%i:%i)", p.x, p.y,
-								   p.z, region.toString().c_str(), sideDelta.x, sideDelta.y, sideDelta.z);
-						continue;
+	});
+}
+
+void MeshFormat::transformTrisAxisAligned(const voxel::Region &region, const MeshTriCollection &tris,
+										  PosMaps &posMaps, const palette::NormalPalette &normalPalette) {
+	Log::debug("axis aligned %i triangles", (int)tris.size());
+	// the side delta moves the voxels by at most one voxel into the negative direction
+	const TriangleTiles tiles(region, (int)tris.size(), [&tris](int triIdx, glm::ivec3 &mins, glm::ivec3 &maxs) {
+		mins = tris[triIdx].roundedMins() - 1;
+		maxs = tris[triIdx].roundedMaxs();
+	});
+	posMaps.reserve(tiles.size());
+	for (int tile = 0; tile < tiles.size(); ++tile) {
+		const glm::ivec3 &dim = tiles.region(tile).getDimensionsInVoxels();
+		posMaps.emplace_back(dim.x * dim.y * dim.z);
+	}
+	app::for_parallel(0, tiles.size(), [&](int start, int end) {
+		for (int tile = start; tile < end; ++tile) {
+			const voxel::Region &tileRegion = tiles.region(tile);
+			PosMap &posMap = posMaps[tile];
+			for (int triIdx : tiles.tris(tile)) {
+				if (stopExecution()) {
+					return;
+				}
+				const voxelformat::MeshTri &meshTri = tris[triIdx];
+				const core::RGBA rgba = meshTri.centerColor();
+				if (rgba.a <= AlphaThreshold) {
+					continue;
+				}
+				const uint32_t area = (uint32_t)(meshTri.area() * 1000.0f);
+				const glm::vec3 &normal = glm::normalize(meshTri.normal());
+				const glm::ivec3 sideDelta(normal.x <= 0 ? 0 : -1, normal.y <= 0 ? 0 : -1, normal.z <= 0 ? 0 : -1);
+				const glm::ivec3 mins = meshTri.roundedMins();
+				const glm::ivec3 maxs = meshTri.roundedMaxs() + glm::ivec3(glm::round(glm::abs(normal)));
+				const uint8_t normalIdx = normalPalette.getClosestMatch(normal);
+				for (int x = mins.x; x < maxs.x; x++) {
+					for (int y = mins.y; y < maxs.y; y++) {
+						for (int z = mins.z; z < maxs.z; z++) {
+							const glm::ivec3 p(x + sideDelta.x, y + sideDelta.y, z + sideDelta.z);
+							// the tile region is part of the volume region - other tiles handle the remaining voxels
+							if (!tileRegion.containsPoint(p)) {
+								continue;
+							}
+							addToPosMap(posMap, rgba, area, normalIdx, p, meshTri.material);
+						}
 					}
-					addToPosMap(posMap, rgba, area, normalIdx, p, meshTri.material);
 				}
 			}
 		}
-	}
+	});
 }
 
 bool MeshFormat::isVoxelMesh(const MeshTriCollection &tris) {
@@ -200,18 +301,39 @@ bool MeshFormat::isVoxelMesh(const MeshTriCollection &tris) {
 	return true;
 }
 
+/**
+ * @brief The range of the loop indices for @c voxelizeTriangle() - the voxel positions are the indices plus the
+ * integral @c trisMins (plus one for negative positions)
+ */
+static void voxelizeTriangleRange(const glm::vec3 &trisMins, const voxelformat::MeshTri &meshTri, glm::ivec3 &imins,
+								  glm::ivec3 &imaxs) {
+	const glm::vec3 voxelHalf(0.5f);
+	const glm::vec3 shiftedTrisMins = trisMins + voxelHalf;
+	const glm::vec3 mins = meshTri.mins();
+	const glm::vec3 maxs = meshTri.maxs();
+	imins = glm::ivec3(glm::floor(mins - shiftedTrisMins));
+	const glm::ivec3 size(glm::round(maxs - mins));
+	imaxs = 2 + imins + size;
+}
+
+/**
+ * @brief Calls the functor for every voxel of the given tile region that intersects the triangle
+ */
 template<class FUNC>
-static void voxelizeTriangle(const glm::vec3 &trisMins, const voxelformat::MeshTri &meshTri, FUNC &&func) {
+static void voxelizeTriangle(const glm::vec3 &trisMins, const voxel::Region &tileRegion,
+							 const voxelformat::MeshTri &meshTri, FUNC &&func) {
 	const glm::vec3 voxelHalf(0.5f);
 	const glm::vec3 shiftedTrisMins = trisMins + voxelHalf;
 	const glm::vec3 &v0 = meshTri.vertices[0];
 	const glm::vec3 &v1 = meshTri.vertices[1];
 	const glm::vec3 &v2 = meshTri.vertices[2];
-	const glm::vec3 mins = meshTri.mins();
-	const glm::vec3 maxs = meshTri.maxs();
-	const glm::ivec3 imins(glm::floor(mins - shiftedTrisMins));
-	const glm::ivec3 size(glm::round(maxs - mins));
-	const glm::ivec3 imaxs = 2 + imins + size;
+	glm::ivec3 imins;
+	glm::ivec3 imaxs;
+	voxelizeTriangleRange(trisMins, meshTri, imins, imaxs);
+	// skip the loop indices that can't end up in the tile
+	const glm::ivec3 itrisMins(trisMins);
+	imins = glm::max(imins, tileRegion.getLowerCorner() - itrisMins - 1);
+	imaxs = glm::min(imaxs, tileRegion.getUpperCorner() - itrisMins + 1);
 
 	glm::vec3 center {};
 	for (int x = imins.x; x < imaxs.x; x++) {
@@ -220,12 +342,16 @@ static void voxelizeTriangle(const glm::vec3 &trisMins, const voxelformat::MeshT
 			center.y = trisMins.y + y;
 			for (int z = imins.z; z < imaxs.z; z++) {
 				center.z = trisMins.z + z;
+				const glm::ivec3 pos(shiftedTrisMins.x + x, shiftedTrisMins.y + y, shiftedTrisMins.z + z);
+				if (!tileRegion.containsPoint(pos)) {
+					continue;
+				}
 				if (glm::intersectTriangleAABB(center, voxelHalf, v0, v1, v2)) {
 					glm::vec2 uv;
 					if (!meshTri.calcUVs(center, uv)) {
 						continue;
 					}
-					func(meshTri, uv, shiftedTrisMins.x + x, shiftedTrisMins.y + y, shiftedTrisMins.z + z);
+					func(meshTri, uv, pos.x, pos.y, pos.z);
 				}
 			}
 		}
@@ -276,46 +402,72 @@ int MeshFormat::voxelizeNode(const core::String &uuid, const core::String &name,
 	const int voxelizeMode = core::Var::getSafe(cfg::VoxformatVoxelizeMode)->intVal();
 	const bool fillHollow = core::Var::getSafe(cfg::VoxformatFillHollow)->boolVal();
 	if (axisAligned) {
-		const int maxVoxels = vdim.x * vdim.y * vdim.z;
-		Log::debug("max voxels: %i (%i:%i:%i)", maxVoxels, vdim.x, vdim.y, vdim.z);
-		PosMap posMap(maxVoxels);
-		transformTrisAxisAligned(region, tris, posMap, normalPalette);
-		voxelizeTris(node, posMap, fillHollow);
+		Log::debug("max voxels: %i (%i:%i:%i)", vdim.x * vdim.y * vdim.z, vdim.x, vdim.y, vdim.z);
+		PosMaps posMaps;
+		transformTrisAxisAligned(region, tris, posMaps, normalPalette);
+		voxelizeTris(node, posMaps, fillHollow);
 	} else if (voxelizeMode == VoxelizeMode::Fast) {
-		voxel::RawVolumeWrapper wrapper(node.volume());
+		voxel::RawVolume *volume = node.volume();
 		palette::Palette palette;
 
+		const TriangleTiles tiles(region, (int)tris.size(),
+								  [&tris, &trisMins](int triIdx, glm::ivec3 &mins, glm::ivec3 &maxs) {
+									  voxelizeTriangleRange(trisMins, tris[triIdx], mins, maxs);
+									  mins += glm::ivec3(trisMins);
+									  maxs += glm::ivec3(trisMins);
+								  });
 		const bool shouldCreatePalette = core::Var::getSafe(cfg::VoxelCreatePalette)->boolVal();
 		if (shouldCreatePalette) {
-			RGBAMaterialMap colorMaterials;
 			Log::debug("create palette");
-			for (const voxelformat::MeshTri &meshTri : tris) {
-#if 1
-				voxelizeTriangle(trisMins, meshTri, [this, &colorMaterials] (const voxelformat::MeshTri &tri, const glm::vec2 &uv, int x, int y, int z) {
-					const core::RGBA rgba = flattenRGB(tri.colorAt(uv));
-					colorMaterials.put(rgba, tri.material ? &tri.material->material : nullptr);
+			// the colors are merged in batch order - the palette doesn't depend on the amount of threads
+			const core::DynamicArray<RGBAMaterialMap> &batches = app::map_parallel<RGBAMaterialMap>(
+				0, tiles.size(), 16, [&](int start, int end, RGBAMaterialMap &colorMaterials) {
+					for (int tile = start; tile < end; ++tile) {
+						const voxel::Region &tileRegion = tiles.region(tile);
+						for (int triIdx : tiles.tris(tile)) {
+							voxelizeTriangle(trisMins, tileRegion, tris[triIdx],
+											 [this, &colorMaterials](const voxelformat::MeshTri &tri,
+																	 const glm::vec2 &uv, int x, int y, int z) {
+												 const core::RGBA rgba = flattenRGB(tri.colorAt(uv));
+												 colorMaterials.put(rgba, tri.material ? &tri.material->material
+																					   : nullptr);
+											 });
+						}
+					}
 				});
-#else
-				const core::RGBA rgba = flattenRGB(triangle.centerColor());
-				colorMaterials.put(rgba, tri.material ? &tri.material->material : nullptr);
-#endif
+			RGBAMaterialMap colorMaterials;
+			for (const RGBAMaterialMap &batchColors : batches) {
+				for (const auto &entry : batchColors) {
+					colorMaterials.put(entry->key, entry->value);
+				}
 			}
 			createPalette(colorMaterials, palette);
 		} else {
 			palette = voxel::getPalette();
 		}
 
-		Log::debug("create voxels from %i tris", (int)tris.size());
-		palette::PaletteLookup palLookup(palette);
-		for (const voxelformat::MeshTri &meshTri : tris) {
-			voxelizeTriangle(trisMins, meshTri, [&] (const voxelformat::MeshTri &tri, const glm::vec2 &uv, int x, int y, int z) {
-				const core::RGBA color = flattenRGB(tri.colorAt(uv));
-				const glm::vec3 &normal = tri.normal();
-				const uint8_t normalIndex = normalPalette.getClosestMatch(normal);
-				const voxel::Voxel voxel = voxel::createVoxel(palette, palLookup.findClosestIndex(color), normalIndex);
-				wrapper.setVoxel(x, y, z, voxel);
-			});
-		}
+		Log::debug("create voxels from %i tris in %i tiles", (int)tris.size(), tiles.size());
+		// the tiles don't share any voxel - the volume can be modified concurrently
+		app::for_parallel(0, tiles.size(), [&](int start, int end) {
+			palette::PaletteLookup palLookup(palette);
+			for (int tile = start; tile < end; ++tile) {
+				if (stopExecution()) {
+					return;
+				}
+				const voxel::Region &tileRegion = tiles.region(tile);
+				for (int triIdx : tiles.tris(tile)) {
+					voxelizeTriangle(trisMins, tileRegion, tris[triIdx],
+									 [&](const voxelformat::MeshTri &tri, const glm::vec2 &uv, int x, int y, int z) {
+										 const core::RGBA color = flattenRGB(tri.colorAt(uv));
+										 const glm::vec3 &normal = tri.normal();
+										 const uint8_t normalIndex = normalPalette.getClosestMatch(normal);
+										 const voxel::Voxel voxel = voxel::createVoxel(
+											 palette, palLookup.findClosestIndex(color), normalIndex);
+										 volume->setVoxel(x, y, z, voxel);
+									 });
+				}
+			}
+		});
 
 		if (palette.colorCount() == 1) {
 			core::RGBA c = palette.color(0);
@@ -327,24 +479,26 @@ int MeshFormat::voxelizeNode(const core::String &uuid, const core::String &name,
 		node.setPalette(palette);
 		if (fillHollow && !stopExecution()) {
 			Log::debug("fill hollows");
+			voxel::RawVolumeWrapper wrapper(volume);
 			const voxel::Voxel voxel = voxel::createVoxel(palette, FillColorIndex);
 			voxelutil::fillHollow(wrapper, voxel);
 		}
 	} else {
 		Log::debug("Subdivide %i triangles", (int)tris.size());
-		core::DynamicArray<std::future<MeshTriCollection>> futures;
-		futures.reserve(tris.size());
-		for (const voxelformat::MeshTri &meshTri : tris) {
-			futures.emplace_back(app::async([meshTri]() {
-				MeshTriCollection subdivided;
-				subdivideTri(meshTri, subdivided);
-				return subdivided;
-			}));
+		const core::DynamicArray<MeshTriCollection> &batches = app::map_parallel<MeshTriCollection>(
+			0, (int)tris.size(), 256, [&tris](int start, int end, MeshTriCollection &subdivided) {
+				for (int i = start; i < end; ++i) {
+					subdivideTri(tris[i], subdivided);
+				}
+			});
+		size_t subdividedCount = 0u;
+		for (const MeshTriCollection &batch : batches) {
+			subdividedCount += batch.size();
 		}
 		MeshTriCollection subdivided;
-		for (std::future<MeshTriCollection> &future : futures) {
-			const MeshTriCollection &sub = future.get();
-			subdivided.append(sub);
+		subdivided.reserve(subdividedCount);
+		for (const MeshTriCollection &batch : batches) {
+			subdivided.append(batch);
 		}
 
 		if (subdivided.empty()) {
@@ -352,9 +506,9 @@ int MeshFormat::voxelizeNode(const core::String &uuid, const core::String &name,
 			return InvalidNodeId;
 		}
 
-		PosMap posMap((int)subdivided.size() * 3);
-		transformTris(region, subdivided, posMap, normalPalette);
-		voxelizeTris(node, posMap, fillHollow);
+		PosMaps posMaps;
+		transformTris(region, subdivided, posMaps, normalPalette);
+		voxelizeTris(node, posMaps, fillHollow);
 	}
 
 	if (resetOrigin) {
@@ -385,42 +539,53 @@ bool MeshFormat::calculateAABB(const MeshTriCollection &tris, glm::vec3 &mins, g
 	return true;
 }
 
-void MeshFormat::voxelizeTris(scenegraph::SceneGraphNode &node, const PosMap &posMap, bool fillHollow) const {
-	voxel::RawVolumeWrapper wrapper(node.volume());
+void MeshFormat::voxelizeTris(scenegraph::SceneGraphNode &node, const PosMaps &posMaps, bool fillHollow) const {
 	palette::Palette palette;
 	const bool shouldCreatePalette = core::Var::getSafe(cfg::VoxelCreatePalette)->boolVal();
 	if (shouldCreatePalette) {
 		RGBAMaterialMap colorMaterials;
 		Log::debug("create palette");
-		for (const auto &entry : posMap) {
-			if (stopExecution()) {
-				return;
-			}
-			const PosSampling &pos = entry->second;
-			const core::RGBA rgba = pos.getColor(_flattenFactor, _weightedAverage);
-			if (rgba.a <= AlphaThreshold) {
-				continue;
+		for (const PosMap &posMap : posMaps) {
+			for (const auto &entry : posMap) {
+				if (stopExecution()) {
+					return;
+				}
+				const PosSampling &pos = entry->second;
+				const core::RGBA rgba = pos.getColor(_flattenFactor, _weightedAverage);
+				if (rgba.a <= AlphaThreshold) {
+					continue;
+				}
+				const MeshMaterialPtr &material = pos.getMaterial();
+				colorMaterials.put(rgba, material ? &material->material : nullptr);
 			}
-			const MeshMaterialPtr &material = pos.getMaterial();
-			colorMaterials.put(rgba, material ? &material->material : nullptr);
 		}
 		createPalette(colorMaterials, palette);
 	} else {
 		palette = voxel::getPalette();
 	}
 
-	Log::debug("create voxels for %i positions", (int)posMap.size());
-	for (const auto &entry : posMap) {
-		if (stopExecution()) {
-			return;
-		}
-		const PosSampling &pos = entry->second;
-		const core::RGBA rgba = pos.getColor(_flattenFactor, _weightedAverage);
-		if (rgba.a <= AlphaThreshold) {
-			continue;
+	Log::debug("create voxels for %i tiles", (int)posMaps.size());
+	// the positions of the tiles are disjunct - the volume can be modified concurrently
+	voxel::RawVolume *volume = node.volume();
+	app::for_parallel(0, (int)posMaps.size(), [&](int start, int end) {
+		for (int tile = start; tile < end; ++tile) {
+			for (const auto &entry : posMaps[tile]) {
+				if (stopExecution()) {
+					return;
+				}
+				const PosSampling &pos = entry->second;
+				const core::RGBA rgba = pos.getColor(_flattenFactor, _weightedAverage);
+				if (rgba.a <= AlphaThreshold) {
+					continue;
+				}
+				const voxel::Voxel voxel =
+					voxel::createVoxel(palette, palette.getClosestMatch(rgba), pos.getNormal());
+				volume->setVoxel(entry->first, voxel);
+			}
 		}
-		const voxel::Voxel voxel = voxel::createVoxel(palette, palette.getClosestMatch(rgba), pos.getNormal());
-		wrapper.setVoxel(entry->first, voxel);
+	});
+	if (stopExecution()) {
+		return;
 	}
 	if (palette.colorCount() == 1) {
 		core::RGBA c = palette.color(0);
@@ -431,10 +596,8 @@ void MeshFormat::voxelizeTris(scenegraph::SceneGraphNode &node, const PosMap &po
 	}
 	node.setPalette(palette);
 	if (fillHollow) {
-		if (stopExecution()) {
-			return;
-		}
 		Log::debug("fill hollows");
+		voxel::RawVolumeWrapper wrapper(volume);
 		const voxel::Voxel voxel = voxel::createVoxel(palette, FillColorIndex);
 		voxelutil::fillHollow(wrapper, voxel);
 	}
@@ -560,6 +723,94 @@ core::String MeshFormat::lookupTexture(const core::String &meshFilename, const c
 	return fullpath;
 }
 
+/**
+ * @brief Key of a vertex on a z plane of a mesh - the x and y position must fit into 20 bits
+ */
+static inline uint64_t planeVertexKey(const voxel::VoxelVertex &vertex) {
+	return ((uint64_t)(uint32_t)vertex.position.x & 0xFFFFFu) | (((uint64_t)(uint32_t)vertex.position.y & 0xFFFFFu) << 20) |
+		   ((uint64_t)vertex.info << 40) | ((uint64_t)vertex.colorIndex << 48) | ((uint64_t)vertex.normalIndex << 56);
+}
+
+using PlaneVertices = core::DynamicMap<uint64_t, voxel::IndexType, 1031>;
+
+/**
+ * @brief Appends the mesh of a slice to the target mesh. If @c stitch is @c true, the vertices on the lower z plane of
+ * the slice are replaced by the equal vertices on the upper z plane of the previous slice.
+ *
+ * @param[in,out] planeVertices The vertices of the previous slice on the shared plane - contains the vertices of this
+ * slice on its upper plane afterwards
+ */
+static void appendSlice(voxel::Mesh &target, const voxel::Mesh &slice, int lowerZ, int upperZ, bool stitch,
+						PlaneVertices &planeVertices) {
+	const voxel::VertexArray &vertices = slice.getVertexVector();
+	core::DynamicArray<voxel::IndexType> indexMap;
+	indexMap.resize(vertices.size());
+	PlaneVertices upperPlaneVertices;
+	for (size_t i = 0; i < vertices.size(); ++i) {
+		const voxel::VoxelVertex &vertex = vertices[i];
+		const int z = (int)vertex.position.z;
+		if (stitch && z == lowerZ && planeVertices.get(planeVertexKey(vertex), indexMap[i])) {
+			continue;
+		}
+		indexMap[i] = target.addVertex(vertex);
+		if (stitch && z == upperZ) {
+			upperPlaneVertices.put(planeVertexKey(vertex), indexMap[i]);
+		}
+	}
+	const voxel::IndexArray &indices = slice.getIndexVector();
+	for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+		target.addTriangle(indexMap[indices[i]], indexMap[indices[i + 1]], indexMap[indices[i + 2]]);
+	}
+	planeVertices = core::move(upperPlaneVertices);
+}
+
+void MeshFormat::extractMesh(voxel::SurfaceExtractionType type, const voxel::RawVolume *volume,
+							 const voxel::Region &region, const palette::Palette &palette, voxel::ChunkMesh &mesh,
+							 bool mergeQuads, bool reuseVertices, bool ambientOcclusion) {
+	const int sliceDepth = ExtractSliceDepth;
+	const glm::ivec3 &mins = region.getLowerCorner();
+	const glm::ivec3 &maxs = region.getUpperCorner();
+	if (!voxel::isCubicMesh(type) || region.getDepthInVoxels() <= sliceDepth) {
+		voxel::SurfaceExtractionContext ctx = voxel::createContext(type, volume, region, palette, mesh, {0, 0, 0},
+																   mergeQuads, reuseVertices, ambientOcclusion);
+		voxel::extractSurface(ctx);
+		return;
+	}
+	core_trace_scoped(ExtractMeshSlices);
+	const core::DynamicArray<voxel::ChunkMesh> &slices = app::map_parallel<voxel::ChunkMesh>(
+		mins.z, maxs.z + 1, sliceDepth, [&](int start, int end, voxel::ChunkMesh &sliceMesh) {
+			const voxel::Region sliceRegion(mins.x, mins.y, start, maxs.x, maxs.y, end - 1);
+			// the vertices of all slices are relative to the lower corner of the whole region
+			const glm::ivec3 translate(0, 0, start - mins.z);
+			voxel::SurfaceExtractionContext ctx =
+				voxel::createContext(type, volume, sliceRegion, palette, sliceMesh, translate, mergeQuads,
+									 reuseVertices, ambientOcclusion);
+			voxel::extractSurface(ctx);
+		});
+
+	mesh.clear();
+	mesh.setOffset(mins);
+	const glm::ivec3 &dim = region.getDimensionsInVoxels();
+	const bool stitch = reuseVertices && dim.x <= 0xFFFFF && dim.y <= 0xFFFFF;
+	for (int i = 0; i < voxel::ChunkMesh::Meshes; ++i) {
+		voxel::Mesh &target = mesh.mesh[i];
+		size_t vertices = 0u;
+		size_t indices = 0u;
+		for (const voxel::ChunkMesh &slice : slices) {
+			vertices += slice.mesh[i].getNoOfVertices();
+			indices += slice.mesh[i].getNoOfIndices();
+		}
+		target.getVertexVector().reserve(vertices);
+		target.getIndexVector().reserve(indices);
+		PlaneVertices planeVertices;
+		for (size_t n = 0; n < slices.size(); ++n) {
+			const int lowerZ = (int)n * sliceDepth;
+			appendSlice(target, slices[n].mesh[i], lowerZ, lowerZ + sliceDepth, stitch, planeVertices);
+		}
+		target.compressIndices();
+	}
+}
+
 bool MeshFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const core::String &filename,
 							const io::ArchivePtr &archive, const SaveContext &saveCtx) {
 	const bool mergeQuads = core::Var::getSafe(cfg::VoxformatMergequads)->boolVal();
@@ -586,10 +837,7 @@ bool MeshFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const core
 			voxel::Region regionExt = region;
 			// we are increasing the region by one voxel to ensure the inclusion of the boundary voxels in this mesh
 			regionExt.shiftUpperCorner(1, 1, 1);
-			voxel::SurfaceExtractionContext ctx =
-				voxel::createContext(type, volume, regionExt, node.palette(), *mesh, {0, 0, 0}, mergeQuads,
-									 reuseVertices, ambientOcclusion);
-			voxel::extractSurface(ctx);
+			extractMesh(type, volume, regionExt, node.palette(), *mesh, mergeQuads, reuseVertices, ambientOcclusion);
 			if (withNormals) {
 				Log::debug("Calculate normals");
 				mesh->calculateNormals();
@@ -630,7 +878,7 @@ bool MeshFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const core
 	} else {
 		Log::debug("Save meshes");
 		state = saveMeshes(meshIdxNodeMap, sceneGraph, nonEmptyMeshes, filename, archive, {1.0f, 1.0f, 1.0f},
-						   type == voxel::SurfaceExtractionType::Cubic ? quads : false, withColor, withTexCoords);
+						   voxel::isCubicMesh(type) ? quads : false, withColor, withTexCoords);
 	}
 	for (MeshExt &meshext : meshes) {
 		delete meshext.mesh;
@@ -11,6 +11,7 @@
 #include "io/Archive.h"
 #include "palette/NormalPalette.h"
 #include "voxel/ChunkMesh.h"
+#include "voxel/SurfaceExtractor.h"
 #include "voxelformat/Format.h"
 
 namespace voxelformat {
@@ -25,6 +26,12 @@ namespace voxelformat {
 class MeshFormat : public Format {
 public:
 	static constexpr const uint8_t FillColorIndex = 2;
+	/**
+	 * @brief The side length of the tiles the volume is split into to voxelize the triangles in parallel
+	 * @note The tiles are aligned to the lower corner of the volume and the size must be a multiple of
+	 * @c voxel::RawVolume::OccupancyBrickSize - so the parallel writers never share an occupancy brick
+	 */
+	static constexpr const int VoxelizeTileSize = 32;
 	using MeshTriCollection = core::DynamicArray<voxelformat::MeshTri, 512>;
 
 	/**
@@ -37,6 +44,19 @@ public:
 	 */
 	static bool isVoxelMesh(const MeshTriCollection &tris);
 
+	/**
+	 * @brief The depth of the z slices the cubic meshes are extracted in parallel
+	 */
+	static constexpr const int ExtractSliceDepth = 64;
+	/**
+	 * @brief Extracts the mesh of the given region. The cubic mesh types are extracted in slices of
+	 * @c ExtractSliceDepth along the z axis in parallel and merged in slice order - the result doesn't depend on the
+	 * amount of threads.
+	 */
+	static void extractMesh(voxel::SurfaceExtractionType type, const voxel::RawVolume *volume,
+							const voxel::Region &region, const palette::Palette &palette, voxel::ChunkMesh &mesh,
+							bool mergeQuads, bool reuseVertices, bool ambientOcclusion);
+
 protected:
 	/**
 	 * @brief Color flatten factor - see @c PosSampling::getColor()
@@ -130,6 +150,11 @@ protected:
 	 * @brief A map with positions and colors that can get averaged from the input triangles
 	 */
 	typedef core::Map<glm::ivec3, PosSampling, 64, glm::hash<glm::ivec3>> PosMap;
+	/**
+	 * @brief One @c PosMap per tile of the volume. A position is only part of one tile - this allows to fill the
+	 * maps in parallel without changing the result.
+	 */
+	using PosMaps = core::DynamicArray<PosMap>;
 	static void addToPosMap(PosMap &posMap, core::RGBA rgba, uint32_t area, uint8_t normalIdx, const glm::ivec3 &pos,
 							const MeshMaterialPtr &material);
 
@@ -137,32 +162,32 @@ protected:
 	 * @brief Convert the given input triangles into a list of positions to place the voxels at
 	 *
 	 * @param[in] tris The triangles to voxelize
-	 * @param[out] posMap The PosMap instance to fill with positions and colors
+	 * @param[out] posMaps The PosMap instances to fill with positions and colors
 	 * @sa transformTrisAxisAligned()
 	 * @sa voxelizeTris()
 	 */
-	static void transformTris(const voxel::Region &region, const MeshTriCollection &tris, PosMap &posMap,
+	static void transformTris(const voxel::Region &region, const MeshTriCollection &tris, PosMaps &posMaps,
 							  const palette::NormalPalette &normalPalette);
 	/**
 	 * @brief Convert the given input triangles into a list of positions to place the voxels at. This version is for
 	 * aligned aligned triangles. This is usually the case for meshes that were exported from voxels.
 	 *
 	 * @param[in] tris The triangles to voxelize
-	 * @param[out] posMap The @c PosMap instance to fill with positions and colors
+	 * @param[out] posMaps The @c PosMap instances to fill with positions and colors
 	 * @sa transformTris()
 	 * @sa voxelizeTris()
 	 */
-	static void transformTrisAxisAligned(const voxel::Region &region, const MeshTriCollection &tris, PosMap &posMap,
-										 const palette::NormalPalette &normalPalette);
+	static void transformTrisAxisAligned(const voxel::Region &region, const MeshTriCollection &tris,
+										 PosMaps &posMaps, const palette::NormalPalette &normalPalette);
 	/**
-	 * @brief Convert the given @c PosMap into a volume
+	 * @brief Convert the given @c PosMap instances into a volume
 	 *
 	 * @note The @c PosMap values can get calculated by @c transformTris() or @c transformTrisAxisAligned()
-	 * @param[in] posMap The @c PosMap values with voxel positions and colors
+	 * @param[in] posMaps The @c PosMap values with voxel positions and colors
 	 * @param[in] fillHollow Fill the inner parts of a voxel volume
 	 * @param[out] node The node to create the volume in
 	 */
-	void voxelizeTris(scenegraph::SceneGraphNode &node, const PosMap &posMap, bool fillHollow) const;
+	void voxelizeTris(scenegraph::SceneGraphNode &node, const PosMaps &posMaps, bool fillHollow) const;
 
 public:
 	static core::String lookupTexture(const core::String &meshFilename, const core::String &in);
@@ -83,39 +83,72 @@ bool DatFormat::loadGroupsPalette(const core::String &filename, const io::Archiv
 
 	int nodesAdded = 0;
 
-	core::DynamicArray<std::future<scenegraph::SceneGraph>> futures;
-	Log::info("Found %i region files", (int)entities.size());
+	core::DynamicArray<core::String> regionFilenames;
+	regionFilenames.reserve(entities.size());
 	for (const io::FilesystemEntry &e : entities) {
 		if (e.type != io::FilesystemEntry::Type::file) {
 			continue;
 		}
-		const core::String &regionFilename = core::string::path(baseName, "region", e.name);
-		futures.emplace_back(app::async([regionFilename, &archive, &loadctx]() {
-			MCRFormat mcrFormat;
-			scenegraph::SceneGraph newSceneGraph;
-			if (!mcrFormat.load(regionFilename, archive, newSceneGraph, loadctx)) {
-				Log::debug("Could not load %s", regionFilename.c_str());
-				return core::move(newSceneGraph);
-			}
-			const scenegraph::SceneGraph::MergeResult &merged = newSceneGraph.merge();
-			newSceneGraph.clear();
-			if (!merged.hasVolume()) {
-				return core::move(newSceneGraph);
-			}
-			scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
-			node.setVolume(merged.volume(), true);
-			node.setPalette(merged.palette);
-			node.setNormalPalette(merged.normalPalette);
-			newSceneGraph.emplace(core::move(node));
+		regionFilenames.push_back(core::string::path(baseName, "region", e.name));
+	}
+
+	// the region nodes are handed out to the caller by this format - the chunks of a region are not streamed
+	LoadContext regionctx;
+	regionctx.monitor = loadctx.monitor;
+	auto loadRegion = [&archive, &regionctx](const core::String &regionFilename) {
+		MCRFormat mcrFormat;
+		scenegraph::SceneGraph newSceneGraph;
+		if (!mcrFormat.load(regionFilename, archive, newSceneGraph, regionctx)) {
+			Log::debug("Could not load %s", regionFilename.c_str());
+			return core::move(newSceneGraph);
+		}
+		const scenegraph::SceneGraph::MergeResult &merged = newSceneGraph.merge();
+		newSceneGraph.clear();
+		if (!merged.hasVolume()) {
 			return core::move(newSceneGraph);
-		}));
+		}
+		scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+		node.setVolume(merged.volume(), true);
+		node.setPalette(merged.palette);
+		node.setNormalPalette(merged.normalPalette);
+		newSceneGraph.emplace(core::move(node));
+		return core::move(newSceneGraph);
+	};
+
+	// with a memory limit only a few regions are loaded ahead - otherwise the finished regions would pile up in
+	// their futures while the caller is still busy with the first one
+	const int regionCount = (int)regionFilenames.size();
+	int maxPending = regionCount;
+	if (loadctx.maxMemory > 0u) {
+		maxPending = core_max(1, (int)app::App::getInstance()->threadPool().size());
 	}
-	Log::debug("Scheduled %i regions", (int)futures.size());
-	int count = 0;
-	for (auto &f : futures) {
-		scenegraph::SceneGraph newSceneGraph = core::move(f.get());
-		nodesAdded += scenegraph::addSceneGraphNodes(sceneGraph, newSceneGraph, rootNode);
-		Log::debug("... loaded %i", count++);
+	core::DynamicArray<std::future<scenegraph::SceneGraph>> futures;
+	futures.reserve(regionCount);
+	int scheduled = 0;
+	Log::info("Found %i region files", regionCount);
+	for (int i = 0; i < regionCount; ++i) {
+		for (; scheduled < regionCount && scheduled < i + maxPending; ++scheduled) {
+			futures.emplace_back(app::async(loadRegion, regionFilenames[scheduled]));
+		}
+		scenegraph::SceneGraph newSceneGraph = core::move(futures[i].get());
+		const int added = scenegraph::addSceneGraphNodes(sceneGraph, newSceneGraph, rootNode);
+		nodesAdded += added;
+		loadctx.progress("regions", i + 1, regionCount);
+		Log::debug("... loaded %i", i);
+		// the region nodes were appended to the children of the root node
+		const scenegraph::SceneGraphNodeChildren &children = sceneGraph.node(rootNode).children();
+		core::DynamicArray<int> addedNodes;
+		for (int n = (int)children.size() - added; n < (int)children.size(); ++n) {
+			addedNodes.push_back(children[n]);
+		}
+		for (int nodeId : addedNodes) {
+			if (!emitNode(sceneGraph, nodeId, loadctx)) {
+				for (int j = i + 1; j < scheduled; ++j) {
+					futures[j].wait();
+				}
+				return false;
+			}
+		}
 	}
 
 	return nodesAdded > 0;
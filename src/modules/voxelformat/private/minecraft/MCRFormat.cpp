@@ -14,8 +14,7 @@
 #include "io/ZipWriteStream.h"
 #include "scenegraph/SceneGraph.h"
 #include "palette/Palette.h"
-#include "voxelutil/VolumeCropper.h"
-#include "voxelutil/VolumeMerger.h"
+#include "voxel/PagedVolume.h"
 #include "MinecraftPaletteMap.h"
 #include "NamedBinaryTag.h"
 
@@ -86,7 +85,7 @@ bool MCRFormat::loadGroupsPalette(const core::String &filename, const io::Archiv
 			return false;
 		}
 
-		const bool success = loadMinecraftRegion(sceneGraph, *stream, palette);
+		const bool success = loadMinecraftRegion(sceneGraph, *stream, palette, ctx);
 		return success;
 	}
 	}
@@ -95,8 +94,9 @@ bool MCRFormat::loadGroupsPalette(const core::String &filename, const io::Archiv
 }
 
 bool MCRFormat::loadMinecraftRegion(scenegraph::SceneGraph &sceneGraph, io::SeekableReadStream &stream,
-									const palette::Palette &palette) {
+									const palette::Palette &palette, const LoadContext &ctx) {
 	for (int i = 0; i < SECTOR_INTS; ++i) {
+		ctx.progress("chunks", i, SECTOR_INTS);
 		if (_offsets[i].sectorCount == 0u || _offsets[i].offset < sizeof(_offsets)) {
 			continue;
 		}
@@ -106,7 +106,7 @@ bool MCRFormat::loadMinecraftRegion(scenegraph::SceneGraph &sceneGraph, io::Seek
 		if (stream.seek(_offsets[i].offset) == -1) {
 			continue;
 		}
-		if (!readCompressedNBT(sceneGraph, stream, i, palette)) {
+		if (!readCompressedNBT(sceneGraph, stream, i, palette, ctx)) {
 			Log::error("Failed to load minecraft chunk section %i for offset %u", i, (int)_offsets[i].offset);
 			return false;
 		}
@@ -116,7 +116,7 @@ bool MCRFormat::loadMinecraftRegion(scenegraph::SceneGraph &sceneGraph, io::Seek
 }
 
 bool MCRFormat::readCompressedNBT(scenegraph::SceneGraph &sceneGraph, io::SeekableReadStream &stream, int sector,
-								  const palette::Palette &palette) {
+								  const palette::Palette &palette, const LoadContext &loadctx) {
 	uint32_t nbtSize;
 	wrap(stream.readUInt32BE(nbtSize));
 	if (nbtSize == 0) {
@@ -166,8 +166,11 @@ bool MCRFormat::readCompressedNBT(scenegraph::SceneGraph &sceneGraph, io::Seekab
 	scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
 	node.setVolume(volume, true);
 	node.setPalette(palette);
-	sceneGraph.emplace(core::move(node));
-	return true;
+	const int nodeId = sceneGraph.emplace(core::move(node));
+	if (nodeId == InvalidNodeId) {
+		return false;
+	}
+	return emitNode(sceneGraph, nodeId, loadctx);
 }
 
 int MCRFormat::getVoxel(int dataVersion, const priv::NamedBinaryTag &data, const glm::ivec3 &pos) {
@@ -196,14 +199,19 @@ voxel::RawVolume *MCRFormat::finalize(SectionVolumes &volumes, int xPos, int zPo
 		Log::error("No volumes found at %i:%i", xPos, zPos);
 		return nullptr;
 	}
-	// TODO: VOXELFORMAT: only merge connected y chunks - don't fill empty chunks - just a waste of memory
-	voxel::RawVolume *merged = voxelutil::merge(volumes);
+	// collect the sections in a paged volume - empty sections and the air between them don't allocate any memory
+	voxel::PagedVolume paged;
 	for (voxel::RawVolume *v : volumes) {
+		paged.copyFrom(*v);
 		delete v;
 	}
-	merged->translate(glm::ivec3(xPos * MAX_SIZE, 0, zPos * MAX_SIZE));
-	voxel::RawVolume *cropped = voxelutil::cropVolume(merged);
-	delete merged;
+	const voxel::Region &region = paged.calculateRegion();
+	if (!region.isValid()) {
+		return nullptr;
+	}
+	voxel::RawVolume *cropped = new voxel::RawVolume(region);
+	paged.copyTo(*cropped);
+	cropped->translate(glm::ivec3(xPos * MAX_SIZE, 0, zPos * MAX_SIZE));
 	return cropped;
 }
 
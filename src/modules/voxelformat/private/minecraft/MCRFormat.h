@@ -112,9 +112,9 @@ private:
 										 const palette::Palette &palette);
 
 	bool readCompressedNBT(scenegraph::SceneGraph &sceneGraph, io::SeekableReadStream &stream, int sector,
-						   const palette::Palette &palette);
+						   const palette::Palette &palette, const LoadContext &loadctx);
 	bool loadMinecraftRegion(scenegraph::SceneGraph &sceneGraph, io::SeekableReadStream &stream,
-							 const palette::Palette &palette);
+							 const palette::Palette &palette, const LoadContext &ctx);
 
 	bool saveSections(const scenegraph::SceneGraph &sceneGraph, priv::NBTList &sections, int sector);
 	bool saveCompressedNBT(const scenegraph::SceneGraph &sceneGraph, io::SeekableWriteStream &stream, int sector);
@@ -252,8 +252,45 @@ bool QBFormat::readColor(State &state, io::SeekableReadStream &stream, core::RGB
 	return true;
 }
 
+bool QBFormat::skipMatrixVoxels(State &state, io::SeekableReadStream &stream, const glm::uvec3 &size,
+								int64_t &voxels) {
+	if (state._compressed == Compression::None) {
+		// the voxels are not counted to skip the whole matrix at once
+		voxels = -1;
+		if (stream.skip((int64_t)size.x * size.y * size.z * 4) == -1) {
+			Log::error("Failed to skip the matrix voxels");
+			return false;
+		}
+		return true;
+	}
+	voxels = 0;
+	uint32_t z = 0u;
+	while (z < size.z) {
+		for (;;) {
+			uint32_t data;
+			wrap(stream.peekUInt32(data))
+			if (data == qb::NEXT_SLICE_FLAG) {
+				stream.skip(sizeof(data));
+				break;
+			}
+			uint32_t count = 1;
+			if (data == qb::RLE_FLAG) {
+				stream.skip(sizeof(data));
+				wrap(stream.readUInt32(count))
+			}
+			core::RGBA color(0);
+			wrapBool(readColor(state, stream, color))
+			if (color.a != 0) {
+				voxels += count;
+			}
+		}
+		++z;
+	}
+	return true;
+}
+
 bool QBFormat::readMatrix(State &state, io::SeekableReadStream &stream, scenegraph::SceneGraph &sceneGraph,
-						  palette::PaletteLookup &palLookup) {
+						  palette::PaletteLookup &palLookup, ProbeModels *probeModels) {
 	core::String name;
 	wrapBool(stream.readPascalStringUInt8(name))
 	Log::debug("Matrix name: %s", name.c_str());
@@ -306,6 +343,25 @@ bool QBFormat::readMatrix(State &state, io::SeekableReadStream &stream, scenegra
 		return false;
 	}
 
+	if (probeModels != nullptr) {
+		ProbeModel model;
+		model.region = region;
+		if (!skipMatrixVoxels(state, stream, size, model.voxels)) {
+			return false;
+		}
+		scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+		node.setVolume(new voxel::RawVolume(voxel::Region(0, 0)), true);
+		node.setName(name);
+		const scenegraph::KeyFrameIndex keyFrameIdx = 0;
+		node.setTransform(keyFrameIdx, transform);
+		const int nodeId = sceneGraph.emplace(core::move(node));
+		if (nodeId == InvalidNodeId) {
+			return false;
+		}
+		probeModels->put(nodeId, model);
+		return true;
+	}
+
 	core::ScopedPtr<voxel::RawVolume> v(new voxel::RawVolume(region));
 	if (state._compressed == Compression::None) {
 		Log::debug("qb matrix uncompressed");
@@ -453,33 +509,47 @@ bool QBFormat::readPalette(State &state, io::SeekableReadStream &stream, RGBAMap
 	return true;
 }
 
-size_t QBFormat::loadPalette(const core::String &filename, const io::ArchivePtr &archive, palette::Palette &palette,
-							 const LoadContext &ctx) {
-	core::ScopedPtr<io::SeekableReadStream> stream(archive->readStream(filename));
-	if (!stream) {
-		Log::error("Could not load file %s", filename.c_str());
-		return 0;
-	}
-
-	State state;
-	wrap(stream->readUInt32(state._version))
+bool QBFormat::readHeader(State &state, io::SeekableReadStream &stream, uint32_t &numMatrices) {
+	wrap(stream.readUInt32(state._version))
 	uint32_t colorFormat;
-	wrap(stream->readUInt32(colorFormat))
+	wrap(stream.readUInt32(colorFormat))
 	state._colorFormat = (ColorFormat)colorFormat;
 	uint32_t zAxisOrientation;
-	wrap(stream->readUInt32(zAxisOrientation))
+	wrap(stream.readUInt32(zAxisOrientation))
 	state._zAxisOrientation = (ZAxisOrientation)zAxisOrientation;
 	uint32_t compressed;
-	wrap(stream->readUInt32(compressed))
+	wrap(stream.readUInt32(compressed))
 	state._compressed = (Compression)compressed;
 	uint32_t visibilityMaskEncoded;
-	wrap(stream->readUInt32(visibilityMaskEncoded))
+	wrap(stream.readUInt32(visibilityMaskEncoded))
 	state._visibilityMaskEncoded = (VisibilityMask)visibilityMaskEncoded;
 
-	uint32_t numMatrices;
-	wrap(stream->readUInt32(numMatrices))
+	wrap(stream.readUInt32(numMatrices))
 	if (numMatrices > 16384) {
 		Log::error("Max allowed matrices exceeded: %u", numMatrices);
+		return false;
+	}
+
+	Log::debug("Version: %u", state._version);
+	Log::debug("ColorFormat: %u", core::enumVal(state._colorFormat));
+	Log::debug("ZAxisOrientation: %u", core::enumVal(state._zAxisOrientation));
+	Log::debug("Compressed: %u", core::enumVal(state._compressed));
+	Log::debug("VisibilityMaskEncoded: %u", core::enumVal(state._visibilityMaskEncoded));
+	Log::debug("NumMatrices: %u", numMatrices);
+	return true;
+}
+
+size_t QBFormat::loadPalette(const core::String &filename, const io::ArchivePtr &archive, palette::Palette &palette,
+							 const LoadContext &ctx) {
+	core::ScopedPtr<io::SeekableReadStream> stream(archive->readStream(filename));
+	if (!stream) {
+		Log::error("Could not load file %s", filename.c_str());
+		return 0;
+	}
+
+	State state;
+	uint32_t numMatrices;
+	if (!readHeader(state, *stream, numMatrices)) {
 		return 0;
 	}
 	RGBAMap colors;
@@ -502,34 +572,10 @@ bool QBFormat::loadGroupsRGBA(const core::String &filename, const io::ArchivePtr
 		return false;
 	}
 	State state;
-	wrap(stream->readUInt32(state._version))
-	uint32_t colorFormat;
-	wrap(stream->readUInt32(colorFormat))
-	state._colorFormat = (ColorFormat)colorFormat;
-	uint32_t zAxisOrientation;
-	wrap(stream->readUInt32(zAxisOrientation))
-	state._zAxisOrientation = (ZAxisOrientation)zAxisOrientation;
-	uint32_t compressed;
-	wrap(stream->readUInt32(compressed))
-	state._compressed = (Compression)compressed;
-	uint32_t visibilityMaskEncoded;
-	wrap(stream->readUInt32(visibilityMaskEncoded))
-	state._visibilityMaskEncoded = (VisibilityMask)visibilityMaskEncoded;
-
 	uint32_t numMatrices;
-	wrap(stream->readUInt32(numMatrices))
-	if (numMatrices > 16384) {
-		Log::error("Max allowed matrices exceeded: %u", numMatrices);
+	if (!readHeader(state, *stream, numMatrices)) {
 		return false;
 	}
-
-	Log::debug("Version: %u", state._version);
-	Log::debug("ColorFormat: %u", core::enumVal(state._colorFormat));
-	Log::debug("ZAxisOrientation: %u", core::enumVal(state._zAxisOrientation));
-	Log::debug("Compressed: %u", core::enumVal(state._compressed));
-	Log::debug("VisibilityMaskEncoded: %u", core::enumVal(state._visibilityMaskEncoded));
-	Log::debug("NumMatrices: %u", numMatrices);
-
 	sceneGraph.reserve(numMatrices);
 	palette::PaletteLookup palLookup(palette);
 	for (uint32_t i = 0; i < numMatrices; i++) {
@@ -542,6 +588,33 @@ bool QBFormat::loadGroupsRGBA(const core::String &filename, const io::ArchivePtr
 	return true;
 }
 
+bool QBFormat::probe(const core::String &filename, const io::ArchivePtr &archive, ProbeResult &result,
+					 const LoadContext &ctx) {
+	core::ScopedPtr<io::SeekableReadStream> stream(archive->readStream(filename));
+	if (!stream) {
+		Log::error("Could not load file %s", filename.c_str());
+		return false;
+	}
+	State state;
+	uint32_t numMatrices;
+	if (!readHeader(state, *stream, numMatrices)) {
+		return false;
+	}
+	scenegraph::SceneGraph sceneGraph;
+	sceneGraph.reserve(numMatrices);
+	palette::Palette palette;
+	palette::PaletteLookup palLookup(palette);
+	ProbeModels models;
+	for (uint32_t i = 0; i < numMatrices; i++) {
+		if (!readMatrix(state, *stream, sceneGraph, palLookup, &models)) {
+			Log::error("Failed to probe the matrix %u", i);
+			break;
+		}
+	}
+	fillProbeResult(sceneGraph, models, false, result);
+	return true;
+}
+
 } // namespace voxelformat
 
 #undef wrap
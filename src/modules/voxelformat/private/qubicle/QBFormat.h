@@ -45,8 +45,14 @@ private:
 
 	bool readColor(State &state, io::SeekableReadStream &stream, core::RGBA &color);
 	voxel::Voxel getVoxel(State &state, io::SeekableReadStream &stream, palette::PaletteLookup &palLookup);
+	bool readHeader(State &state, io::SeekableReadStream &stream, uint32_t &numMatrices);
+	/**
+	 * @param probeModels If this is not @c null, the voxels are skipped and the model node only gets a placeholder
+	 * volume - see @c probe()
+	 */
 	bool readMatrix(State &state, io::SeekableReadStream &stream, scenegraph::SceneGraph &sceneGraph,
-					palette::PaletteLookup &palLookup);
+					palette::PaletteLookup &palLookup, ProbeModels *probeModels = nullptr);
+	bool skipMatrixVoxels(State &state, io::SeekableReadStream &stream, const glm::uvec3 &size, int64_t &voxels);
 	bool readPalette(State &state, io::SeekableReadStream &stream, RGBAMap &colors);
 	bool loadGroupsRGBA(const core::String &filename, const io::ArchivePtr &archive,
 						scenegraph::SceneGraph &sceneGraph, const palette::Palette &palette,
@@ -59,6 +65,12 @@ private:
 public:
 	size_t loadPalette(const core::String &filename, const io::ArchivePtr &archive, palette::Palette &palette,
 					   const LoadContext &ctx) override;
+	/**
+	 * @brief Uncompressed matrices are skipped completely - the rle compressed matrices are scanned to count the
+	 * voxels. The palette is not reported as it would be created from all voxel colors.
+	 */
+	bool probe(const core::String &filename, const io::ArchivePtr &archive, ProbeResult &result,
+			   const LoadContext &ctx) override;
 
 	static const io::FormatDescription &format() {
 		static io::FormatDescription f{"Qubicle Binary", {"qb"}, {}, VOX_FORMAT_FLAG_PALETTE_EMBEDDED | FORMAT_FLAG_SAVE};
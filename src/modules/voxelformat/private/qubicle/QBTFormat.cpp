@@ -427,13 +427,33 @@ bool QBTFormat::loadMatrix(io::SeekableReadStream &stream, scenegraph::SceneGrap
 		Log::warn("Size of matrix results in empty space - voxelDataSize: %u", voxelDataSize);
 		return false;
 	}
-	io::ZipReadStream zipStream(stream, voxelDataSize);
-
 	const voxel::Region region(glm::ivec3(0), glm::ivec3(size) - 1);
 	if (!region.isValid()) {
 		Log::error("Invalid region");
 		return false;
 	}
+	if (state.probeModels != nullptr) {
+		if (stream.skip(voxelDataSize) == -1) {
+			Log::error("Failed to skip the voxel data");
+			return false;
+		}
+		scenegraph::SceneGraphNode node;
+		node.setVolume(new voxel::RawVolume(voxel::Region(0, 0)), true);
+		node.setName(name);
+		node.setPivot(pivot);
+		const scenegraph::KeyFrameIndex keyFrameIdx = 0;
+		node.setTransform(keyFrameIdx, transform);
+		const int id = sceneGraph.emplace(core::move(node), parent);
+		if (id == InvalidNodeId) {
+			return false;
+		}
+		ProbeModel model;
+		model.region = region;
+		state.probeModels->put(id, model);
+		return true;
+	}
+
+	io::ZipReadStream zipStream(stream, voxelDataSize);
 	core::ScopedPtr<voxel::RawVolume> volume(new voxel::RawVolume(region));
 	for (int32_t x = 0; x < (int)size.x; x++) {
 		for (int32_t z = 0; z < (int)size.z; z++) {
@@ -710,6 +730,54 @@ bool QBTFormat::loadGroupsPalette(const core::String &filename, const io::Archiv
 	return true;
 }
 
+bool QBTFormat::probe(const core::String &filename, const io::ArchivePtr &archive, ProbeResult &result,
+					  const LoadContext &ctx) {
+	core::ScopedPtr<io::SeekableReadStream> stream(archive->readStream(filename));
+	if (!stream) {
+		Log::error("Could not load file %s", filename.c_str());
+		return false;
+	}
+	Header state;
+	wrapBool(loadHeader(*stream, state))
+	ProbeModels models;
+	state.probeModels = &models;
+
+	scenegraph::SceneGraph sceneGraph;
+	palette::Palette palette;
+	while (stream->remaining() > 0) {
+		char buf[8];
+		wrapBool(stream->readString(sizeof(buf), buf));
+		if (0 == memcmp(buf, "COLORMAP", 7)) {
+			if (!loadColorMap(*stream, palette)) {
+				Log::error("Failed to load color map");
+				return false;
+			}
+			if (palette.colorCount() > 0) {
+				state.colorFormat = ColorFormat::Palette;
+			}
+		} else if (0 == memcmp(buf, "DATATREE", 8)) {
+			if (!loadNode(*stream, sceneGraph, sceneGraph.root().id(), palette, state)) {
+				Log::error("Failed to probe node");
+				return false;
+			}
+		} else {
+			Log::error("Unknown section found: %c%c%c%c%c%c%c%c", buf[0], buf[1], buf[2], buf[3], buf[4], buf[5],
+					   buf[6], buf[7]);
+			return false;
+		}
+	}
+	// without a color map the palette is created from the voxel colors
+	const bool colorMap = state.colorFormat == ColorFormat::Palette;
+	if (colorMap) {
+		for (auto iter = sceneGraph.beginModel(); iter != sceneGraph.end(); ++iter) {
+			scenegraph::SceneGraphNode &node = *iter;
+			node.setPalette(palette);
+		}
+	}
+	fillProbeResult(sceneGraph, models, colorMap, result);
+	return true;
+}
+
 #undef wrapSave
 #undef wrap
 #undef wrapBool
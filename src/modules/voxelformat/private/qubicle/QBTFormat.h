@@ -28,6 +28,8 @@ private:
 		uint8_t versionMinor = 0;
 		ColorFormat colorFormat = ColorFormat::RGBA;
 		glm::vec3 globalScale{0};
+		/** if this is set, the voxel data is skipped - see @c probe() */
+		ProbeModels *probeModels = nullptr;
 	};
 
 	bool loadHeader(io::SeekableReadStream &stream, Header &state);
@@ -61,6 +63,11 @@ private:
 public:
 	size_t loadPalette(const core::String &filename, const io::ArchivePtr &archive, palette::Palette &palette,
 					   const LoadContext &ctx) override;
+	/**
+	 * @brief The compressed voxel data of the matrices is skipped - the voxel counts are not known
+	 */
+	bool probe(const core::String &filename, const io::ArchivePtr &archive, ProbeResult &result,
+			   const LoadContext &ctx) override;
 
 	static const io::FormatDescription &format() {
 		static io::FormatDescription f{
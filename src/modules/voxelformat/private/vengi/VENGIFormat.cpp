@@ -3,13 +3,21 @@
  */
 
 #include "VENGIFormat.h"
+#include "app/Async.h"
 #include "core/ArrayLength.h"
+#include "core/Assert.h"
 #include "core/FourCC.h"
 #include "core/ConfigVar.h"
+#include "core/GLM.h"
 #include "core/Log.h"
 #include "core/ScopedPtr.h"
+#include "core/SharedPtr.h"
 #include "core/Var.h"
 #include "core/collection/Array.h"
+#include "core/collection/DynamicSet.h"
+#include "core/concurrent/Atomic.h"
+#include "io/BufferedReadWriteStream.h"
+#include "io/MemoryReadStream.h"
 #include "io/ZipReadStream.h"
 #include "io/ZipWriteStream.h"
 #include "palette/NormalPalette.h"
@@ -54,6 +62,107 @@ static scenegraph::InterpolationType toInterpolationType(const core::String &typ
 	return scenegraph::InterpolationType::Max;
 }
 
+// the version that is written - version 5 introduced the independently compressed bricks
+static constexpr uint32_t VENGIVersion = 5u;
+// marks the brick layout - it follows the VENG magic and is never the start of the zlib stream of the versions
+// before 5, as the compression method in the low nibble of the first byte ('B') is not deflate
+static constexpr uint32_t BrickLayoutMagic = FourCC('B', 'R', 'C', 'K');
+// the edge length of the bricks a model node is split into
+static constexpr int BrickSize = 64;
+
+/**
+ * @brief The voxels of a brick that are compressed in parallel before they are written
+ */
+struct BrickData {
+	int nodeId = InvalidNodeId;
+	voxel::Region region;
+	// nullptr if all voxels of the brick are air - such bricks are not written
+	core::SharedPtr<io::BufferedReadWriteStream> compressed;
+	uint32_t size = 0u;
+};
+
+/**
+ * Every voxel is stored as one byte for the air flag - and for solid voxels followed by the color and normal index.
+ * This is the same voxel encoding as in the @c DATA chunk of the older versions.
+ */
+static bool compressBrick(const scenegraph::SceneGraphNode &node, BrickData &brick, int replaceIndex) {
+	const voxel::RawVolume &v = *node.volume();
+	const voxel::Region &region = brick.region;
+	int replacement = -1;
+	if (replaceIndex != -1) {
+		replacement = node.palette().findReplacement(replaceIndex);
+	}
+	core::DynamicArray<uint8_t> raw;
+	raw.reserve((size_t)region.voxels());
+	bool empty = true;
+	for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+		for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+			for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+				const voxel::Voxel &voxel = v.voxel(x, y, z);
+				const bool air = voxel::isAir(voxel.getMaterial());
+				raw.push_back(air ? 1u : 0u);
+				if (air) {
+					continue;
+				}
+				empty = false;
+				raw.push_back(voxel.getColor() == replaceIndex ? (uint8_t)replacement : voxel.getColor());
+				raw.push_back(voxel.getNormal());
+			}
+		}
+	}
+	if (empty) {
+		return true;
+	}
+	brick.size = (uint32_t)raw.size();
+	brick.compressed = core::make_shared<io::BufferedReadWriteStream>((int64_t)raw.size() / 4);
+	// the zip stream buffers are too big for the stack of the worker threads
+	core::ScopedPtr<io::ZipWriteStream> zipStream(new io::ZipWriteStream(*brick.compressed.get()));
+	if (zipStream->write(raw.data(), raw.size()) == -1) {
+		return false;
+	}
+	return zipStream->flush();
+}
+
+/**
+ * @brief Decompresses the given brick into the volume - only the voxels inside the region of the volume are set
+ */
+static bool decompressBrick(const uint8_t *data, const voxel::Region &region, uint32_t compressedSize, uint32_t size,
+							const palette::Palette &palette, voxel::RawVolume &v) {
+	io::MemoryReadStream compressed(data, compressedSize);
+	core::DynamicArray<uint8_t> raw;
+	raw.resize(size);
+	{
+		core::ScopedPtr<io::ZipReadStream> zipStream(new io::ZipReadStream(compressed, (int)compressedSize));
+		if (zipStream->read(raw.data(), size) != (int)size) {
+			return false;
+		}
+	}
+	const voxel::Region &volumeRegion = v.region();
+	size_t pos = 0u;
+	for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+		for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+			for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+				if (pos >= raw.size()) {
+					return false;
+				}
+				const bool air = raw[pos++] != 0u;
+				if (air) {
+					continue;
+				}
+				if (pos + 2u > raw.size()) {
+					return false;
+				}
+				const uint8_t color = raw[pos++];
+				const uint8_t normal = raw[pos++];
+				if (volumeRegion.containsPoint(x, y, z)) {
+					v.setVoxel(x, y, z, voxel::createVoxel(palette, color, normal));
+				}
+			}
+		}
+	}
+	return true;
+}
+
 bool VENGIFormat::saveNodeProperties(const scenegraph::SceneGraph &sceneGraph, const scenegraph::SceneGraphNode &node,
 									 io::WriteStream &stream) {
 	const core::StringMap<core::String> &properties = node.properties();
@@ -81,38 +190,32 @@ bool VENGIFormat::saveAnimation(const scenegraph::SceneGraphNode &node, const co
 }
 
 bool VENGIFormat::saveNodeData(const scenegraph::SceneGraph &sceneGraph, const scenegraph::SceneGraphNode &node,
-							   io::WriteStream &stream) {
+							   io::WriteStream &stream, const NodeBricks &bricks) {
 	if (node.type() != scenegraph::SceneGraphNodeType::Model) {
 		return true;
 	}
-	wrapBool(stream.writeUInt32(FourCC('D', 'A', 'T', 'A')))
-	const voxel::RawVolume *v = node.volume();
-	const voxel::Region &region = v->region();
+	wrapBool(stream.writeUInt32(FourCC('B', 'R', 'C', 'K')))
+	const voxel::Region &region = node.volume()->region();
 	wrapBool(stream.writeInt32(region.getLowerX()))
 	wrapBool(stream.writeInt32(region.getLowerY()))
 	wrapBool(stream.writeInt32(region.getLowerZ()))
 	wrapBool(stream.writeInt32(region.getUpperX()))
 	wrapBool(stream.writeInt32(region.getUpperY()))
 	wrapBool(stream.writeInt32(region.getUpperZ()))
-	const int replaceIndex = core::Var::getSafe(cfg::VoxformatEmptyPaletteIndex)->intVal();
-	int replacement = -1;
-	if (replaceIndex != -1) {
-		replacement = node.palette().findReplacement(replaceIndex);
-		Log::debug("Looking for a similar color in the palette: %d", replacement);
-	}
-	auto visitor = [&stream, replacement, replaceIndex](int, int, int, const voxel::Voxel &voxel) {
-		const bool air = isAir(voxel.getMaterial());
-		stream.writeBool(air);
-		if (!air) {
-			if (voxel.getColor() == replaceIndex) {
-				stream.writeUInt8(replacement);
-			} else {
-				stream.writeUInt8(voxel.getColor());
-			}
-			stream.writeUInt8(voxel.getNormal());
-		}
-	};
-	voxelutil::visitVolume(*v, visitor, voxelutil::VisitAll(), voxelutil::VisitorOrder::XYZ);
+	Bricks nodeBricks;
+	bricks.get(node.id(), nodeBricks);
+	wrapBool(stream.writeUInt32((uint32_t)nodeBricks.size()))
+	for (const Brick &brick : nodeBricks) {
+		wrapBool(stream.writeInt32(brick.region.getLowerX()))
+		wrapBool(stream.writeInt32(brick.region.getLowerY()))
+		wrapBool(stream.writeInt32(brick.region.getLowerZ()))
+		wrapBool(stream.writeInt32(brick.region.getUpperX()))
+		wrapBool(stream.writeInt32(brick.region.getUpperY()))
+		wrapBool(stream.writeInt32(brick.region.getUpperZ()))
+		wrapBool(stream.writeUInt64(brick.offset))
+		wrapBool(stream.writeUInt32(brick.compressedSize))
+		wrapBool(stream.writeUInt32(brick.size))
+	}
 	return true;
 }
 
@@ -183,7 +286,7 @@ bool VENGIFormat::saveNodePaletteIdentifier(const scenegraph::SceneGraph &sceneG
 }
 
 bool VENGIFormat::saveNode(const scenegraph::SceneGraph &sceneGraph, io::WriteStream &stream,
-						   const scenegraph::SceneGraphNode &node) {
+						   const scenegraph::SceneGraphNode &node, const NodeBricks &bricks) {
 	wrapBool(stream.writeUInt32(FourCC('N', 'O', 'D', 'E')))
 	wrapBool(stream.writePascalStringUInt16LE(node.name()))
 	wrapBool(stream.writePascalStringUInt16LE(scenegraph::SceneGraphNodeTypeStr[(int)node.type()]))
@@ -202,12 +305,12 @@ bool VENGIFormat::saveNode(const scenegraph::SceneGraph &sceneGraph, io::WriteSt
 		wrapBool(saveNodePaletteColors(sceneGraph, node, stream))
 	}
 	wrapBool(saveNodePaletteNormals(sceneGraph, node, stream))
-	wrapBool(saveNodeData(sceneGraph, node, stream))
+	wrapBool(saveNodeData(sceneGraph, node, stream, bricks))
 	for (const core::String &animation : sceneGraph.animations()) {
 		wrapBool(saveAnimation(node, animation, stream))
 	}
 	for (int childId : node.children()) {
-		wrapBool(saveNode(sceneGraph, stream, sceneGraph.node(childId)))
+		wrapBool(saveNode(sceneGraph, stream, sceneGraph.node(childId), bricks))
 	}
 	wrapBool(stream.writeUInt32(FourCC('E', 'N', 'D', 'N')))
 	return true;
@@ -227,8 +330,7 @@ bool VENGIFormat::loadNodeProperties(scenegraph::SceneGraph &sceneGraph, scenegr
 	return true;
 }
 
-bool VENGIFormat::loadNodeData(scenegraph::SceneGraph &sceneGraph, scenegraph::SceneGraphNode &node, uint32_t version,
-							   io::ReadStream &stream) {
+static bool readRegion(io::ReadStream &stream, voxel::Region &region) {
 	glm::ivec3 mins, maxs;
 	wrap(stream.readInt32(mins.x))
 	wrap(stream.readInt32(mins.y))
@@ -236,8 +338,45 @@ bool VENGIFormat::loadNodeData(scenegraph::SceneGraph &sceneGraph, scenegraph::S
 	wrap(stream.readInt32(maxs.x))
 	wrap(stream.readInt32(maxs.y))
 	wrap(stream.readInt32(maxs.z))
-	Log::debug("Load region of %i:%i:%i %i:%i:%i", mins.x, mins.y, mins.z, maxs.x, maxs.y, maxs.z);
-	const voxel::Region region(mins, maxs);
+	region = voxel::Region(mins, maxs);
+	return true;
+}
+
+bool VENGIFormat::loadNodeData(scenegraph::SceneGraph &sceneGraph, scenegraph::SceneGraphNode &node, uint32_t version,
+							   io::ReadStream &stream, LoadState &state, voxel::Region &fullRegion, bool &skip) {
+	voxel::Region region;
+	wrapBool(readRegion(stream, region))
+	Log::debug("Load region of %s", region.toString().c_str());
+	fullRegion = region;
+	if (state.probeModels != nullptr) {
+		// the node keeps the one voxel placeholder volume of loadNode() - the voxels are part of the compressed
+		// stream and have to be read to get to the next chunk
+		core_assert(node.volume() != nullptr);
+		ProbeModel model;
+		model.region = region;
+		skip = !state.ctx.loadModel(node.name(), model.region);
+		model.voxels = 0;
+		for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+			for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+					if (stream.readBool()) {
+						continue;
+					}
+					uint8_t color;
+					wrap(stream.readUInt8(color))
+					if (version >= 4u) {
+						uint8_t normal;
+						wrap(stream.readUInt8(normal))
+					}
+					if (model.region.containsPoint(x, y, z)) {
+						++model.voxels;
+					}
+				}
+			}
+		}
+		state.probeModels->put(node.id(), model);
+		return true;
+	}
 	voxel::RawVolume *v = new voxel::RawVolume(region);
 	node.setVolume(v, true);
 	const palette::Palette &palette = node.palette();
@@ -256,6 +395,186 @@ bool VENGIFormat::loadNodeData(scenegraph::SceneGraph &sceneGraph, scenegraph::S
 		v->setVoxel(x, y, z, voxel::createVoxel(palette, color, normal));
 	};
 	voxelutil::visitVolume(*v, visitor, voxelutil::VisitAll(), voxelutil::VisitorOrder::XYZ);
+
+	// the voxels of these versions can't be loaded partially - they are cropped after loading them
+	voxel::Region cropped = region;
+	if (!state.ctx.loadModel(node.name(), cropped)) {
+		skip = true;
+	} else if (cropped != region) {
+		node.setVolume(new voxel::RawVolume(*v, cropped), true);
+	}
+	return true;
+}
+
+bool VENGIFormat::loadNodeBricks(scenegraph::SceneGraph &sceneGraph, scenegraph::SceneGraphNode &node,
+								 uint32_t version, io::ReadStream &stream, LoadState &state, voxel::Region &fullRegion,
+								 bool &skip) {
+	voxel::Region region;
+	wrapBool(readRegion(stream, region))
+	fullRegion = region;
+	uint32_t brickCount;
+	wrap(stream.readUInt32(brickCount))
+	Log::debug("Load region of %s with %u bricks", region.toString().c_str(), brickCount);
+	if (!region.isValid()) {
+		Log::error("Invalid region %s", region.toString().c_str());
+		return false;
+	}
+	// the bricks are put on a grid of BrickSize cells that starts at the lower corner of the node region
+	const glm::ivec3 &mins = region.getLowerCorner();
+	const glm::ivec3 &maxs = region.getUpperCorner();
+	const glm::i64vec3 dimensions = glm::i64vec3(maxs) - glm::i64vec3(mins) + (int64_t)1;
+	const glm::i64vec3 cells = (dimensions + (int64_t)(BrickSize - 1)) / (int64_t)BrickSize;
+	const uint64_t maxBricks = core_min((uint64_t)(cells.x * cells.y), (uint64_t)UINT32_MAX) * (uint64_t)cells.z;
+	if (brickCount > maxBricks) {
+		Log::error("Invalid brick count %u for region %s", brickCount, region.toString().c_str());
+		return false;
+	}
+	voxel::Region cropped = region;
+	skip = !state.ctx.loadModel(node.name(), cropped);
+	Bricks bricks;
+	if (!skip) {
+		bricks.reserve(brickCount);
+	}
+	// the bricks are decompressed in parallel into the same volume - they must not overlap
+	core::DynamicSet<glm::ivec3, 1031, glm::hash<glm::ivec3>> usedCells;
+	for (uint32_t i = 0; i < brickCount; ++i) {
+		Brick brick;
+		wrapBool(readRegion(stream, brick.region))
+		wrap(stream.readUInt64(brick.offset))
+		wrap(stream.readUInt32(brick.compressedSize))
+		wrap(stream.readUInt32(brick.size))
+		if (!brick.region.isValid() || !region.containsRegion(brick.region)) {
+			Log::error("Brick region %s is outside of region %s", brick.region.toString().c_str(),
+					   region.toString().c_str());
+			return false;
+		}
+		const glm::i64vec3 lower = glm::i64vec3(brick.region.getLowerCorner()) - glm::i64vec3(mins);
+		const glm::i64vec3 upper = glm::i64vec3(brick.region.getUpperCorner()) - glm::i64vec3(mins);
+		const glm::i64vec3 cell = lower / (int64_t)BrickSize;
+		if (lower != cell * (int64_t)BrickSize ||
+			glm::any(glm::greaterThanEqual(upper - lower, glm::i64vec3(BrickSize)))) {
+			Log::error("Brick region %s is not aligned to the brick grid of region %s",
+					   brick.region.toString().c_str(), region.toString().c_str());
+			return false;
+		}
+		if (!usedCells.insert(glm::ivec3(cell))) {
+			Log::error("Duplicate brick region %s", brick.region.toString().c_str());
+			return false;
+		}
+		const uint64_t voxels = (uint64_t)brick.region.voxels();
+		if (brick.size < voxels || brick.size > 3u * voxels) {
+			Log::error("Invalid brick size %u for region %s", brick.size, brick.region.toString().c_str());
+			return false;
+		}
+		if (!skip && voxel::intersects(brick.region, cropped)) {
+			bricks.push_back(brick);
+		}
+	}
+	if (skip) {
+		return true;
+	}
+	if (state.probeModels != nullptr) {
+		// the node keeps the one voxel placeholder volume of loadNode()
+		core_assert(node.volume() != nullptr);
+		ProbeModel model;
+		model.region = cropped;
+		// the bricks store one byte for every voxel and two more bytes for every solid voxel - this is only exact if
+		// the whole region is loaded
+		if (cropped == region) {
+			model.voxels = 0;
+			for (const Brick &brick : bricks) {
+				model.voxels += ((int64_t)brick.size - (int64_t)brick.region.voxels()) / 2;
+			}
+		}
+		state.probeModels->put(node.id(), model);
+		return true;
+	}
+	// the voxels are loaded once the whole index is known
+	node.setVolume(new voxel::RawVolume(cropped), true);
+	state.bricks.put(node.id(), bricks);
+	return true;
+}
+
+bool VENGIFormat::loadBricks(scenegraph::SceneGraph &sceneGraph, io::SeekableReadStream &stream, int64_t dataStart,
+							 LoadState &state) {
+	int loadedNodes = 0;
+	for (const auto &entry : state.bricks) {
+		state.ctx.progress("nodes", loadedNodes++, (int)state.bricks.size());
+		const int nodeId = entry->key;
+		if (!sceneGraph.hasNode(nodeId)) {
+			continue;
+		}
+		const Bricks &bricks = entry->value;
+		scenegraph::SceneGraphNode &node = sceneGraph.node(nodeId);
+
+		// the reads are sequential - but the decompression of the bricks is done in parallel
+		core::DynamicArray<size_t> positions;
+		positions.reserve(bricks.size());
+		size_t compressedSize = 0u;
+		const int64_t available = stream.size() - dataStart;
+		for (const Brick &brick : bricks) {
+			if (brick.offset > (uint64_t)available || brick.compressedSize > (uint64_t)available - brick.offset) {
+				Log::error("The brick at offset %u exceeds the stream", (uint32_t)brick.offset);
+				return false;
+			}
+			positions.push_back(compressedSize);
+			compressedSize += brick.compressedSize;
+		}
+		core::DynamicArray<uint8_t> compressed;
+		compressed.resize(compressedSize);
+		for (size_t i = 0; i < bricks.size(); ++i) {
+			const Brick &brick = bricks[i];
+			if (stream.seek(dataStart + (int64_t)brick.offset) == -1) {
+				Log::error("Failed to seek to the brick at offset %u", (uint32_t)brick.offset);
+				return false;
+			}
+			if (stream.read(compressed.data() + positions[i], brick.compressedSize) != (int)brick.compressedSize) {
+				Log::error("Failed to read the brick at offset %u", (uint32_t)brick.offset);
+				return false;
+			}
+		}
+
+		voxel::RawVolume *v = node.volume();
+		const palette::Palette &palette = node.palette();
+
+		// the threads must not write into the same occupancy brick of the volume. This is only guaranteed if the
+		// bricks are aligned to the occupancy bricks - otherwise the bricks are processed in eight passes with
+		// bricks that are not next to each other.
+		const glm::ivec3 &volumeMins = v->region().getLowerCorner();
+		bool aligned = true;
+		for (const Brick &brick : bricks) {
+			const glm::ivec3 offset = brick.region.getLowerCorner() - volumeMins;
+			if (glm::any(glm::notEqual(offset % voxel::RawVolume::OccupancyBrickSize, glm::ivec3(0)))) {
+				aligned = false;
+				break;
+			}
+		}
+		core::DynamicArray<core::DynamicArray<int>> passes;
+		passes.resize(aligned ? 1 : 8);
+		for (int i = 0; i < (int)bricks.size(); ++i) {
+			// the brick corners are BrickSize apart from each other
+			const glm::ivec3 cell = (bricks[i].region.getLowerCorner() - bricks[0].region.getLowerCorner()) / BrickSize;
+			const int pass = aligned ? 0 : (cell.x & 1) | ((cell.y & 1) << 1) | ((cell.z & 1) << 2);
+			passes[pass].push_back(i);
+		}
+		core::AtomicBool failed{false};
+		for (const core::DynamicArray<int> &pass : passes) {
+			app::for_parallel(0, (int)pass.size(), [&](int start, int end) {
+				for (int n = start; n < end; ++n) {
+					const int i = pass[n];
+					const Brick &brick = bricks[i];
+					if (!decompressBrick(compressed.data() + positions[i], brick.region, brick.compressedSize,
+										 brick.size, palette, *v)) {
+						failed = true;
+					}
+				}
+			});
+		}
+		if (failed) {
+			Log::error("Failed to decompress the voxels of node %s", node.name().c_str());
+			return false;
+		}
+	}
 	return true;
 }
 
@@ -394,7 +713,7 @@ bool VENGIFormat::loadNodeKeyFrame(scenegraph::SceneGraph &sceneGraph, scenegrap
 }
 
 bool VENGIFormat::loadNode(scenegraph::SceneGraph &sceneGraph, int parent, uint32_t version, io::ReadStream &stream,
-						   NodeMapping &nodeMapping) {
+						   LoadState &state) {
 	core::String name;
 	wrapBool(stream.readPascalStringUInt16LE(name))
 	core::String type;
@@ -410,7 +729,7 @@ bool VENGIFormat::loadNode(scenegraph::SceneGraph &sceneGraph, int parent, uint3
 		scenegraph::SceneGraphNode node(nodeType);
 		node.setName(name);
 		if (nodeType == scenegraph::SceneGraphNodeType::Model) {
-			// dummy volume - will be replaced later
+			// dummy volume - will be replaced later - this is also the placeholder volume of the probed model nodes
 			node.setVolume(new voxel::RawVolume(voxel::Region(0, 0)), true);
 		}
 		nodeId = sceneGraph.emplace(core::move(node), parent);
@@ -421,14 +740,14 @@ bool VENGIFormat::loadNode(scenegraph::SceneGraph &sceneGraph, int parent, uint3
 	}
 	scenegraph::SceneGraphNode &node = sceneGraph.node(nodeId);
 
+	int fileNodeId = InvalidNodeId;
 	if (version >= 2) {
-		int fileNodeId;
 		wrap(stream.readInt32(fileNodeId))
 		int referenceNodeId;
 		wrap(stream.readInt32(referenceNodeId))
 		// will get fixed up later once we know all node ids
 		node.setReference(referenceNodeId);
-		nodeMapping.put(fileNodeId, nodeId);
+		state.nodeMapping.put(fileNodeId, nodeId);
 	}
 	node.setVisible(stream.readBool());
 	node.setLocked(stream.readBool());
@@ -442,6 +761,9 @@ bool VENGIFormat::loadNode(scenegraph::SceneGraph &sceneGraph, int parent, uint3
 		wrap(stream.readFloat(pivot.z))
 	}
 
+	// model nodes that are filtered out by the load context are removed once their children are loaded
+	bool skip = false;
+	voxel::Region fullRegion = voxel::Region::InvalidRegion;
 	while (!stream.eos()) {
 		uint32_t chunkMagic;
 		wrap(stream.readUInt32(chunkMagic))
@@ -450,7 +772,11 @@ bool VENGIFormat::loadNode(scenegraph::SceneGraph &sceneGraph, int parent, uint3
 				return false;
 			}
 		} else if (chunkMagic == FourCC('D', 'A', 'T', 'A')) {
-			if (!loadNodeData(sceneGraph, node, version, stream)) {
+			if (!loadNodeData(sceneGraph, node, version, stream, state, fullRegion, skip)) {
+				return false;
+			}
+		} else if (chunkMagic == FourCC('B', 'R', 'C', 'K')) {
+			if (!loadNodeBricks(sceneGraph, node, version, stream, state, fullRegion, skip)) {
 				return false;
 			}
 		} else if (chunkMagic == FourCC('P', 'A', 'L', 'C')) {
@@ -470,10 +796,25 @@ bool VENGIFormat::loadNode(scenegraph::SceneGraph &sceneGraph, int parent, uint3
 				return false;
 			}
 		} else if (chunkMagic == FourCC('N', 'O', 'D', 'E')) {
-			if (!loadNode(sceneGraph, node.id(), version, stream, nodeMapping)) {
+			if (!loadNode(sceneGraph, node.id(), version, stream, state)) {
 				return false;
 			}
 		} else if (chunkMagic == FourCC('E', 'N', 'D', 'N')) {
+			if (skip) {
+				Log::debug("Skip node '%s'", name.c_str());
+				state.nodeMapping.remove(fileNodeId);
+				// the children are moved to the parent of the skipped node
+				sceneGraph.removeNode(nodeId, false);
+				return true;
+			}
+			// the region of the placeholder volume of a probed model node is meaningless
+			if (state.probeModels == nullptr && fullRegion.isValid() && fullRegion != node.region()) {
+				// keep the pivot at the same position for the cropped volume
+				const voxel::Region &region = node.region();
+				const glm::vec3 worldPivot = pivot * glm::vec3(fullRegion.getDimensionsInVoxels()) +
+											 glm::vec3(fullRegion.getLowerCorner() - region.getLowerCorner());
+				pivot = worldPivot / glm::vec3(region.getDimensionsInVoxels());
+			}
 			node.setPivot(pivot);
 			return true;
 		}
@@ -490,17 +831,107 @@ bool VENGIFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const cor
 		return false;
 	}
 	Log::debug("Save scenegraph as vengi");
+
+	core::DynamicArray<BrickData> brickData;
+	for (auto iter = sceneGraph.beginModel(); iter != sceneGraph.end(); ++iter) {
+		const scenegraph::SceneGraphNode &node = *iter;
+		const voxel::Region &region = node.volume()->region();
+		const glm::ivec3 &mins = region.getLowerCorner();
+		const glm::ivec3 &maxs = region.getUpperCorner();
+		for (int z = mins.z; z <= maxs.z; z += BrickSize) {
+			for (int y = mins.y; y <= maxs.y; y += BrickSize) {
+				for (int x = mins.x; x <= maxs.x; x += BrickSize) {
+					BrickData brick;
+					brick.nodeId = node.id();
+					brick.region = voxel::Region(x, y, z, core_min(x + BrickSize - 1, maxs.x),
+												 core_min(y + BrickSize - 1, maxs.y),
+												 core_min(z + BrickSize - 1, maxs.z));
+					brickData.push_back(brick);
+				}
+			}
+		}
+	}
+
+	const int replaceIndex = core::Var::getSafe(cfg::VoxformatEmptyPaletteIndex)->intVal();
+	core::AtomicBool failed{false};
+	app::for_parallel(0, (int)brickData.size(), [&](int start, int end) {
+		for (int i = start; i < end; ++i) {
+			BrickData &brick = brickData[i];
+			if (!compressBrick(sceneGraph.node(brick.nodeId), brick, replaceIndex)) {
+				failed = true;
+			}
+		}
+	});
+	if (failed) {
+		Log::error("Failed to compress the voxels");
+		return false;
+	}
+
+	// the offsets are relative to the end of the index - which is written in front of the bricks
+	NodeBricks nodeBricks;
+	uint64_t offset = 0u;
+	for (const BrickData &data : brickData) {
+		if (!data.compressed) {
+			continue;
+		}
+		Brick brick;
+		brick.region = data.region;
+		brick.offset = offset;
+		brick.compressedSize = (uint32_t)data.compressed->size();
+		brick.size = data.size;
+		offset += brick.compressedSize;
+		auto iter = nodeBricks.find(data.nodeId);
+		if (iter == nodeBricks.end()) {
+			Bricks bricks;
+			bricks.push_back(brick);
+			nodeBricks.put(data.nodeId, bricks);
+		} else {
+			iter->value.push_back(brick);
+		}
+	}
+
+	io::BufferedReadWriteStream index;
+	{
+		io::ZipWriteStream zipStream(index);
+		if (!saveNode(sceneGraph, zipStream, sceneGraph.root(), nodeBricks)) {
+			return false;
+		}
+	}
+
 	wrapBool(stream->writeUInt32(FourCC('V', 'E', 'N', 'G')))
-	io::ZipWriteStream zipStream(*stream, stream->size());
-	wrapBool(zipStream.writeUInt32(4))
-	if (!saveNode(sceneGraph, zipStream, sceneGraph.root())) {
+	wrapBool(stream->writeUInt32(BrickLayoutMagic))
+	wrapBool(stream->writeUInt32(VENGIVersion))
+	wrapBool(stream->writeUInt32((uint32_t)index.size()))
+	if (stream->write(index.getBuffer(), index.size()) != (int)index.size()) {
+		Log::error("Failed to write the index");
 		return false;
 	}
+	for (const BrickData &data : brickData) {
+		if (!data.compressed) {
+			continue;
+		}
+		const int64_t size = data.compressed->size();
+		if (stream->write(data.compressed->getBuffer(), size) != (int)size) {
+			Log::error("Failed to write the voxels");
+			return false;
+		}
+	}
 	return true;
 }
 
-bool VENGIFormat::loadGroups(const core::String &filename, const io::ArchivePtr &archive,
-							 scenegraph::SceneGraph &sceneGraph, const LoadContext &ctx) {
+bool VENGIFormat::loadRootNode(scenegraph::SceneGraph &sceneGraph, uint32_t version, io::ReadStream &stream,
+							   LoadState &state) {
+	uint32_t chunkMagic;
+	wrap(stream.readUInt32(chunkMagic))
+	if (chunkMagic != FourCC('N', 'O', 'D', 'E')) {
+		Log::error("Unknown chunk magic");
+		return false;
+	}
+	return loadNode(sceneGraph, sceneGraph.root().id(), version, stream, state);
+}
+
+bool VENGIFormat::loadScene(const core::String &filename, const io::ArchivePtr &archive,
+							scenegraph::SceneGraph &sceneGraph, LoadState &state) {
 	core::ScopedPtr<io::SeekableReadStream> stream(archive->readStream(filename));
 	if (!stream) {
 		Log::error("Could not load file %s", filename.c_str());
@@ -512,36 +943,91 @@ bool VENGIFormat::loadGroups(const core::String &filename, const io::ArchivePtr
 		Log::error("Invalid magic");
 		return false;
 	}
-	io::ZipReadStream zipStream(*stream, stream->size());
+	uint32_t layout;
+	wrap(stream->readUInt32(layout))
 	uint32_t version;
-	wrap(zipStream.readUInt32(version))
-	if (version > 4) {
-		Log::error("Unsupported version %u", version);
-		return false;
-	}
-	uint32_t chunkMagic;
-	wrap(zipStream.readUInt32(chunkMagic))
-	NodeMapping nodeMapping;
-	if (chunkMagic == FourCC('N', 'O', 'D', 'E')) {
-		if (!loadNode(sceneGraph, sceneGraph.root().id(), version, zipStream, nodeMapping)) {
+	if (layout == BrickLayoutMagic) {
+		// the index is compressed on its own and is followed by the bricks
+		wrap(stream->readUInt32(version))
+		if (version < 5u || version > VENGIVersion) {
+			Log::error("Unsupported version %u", version);
+			return false;
+		}
+		uint32_t indexSize;
+		wrap(stream->readUInt32(indexSize))
+		const int64_t dataStart = stream->pos() + indexSize;
+		if (dataStart > stream->size()) {
+			Log::error("Invalid index size %u", indexSize);
+			return false;
+		}
+		{
+			io::ZipReadStream zipStream(*stream, (int)indexSize);
+			if (!loadRootNode(sceneGraph, version, zipStream, state)) {
+				return false;
+			}
+		}
+		if (state.probeModels == nullptr && !loadBricks(sceneGraph, *stream, dataStart, state)) {
+			return false;
+		}
+	} else {
+		// the older versions compress the whole file - including the version - and the zlib stream starts right
+		// after the magic
+		if (stream->seek(-4, SEEK_CUR) == -1) {
+			Log::error("Failed to seek back to the compressed data");
+			return false;
+		}
+		io::ZipReadStream zipStream(*stream, stream->size());
+		wrap(zipStream.readUInt32(version))
+		if (version > 4) {
+			Log::error("Unsupported version %u", version);
+			return false;
+		}
+		if (!loadRootNode(sceneGraph, version, zipStream, state)) {
 			return false;
 		}
-		for (auto iter = sceneGraph.begin(scenegraph::SceneGraphNodeType::ModelReference); iter != sceneGraph.end();
-			 ++iter) {
-			scenegraph::SceneGraphNode &node = *iter;
-			int nodeId;
-			if (!nodeMapping.get(node.reference(), nodeId)) {
+	}
+
+	core::DynamicArray<int> unresolved;
+	for (auto iter = sceneGraph.begin(scenegraph::SceneGraphNodeType::ModelReference); iter != sceneGraph.end();
+		 ++iter) {
+		scenegraph::SceneGraphNode &node = *iter;
+		int nodeId;
+		if (!state.nodeMapping.get(node.reference(), nodeId)) {
+			if (state.ctx.nodeNames.empty() && !state.ctx.region.isValid()) {
 				Log::error("Failed to perform node id mapping for references");
 				return false;
 			}
-			Log::debug("Update node reference for node %i to: %i", node.id(), nodeId);
-			node.setReference(nodeId);
+			// the referenced model node was filtered out by the load context
+			unresolved.push_back(node.id());
+			continue;
 		}
-		sceneGraph.updateTransforms();
-		return true;
+		Log::debug("Update node reference for node %i to: %i", node.id(), nodeId);
+		node.setReference(nodeId);
 	}
-	Log::error("Unknown chunk magic");
-	return false;
+	for (int nodeId : unresolved) {
+		sceneGraph.removeNode(nodeId, false);
+	}
+	sceneGraph.updateTransforms();
+	return true;
+}
+
+bool VENGIFormat::loadGroups(const core::String &filename, const io::ArchivePtr &archive,
+							 scenegraph::SceneGraph &sceneGraph, const LoadContext &ctx) {
+	LoadState state(ctx);
+	return loadScene(filename, archive, sceneGraph, state);
+}
+
+bool VENGIFormat::probe(const core::String &filename, const io::ArchivePtr &archive, ProbeResult &result,
+						const LoadContext &ctx) {
+	LoadState state(ctx);
+	ProbeModels models;
+	state.probeModels = &models;
+	scenegraph::SceneGraph sceneGraph;
+	if (!loadScene(filename, archive, sceneGraph, state)) {
+		return false;
+	}
+	fillProbeResult(sceneGraph, models, true, result);
+	return true;
 }
 
 #undef wrap
@@ -16,16 +16,50 @@ namespace voxelformat {
  *
  * It's a RIFF header based format. It stores one palette per model node.
  *
+ * Starting with version 5 the voxels are stored in bricks that are compressed independently of each other. The
+ * compressed node hierarchy acts as index for the bricks and is stored in front of them. This allows to compress
+ * the bricks in parallel and to only load the model nodes and regions that were selected in the @c LoadContext.
+ * This layout is marked by a @c BRCK magic behind the @c VENG magic - the older versions compress everything behind
+ * the @c VENG magic.
+ *
  * @ingroup Formats
  */
 class VENGIFormat : public Format {
 private:
 	using NodeMapping = core::Map<int, int>;
 
+	/**
+	 * @brief A part of the voxels of a model node that is compressed on its own
+	 */
+	struct Brick {
+		voxel::Region region;
+		/** relative to the start of the brick data behind the index */
+		uint64_t offset = 0u;
+		uint32_t compressedSize = 0u;
+		uint32_t size = 0u;
+	};
+	using Bricks = core::DynamicArray<Brick>;
+	using NodeBricks = core::Map<int, Bricks>;
+
+	struct LoadState {
+		const LoadContext &ctx;
+		NodeMapping nodeMapping;
+		/** the bricks of the model nodes that should get loaded */
+		NodeBricks bricks;
+		/**
+		 * if set, the voxels are not loaded - the model nodes keep their placeholder volume and their region is
+		 * recorded here
+		 */
+		ProbeModels *probeModels = nullptr;
+
+		LoadState(const LoadContext &_ctx) : ctx(_ctx) {
+		}
+	};
+
 	bool saveNodeProperties(const scenegraph::SceneGraph &sceneGraph, const scenegraph::SceneGraphNode &node,
 							io::WriteStream &stream);
 	bool saveNodeData(const scenegraph::SceneGraph &sceneGraph, const scenegraph::SceneGraphNode &node,
-					  io::WriteStream &stream);
+					  io::WriteStream &stream, const NodeBricks &bricks);
 	bool saveAnimation(const scenegraph::SceneGraphNode &node, const core::String &animation, io::WriteStream &stream);
 	bool saveNodeKeyFrame(const scenegraph::SceneGraphKeyFrame &keyframe, io::WriteStream &stream);
 	bool saveNodePaletteColors(const scenegraph::SceneGraph &sceneGraph, const scenegraph::SceneGraphNode &node,
@@ -35,12 +69,25 @@ private:
 	bool saveNodePaletteNormals(const scenegraph::SceneGraph &sceneGraph, const scenegraph::SceneGraphNode &node,
 								io::WriteStream &stream);
 	bool saveNode(const scenegraph::SceneGraph &sceneGraph, io::WriteStream &stream,
-				  const scenegraph::SceneGraphNode &node);
+				  const scenegraph::SceneGraphNode &node, const NodeBricks &bricks);
 
 	bool loadNodeProperties(scenegraph::SceneGraph &sceneGraph, scenegraph::SceneGraphNode &node, uint32_t version,
 							io::ReadStream &stream);
+	/**
+	 * @param[out] fullRegion The region of the model node before it was cropped by the @c LoadContext
+	 * @param[out] skip @c true if the model node was filtered out by the @c LoadContext
+	 */
 	bool loadNodeData(scenegraph::SceneGraph &sceneGraph, scenegraph::SceneGraphNode &node, uint32_t version,
-					  io::ReadStream &stream);
+					  io::ReadStream &stream, LoadState &state, voxel::Region &fullRegion, bool &skip);
+	/**
+	 * @brief Loads the brick index of a model node - the voxels are loaded later in @c loadBricks()
+	 * @param[out] fullRegion The region of the model node before it was cropped by the @c LoadContext
+	 * @param[out] skip @c true if the model node was filtered out by the @c LoadContext
+	 */
+	bool loadNodeBricks(scenegraph::SceneGraph &sceneGraph, scenegraph::SceneGraphNode &node, uint32_t version,
+						io::ReadStream &stream, LoadState &state, voxel::Region &fullRegion, bool &skip);
+	bool loadBricks(scenegraph::SceneGraph &sceneGraph, io::SeekableReadStream &stream, int64_t dataStart,
+					LoadState &state);
 	bool loadAnimation(scenegraph::SceneGraph &sceneGraph, scenegraph::SceneGraphNode &node, uint32_t version,
 					   io::ReadStream &stream);
 	bool loadNodeKeyFrame(scenegraph::SceneGraph &sceneGraph, scenegraph::SceneGraphNode &node, uint32_t version,
@@ -52,7 +99,10 @@ private:
 	bool loadNodePaletteNormals(scenegraph::SceneGraph &sceneGraph, scenegraph::SceneGraphNode &node, uint32_t version,
 								io::ReadStream &stream);
 	bool loadNode(scenegraph::SceneGraph &sceneGraph, int parent, uint32_t version, io::ReadStream &stream,
-				  NodeMapping &nodeMapping);
+				  LoadState &state);
+	bool loadRootNode(scenegraph::SceneGraph &sceneGraph, uint32_t version, io::ReadStream &stream, LoadState &state);
+	bool loadScene(const core::String &filename, const io::ArchivePtr &archive, scenegraph::SceneGraph &sceneGraph,
+				   LoadState &state);
 
 protected:
 	bool saveGroups(const scenegraph::SceneGraph &sceneGraph, const core::String &filename,
@@ -60,6 +110,13 @@ protected:
 	bool loadGroups(const core::String &filename, const io::ArchivePtr &archive, scenegraph::SceneGraph &sceneGraph,
 					const LoadContext &ctx) override;
 public:
+	/**
+	 * @brief Only reads the compressed node hierarchy in front of the bricks. The amount of voxels is calculated from
+	 * the brick sizes.
+	 */
+	bool probe(const core::String &filename, const io::ArchivePtr &archive, ProbeResult &result,
+			   const LoadContext &ctx) override;
+
 	static const io::FormatDescription &format() {
 		static io::FormatDescription f{
 			"Vengi", {"vengi"}, {"VENG"}, VOX_FORMAT_FLAG_PALETTE_EMBEDDED | VOX_FORMAT_FLAG_ANIMATION | FORMAT_FLAG_SAVE};
@@ -430,6 +430,84 @@ void AbstractFormatTest::testSaveMultipleModels(const core::String &filename, Fo
 	voxel::sceneGraphComparator(sceneGraph, sceneGraphLoad, flags);
 }
 
+void AbstractFormatTest::testProbe(const core::String &filename, Format *format, bool exactRegions) {
+	SCOPED_TRACE(filename.c_str());
+	palette::Palette pal;
+	pal.nippon();
+	voxel::RawVolume model1(voxel::Region(0, 0, 0, 3, 2, 1));
+	voxel::RawVolume model2(voxel::Region(0, 1));
+	for (int z = 0; z <= 1; ++z) {
+		for (int y = 0; y <= 2; ++y) {
+			for (int x = 0; x <= 3; ++x) {
+				model1.setVoxel(x, y, z, voxel::createVoxel(pal, 1));
+			}
+		}
+	}
+	model2.setVoxel(0, 0, 0, voxel::createVoxel(pal, 2));
+	model2.setVoxel(1, 1, 1, voxel::createVoxel(pal, 3));
+	model2.setVoxel(0, 1, 0, voxel::createVoxel(pal, 4));
+
+	scenegraph::SceneGraph sceneGraph;
+	scenegraph::SceneGraphNode node1(scenegraph::SceneGraphNodeType::Model);
+	node1.setVolume(&model1, false);
+	node1.setPalette(pal);
+	node1.setName("first");
+	scenegraph::SceneGraphNode node2(scenegraph::SceneGraphNodeType::Model);
+	node2.setVolume(&model2, false);
+	node2.setPalette(pal);
+	node2.setName("second");
+	ASSERT_NE(InvalidNodeId, sceneGraph.emplace(core::move(node1)));
+	ASSERT_NE(InvalidNodeId, sceneGraph.emplace(core::move(node2)));
+
+	io::ArchivePtr archive = helper_archive();
+	ASSERT_TRUE(format->save(sceneGraph, filename, archive, testSaveCtx));
+	testProbeFile(filename, archive, format, exactRegions);
+}
+
+void AbstractFormatTest::testProbeFile(const core::String &filename, const io::ArchivePtr &archive, Format *format,
+									   bool exactRegions) {
+	SCOPED_TRACE(filename.c_str());
+	scenegraph::SceneGraph sceneGraphLoad;
+	ASSERT_TRUE(format->load(filename, archive, sceneGraphLoad, testLoadCtx));
+
+	ProbeResult result;
+	ASSERT_TRUE(format->probe(filename, archive, result, testLoadCtx));
+	ASSERT_FALSE(result.nodes.empty());
+	EXPECT_EQ(scenegraph::SceneGraphNodeType::Root, result.nodes[0].type);
+	for (size_t i = 1; i < result.nodes.size(); ++i) {
+		const ProbeNode &probeNode = result.nodes[i];
+		const ProbeNode *parent = result.node(probeNode.parent);
+		ASSERT_NE(nullptr, parent) << "node " << probeNode.id << " has no parent";
+		EXPECT_LT(parent - result.nodes.data(), (ptrdiff_t)i) << "parent is not in front of node " << probeNode.id;
+	}
+	ASSERT_EQ(sceneGraphLoad.size(scenegraph::SceneGraphNodeType::AllModels),
+			  result.size(scenegraph::SceneGraphNodeType::AllModels));
+	for (auto iter = sceneGraphLoad.beginModel(); iter != sceneGraphLoad.end(); ++iter) {
+		const scenegraph::SceneGraphNode &node = *iter;
+		const ProbeNode *probeNode = result.node(node.id());
+		ASSERT_NE(nullptr, probeNode) << "node " << node.id() << " is missing in the probe result";
+		EXPECT_EQ(node.name(), probeNode->name);
+		EXPECT_EQ(node.type(), probeNode->type);
+		EXPECT_EQ(node.visible(), probeNode->visible);
+		const glm::ivec3 &dimensions = node.region().getDimensionsInVoxels();
+		const glm::ivec3 &probeDimensions = probeNode->region.getDimensionsInVoxels();
+		if (exactRegions) {
+			EXPECT_EQ(dimensions, probeDimensions) << "region of node " << node.name().c_str();
+		} else {
+			EXPECT_TRUE(glm::all(glm::greaterThanEqual(probeDimensions, dimensions)))
+				<< "region of node " << node.name().c_str();
+		}
+		if (probeNode->voxels != -1) {
+			const int64_t voxels = voxelutil::visitVolume(*node.volume(), voxelutil::EmptyVisitor());
+			EXPECT_EQ(voxels, probeNode->voxels) << "voxels of node " << node.name().c_str();
+		}
+		if (probeNode->palette != -1) {
+			ASSERT_LT(probeNode->palette, (int)result.palettes.size());
+			EXPECT_EQ(node.palette().colorCount(), result.palettes[probeNode->palette].colorCount());
+		}
+	}
+}
+
 void AbstractFormatTest::testSave(const core::String &filename, Format *format, const palette::Palette &palette,
 								  voxel::ValidateFlags flags) {
 	SCOPED_TRACE(filename.c_str());
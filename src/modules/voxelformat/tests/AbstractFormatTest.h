@@ -76,6 +76,15 @@ protected:
 						   voxel::ValidateFlags flags = voxel::ValidateFlags::All, float maxDelta = 0.001f);
 	void testSaveLoadCube(const core::String &filename, Format *format,
 						  voxel::ValidateFlags flags = voxel::ValidateFlags::All, float maxDelta = 0.001f);
+	/**
+	 * @param exactRegions @c false if the format can only report an upper bound for the model regions
+	 */
+	void testProbe(const core::String &filename, Format *format, bool exactRegions = true);
+	/**
+	 * @brief Compares the probe result of an existing file with the loaded scene graph
+	 */
+	void testProbeFile(const core::String &filename, const io::ArchivePtr &archive, Format *format,
+					   bool exactRegions = true);
 	void testConvert(const core::String &srcFilename, Format &srcFormat, const core::String &destFilename,
 							 Format &destFormat, voxel::ValidateFlags flags = voxel::ValidateFlags::All,
 							 float maxDelta = 0.001f);
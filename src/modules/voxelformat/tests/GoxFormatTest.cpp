@@ -18,6 +18,11 @@ TEST_F(GoxFormatTest, testSaveSmallVoxel) {
 	testSaveLoadVoxel("goxel-smallvolumesavetest.gox", &f, -16, 15, voxel::ValidateFlags::None);
 }
 
+TEST_F(GoxFormatTest, testProbe) {
+	GoxFormat f;
+	testProbe("goxel-probetest.gox", &f, false);
+}
+
 TEST_F(GoxFormatTest, testLoadRGB) {
 	testRGB("rgb.gox");
 }
@@ -3,6 +3,8 @@
  */
 
 #include "AbstractFormatTest.h"
+#include "io/FormatDescription.h"
+#include "voxelformat/VolumeFormat.h"
 #include "scenegraph/SceneGraphNode.h"
 #include "voxel/RawVolume.h"
 #include "voxelutil/VolumeVisitor.h"
@@ -46,4 +48,56 @@ TEST_F(MCRFormatTest, testLoad113) {
 	EXPECT_EQ(17920, cnt);
 }
 
+TEST_F(MCRFormatTest, testLoadStreamed) {
+	const io::ArchivePtr &archive = helper_filesystemarchive();
+	const core::String filename = "r.0.-2.mca";
+	if (!archive->exists(filename)) {
+		GTEST_SKIP() << "Could not open " << filename;
+	}
+	struct Streamed {
+		int nodes = 0;
+		int voxels = 0;
+	} streamed;
+	LoadContext ctx;
+	ctx.userdata = &streamed;
+	ctx.nodeLoaded = [](const scenegraph::SceneGraph &sceneGraph, int nodeId, void *userdata) {
+		Streamed *s = (Streamed *)userdata;
+		const voxel::RawVolume *v = sceneGraph.node(nodeId).volume();
+		s->voxels += voxelutil::visitVolume(*v, [&](int, int, int, const voxel::Voxel &) {});
+		++s->nodes;
+		return true;
+	};
+	// every node exceeds the limit - so they are all removed from the scene graph after they were handed out
+	ctx.maxMemory = 1u;
+	io::FileDescription fileDesc;
+	fileDesc.set(filename);
+	scenegraph::SceneGraph sceneGraph;
+	ASSERT_TRUE(voxelformat::loadFormat(fileDesc, archive, sceneGraph, ctx));
+	EXPECT_EQ(0u, sceneGraph.size(scenegraph::SceneGraphNodeType::Model));
+	EXPECT_EQ(128, streamed.nodes);
+
+	scenegraph::SceneGraph fullSceneGraph;
+	ASSERT_TRUE(voxelformat::loadFormat(fileDesc, archive, fullSceneGraph, testLoadCtx));
+	int voxels = 0;
+	for (auto iter = fullSceneGraph.beginModel(); iter != fullSceneGraph.end(); ++iter) {
+		voxels += voxelutil::visitVolume(*(*iter).volume(), [&](int, int, int, const voxel::Voxel &) {});
+	}
+	EXPECT_EQ(voxels, streamed.voxels);
+}
+
+TEST_F(MCRFormatTest, testLoadStreamedAbort) {
+	const io::ArchivePtr &archive = helper_filesystemarchive();
+	const core::String filename = "r.0.-2.mca";
+	if (!archive->exists(filename)) {
+		GTEST_SKIP() << "Could not open " << filename;
+	}
+	LoadContext ctx;
+	ctx.nodeLoaded = [](const scenegraph::SceneGraph &, int, void *) { return false; };
+	ctx.maxMemory = 1u;
+	io::FileDescription fileDesc;
+	fileDesc.set(filename);
+	scenegraph::SceneGraph sceneGraph;
+	EXPECT_FALSE(voxelformat::loadFormat(fileDesc, archive, sceneGraph, ctx)) << "A failed load must not succeed";
+}
+
 } // namespace voxelformat
@@ -3,22 +3,133 @@
  */
 
 #include "voxelformat/private/mesh/MeshFormat.h"
+#include "core/Algorithm.h"
 #include "core/Color.h"
+#include "core/ConfigVar.h"
+#include "core/GLM.h"
+#include "core/collection/Map.h"
 #include "core/tests/TestColorHelper.h"
 #include "image/Image.h"
 #include "io/Archive.h"
 #include "scenegraph/SceneGraph.h"
 #include "scenegraph/SceneGraphNode.h"
+#include "util/VarUtil.h"
 #include "video/ShapeBuilder.h"
 #include "voxel/MaterialColor.h"
 #include "voxel/RawVolume.h"
+#include "voxel/SurfaceExtractor.h"
 #include "voxelformat/VolumeFormat.h"
 #include "voxelformat/private/mesh/MeshMaterial.h"
 #include "voxelformat/tests/AbstractFormatTest.h"
 
 namespace voxelformat {
 
-class MeshFormatTest : public AbstractFormatTest {};
+class MeshFormatTest : public AbstractFormatTest {
+protected:
+	class TestMesh : public MeshFormat {
+	public:
+		bool saveMeshes(const core::Map<int, int> &, const scenegraph::SceneGraph &, const Meshes &,
+						const core::String &, const io::ArchivePtr &, const glm::vec3 &, bool, bool, bool) override {
+			return false;
+		}
+		void voxelize(scenegraph::SceneGraph &sceneGraph, const MeshFormat::MeshTriCollection &tris) {
+			voxelizeNode("test", sceneGraph, tris);
+			sceneGraph.updateTransforms();
+		}
+	};
+
+	static constexpr int QuadSize = 100;
+	const core::RGBA _lowerColor{255, 0, 0, 255};
+	const core::RGBA _upperColor{0, 0, 255, 255};
+
+	/**
+	 * @brief A quad on the plane @c z=x+0.5 that spans several voxelize tiles - the lower triangle is red and the
+	 * upper one is blue. The offsets keep the voxel centers away from the borders of the triangles.
+	 */
+	MeshFormat::MeshTriCollection tiltedQuad() const {
+		const float s = (float)QuadSize;
+		const glm::vec3 corners[4]{{0.0f, 0.5f, 0.5f}, {s, 0.5f, s + 0.5f}, {s, s + 0.5f, s + 0.5f}, {0.0f, s + 0.5f, 0.5f}};
+		const int triCorners[2][3]{{0, 1, 2}, {0, 2, 3}};
+		MeshFormat::MeshTriCollection tris;
+		for (int i = 0; i < 2; ++i) {
+			voxelformat::MeshTri meshTri;
+			for (int j = 0; j < 3; ++j) {
+				meshTri.vertices[j] = corners[triCorners[i][j]];
+				meshTri.color[j] = i == 0 ? _lowerColor : _upperColor;
+			}
+			tris.push_back(meshTri);
+		}
+		return tris;
+	}
+
+	using ExpectedVoxels = core::Map<glm::ivec3, core::RGBA, 1031, glm::hash<glm::ivec3>>;
+
+	/**
+	 * @brief Compares every voxel of the volume with the expected voxels - the expected voxels with an alpha of
+	 * @c 0 are only checked to be solid
+	 */
+	void checkVoxels(const scenegraph::SceneGraphNode &node, const ExpectedVoxels &expected) const {
+		const voxel::RawVolume *v = node.volume();
+		const palette::Palette &palette = node.palette();
+		const voxel::Region &region = v->region();
+		int solid = 0;
+		for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+			for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+					const voxel::Voxel &voxel = v->voxel(x, y, z);
+					core::RGBA color;
+					const bool expectedSolid = expected.get(glm::ivec3(x, y, z), color);
+					ASSERT_EQ(expectedSolid, !voxel::isAir(voxel.getMaterial())) << x << ":" << y << ":" << z;
+					if (!expectedSolid) {
+						continue;
+					}
+					++solid;
+					if (color.a != 0) {
+						ASSERT_EQ(color, palette.color(voxel.getColor())) << x << ":" << y << ":" << z;
+					}
+				}
+			}
+		}
+		EXPECT_EQ((int)expected.size(), solid);
+	}
+	struct Triangle {
+		glm::vec3 positions[3];
+		int attributes[3];
+	};
+
+	/**
+	 * @brief The triangles of the mesh in a defined order - to compare meshes with a different vertex order
+	 */
+	core::DynamicArray<Triangle> sortedTriangles(const voxel::Mesh &mesh) const {
+		const voxel::VertexArray &vertices = mesh.getVertexVector();
+		const voxel::IndexArray &indices = mesh.getIndexVector();
+		core::DynamicArray<Triangle> triangles;
+		triangles.reserve(indices.size() / 3);
+		for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+			Triangle triangle;
+			for (int n = 0; n < 3; ++n) {
+				const voxel::VoxelVertex &vertex = vertices[indices[i + n]];
+				triangle.positions[n] = vertex.position;
+				triangle.attributes[n] = (vertex.info << 16) | (vertex.colorIndex << 8) | vertex.normalIndex;
+			}
+			triangles.push_back(triangle);
+		}
+		core::sort(triangles.begin(), triangles.end(), [](const Triangle &a, const Triangle &b) {
+			for (int n = 0; n < 3; ++n) {
+				for (int c = 0; c < 3; ++c) {
+					if (a.positions[n][c] != b.positions[n][c]) {
+						return a.positions[n][c] < b.positions[n][c];
+					}
+				}
+				if (a.attributes[n] != b.attributes[n]) {
+					return a.attributes[n] < b.attributes[n];
+				}
+			}
+			return false;
+		});
+		return triangles;
+	}
+};
 
 TEST_F(MeshFormatTest, testSubdivide) {
 	MeshFormat::MeshTriCollection tinyTris;
@@ -115,19 +226,66 @@ TEST_F(MeshFormatTest, testAreAllTrisAxisAligned) {
 	EXPECT_FALSE(MeshFormat::isVoxelMesh(tris));
 }
 
-TEST_F(MeshFormatTest, testVoxelizeColor) {
-	class TestMesh : public MeshFormat {
-	public:
-		bool saveMeshes(const core::Map<int, int> &, const scenegraph::SceneGraph &, const Meshes &,
-						const core::String &, const io::ArchivePtr &, const glm::vec3 &, bool, bool, bool) override {
-			return false;
+TEST_F(MeshFormatTest, testExtractMeshSlices) {
+	// deep enough to get extracted in several z slices that are stitched together again
+	const int depth = MeshFormat::ExtractSliceDepth * 2 + 22;
+	voxel::RawVolume volume(voxel::Region(0, 0, 0, 7, 7, depth - 1));
+	for (int z = 0; z < depth; ++z) {
+		for (int y = 0; y < 8; ++y) {
+			for (int x = 0; x < 8; ++x) {
+				if ((x + y * 3 + z * 7) % 5 != 0) {
+					volume.setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, (x + z) % 4 + 1));
+				}
+			}
 		}
-		void voxelize(scenegraph::SceneGraph &sceneGraph, const MeshFormat::MeshTriCollection &tris) {
-			voxelizeNode("test", sceneGraph, tris);
-			sceneGraph.updateTransforms();
+	}
+	palette::Palette pal;
+	pal.nippon();
+	voxel::Region region = volume.region();
+	region.shiftUpperCorner(1, 1, 1);
+
+	// the merged quads can't span several slices - so the single pass extraction is compared without merging
+	const bool mergeQuads = false;
+	voxel::ChunkMesh expected;
+	voxel::SurfaceExtractionContext ctx = voxel::createContext(voxel::SurfaceExtractionType::Cubic, &volume, region,
+															   pal, expected, {0, 0, 0}, mergeQuads, true, true);
+	voxel::extractSurface(ctx);
+
+	voxel::ChunkMesh mesh;
+	MeshFormat::extractMesh(voxel::SurfaceExtractionType::Cubic, &volume, region, pal, mesh, mergeQuads, true, true);
+	voxel::ChunkMesh again;
+	MeshFormat::extractMesh(voxel::SurfaceExtractionType::Cubic, &volume, region, pal, again, mergeQuads, true, true);
+
+	for (int i = 0; i < voxel::ChunkMesh::Meshes; ++i) {
+		// the vertices on the slice planes are shared - like in the single pass extraction
+		ASSERT_EQ(expected.mesh[i].getNoOfVertices(), mesh.mesh[i].getNoOfVertices()) << "mesh " << i;
+		ASSERT_EQ(expected.mesh[i].getNoOfIndices(), mesh.mesh[i].getNoOfIndices()) << "mesh " << i;
+		const core::DynamicArray<Triangle> &expectedTriangles = sortedTriangles(expected.mesh[i]);
+		const core::DynamicArray<Triangle> &triangles = sortedTriangles(mesh.mesh[i]);
+		for (size_t n = 0; n < triangles.size(); ++n) {
+			for (int v = 0; v < 3; ++v) {
+				ASSERT_EQ(expectedTriangles[n].positions[v], triangles[n].positions[v]) << "triangle " << n;
+				ASSERT_EQ(expectedTriangles[n].attributes[v], triangles[n].attributes[v]) << "triangle " << n;
+			}
 		}
-	};
 
+		// the slices are merged in a fixed order - the result doesn't depend on the scheduling of the slices
+		ASSERT_EQ(mesh.mesh[i].getNoOfVertices(), again.mesh[i].getNoOfVertices());
+		ASSERT_EQ(mesh.mesh[i].getIndexVector().size(), again.mesh[i].getIndexVector().size());
+		for (size_t n = 0; n < mesh.mesh[i].getNoOfVertices(); ++n) {
+			const voxel::VoxelVertex &a = mesh.mesh[i].getVertexVector()[n];
+			const voxel::VoxelVertex &b = again.mesh[i].getVertexVector()[n];
+			ASSERT_EQ(a.position, b.position) << "vertex " << n;
+			ASSERT_EQ(a.info, b.info) << "vertex " << n;
+			ASSERT_EQ(a.colorIndex, b.colorIndex) << "vertex " << n;
+			ASSERT_EQ(a.normalIndex, b.normalIndex) << "vertex " << n;
+		}
+		ASSERT_EQ(0, core_memcmp(mesh.mesh[i].getIndexVector().data(), again.mesh[i].getIndexVector().data(),
+								 mesh.mesh[i].getIndexVector().size() * sizeof(voxel::IndexType)));
+	}
+}
+
+TEST_F(MeshFormatTest, testVoxelizeColor) {
 	TestMesh mesh;
 	MeshFormat::MeshTriCollection tris;
 
@@ -172,4 +330,80 @@ TEST_F(MeshFormatTest, testVoxelizeColor) {
 	EXPECT_COLOR_NEAR(nipponGreen, node->palette().color(v->voxel(size - 1, size - 1, size - 1).getColor()), 0.01f);
 }
 
+TEST_F(MeshFormatTest, testVoxelizeTilesFast) {
+	static_assert(QuadSize > 2 * MeshFormat::VoxelizeTileSize, "The quad must span several tiles");
+	util::ScopedVarChange voxelizeMode(cfg::VoxformatVoxelizeMode, (int)MeshFormat::VoxelizeMode::Fast);
+	util::ScopedVarChange fillHollow(cfg::VoxformatFillHollow, "false");
+	util::ScopedVarChange createPalette(cfg::VoxelCreatePalette, "true");
+	TestMesh mesh;
+	scenegraph::SceneGraph sceneGraph;
+	mesh.voxelize(sceneGraph, tiltedQuad());
+	const scenegraph::SceneGraphNode *node = sceneGraph.findNodeByName("test");
+	ASSERT_NE(nullptr, node);
+	EXPECT_EQ(voxel::Region(0, 0, 0, QuadSize, QuadSize + 1, QuadSize + 1), node->region());
+
+	// the voxels that intersect the plane are the ones with z=x and z=x+1 - their centers are projected onto the
+	// plane by -0.25 or +0.25 in x and must be inside of the quad
+	ExpectedVoxels expected;
+	for (int x = 0; x <= QuadSize; ++x) {
+		for (int y = 1; y <= QuadSize; ++y) {
+			for (int dz = 0; dz <= 1; ++dz) {
+				const float projectedX = (float)x + (dz == 0 ? -0.25f : 0.25f);
+				if (projectedX < 0.0f || projectedX > (float)QuadSize) {
+					continue;
+				}
+				const bool lower = projectedX > (float)y - 0.5f;
+				expected.put(glm::ivec3(x, y, x + dz), lower ? _lowerColor : _upperColor);
+			}
+		}
+	}
+	EXPECT_EQ(2 * QuadSize * QuadSize, (int)expected.size());
+	checkVoxels(*node, expected);
+
+	const palette::Palette &palette = node->palette();
+	ASSERT_EQ(2, palette.colorCount());
+	EXPECT_TRUE((palette.color(0) == _lowerColor && palette.color(1) == _upperColor) ||
+				(palette.color(0) == _upperColor && palette.color(1) == _lowerColor));
+}
+
+TEST_F(MeshFormatTest, testVoxelizeTilesSubdivide) {
+	util::ScopedVarChange voxelizeMode(cfg::VoxformatVoxelizeMode, (int)MeshFormat::VoxelizeMode::HighQuality);
+	util::ScopedVarChange fillHollow(cfg::VoxformatFillHollow, "false");
+	util::ScopedVarChange createPalette(cfg::VoxelCreatePalette, "true");
+	const MeshFormat::MeshTriCollection &tris = tiltedQuad();
+	TestMesh mesh;
+	scenegraph::SceneGraph sceneGraph;
+	mesh.voxelize(sceneGraph, tris);
+	const scenegraph::SceneGraphNode *node = sceneGraph.findNodeByName("test");
+	ASSERT_NE(nullptr, node);
+
+	// every subdivided triangle ends up in the voxel of its center - the voxels that get both colors are mixed
+	ExpectedVoxels expected;
+	for (const voxelformat::MeshTri &tri : tris) {
+		MeshFormat::MeshTriCollection tinyTris;
+		MeshFormat::subdivideTri(tri, tinyTris);
+		for (const voxelformat::MeshTri &tinyTri : tinyTris) {
+			const glm::ivec3 pos(tinyTri.center());
+			core::RGBA color;
+			if (expected.get(pos, color) && color != tinyTri.color[0]) {
+				color = core::RGBA(0, 0, 0, 0);
+			} else {
+				color = tinyTri.color[0];
+			}
+			expected.put(pos, color);
+		}
+	}
+	checkVoxels(*node, expected);
+
+	const palette::Palette &palette = node->palette();
+	bool lowerFound = false;
+	bool upperFound = false;
+	for (int i = 0; i < palette.colorCount(); ++i) {
+		lowerFound |= palette.color(i) == _lowerColor;
+		upperFound |= palette.color(i) == _upperColor;
+	}
+	EXPECT_TRUE(lowerFound);
+	EXPECT_TRUE(upperFound);
+}
+
 } // namespace voxelformat
@@ -43,4 +43,9 @@ TEST_F(QBFormatTest, testSaveMultipleModels) {
 	testSaveMultipleModels("qubicle-multiplemodelsavetest.qb", &f);
 }
 
+TEST_F(QBFormatTest, testProbe) {
+	QBFormat f;
+	testProbe("qubicle-probetest.qb", &f);
+}
+
 }
@@ -37,6 +37,11 @@ TEST_F(QBTFormatTest, testSaveMultipleModels) {
 	testSaveMultipleModels("qubicle-multiplemodelsavetest.qbt", &f);
 }
 
+TEST_F(QBTFormatTest, testProbe) {
+	QBTFormat f;
+	testProbe("qubicle-probetest.qbt", &f);
+}
+
 TEST_F(QBTFormatTest, testSave) {
 	QBTFormat f;
 	testConvert("qubicle.qbt", f, "qubicle-savetest.qbt", f);
@@ -4,6 +4,11 @@
 
 #include "voxelformat/private/vengi/VENGIFormat.h"
 #include "AbstractFormatTest.h"
+#include "core/FourCC.h"
+#include "core/ScopedPtr.h"
+#include "core/collection/DynamicArray.h"
+#include "scenegraph/SceneGraph.h"
+#include "voxel/RawVolume.h"
 
 namespace voxelformat {
 
@@ -19,4 +24,120 @@ TEST_F(VENGIFormatTest, testSaveLoadVoxel) {
 	testSaveLoadVoxel("testSaveLoadVoxel.vengi", &f);
 }
 
+TEST_F(VENGIFormatTest, testProbe) {
+	VENGIFormat f;
+	testProbe("testProbe.vengi", &f);
+}
+
+TEST_F(VENGIFormatTest, testProbeOldVersion) {
+	VENGIFormat f;
+	testProbeFile("bat_anim.vengi", helper_filesystemarchive(), &f);
+}
+
+TEST_F(VENGIFormatTest, testLoadOldVersion) {
+	// the versions before 5 compress the whole file after the magic
+	testLoad("bat_anim.vengi", 5);
+	testLoad("testkv6-multiple-slots.vengi", 1);
+}
+
+TEST_F(VENGIFormatTest, testLoadPartial) {
+	scenegraph::SceneGraph sceneGraph;
+	{
+		// spans several bricks
+		voxel::RawVolume *v = new voxel::RawVolume(voxel::Region(0, 0, 0, 99, 9, 9));
+		v->setVoxel(0, 0, 0, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+		v->setVoxel(99, 9, 9, voxel::createVoxel(voxel::VoxelType::Generic, 2));
+		scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+		node.setVolume(v, true);
+		node.setName("first");
+		ASSERT_NE(InvalidNodeId, sceneGraph.emplace(core::move(node)));
+	}
+	{
+		voxel::RawVolume *v = new voxel::RawVolume(voxel::Region(0, 9));
+		v->setVoxel(5, 5, 5, voxel::createVoxel(voxel::VoxelType::Generic, 3));
+		scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+		node.setVolume(v, true);
+		node.setName("second");
+		ASSERT_NE(InvalidNodeId, sceneGraph.emplace(core::move(node)));
+	}
+	VENGIFormat f;
+	const core::String filename = "testLoadPartial.vengi";
+	const io::ArchivePtr &archive = helper_archive();
+	ASSERT_TRUE(f.save(sceneGraph, filename, archive, testSaveCtx));
+
+	{
+		scenegraph::SceneGraph sceneGraphLoad;
+		ASSERT_TRUE(f.load(filename, archive, sceneGraphLoad, testLoadCtx));
+		ASSERT_EQ(2u, sceneGraphLoad.size());
+		const voxel::RawVolume *v = sceneGraphLoad.findNodeByName("first")->volume();
+		EXPECT_EQ(1, v->voxel(0, 0, 0).getColor());
+		EXPECT_EQ(2, v->voxel(99, 9, 9).getColor());
+	}
+	{
+		LoadContext ctx;
+		ctx.nodeNames.push_back("second");
+		scenegraph::SceneGraph sceneGraphLoad;
+		ASSERT_TRUE(f.load(filename, archive, sceneGraphLoad, ctx));
+		ASSERT_EQ(1u, sceneGraphLoad.size());
+		const scenegraph::SceneGraphNode *node = sceneGraphLoad.findNodeByName("second");
+		ASSERT_NE(nullptr, node);
+		EXPECT_EQ(3, node->volume()->voxel(5, 5, 5).getColor());
+	}
+	{
+		LoadContext ctx;
+		ctx.region = voxel::Region(64, 0, 0, 127, 9, 9);
+		scenegraph::SceneGraph sceneGraphLoad;
+		ASSERT_TRUE(f.load(filename, archive, sceneGraphLoad, ctx));
+		ASSERT_EQ(1u, sceneGraphLoad.size()) << "The second node doesn't intersect the region";
+		const scenegraph::SceneGraphNode *node = sceneGraphLoad.findNodeByName("first");
+		ASSERT_NE(nullptr, node);
+		EXPECT_EQ(voxel::Region(64, 0, 0, 99, 9, 9), node->region());
+		EXPECT_EQ(2, node->volume()->voxel(99, 9, 9).getColor());
+	}
+	{
+		// the bricks are not aligned to the occupancy bricks of the cropped volume
+		LoadContext ctx;
+		ctx.nodeNames.push_back("first");
+		ctx.region = voxel::Region(5, 0, 0, 99, 9, 9);
+		scenegraph::SceneGraph sceneGraphLoad;
+		ASSERT_TRUE(f.load(filename, archive, sceneGraphLoad, ctx));
+		const scenegraph::SceneGraphNode *node = sceneGraphLoad.findNodeByName("first");
+		ASSERT_NE(nullptr, node);
+		EXPECT_EQ(voxel::Region(5, 0, 0, 99, 9, 9), node->region());
+		EXPECT_EQ(2, node->volume()->voxel(99, 9, 9).getColor());
+		EXPECT_EQ(1, node->volume()->solidVoxels());
+	}
+}
+
+TEST_F(VENGIFormatTest, testLoadTruncated) {
+	scenegraph::SceneGraph sceneGraph;
+	voxel::RawVolume *v = new voxel::RawVolume(voxel::Region(0, 0, 0, 99, 9, 9));
+	v->setVoxel(99, 9, 9, voxel::createVoxel(voxel::VoxelType::Generic, 2));
+	scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+	node.setVolume(v, true);
+	ASSERT_NE(InvalidNodeId, sceneGraph.emplace(core::move(node)));
+	VENGIFormat f;
+	const io::ArchivePtr &archive = helper_archive();
+	ASSERT_TRUE(f.save(sceneGraph, "testLoadTruncated.vengi", archive, testSaveCtx));
+
+	core::DynamicArray<uint8_t> buffer;
+	{
+		core::ScopedPtr<io::SeekableReadStream> stream(archive->readStream("testLoadTruncated.vengi"));
+		ASSERT_TRUE(stream);
+		buffer.resize(stream->size());
+		ASSERT_EQ((int)buffer.size(), stream->read(buffer.data(), buffer.size()));
+	}
+	// the brick layout is marked behind the magic
+	ASSERT_GT(buffer.size(), 8u);
+	EXPECT_EQ(FourCC('B', 'R', 'C', 'K'), FourCC(buffer[4], buffer[5], buffer[6], buffer[7]));
+	{
+		// cut off the last brick - the index points behind the end of the stream
+		core::ScopedPtr<io::SeekableWriteStream> stream(archive->writeStream("testLoadTruncated2.vengi"));
+		ASSERT_TRUE(stream);
+		ASSERT_EQ((int)buffer.size() - 1, stream->write(buffer.data(), buffer.size() - 1));
+	}
+	scenegraph::SceneGraph sceneGraphLoad;
+	EXPECT_FALSE(f.load("testLoadTruncated2.vengi", archive, sceneGraphLoad, testLoadCtx));
+}
+
 } // namespace voxelformat
@@ -147,6 +147,11 @@ TEST_F(VoxFormatTest, testSaveMultipleModels) {
 						   voxel::ValidateFlags::All & ~voxel::ValidateFlags::Palette);
 }
 
+TEST_F(VoxFormatTest, testProbe) {
+	VoxFormat f;
+	testProbe("mv-probetest.vox", &f);
+}
+
 TEST_F(VoxFormatTest, testSaveBigVolume) {
 	VoxFormat f;
 	const voxel::Region region(glm::ivec3(0), glm::ivec3(1023, 0, 0));
@@ -4,11 +4,15 @@
 
 #include "LUAApi.h"
 #include "app/App.h"
+#include "app/Async.h"
 #include "commonlua/LUA.h"
 #include "commonlua/LUAFunctions.h"
 #include "core/Color.h"
 #include "core/StringUtil.h"
+#include "core/Trace.h"
 #include "core/UTF8.h"
+#include "core/concurrent/Atomic.h"
+#include "core/concurrent/Lock.h"
 #include "image/Image.h"
 #include "io/Stream.h"
 #include "io/StreamArchive.h"
@@ -51,6 +55,54 @@ struct LuaSceneGraphNode {
 	}
 };
 
+/**
+ * @brief A copy of the voxels of a region that the kernels can work on without going through lua for every voxel
+ *
+ * Air is stored as @c -1 and solid voxels as their color index - but the kernels might produce any other value, too.
+ */
+struct LuaVoxelBuffer {
+	voxel::Region region;
+	core::DynamicArray<float> values;
+
+	LuaVoxelBuffer(const voxel::Region &_region, float value) : region(_region) {
+		values.resize(region.voxels());
+		values.fill(value);
+	}
+
+	inline int index(int x, int y, int z) const {
+		const glm::ivec3 &mins = region.getLowerCorner();
+		const glm::ivec3 &dim = region.getDimensionsInVoxels();
+		return ((z - mins.z) * dim.y + (y - mins.y)) * dim.x + (x - mins.x);
+	}
+
+	inline float value(int x, int y, int z, float outside) const {
+		if (!region.containsPoint(x, y, z)) {
+			return outside;
+		}
+		return values[index(x, y, z)];
+	}
+
+	/**
+	 * @brief Executes the functor for every position of the region - the z slices are processed in parallel
+	 * @param func Called with the position and the index into @c values: @code void(int x, int y, int z, int idx) @endcode
+	 */
+	template<class FUNC>
+	void visit(FUNC &&func) const {
+		const glm::ivec3 &mins = region.getLowerCorner();
+		const glm::ivec3 &maxs = region.getUpperCorner();
+		app::for_parallel(mins.z, maxs.z + 1, [&](int start, int end) {
+			for (int z = start; z < end; ++z) {
+				for (int y = mins.y; y <= maxs.y; ++y) {
+					int idx = index(mins.x, y, z);
+					for (int x = mins.x; x <= maxs.x; ++x, ++idx) {
+						func(x, y, z, idx);
+					}
+				}
+			}
+		});
+	}
+};
+
 struct LuaKeyFrame {
 	scenegraph::SceneGraphNode *node;
 	scenegraph::KeyFrameIndex keyFrameIdx;
@@ -105,6 +157,10 @@ static const char *luaVoxel_globaldirtyregion() {
 	return "__global_region";
 }
 
+static const char *luaVoxel_globalparallel() {
+	return "__global_parallel";
+}
+
 static const char *luaVoxel_metascenegraphnode() {
 	return "__meta_scenegraphnode";
 }
@@ -129,6 +185,14 @@ static const char *luaVoxel_metavolumewrapper() {
 	return "__meta_volumewrapper";
 }
 
+static const char *luaVoxel_metavoxelbuffer() {
+	return "__meta_voxelbuffer";
+}
+
+static const char *luaVoxel_metavoxelbufferglobal() {
+	return "__meta_voxelbuffer_global";
+}
+
 static const char *luaVoxel_metapaletteglobal() {
 	return "__meta_palette_global";
 }
@@ -187,6 +251,21 @@ static glm::vec<N, T> luaVoxel_getvec(lua_State *s, int idx) {
 	return val;
 }
 
+/**
+ * @brief The lua states of a script that is executed in parallel share the scene graph, the palettes and the volume
+ * - only the voxels of the own brick may be modified
+ */
+static bool luaVoxel_isparallel(lua_State *s) {
+	lua_getglobal(s, luaVoxel_globalparallel());
+	const bool parallel = lua_toboolean(s, -1);
+	lua_pop(s, 1);
+	return parallel;
+}
+
+static int luaVoxel_parallelerror(lua_State *s, const char *func) {
+	return clua_error(s, "%s() is not allowed in a script that is executed in parallel", func);
+}
+
 static scenegraph::SceneGraph *luaVoxel_scenegraph(lua_State *s) {
 	return luaVoxel_globalData<scenegraph::SceneGraph>(s, luaVoxel_globalscenegraph());
 }
@@ -282,6 +361,9 @@ static int luaVoxel_volumewrapper_region(lua_State* s) {
 }
 
 static int luaVoxel_volumewrapper_translate(lua_State* s) {
+	if (luaVoxel_isparallel(s)) {
+		return luaVoxel_parallelerror(s, "translate");
+	}
 	LuaRawVolumeWrapper* volume = luaVoxel_tovolumewrapper(s, 1);
 	const int x = (int)luaL_checkinteger(s, 2);
 	const int y = (int)luaL_optinteger(s, 3, 0);
@@ -291,6 +373,9 @@ static int luaVoxel_volumewrapper_translate(lua_State* s) {
 }
 
 static int luaVoxel_volumewrapper_move(lua_State* s) {
+	if (luaVoxel_isparallel(s)) {
+		return luaVoxel_parallelerror(s, "move");
+	}
 	LuaRawVolumeWrapper* volume = luaVoxel_tovolumewrapper(s, 1);
 	const int x = (int)luaL_checkinteger(s, 2);
 	const int y = (int)luaL_optinteger(s, 3, 0);
@@ -305,6 +390,9 @@ static int luaVoxel_volumewrapper_move(lua_State* s) {
 }
 
 static int luaVoxel_volumewrapper_resize(lua_State *s) {
+	if (luaVoxel_isparallel(s)) {
+		return luaVoxel_parallelerror(s, "resize");
+	}
 	LuaRawVolumeWrapper *volume = luaVoxel_tovolumewrapper(s, 1);
 	const int w = (int)luaL_checkinteger(s, 2);
 	const int h = (int)luaL_optinteger(s, 3, 0);
@@ -333,6 +421,9 @@ static math::Axis luaVoxel_getAxis(lua_State *s, int index) {
 }
 
 static int luaVoxel_volumewrapper_mirroraxis(lua_State *s) {
+	if (luaVoxel_isparallel(s)) {
+		return luaVoxel_parallelerror(s, "mirrorAxis");
+	}
 	LuaRawVolumeWrapper *volume = luaVoxel_tovolumewrapper(s, 1);
 	voxel::RawVolume* v = voxelutil::mirrorAxis(volume->volume(), luaVoxel_getAxis(s, 2));
 	if (v != nullptr) {
@@ -343,6 +434,9 @@ static int luaVoxel_volumewrapper_mirroraxis(lua_State *s) {
 }
 
 static int luaVoxel_volumewrapper_rotateaxis(lua_State *s) {
+	if (luaVoxel_isparallel(s)) {
+		return luaVoxel_parallelerror(s, "rotateAxis");
+	}
 	LuaRawVolumeWrapper *volume = luaVoxel_tovolumewrapper(s, 1);
 	voxel::RawVolume* v = voxelutil::rotateAxis(volume->volume(), luaVoxel_getAxis(s, 2));
 	if (v != nullptr) {
@@ -416,6 +510,9 @@ static int luaVoxel_volumewrapper_importcoloredheightmap(lua_State *s) {
 }
 
 static int luaVoxel_volumewrapper_crop(lua_State *s) {
+	if (luaVoxel_isparallel(s)) {
+		return luaVoxel_parallelerror(s, "crop");
+	}
 	LuaRawVolumeWrapper *volume = luaVoxel_tovolumewrapper(s, 1);
 	voxel::RawVolume* v = voxelutil::cropVolume(volume->volume());
 	if (v != nullptr) {
@@ -465,17 +562,218 @@ static int luaVoxel_volumewrapper_setvoxel(lua_State* s) {
 static int luaVoxel_volumewrapper_gc(lua_State *s) {
 	LuaRawVolumeWrapper* volume = luaVoxel_tovolumewrapper(s, 1);
 	if (volume->dirtyRegion().isValid()) {
-		voxel::Region* dirtyRegion = luaVoxel_globalData<voxel::Region>(s, luaVoxel_globaldirtyregion());
-		if (dirtyRegion->isValid()) {
-			dirtyRegion->accumulate(volume->dirtyRegion());
-		} else {
-			*dirtyRegion = volume->dirtyRegion();
-		}
+		voxel::DirtyRegions* dirtyRegions = luaVoxel_globalData<voxel::DirtyRegions>(s, luaVoxel_globaldirtyregion());
+		dirtyRegions->add(volume->dirtyRegions());
 	}
 	delete volume;
 	return 0;
 }
 
+static LuaVoxelBuffer* luaVoxel_tovoxelbuffer(lua_State* s, int n) {
+	return *(LuaVoxelBuffer**)clua_getudata<LuaVoxelBuffer*>(s, n, luaVoxel_metavoxelbuffer());
+}
+
+static int luaVoxel_pushvoxelbuffer(lua_State* s, LuaVoxelBuffer* buffer) {
+	return clua_pushudata(s, buffer, luaVoxel_metavoxelbuffer());
+}
+
+static int luaVoxel_volumewrapper_readbuffer(lua_State* s) {
+	const LuaRawVolumeWrapper* volume = luaVoxel_tovolumewrapper(s, 1);
+	const voxel::Region region = lua_gettop(s) >= 2 ? *luaVoxel_toregion(s, 2) : volume->region();
+	if (!region.isValid()) {
+		return clua_error(s, "Invalid region given");
+	}
+	LuaVoxelBuffer *buffer = new LuaVoxelBuffer(region, -1.0f);
+	const voxel::RawVolume *v = volume->volume();
+	buffer->visit([&](int x, int y, int z, int idx) {
+		const voxel::Voxel &voxel = v->voxel(x, y, z);
+		if (!voxel::isAir(voxel.getMaterial())) {
+			buffer->values[idx] = (float)voxel.getColor();
+		}
+	});
+	return luaVoxel_pushvoxelbuffer(s, buffer);
+}
+
+static int luaVoxel_volumewrapper_writebuffer(lua_State* s) {
+	LuaRawVolumeWrapper* volume = luaVoxel_tovolumewrapper(s, 1);
+	const LuaVoxelBuffer* buffer = luaVoxel_tovoxelbuffer(s, 2);
+	const bool skipAir = clua_optboolean(s, 3, false);
+	const voxel::Voxel air = voxel::createVoxel(voxel::VoxelType::Air, 0);
+	const glm::ivec3 &mins = buffer->region.getLowerCorner();
+	const glm::ivec3 &maxs = buffer->region.getUpperCorner();
+	// this is not done in parallel - the wrapper keeps track of the dirty region
+	int idx = 0;
+	for (int z = mins.z; z <= maxs.z; ++z) {
+		for (int y = mins.y; y <= maxs.y; ++y) {
+			for (int x = mins.x; x <= maxs.x; ++x, ++idx) {
+				const float value = buffer->values[idx];
+				if (value < 0.0f) {
+					if (!skipAir) {
+						volume->setVoxel(x, y, z, air);
+					}
+					continue;
+				}
+				const int color = glm::clamp((int)glm::round(value), 0, 255);
+				volume->setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, color));
+			}
+		}
+	}
+	return 0;
+}
+
+static int luaVoxel_voxelbuffer_new(lua_State* s) {
+	const voxel::Region* region = luaVoxel_toregion(s, 1);
+	if (!region->isValid()) {
+		return clua_error(s, "Invalid region given");
+	}
+	const float value = (float)luaL_optnumber(s, 2, -1.0);
+	return luaVoxel_pushvoxelbuffer(s, new LuaVoxelBuffer(*region, value));
+}
+
+static int luaVoxel_voxelbuffer_get(lua_State* s) {
+	const LuaVoxelBuffer* buffer = luaVoxel_tovoxelbuffer(s, 1);
+	const int x = (int)luaL_checkinteger(s, 2);
+	const int y = (int)luaL_checkinteger(s, 3);
+	const int z = (int)luaL_checkinteger(s, 4);
+	lua_pushnumber(s, buffer->value(x, y, z, -1.0f));
+	return 1;
+}
+
+static int luaVoxel_voxelbuffer_set(lua_State* s) {
+	LuaVoxelBuffer* buffer = luaVoxel_tovoxelbuffer(s, 1);
+	const int x = (int)luaL_checkinteger(s, 2);
+	const int y = (int)luaL_checkinteger(s, 3);
+	const int z = (int)luaL_checkinteger(s, 4);
+	const float value = (float)luaL_checknumber(s, 5);
+	const bool insideRegion = buffer->region.containsPoint(x, y, z);
+	if (insideRegion) {
+		buffer->values[buffer->index(x, y, z)] = value;
+	}
+	lua_pushboolean(s, insideRegion ? 1 : 0);
+	return 1;
+}
+
+static int luaVoxel_voxelbuffer_region(lua_State* s) {
+	const LuaVoxelBuffer* buffer = luaVoxel_tovoxelbuffer(s, 1);
+	return luaVoxel_pushregion(s, buffer->region);
+}
+
+static int luaVoxel_voxelbuffer_fill(lua_State* s) {
+	LuaVoxelBuffer* buffer = luaVoxel_tovoxelbuffer(s, 1);
+	const float value = (float)luaL_checknumber(s, 2);
+	buffer->values.fill(value);
+	return 0;
+}
+
+static int luaVoxel_voxelbuffer_mask(lua_State* s) {
+	const LuaVoxelBuffer* buffer = luaVoxel_tovoxelbuffer(s, 1);
+	LuaVoxelBuffer *result = new LuaVoxelBuffer(buffer->region, 0.0f);
+	buffer->visit([&](int, int, int, int idx) {
+		result->values[idx] = buffer->values[idx] >= 0.0f ? 1.0f : 0.0f;
+	});
+	return luaVoxel_pushvoxelbuffer(s, result);
+}
+
+static int luaVoxel_voxelbuffer_countneighbors(lua_State* s) {
+	const LuaVoxelBuffer* buffer = luaVoxel_tovoxelbuffer(s, 1);
+	const int radius = (int)luaL_optinteger(s, 2, 1);
+	if (radius < 1) {
+		return clua_error(s, "Radius must be at least 1");
+	}
+	LuaVoxelBuffer *result = new LuaVoxelBuffer(buffer->region, 0.0f);
+	buffer->visit([&](int x, int y, int z, int idx) {
+		int count = 0;
+		for (int nz = z - radius; nz <= z + radius; ++nz) {
+			for (int ny = y - radius; ny <= y + radius; ++ny) {
+				for (int nx = x - radius; nx <= x + radius; ++nx) {
+					if (buffer->value(nx, ny, nz, -1.0f) >= 0.0f) {
+						++count;
+					}
+				}
+			}
+		}
+		if (buffer->values[idx] >= 0.0f) {
+			--count;
+		}
+		result->values[idx] = (float)count;
+	});
+	return luaVoxel_pushvoxelbuffer(s, result);
+}
+
+static int luaVoxel_voxelbuffer_convolve(lua_State* s) {
+	const LuaVoxelBuffer* buffer = luaVoxel_tovoxelbuffer(s, 1);
+	luaL_checktype(s, 2, LUA_TTABLE);
+	const float divisor = (float)luaL_optnumber(s, 3, 1.0);
+	if (divisor == 0.0f) {
+		return clua_error(s, "Divisor must not be 0");
+	}
+	const int n = (int)lua_rawlen(s, 2);
+	int size = 1;
+	while (size * size * size < n) {
+		size += 2;
+	}
+	if (size * size * size != n) {
+		return clua_error(s, "Kernel must have size^3 entries with an odd size - got %i entries", n);
+	}
+	core::DynamicArray<float> kernel;
+	kernel.resize(n);
+	for (int i = 0; i < n; ++i) {
+		lua_rawgeti(s, 2, i + 1);
+		kernel[i] = (float)luaL_checknumber(s, -1);
+		lua_pop(s, 1);
+	}
+	const int half = size / 2;
+	LuaVoxelBuffer *result = new LuaVoxelBuffer(buffer->region, 0.0f);
+	buffer->visit([&](int x, int y, int z, int idx) {
+		float sum = 0.0f;
+		int k = 0;
+		for (int nz = z - half; nz <= z + half; ++nz) {
+			for (int ny = y - half; ny <= y + half; ++ny) {
+				for (int nx = x - half; nx <= x + half; ++nx, ++k) {
+					sum += kernel[k] * buffer->value(nx, ny, nz, 0.0f);
+				}
+			}
+		}
+		result->values[idx] = sum / divisor;
+	});
+	return luaVoxel_pushvoxelbuffer(s, result);
+}
+
+static int luaVoxel_voxelbuffer_threshold(lua_State* s) {
+	const LuaVoxelBuffer* buffer = luaVoxel_tovoxelbuffer(s, 1);
+	const float threshold = (float)luaL_checknumber(s, 2);
+	const float above = (float)luaL_optnumber(s, 3, 1.0);
+	const float below = (float)luaL_optnumber(s, 4, -1.0);
+	LuaVoxelBuffer *result = new LuaVoxelBuffer(buffer->region, below);
+	buffer->visit([&](int, int, int, int idx) {
+		if (buffer->values[idx] >= threshold) {
+			result->values[idx] = above;
+		}
+	});
+	return luaVoxel_pushvoxelbuffer(s, result);
+}
+
+static int luaVoxel_voxelbuffer_noise(lua_State* s) {
+	LuaVoxelBuffer* buffer = luaVoxel_tovoxelbuffer(s, 1);
+	const float frequency = (float)luaL_optnumber(s, 2, 0.01);
+	const uint8_t octaves = (uint8_t)luaL_optinteger(s, 3, 4);
+	const float lacunarity = (float)luaL_optnumber(s, 4, 2.0);
+	const float gain = (float)luaL_optnumber(s, 5, 0.5);
+	const glm::vec3 offset((float)luaL_optnumber(s, 6, 0.0), (float)luaL_optnumber(s, 7, 0.0),
+						   (float)luaL_optnumber(s, 8, 0.0));
+	buffer->visit([&](int x, int y, int z, int idx) {
+		const glm::vec3 pos = glm::vec3((float)x, (float)y, (float)z) * frequency + offset;
+		buffer->values[idx] = noise::fBm(pos, octaves, lacunarity, gain);
+	});
+	return 0;
+}
+
+static int luaVoxel_voxelbuffer_gc(lua_State* s) {
+	LuaVoxelBuffer* buffer = luaVoxel_tovoxelbuffer(s, 1);
+	delete buffer;
+	return 0;
+}
+
 static int luaVoxel_shape_cylinder(lua_State* s) {
 	LuaRawVolumeWrapper *volume = luaVoxel_tovolumewrapper(s, 1);
 	const glm::vec3& centerBottom = clua_tovec<glm::vec3>(s, 2);
@@ -618,6 +916,9 @@ static int luaVoxel_import_imageasplane(lua_State *s) {
 }
 
 static int luaVoxel_import_scene(lua_State *s) {
+	if (luaVoxel_isparallel(s)) {
+		return luaVoxel_parallelerror(s, "scene");
+	}
 	const char *filename = luaL_checkstring(s, 1);
 	io::SeekableReadStream *readStream = clua_tostream(s, 2);
 	io::FileDescription fileDesc;
@@ -667,6 +968,9 @@ static int luaVoxel_palette_colors(lua_State* s) {
 }
 
 static int luaVoxel_palette_load(lua_State* s) {
+	if (luaVoxel_isparallel(s) && luaL_testudata(s, 1, luaVoxel_metapalette()) != nullptr) {
+		return luaVoxel_parallelerror(s, "load");
+	}
 	palette::Palette *palette = luaVoxel_toPalette(s, 1);
 	const char *filename = luaL_checkstring(s, 2);
 	if (!palette->load(filename)) {
@@ -711,6 +1015,9 @@ static int luaVoxel_palette_color(lua_State* s) {
 }
 
 static int luaVoxel_palette_setcolor(lua_State* s) {
+	if (luaVoxel_isparallel(s) && luaL_testudata(s, 1, luaVoxel_metapalette()) != nullptr) {
+		return luaVoxel_parallelerror(s, "setColor");
+	}
 	palette::Palette *palette = luaVoxel_toPalette(s, 1);
 	const uint8_t color = luaL_checkinteger(s, 2);
 	const uint8_t r = luaL_checkinteger(s, 3);
@@ -722,6 +1029,9 @@ static int luaVoxel_palette_setcolor(lua_State* s) {
 }
 
 static int luaVoxel_palette_setmaterialproperty(lua_State* s) {
+	if (luaVoxel_isparallel(s) && luaL_testudata(s, 1, luaVoxel_metapalette()) != nullptr) {
+		return luaVoxel_parallelerror(s, "setMaterial");
+	}
 	palette::Palette *palette = luaVoxel_toPalette(s, 1);
 	const uint8_t idx = luaL_checkinteger(s, 2);
 	const char *name = luaL_checkstring(s, 3);
@@ -1063,6 +1373,9 @@ static int luaVoxel_region_gc(lua_State *s) {
 }
 
 static int luaVoxel_scenegraph_updatetransforms(lua_State* s) {
+	if (luaVoxel_isparallel(s)) {
+		return luaVoxel_parallelerror(s, "updateTransforms");
+	}
 	scenegraph::SceneGraph *sceneGraph = luaVoxel_scenegraph(s);
 	sceneGraph->updateTransforms();
 	return 0;
@@ -1086,6 +1399,9 @@ static int luaVoxel_scenegraph_get_all_node_ids(lua_State *s) {
 }
 
 static int luaVoxel_scenegraph_align(lua_State* s) {
+	if (luaVoxel_isparallel(s)) {
+		return luaVoxel_parallelerror(s, "align");
+	}
 	scenegraph::SceneGraph *sceneGraph = luaVoxel_scenegraph(s);
 	int padding = (int)luaL_optinteger(s, 1, 2);
 	sceneGraph->align(padding);
@@ -1102,6 +1418,9 @@ static scenegraph::SceneGraphNodeType toNodeType(const char *type) {
 }
 
 static int luaVoxel_scenegraph_new_node(lua_State* s) {
+	if (luaVoxel_isparallel(s)) {
+		return luaVoxel_parallelerror(s, "new");
+	}
 	const char *name = lua_tostring(s, 1);
 	voxel::RawVolume *v = nullptr;
 	bool visible = true;
@@ -1184,6 +1503,9 @@ static int luaVoxel_scenegraph_get_node_by_id(lua_State* s) {
 }
 
 static int luaVoxel_scenegraph_addanimation(lua_State* s) {
+	if (luaVoxel_isparallel(s)) {
+		return luaVoxel_parallelerror(s, "addAnimation");
+	}
 	scenegraph::SceneGraph* sceneGraph = luaVoxel_scenegraph(s);
 	const char *name = luaL_checkstring(s, 1);
 	lua_pushboolean(s, sceneGraph->addAnimation(name));
@@ -1198,6 +1520,9 @@ static int luaVoxel_scenegraph_hasanimation(lua_State* s) {
 }
 
 static int luaVoxel_scenegraph_setanimation(lua_State* s) {
+	if (luaVoxel_isparallel(s)) {
+		return luaVoxel_parallelerror(s, "setAnimation");
+	}
 	scenegraph::SceneGraph* sceneGraph = luaVoxel_scenegraph(s);
 	const char *name = luaL_checkstring(s, 1);
 	lua_pushboolean(s, sceneGraph->setAnimation(name));
@@ -1211,6 +1536,9 @@ static int luaVoxel_scenegraph_activeanimation(lua_State* s) {
 }
 
 static int luaVoxel_scenegraph_duplicateanimation(lua_State* s) {
+	if (luaVoxel_isparallel(s)) {
+		return luaVoxel_parallelerror(s, "duplicateAnimation");
+	}
 	scenegraph::SceneGraph* sceneGraph = luaVoxel_scenegraph(s);
 	const char *animation = luaL_checkstring(s, 1);
 	const char *newName = luaL_checkstring(s, 2);
@@ -1275,6 +1603,9 @@ static int luaVoxel_scenegraphnode_id(lua_State* s) {
 }
 
 static int luaVoxel_scenegraphnode_clone(lua_State* s) {
+	if (luaVoxel_isparallel(s)) {
+		return luaVoxel_parallelerror(s, "clone");
+	}
 	LuaSceneGraphNode* node = luaVoxel_toscenegraphnode(s, 1);
 	scenegraph::SceneGraph* sceneGraph = luaVoxel_scenegraph(s);
 	const int nodeId = scenegraph::copyNodeToSceneGraph(*sceneGraph, *node->node, node->node->parent(), false);
@@ -1297,6 +1628,9 @@ static int luaVoxel_scenegraphnode_parent(lua_State* s) {
 }
 
 static int luaVoxel_scenegraphnode_setname(lua_State* s) {
+	if (luaVoxel_isparallel(s)) {
+		return luaVoxel_parallelerror(s, "setName");
+	}
 	LuaSceneGraphNode* node = luaVoxel_toscenegraphnode(s, 1);
 	const char *newName = lua_tostring(s, 2);
 	node->node->setName(newName);
@@ -1333,6 +1667,9 @@ static int luaVoxel_scenegraphnode_hasframe(lua_State* s) {
 }
 
 static int luaVoxel_scenegraphnode_removekeyframeforframe(lua_State* s) {
+	if (luaVoxel_isparallel(s)) {
+		return luaVoxel_parallelerror(s, "removeKeyFrameForFrame");
+	}
 	LuaSceneGraphNode* node = luaVoxel_toscenegraphnode(s, 1);
 	scenegraph::FrameIndex frame = (scenegraph::FrameIndex)luaL_checkinteger(s, 2);
 	scenegraph::KeyFrameIndex existingIndex = InvalidKeyFrame;
@@ -1348,6 +1685,9 @@ static int luaVoxel_scenegraphnode_removekeyframeforframe(lua_State* s) {
 }
 
 static int luaVoxel_scenegraphnode_removekeyframe(lua_State* s) {
+	if (luaVoxel_isparallel(s)) {
+		return luaVoxel_parallelerror(s, "removeKeyFrame");
+	}
 	LuaSceneGraphNode* node = luaVoxel_toscenegraphnode(s, 1);
 	scenegraph::KeyFrameIndex keyFrameIdx = (scenegraph::KeyFrameIndex)luaL_checkinteger(s, 2);
 	if (!node->node->removeKeyFrame(keyFrameIdx)) {
@@ -1359,6 +1699,9 @@ static int luaVoxel_scenegraphnode_removekeyframe(lua_State* s) {
 }
 
 static int luaVoxel_scenegraphnode_addframe(lua_State* s) {
+	if (luaVoxel_isparallel(s)) {
+		return luaVoxel_parallelerror(s, "addKeyFrame");
+	}
 	LuaSceneGraphNode* node = luaVoxel_toscenegraphnode(s, 1);
 	const int frameIdx = (int)luaL_checkinteger(s, 2);
 	scenegraph::InterpolationType interpolation = (scenegraph::InterpolationType)luaL_optinteger(s, 3, (int)scenegraph::InterpolationType::Linear);
@@ -1411,6 +1754,9 @@ static int luaVoxel_keyframe_interpolation(lua_State *s) {
 }
 
 static int luaVoxel_keyframe_setinterpolation(lua_State *s) {
+	if (luaVoxel_isparallel(s)) {
+		return luaVoxel_parallelerror(s, "setInterpolation");
+	}
 	LuaKeyFrame *keyFrame = luaVoxel_tokeyframe(s, 1);
 	const scenegraph::InterpolationType interpolation = toInterpolationType(luaL_checkstring(s, 2));
 	if (interpolation == scenegraph::InterpolationType::Max) {
@@ -1429,6 +1775,9 @@ static int luaVoxel_keyframe_localscale(lua_State *s) {
 }
 
 static int luaVoxel_keyframe_setlocalscale(lua_State *s) {
+	if (luaVoxel_isparallel(s)) {
+		return luaVoxel_parallelerror(s, "setLocalScale");
+	}
 	LuaKeyFrame *keyFrame = luaVoxel_tokeyframe(s, 1);
 	const glm::vec3 &val = luaVoxel_getvec<3, float>(s, 2);
 	scenegraph::SceneGraphKeyFrame &kf = keyFrame->keyFrame();
@@ -1444,6 +1793,9 @@ static int luaVoxel_keyframe_localorientation(lua_State *s) {
 }
 
 static int luaVoxel_keyframe_setlocalorientation(lua_State *s) {
+	if (luaVoxel_isparallel(s)) {
+		return luaVoxel_parallelerror(s, "setLocalOrientation");
+	}
 	LuaKeyFrame *keyFrame = luaVoxel_tokeyframe(s, 1);
 	glm::quat val;
 	if (clua_isquat(s, 2)) {
@@ -1468,6 +1820,9 @@ static int luaVoxel_keyframe_localtranslation(lua_State *s) {
 }
 
 static int luaVoxel_keyframe_setlocaltranslation(lua_State *s) {
+	if (luaVoxel_isparallel(s)) {
+		return luaVoxel_parallelerror(s, "setLocalTranslation");
+	}
 	LuaKeyFrame *keyFrame = luaVoxel_tokeyframe(s, 1);
 	const glm::vec3 &val = luaVoxel_getvec<3, float>(s, 2);
 	scenegraph::SceneGraphKeyFrame &kf = keyFrame->keyFrame();
@@ -1483,6 +1838,9 @@ static int luaVoxel_keyframe_worldscale(lua_State *s) {
 }
 
 static int luaVoxel_keyframe_setworldscale(lua_State *s) {
+	if (luaVoxel_isparallel(s)) {
+		return luaVoxel_parallelerror(s, "setWorldScale");
+	}
 	LuaKeyFrame *keyFrame = luaVoxel_tokeyframe(s, 1);
 	const glm::vec3 &val = luaVoxel_getvec<3, float>(s, 2);
 	scenegraph::SceneGraphKeyFrame &kf = keyFrame->keyFrame();
@@ -1498,6 +1856,9 @@ static int luaVoxel_keyframe_worldorientation(lua_State *s) {
 }
 
 static int luaVoxel_keyframe_setworldorientation(lua_State *s) {
+	if (luaVoxel_isparallel(s)) {
+		return luaVoxel_parallelerror(s, "setWorldOrientation");
+	}
 	LuaKeyFrame *keyFrame = luaVoxel_tokeyframe(s, 1);
 	glm::quat val;
 	if (clua_isquat(s, 2)) {
@@ -1522,6 +1883,9 @@ static int luaVoxel_keyframe_worldtranslation(lua_State *s) {
 }
 
 static int luaVoxel_keyframe_setworldtranslation(lua_State *s) {
+	if (luaVoxel_isparallel(s)) {
+		return luaVoxel_parallelerror(s, "setWorldTranslation");
+	}
 	LuaKeyFrame *keyFrame = luaVoxel_tokeyframe(s, 1);
 	const glm::vec3 &val = luaVoxel_getvec<3, float>(s, 2);
 	scenegraph::SceneGraphKeyFrame &kf = keyFrame->keyFrame();
@@ -1558,6 +1922,9 @@ static int luaVoxel_keyframe_tostring(lua_State *s) {
 }
 
 static int luaVoxel_scenegraphnode_setpalette(lua_State* s) {
+	if (luaVoxel_isparallel(s)) {
+		return luaVoxel_parallelerror(s, "setPalette");
+	}
 	LuaSceneGraphNode* node = luaVoxel_toscenegraphnode(s, 1);
 	palette::Palette *palette = luaVoxel_toPalette(s, 2);
 	if (clua_optboolean(s, 3, false)) {
@@ -1568,6 +1935,9 @@ static int luaVoxel_scenegraphnode_setpalette(lua_State* s) {
 }
 
 static int luaVoxel_scenegraphnode_setpivot(lua_State* s) {
+	if (luaVoxel_isparallel(s)) {
+		return luaVoxel_parallelerror(s, "setPivot");
+	}
 	LuaSceneGraphNode* node = luaVoxel_toscenegraphnode(s, 1);
 	const glm::vec3 &val = luaVoxel_getvec<3, float>(s, 2);
 	node->node->setPivot(val);
@@ -1603,11 +1973,34 @@ static void prepareState(lua_State* s) {
 		{"mirrorAxis", luaVoxel_volumewrapper_mirroraxis},
 		{"rotateAxis", luaVoxel_volumewrapper_rotateaxis},
 		{"setVoxel", luaVoxel_volumewrapper_setvoxel},
+		{"readBuffer", luaVoxel_volumewrapper_readbuffer},
+		{"writeBuffer", luaVoxel_volumewrapper_writebuffer},
 		{"__gc", luaVoxel_volumewrapper_gc},
 		{nullptr, nullptr}
 	};
 	clua_registerfuncs(s, volumeFuncs, luaVoxel_metavolumewrapper());
 
+	static const luaL_Reg voxelBufferFuncs[] = {
+		{"get", luaVoxel_voxelbuffer_get},
+		{"set", luaVoxel_voxelbuffer_set},
+		{"region", luaVoxel_voxelbuffer_region},
+		{"fill", luaVoxel_voxelbuffer_fill},
+		{"mask", luaVoxel_voxelbuffer_mask},
+		{"countNeighbors", luaVoxel_voxelbuffer_countneighbors},
+		{"convolve", luaVoxel_voxelbuffer_convolve},
+		{"threshold", luaVoxel_voxelbuffer_threshold},
+		{"noise", luaVoxel_voxelbuffer_noise},
+		{"__gc", luaVoxel_voxelbuffer_gc},
+		{nullptr, nullptr}
+	};
+	clua_registerfuncs(s, voxelBufferFuncs, luaVoxel_metavoxelbuffer());
+
+	static const luaL_Reg globalVoxelBufferFuncs[] = {
+		{"new", luaVoxel_voxelbuffer_new},
+		{nullptr, nullptr}
+	};
+	clua_registerfuncsglobal(s, globalVoxelBufferFuncs, luaVoxel_metavoxelbufferglobal(), "g_buffer");
+
 	static const luaL_Reg regionFuncs[] = {
 		{"width", luaVoxel_region_width},
 		{"height", luaVoxel_region_height},
@@ -1811,12 +2204,18 @@ bool LUAApi::init() {
 		Log::warn("Failed to initialize noise");
 	}
 	luaVoxel_newGlobalData(_lua, luaVoxel_globalnoise(), &_noise);
-	luaVoxel_newGlobalData(_lua, luaVoxel_globaldirtyregion(), &_dirtyRegion);
+	luaVoxel_newGlobalData(_lua, luaVoxel_globaldirtyregion(), &_dirtyRegions);
 	prepareState(_lua);
 	return true;
 }
 
 ScriptState LUAApi::update(double nowSeconds) {
+	if (_scriptStillRunning && _parallel.brickSize > 0) {
+		const bool success = execParallel();
+		_parallel = ParallelExecution();
+		_scriptStillRunning = false;
+		return success ? ScriptState::Finished : ScriptState::Error;
+	}
 	if (_scriptStillRunning) {
 		int nres = 0;
 		const int error = lua_resume(_lua, nullptr, _nargs, &nres);
@@ -2004,6 +2403,88 @@ static bool luaVoxel_pushargs(lua_State* s, const core::DynamicArray<core::Strin
 	return true;
 }
 
+/**
+ * @brief Pushes the @c main() function of the script and its parameters onto the stack
+ */
+static bool luaVoxel_pushmain(lua_State *s, scenegraph::SceneGraphNode &node, const voxel::Region &region, int color,
+							  const core::DynamicArray<core::String> &args,
+							  const core::DynamicArray<LUAParameterDescription> &argsInfo) {
+	// get main(node, region, color) method
+	lua_getglobal(s, "main");
+	if (!lua_isfunction(s, -1)) {
+		Log::error("LUA generator: no main(node, region, color) function found in script");
+		return false;
+	}
+
+	// first parameter is scene node
+	if (luaVoxel_pushscenegraphnode(s, node) == 0) {
+		Log::error("Failed to push scene graph node");
+		return false;
+	}
+
+	// second parameter is the region to operate on
+	if (luaVoxel_pushregion(s, region) == 0) {
+		Log::error("Failed to push region");
+		return false;
+	}
+
+	// third parameter is the current color
+	lua_pushinteger(s, color);
+
+#if GENERATOR_LUA_SANTITY > 0
+	if (!lua_isfunction(s, -4)) {
+		Log::error("LUA generate: expected to find the main function");
+		return false;
+	}
+	if (luaL_testudata(s, -3, luaVoxel_metascenegraphnode()) == nullptr) {
+		Log::error("LUA generate: expected to find scene graph node");
+		return false;
+	}
+	if (!luaVoxel_isregion(s, -2)) {
+		Log::error("LUA generate: expected to find region");
+		return false;
+	}
+	if (!lua_isnumber(s, -1)) {
+		Log::error("LUA generate: expected to find color");
+		return false;
+	}
+#endif
+
+	if (!luaVoxel_pushargs(s, args, argsInfo)) {
+		Log::error("Failed to execute main() function with the given number of arguments. Try calling with 'help' as parameter");
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Scripts can declare that their @c main() function can be executed in parallel for parts of the region by
+ * providing a @c parallel() function. It returns @c true or the brick size for the width and depth of the parts.
+ * @return The brick size or @c 0 if the script doesn't support parallel execution
+ */
+static int luaVoxel_parallelbricksize(lua_State *s) {
+	const int defaultBrickSize = 64;
+	lua_getglobal(s, "parallel");
+	if (!lua_isfunction(s, -1)) {
+		lua_pop(s, 1);
+		return 0;
+	}
+	if (lua_pcall(s, 0, 1, 0) != LUA_OK) {
+		Log::error("LUA generator: failed to call parallel(): %s", lua_tostring(s, -1));
+		lua_pop(s, 1);
+		return 0;
+	}
+	int brickSize = 0;
+	if (lua_isboolean(s, -1)) {
+		brickSize = lua_toboolean(s, -1) ? defaultBrickSize : 0;
+	} else if (lua_isinteger(s, -1)) {
+		brickSize = core_max(0, (int)lua_tointeger(s, -1));
+	}
+	lua_pop(s, 1);
+	return brickSize;
+}
+
 core::String LUAApi::load(const core::String& scriptName) const {
 	core::String filename = scriptName;
 	io::normalizePath(filename);
@@ -2045,6 +2526,85 @@ core::DynamicArray<LUAScript> LUAApi::listScripts() const {
 	return scripts;
 }
 
+bool LUAApi::execParallel() {
+	core_trace_scoped(LUAApiExecParallel);
+	scenegraph::SceneGraphNode &node = _parallel.sceneGraph->node(_parallel.nodeId);
+	const voxel::Region &volumeRegion = node.volume()->region();
+	voxel::Region region = _parallel.region;
+	if (!region.cropTo(volumeRegion)) {
+		return true;
+	}
+	const glm::ivec3 &mins = region.getLowerCorner();
+	const glm::ivec3 &maxs = region.getUpperCorner();
+	// the bricks are aligned to the bricks of the occupancy summary of the volume - this keeps the states from
+	// writing into the same summary brick
+	const int occupancyBrickSize = voxel::RawVolume::OccupancyBrickSize;
+	const int brickSize = (_parallel.brickSize + occupancyBrickSize - 1) / occupancyBrickSize * occupancyBrickSize;
+	const glm::ivec3 &volumeMins = volumeRegion.getLowerCorner();
+	const int startX = volumeMins.x + (mins.x - volumeMins.x) / brickSize * brickSize;
+	const int startZ = volumeMins.z + (mins.z - volumeMins.z) / brickSize * brickSize;
+
+	// the bricks cover the full height of the region - scripts that work on columns don't conflict with each other
+	core::DynamicArray<voxel::Region> bricks;
+	for (int z = startZ; z <= maxs.z; z += brickSize) {
+		for (int x = startX; x <= maxs.x; x += brickSize) {
+			bricks.emplace_back(core_max(x, mins.x), mins.y, core_max(z, mins.z), core_min(x + brickSize - 1, maxs.x),
+								maxs.y, core_min(z + brickSize - 1, maxs.z));
+		}
+	}
+	Log::debug("Execute script for %i bricks in parallel", (int)bricks.size());
+
+	// every chunk of bricks gets its own lua state and dirty regions
+	core_trace_mutex(core::Lock, dirtyLock, "DirtyRegions");
+	core::AtomicBool failed{false};
+	app::for_parallel(0, (int)bricks.size(), [&](int start, int end) {
+		voxel::DirtyRegions dirtyRegions;
+		noise::Noise noise;
+		{
+			lua::LUA lua;
+			lua_State *s = lua.state();
+			luaVoxel_newGlobalData(s, luaVoxel_globalnoise(), &noise);
+			luaVoxel_newGlobalData(s, luaVoxel_globaldirtyregion(), &dirtyRegions);
+			prepareState(s);
+			lua_pushboolean(s, 1);
+			lua_setglobal(s, luaVoxel_globalparallel());
+			luaVoxel_newGlobalData(s, luaVoxel_globalscenegraph(), _parallel.sceneGraph);
+			lua_pushinteger(s, _parallel.nodeId);
+			lua_setglobal(s, luaVoxel_globalnodeid());
+			if (luaL_dostring(s, _parallel.script.c_str())) {
+				Log::error("%s", lua_tostring(s, -1));
+				failed = true;
+				return;
+			}
+			for (int i = start; i < end && !failed; ++i) {
+				if (!luaVoxel_pushmain(s, node, bricks[i], _parallel.color, _parallel.args, _argsInfo)) {
+					failed = true;
+					return;
+				}
+				int nargs = 3 + (int)_argsInfo.size();
+				int error;
+				do {
+					int nres = 0;
+					error = lua_resume(s, nullptr, nargs, &nres);
+					lua_pop(s, nres);
+					nargs = 0;
+				} while (error == LUA_YIELD);
+				if (error != LUA_OK) {
+					Log::error("Error running script for brick %s: %s", bricks[i].toString().c_str(),
+							   lua_tostring(s, -1));
+					failed = true;
+					return;
+				}
+			}
+			// the volume wrappers report their dirty region when they are collected
+			lua_gc(s, LUA_GCCOLLECT, 0);
+		}
+		core::ScopedLock lock(dirtyLock);
+		_dirtyRegions.add(dirtyRegions);
+	});
+	return !failed;
+}
+
 bool LUAApi::exec(const core::String &luaScript, scenegraph::SceneGraph &sceneGraph, int nodeId,
 						const voxel::Region &region, const voxel::Voxel &voxel,
 						const core::DynamicArray<core::String> &args) {
@@ -2053,7 +2613,7 @@ bool LUAApi::exec(const core::String &luaScript, scenegraph::SceneGraph &sceneGr
 		return false;
 	}
 
-	_dirtyRegion = voxel::Region::InvalidRegion;
+	_dirtyRegions.clear();
 
 	_argsInfo.clear();
 	if (!argumentInfo(luaScript, _argsInfo)) {
@@ -2088,49 +2648,20 @@ bool LUAApi::exec(const core::String &luaScript, scenegraph::SceneGraph &sceneGr
 		return false;
 	}
 
-	// get main(node, region, color) method
-	lua_getglobal(s, "main");
-	if (!lua_isfunction(s, -1)) {
-		Log::error("LUA generator: no main(node, region, color) function found in '%s'", luaScript.c_str());
-		return false;
-	}
-
-	// first parameter is scene node
-	if (luaVoxel_pushscenegraphnode(s, node) == 0) {
-		Log::error("Failed to push scene graph node");
-		return false;
-	}
-
-	// second parameter is the region to operate on
-	if (luaVoxel_pushregion(s, region) == 0) {
-		Log::error("Failed to push region");
-		return false;
-	}
-
-	// third parameter is the current color
-	lua_pushinteger(s, voxel.getColor());
-
-#if GENERATOR_LUA_SANTITY > 0
-	if (!lua_isfunction(s, -4)) {
-		Log::error("LUA generate: expected to find the main function");
-		return false;
-	}
-	if (luaL_testudata(s, -3, luaVoxel_metascenegraphnode()) == nullptr) {
-		Log::error("LUA generate: expected to find scene graph node");
-		return false;
-	}
-	if (!luaVoxel_isregion(s, -2)) {
-		Log::error("LUA generate: expected to find region");
-		return false;
-	}
-	if (!lua_isnumber(s, -1)) {
-		Log::error("LUA generate: expected to find color");
-		return false;
+	const int brickSize = luaVoxel_parallelbricksize(s);
+	if (brickSize > 0) {
+		_parallel.script = luaScript;
+		_parallel.args = args;
+		_parallel.sceneGraph = &sceneGraph;
+		_parallel.nodeId = nodeId;
+		_parallel.region = region;
+		_parallel.color = voxel.getColor();
+		_parallel.brickSize = brickSize;
+		_scriptStillRunning = true;
+		return true;
 	}
-#endif
 
-	if (!luaVoxel_pushargs(s, args, _argsInfo)) {
-		Log::error("Failed to execute main() function with the given number of arguments. Try calling with 'help' as parameter");
+	if (!luaVoxel_pushmain(s, node, region, voxel.getColor(), args, _argsInfo)) {
 		return false;
 	}
 
@@ -11,6 +11,7 @@
 #include "core/collection/DynamicArray.h"
 #include "io/Filesystem.h"
 #include "noise/Noise.h"
+#include "voxel/DirtyRegions.h"
 #include "voxel/Region.h"
 
 struct lua_State;
@@ -78,10 +79,30 @@ private:
 	io::FilesystemPtr _filesystem;
 	lua::LUA _lua;
 	core::DynamicArray<LUAParameterDescription> _argsInfo;
-	voxel::Region _dirtyRegion = voxel::Region::InvalidRegion;
+	voxel::DirtyRegions _dirtyRegions;
 	bool _scriptStillRunning = false;
 	int _nargs = 0;
 
+	/**
+	 * @brief A script that declared itself region parallel by its @c parallel() function. The region is split into
+	 * columns of bricks and @c main() is executed for each of them in its own lua state on the thread pool.
+	 */
+	struct ParallelExecution {
+		core::String script;
+		core::DynamicArray<core::String> args;
+		scenegraph::SceneGraph *sceneGraph = nullptr;
+		int nodeId = -1;
+		voxel::Region region = voxel::Region::InvalidRegion;
+		int color = 0;
+		/**
+		 * @brief The width and depth of the bricks - @c 0 if the script isn't executed in parallel
+		 */
+		int brickSize = 0;
+	};
+	ParallelExecution _parallel;
+
+	bool execParallel();
+
 public:
 	LUAApi(const io::FilesystemPtr &filesystem);
 	virtual ~LUAApi() {
@@ -115,6 +136,7 @@ public:
 			  const core::DynamicArray<core::String> &args = {});
 
 	const voxel::Region &dirtyRegion() const;
+	const voxel::DirtyRegions &dirtyRegions() const;
 };
 
 inline const core::String &LUAApi::error() const {
@@ -122,7 +144,11 @@ inline const core::String &LUAApi::error() const {
 }
 
 inline const voxel::Region &LUAApi::dirtyRegion() const {
-	return _dirtyRegion;
+	return _dirtyRegions.bounds();
+}
+
+inline const voxel::DirtyRegions &LUAApi::dirtyRegions() const {
+	return _dirtyRegions;
 }
 
 inline auto scriptCompleter(const io::FilesystemPtr &filesystem) {
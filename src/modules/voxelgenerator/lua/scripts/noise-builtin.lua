@@ -11,6 +11,11 @@ function arguments()
 	}
 end
 
+-- every column of the region is generated independently
+function parallel()
+	return true
+end
+
 local function noise2d(volume, region, color, freq, amplitude, type, seed)
 	local visitor = function (noiseVolume, x, z)
 		if noiseVolume == nil then
@@ -9,6 +9,11 @@ function arguments()
 	}
 end
 
+-- every column of the region is generated independently
+function parallel()
+	return true
+end
+
 function main(node, region, color, freq, amplitude, offset)
 	perlin:load()
 
@@ -116,6 +116,112 @@ TEST_F(LUAApiTest, testExecute) {
 	EXPECT_NE(0u, volume->voxel(1, 0, 0).getColor());
 }
 
+TEST_F(LUAApiTest, testVoxelBuffer) {
+	const core::String script = R"(
+		function main(node, region, color)
+			local volume = node:volume()
+			local buffer = volume:readBuffer()
+			if buffer:get(0, 0, 0) ~= 42 or buffer:get(1, 0, 0) ~= -1 then
+				error('Unexpected buffer content')
+			end
+			local neighbors = buffer:countNeighbors()
+			if neighbors:get(1, 1, 0) ~= 6 then
+				error('Expected 6 neighbors, got ' .. neighbors:get(1, 1, 0))
+			end
+			local ones = {}
+			for i = 1, 27 do
+				ones[i] = 1
+			end
+			local convolved = buffer:mask():convolve(ones)
+			if convolved:get(1, 1, 0) ~= 6 or convolved:get(0, 0, 0) ~= 2 then
+				error('Unexpected convolution result')
+			end
+			local noise = g_buffer.new(region, 0)
+			noise:noise(0.1)
+			volume:writeBuffer(neighbors:threshold(6, 1))
+		end
+	)";
+
+	scenegraph::SceneGraph sceneGraph;
+	run(sceneGraph, script, {}, true);
+	const voxel::RawVolume *volume = sceneGraph.node(sceneGraph.activeNode()).volume();
+	EXPECT_TRUE(voxel::isAir(volume->voxel(0, 0, 0).getMaterial()));
+	EXPECT_FALSE(voxel::isAir(volume->voxel(1, 1, 0).getMaterial()));
+	EXPECT_EQ(1u, volume->voxel(1, 1, 0).getColor());
+	EXPECT_FALSE(voxel::isAir(volume->voxel(1, 1, 1).getMaterial()));
+	EXPECT_TRUE(voxel::isAir(volume->voxel(1, 0, 0).getMaterial()));
+}
+
+TEST_F(LUAApiTest, testParallel) {
+	const core::String script = R"(
+		function parallel()
+			return 3
+		end
+
+		function main(node, region, color)
+			-- the brick size is rounded up to the size of the occupancy bricks of the volume
+			if region:width() > 16 or region:depth() > 16 or region:height() ~= 8 then
+				error('Unexpected brick region ' .. tostring(region))
+			end
+			local volume = node:volume()
+			local mins = region:mins()
+			local maxs = region:maxs()
+			for x = mins.x, maxs.x do
+				for z = mins.z, maxs.z do
+					volume:setVoxel(x, 7, z, color)
+				end
+			end
+			coroutine.yield()
+		end
+	)";
+
+	scenegraph::SceneGraph sceneGraph;
+	run(sceneGraph, script, {}, true);
+	const voxel::RawVolume *volume = sceneGraph.node(sceneGraph.activeNode()).volume();
+	for (int x = 0; x <= 7; ++x) {
+		for (int z = 0; z <= 7; ++z) {
+			EXPECT_EQ(42u, volume->voxel(x, 7, z).getColor()) << x << ":" << z;
+		}
+	}
+}
+
+TEST_F(LUAApiTest, testParallelSharedState) {
+	const char *calls[] = {"node:volume():resize(1)", "node:palette():setColor(1, 255, 0, 0)", "node:setName('foo')",
+						   "g_scenegraph.new('foo', g_region.new(0, 0, 0, 1, 1, 1))"};
+	for (const char *call : calls) {
+		SCOPED_TRACE(call);
+		const core::String script = core::String::format(R"(
+			function parallel()
+				return true
+			end
+
+			function main(node, region, color)
+				-- own palettes can be modified
+				local pal = g_palette.new()
+				pal:setColor(1, 255, 0, 0)
+				%s
+			end
+		)", call);
+
+		scenegraph::SceneGraph sceneGraph;
+		scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+		node.setVolume(new voxel::RawVolume(_region), true);
+		node.setName("belt");
+		const int nodeId = sceneGraph.emplace(core::move(node));
+		ASSERT_NE(nodeId, InvalidNodeId);
+
+		LUAApi g(_testApp->filesystem());
+		ASSERT_TRUE(g.init());
+		const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, 42);
+		EXPECT_TRUE(g.exec(script, sceneGraph, nodeId, _region, voxel));
+		EXPECT_EQ(ScriptState::Error, g.update(0.0001));
+		EXPECT_EQ(1u, sceneGraph.size());
+		EXPECT_EQ("belt", sceneGraph.node(nodeId).name());
+		EXPECT_EQ(_region, sceneGraph.node(nodeId).region());
+		g.shutdown();
+	}
+}
+
 TEST_F(LUAApiTest, testYield) {
 	const core::String script = R"(
 		function main(node, region, color)
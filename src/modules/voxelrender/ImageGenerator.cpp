@@ -16,30 +16,12 @@
 #include "video/Texture.h"
 #include "voxelformat/Format.h"
 #include "voxelrender/SceneGraphRenderer.h"
+#include "voxelrender/SoftwareRenderer.h"
 #include "scenegraph/SceneGraph.h"
 
 namespace voxelrender {
 
-static image::ImagePtr volumeThumbnail(const voxel::MeshStatePtr &meshState, RenderContext &renderContext, voxelrender::SceneGraphRenderer &volumeRenderer, const voxelformat::ThumbnailContext &ctx) {
-	if (!renderContext.sceneGraph) {
-		Log::error("No scene graph set");
-		return image::ImagePtr();
-	}
-	const scenegraph::SceneGraph &sceneGraph = *renderContext.sceneGraph;
-	video::clearColor(ctx.clearColor);
-	video::enable(video::State::DepthTest);
-	video::depthFunc(video::CompareFunc::LessEqual);
-	video::enable(video::State::CullFace);
-	video::enable(video::State::DepthMask);
-	video::enable(video::State::Blend);
-	video::blendFunc(video::BlendMode::SourceAlpha, video::BlendMode::OneMinusSourceAlpha);
-
-	video::TextureConfig textureCfg;
-	textureCfg.wrap(video::TextureWrap::ClampToEdge);
-	textureCfg.format(video::TextureFormat::RGBA);
-
-	core_trace_scoped(EditorSceneRenderFramebuffer);
-
+static video::Camera thumbnailCamera(const scenegraph::SceneGraph &sceneGraph, const voxelformat::ThumbnailContext &ctx) {
 	video::Camera camera;
 
 	if (ctx.useSceneCamera && sceneGraph.size(scenegraph::SceneGraphNodeType::Camera) > 0) {
@@ -74,6 +56,30 @@ static image::ImagePtr volumeThumbnail(const voxel::MeshStatePtr &meshState, Ren
 		}
 	}
 	camera.update(ctx.deltaFrameSeconds);
+	return camera;
+}
+
+static image::ImagePtr volumeThumbnail(const voxel::MeshStatePtr &meshState, RenderContext &renderContext, voxelrender::SceneGraphRenderer &volumeRenderer, const voxelformat::ThumbnailContext &ctx) {
+	if (!renderContext.sceneGraph) {
+		Log::error("No scene graph set");
+		return image::ImagePtr();
+	}
+	const scenegraph::SceneGraph &sceneGraph = *renderContext.sceneGraph;
+	video::clearColor(ctx.clearColor);
+	video::enable(video::State::DepthTest);
+	video::depthFunc(video::CompareFunc::LessEqual);
+	video::enable(video::State::CullFace);
+	video::enable(video::State::DepthMask);
+	video::enable(video::State::Blend);
+	video::blendFunc(video::BlendMode::SourceAlpha, video::BlendMode::OneMinusSourceAlpha);
+
+	video::TextureConfig textureCfg;
+	textureCfg.wrap(video::TextureWrap::ClampToEdge);
+	textureCfg.format(video::TextureFormat::RGBA);
+
+	core_trace_scoped(EditorSceneRenderFramebuffer);
+
+	const video::Camera &camera = thumbnailCamera(sceneGraph, ctx);
 
 	renderContext.frameBuffer.bind(true);
 	volumeRenderer.render(meshState, renderContext, camera, true, true);
@@ -83,6 +89,13 @@ static image::ImagePtr volumeThumbnail(const voxel::MeshStatePtr &meshState, Ren
 }
 
 image::ImagePtr volumeThumbnail(const scenegraph::SceneGraph &sceneGraph, const voxelformat::ThumbnailContext &ctx) {
+	if (ctx.useSoftwareRenderer) {
+		SoftwareRenderer renderer;
+		renderer.prepare(sceneGraph);
+		const image::ImagePtr &image = renderer.render(thumbnailCamera(sceneGraph, ctx), ctx.clearColor);
+		renderer.shutdown();
+		return image;
+	}
 	voxelrender::SceneGraphRenderer sceneGraphRenderer;
 	sceneGraphRenderer.construct();
 	RenderContext renderContext;
@@ -106,7 +119,47 @@ image::ImagePtr volumeThumbnail(const scenegraph::SceneGraph &sceneGraph, const
 	return image;
 }
 
+static bool writeTurntableImage(const image::ImagePtr &image, const core::String &filepath) {
+	if (!image) {
+		Log::error("Failed to create thumbnail for %s", filepath.c_str());
+		return false;
+	}
+	const io::FilePtr &outfile = io::filesystem()->open(filepath, io::FileMode::SysWrite);
+	io::FileStream outStream(outfile);
+	if (!image::Image::writePng(outStream, image->data(), image->width(), image->height(), image->depth())) {
+		Log::error("Failed to write image %s", filepath.c_str());
+		return false;
+	}
+	Log::info("Write image %s", filepath.c_str());
+	return true;
+}
+
+static bool volumeTurntableSoftware(const scenegraph::SceneGraph &sceneGraph, const core::String &imageFile,
+									voxelformat::ThumbnailContext ctx, int loops) {
+	SoftwareRenderer renderer;
+	// the scene doesn't change between the angles - only the camera does
+	renderer.prepare(sceneGraph);
+	bool success = true;
+	const core::String ext = core::string::extractExtension(imageFile);
+	const core::String baseFilePath = core::string::stripExtension(imageFile);
+	for (int i = 0; i < loops; ++i) {
+		const core::String &filepath = core::string::format("%s_%i.%s", baseFilePath.c_str(), i, ext.c_str());
+		const image::ImagePtr &image = renderer.render(thumbnailCamera(sceneGraph, ctx), ctx.clearColor);
+		if (!writeTurntableImage(image, filepath)) {
+			success = false;
+			break;
+		}
+		ctx.omega = glm::vec3(0.0f, glm::two_pi<float>() / (float)loops, 0.0f);
+		ctx.deltaFrameSeconds += 1000.0 / (double)loops;
+	}
+	renderer.shutdown();
+	return success;
+}
+
 bool volumeTurntable(const scenegraph::SceneGraph &sceneGraph, const core::String &imageFile, voxelformat::ThumbnailContext ctx, int loops) {
+	if (ctx.useSoftwareRenderer) {
+		return volumeTurntableSoftware(sceneGraph, imageFile, ctx, loops);
+	}
 	voxelrender::SceneGraphRenderer sceneGraphRenderer;
 	RenderContext renderContext;
 	renderContext.init(ctx.outputSize);
@@ -123,31 +176,15 @@ bool volumeTurntable(const scenegraph::SceneGraph &sceneGraph, const core::Strin
 		return image::ImagePtr();
 	}
 
+	bool success = true;
 	const core::String ext = core::string::extractExtension(imageFile);
 	const core::String baseFilePath = core::string::stripExtension(imageFile);
 	for (int i = 0; i < loops; ++i) {
 		const core::String &filepath = core::string::format("%s_%i.%s", baseFilePath.c_str(), i, ext.c_str());
-		const io::FilePtr &outfile = io::filesystem()->open(filepath, io::FileMode::SysWrite);
-		io::FileStream outStream(outfile);
 		const image::ImagePtr &image = volumeThumbnail(meshState, renderContext, sceneGraphRenderer, ctx);
-		if (image) {
-			if (!image::Image::writePng(outStream, image->data(), image->width(), image->height(), image->depth())) {
-				Log::error("Failed to write image %s", filepath.c_str());
-				sceneGraphRenderer.shutdown();
-				renderContext.shutdown();
-				// don't free the volumes here, they belong to the scene graph
-				(void)meshState->shutdown();
-				return false;
-			} else {
-				Log::info("Write image %s", filepath.c_str());
-			}
-		} else {
-			Log::error("Failed to create thumbnail for %s", imageFile.c_str());
-			sceneGraphRenderer.shutdown();
-			renderContext.shutdown();
-			// don't free the volumes here, they belong to the scene graph
-			(void)meshState->shutdown();
-			return false;
+		if (!writeTurntableImage(image, filepath)) {
+			success = false;
+			break;
 		}
 		ctx.omega = glm::vec3(0.0f, glm::two_pi<float>() / (float)loops, 0.0f);
 		ctx.deltaFrameSeconds += 1000.0 / (double)loops;
@@ -156,7 +193,7 @@ bool volumeTurntable(const scenegraph::SceneGraph &sceneGraph, const core::Strin
 	renderContext.shutdown();
 	// don't free the volumes here, they belong to the scene graph
 	(void)meshState->shutdown();
-	return true;
+	return success;
 }
 
 } // namespace voxelrender
@@ -0,0 +1,240 @@
+/**
+ * @file
+ */
+
+#include "SoftwareRenderer.h"
+#include "app/Async.h"
+#include "core/Color.h"
+#include "core/Trace.h"
+#include "palette/Palette.h"
+#include "scenegraph/SceneGraph.h"
+#include "scenegraph/SceneGraphNode.h"
+#include "video/Camera.h"
+#include "voxel/RawVolume.h"
+#include "voxelutil/Raycast.h"
+#include <float.h>
+#include <glm/common.hpp>
+#include <glm/ext/matrix_projection.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/geometric.hpp>
+#include <glm/matrix.hpp>
+
+namespace voxelrender {
+
+namespace {
+
+// same values as the mesh renderer uses for the ambient occlusion of the vertices
+const float AmbientOcclusionValues[] = {0.15f, 0.6f, 0.8f, 1.0f};
+const float AmbientLight = 0.75f;
+const float DiffuseLight = 0.25f;
+
+inline bool solid(const voxel::RawVolume *volume, const glm::ivec3 &pos) {
+	const voxel::VoxelType material = volume->voxel(pos).getMaterial();
+	return !voxel::isAir(material) && !voxel::isTransparent(material);
+}
+
+/**
+ * @brief The ambient occlusion of a face corner - see the mesh extractor
+ */
+inline float vertexAmbientOcclusion(const voxel::RawVolume *volume, const glm::ivec3 &facePos, const glm::ivec3 &u,
+									const glm::ivec3 &w) {
+	const bool side1 = solid(volume, facePos + u);
+	const bool side2 = solid(volume, facePos + w);
+	if (side1 && side2) {
+		return AmbientOcclusionValues[0];
+	}
+	const bool corner = solid(volume, facePos + u + w);
+	return AmbientOcclusionValues[3 - (int)side1 - (int)side2 - (int)corner];
+}
+
+struct Hit {
+	float t = 1.0f;
+	int modelIdx = -1;
+	glm::ivec3 pos{0};
+	glm::vec3 localPos{0.0f};
+	int axis = 0;
+	int sign = 1;
+};
+
+} // namespace
+
+void SoftwareRenderer::prepare(const scenegraph::SceneGraph &sceneGraph, scenegraph::FrameIndex frameIdx) {
+	core_trace_scoped(SoftwareRendererPrepare);
+	_models.clear();
+	core::DynamicArray<const voxel::RawVolume *> volumes;
+	for (auto entry : sceneGraph.nodes()) {
+		const scenegraph::SceneGraphNode &node = entry->second;
+		if (!node.isAnyModelNode() || !node.visible()) {
+			continue;
+		}
+		const voxel::RawVolume *volume = sceneGraph.resolveVolume(node);
+		if (volume == nullptr) {
+			continue;
+		}
+		const scenegraph::SceneGraphNode &paletteNode = node.isReference() ? sceneGraph.node(node.reference()) : node;
+		const scenegraph::FrameTransform &transform = sceneGraph.transformForFrame(node, frameIdx);
+		const voxel::Region &region = sceneGraph.resolveRegion(node);
+		const glm::vec3 pivot = transform.scale() * node.pivot() * glm::vec3(region.getDimensionsInVoxels());
+
+		Model model;
+		model.volume = volume;
+		model.palette = &paletteNode.palette();
+		// the mesh renderer places the vertices at worldMatrix * (pos - pivot)
+		model.worldToLocal = glm::translate(glm::mat4(1.0f), pivot) * glm::inverse(transform.worldMatrix());
+		model.normalMatrix = glm::transpose(glm::mat3(model.worldToLocal));
+		for (size_t i = 0; i < volumes.size(); ++i) {
+			if (volumes[i] == volume) {
+				model.occupancyIdx = (int)i;
+				break;
+			}
+		}
+		if (model.occupancyIdx == -1) {
+			model.occupancyIdx = (int)volumes.size();
+			volumes.push_back(volume);
+		}
+		_models.push_back(model);
+	}
+
+	_occupancies.clear();
+	_occupancies.resize(volumes.size());
+	app::for_parallel(
+		0, (int)volumes.size(),
+		[&](int start, int end) {
+			for (int i = start; i < end; ++i) {
+				_occupancies[i].setVolume(volumes[i]);
+				_occupancies[i].update();
+			}
+		},
+		1);
+}
+
+image::ImagePtr SoftwareRenderer::render(const video::Camera &camera, const glm::vec4 &clearColor) const {
+	core_trace_scoped(SoftwareRendererRender);
+	const glm::ivec2 &size = camera.size();
+	image::ImagePtr image = image::createEmptyImage("thumbnail");
+	if (size.x <= 0 || size.y <= 0) {
+		return image;
+	}
+
+	// the rays are interpolated between the corners of the near and the far plane - row 0 is the top of the image
+	const glm::vec4 viewport(0.0f, 0.0f, 1.0f, 1.0f);
+	const glm::mat4 &view = camera.viewMatrix();
+	const glm::mat4 &projection = camera.projectionMatrix();
+	glm::vec3 nearCorners[4];
+	glm::vec3 farCorners[4];
+	const glm::vec2 windowCorners[4] = {{0.0f, 1.0f}, {1.0f, 1.0f}, {0.0f, 0.0f}, {1.0f, 0.0f}};
+	for (int i = 0; i < 4; ++i) {
+		nearCorners[i] = glm::unProject(glm::vec3(windowCorners[i], 0.0f), view, projection, viewport);
+		farCorners[i] = glm::unProject(glm::vec3(windowCorners[i], 1.0f), view, projection, viewport);
+	}
+	const glm::vec3 lightDir = glm::normalize(glm::vec3(25.0f, 100.0f, 25.0f));
+	const core::RGBA clearRGBA = core::Color::getRGBA(clearColor);
+
+	core::DynamicArray<core::RGBA> pixels;
+	pixels.resize((size_t)size.x * (size_t)size.y);
+	app::for_parallel(0, size.y, [&](int startRow, int endRow) {
+		for (int y = startRow; y < endRow; ++y) {
+			const float v = ((float)y + 0.5f) / (float)size.y;
+			const glm::vec3 nearLeft = glm::mix(nearCorners[0], nearCorners[2], v);
+			const glm::vec3 nearRight = glm::mix(nearCorners[1], nearCorners[3], v);
+			const glm::vec3 farLeft = glm::mix(farCorners[0], farCorners[2], v);
+			const glm::vec3 farRight = glm::mix(farCorners[1], farCorners[3], v);
+			for (int x = 0; x < size.x; ++x) {
+				const float u = ((float)x + 0.5f) / (float)size.x;
+				const glm::vec3 rayStart = glm::mix(nearLeft, nearRight, u);
+				const glm::vec3 rayEnd = glm::mix(farLeft, farRight, u);
+
+				// t is the position on the segment between the near and the far plane - the same for all models
+				Hit hit;
+				for (size_t modelIdx = 0; modelIdx < _models.size(); ++modelIdx) {
+					const Model &model = _models[modelIdx];
+					const glm::vec3 start = model.worldToLocal * glm::vec4(rayStart, 1.0f);
+					const glm::vec3 end = model.worldToLocal * glm::vec4(rayEnd, 1.0f);
+					const glm::vec3 dir = end - start;
+					glm::ivec3 pos;
+					bool found = false;
+					voxelutil::raycastWithEndpoints(
+						model.volume, _occupancies[model.occupancyIdx], start, start + dir * hit.t,
+						[&](const voxel::RawVolume::Sampler &sampler) {
+							if (voxel::isAir(sampler.voxel().getMaterial())) {
+								return true;
+							}
+							pos = sampler.position();
+							found = true;
+							return false;
+						});
+					if (!found) {
+						continue;
+					}
+					// the entry point into the voxel gives the depth and the face that was hit
+					float tnear = -FLT_MAX;
+					int axis = 0;
+					for (int i = 0; i < 3; ++i) {
+						if (dir[i] == 0.0f) {
+							continue;
+						}
+						const float t1 = ((float)pos[i] - start[i]) / dir[i];
+						const float t2 = ((float)pos[i] + 1.0f - start[i]) / dir[i];
+						const float tmin = glm::min(t1, t2);
+						if (tmin > tnear) {
+							tnear = tmin;
+							axis = i;
+						}
+					}
+					tnear = glm::max(tnear, 0.0f);
+					if (tnear >= hit.t) {
+						continue;
+					}
+					hit.t = tnear;
+					hit.modelIdx = (int)modelIdx;
+					hit.pos = pos;
+					hit.localPos = start + dir * tnear;
+					hit.axis = axis;
+					hit.sign = dir[axis] > 0.0f ? -1 : 1;
+				}
+
+				core::RGBA &pixel = pixels[(size_t)y * size.x + x];
+				if (hit.modelIdx == -1) {
+					pixel = clearRGBA;
+					continue;
+				}
+				const Model &model = _models[hit.modelIdx];
+				const voxel::Voxel &voxel = model.volume->voxel(hit.pos);
+				const glm::vec4 color = core::Color::fromRGBA(model.palette->color(voxel.getColor()));
+
+				// bilinear interpolation of the ambient occlusion of the face corners
+				const int axisU = (hit.axis + 1) % 3;
+				const int axisW = (hit.axis + 2) % 3;
+				glm::ivec3 facePos = hit.pos;
+				facePos[hit.axis] += hit.sign;
+				glm::ivec3 du(0);
+				glm::ivec3 dw(0);
+				du[axisU] = 1;
+				dw[axisW] = 1;
+				const float fu = glm::clamp(hit.localPos[axisU] - (float)hit.pos[axisU], 0.0f, 1.0f);
+				const float fw = glm::clamp(hit.localPos[axisW] - (float)hit.pos[axisW], 0.0f, 1.0f);
+				const float ao00 = vertexAmbientOcclusion(model.volume, facePos, -du, -dw);
+				const float ao10 = vertexAmbientOcclusion(model.volume, facePos, du, -dw);
+				const float ao01 = vertexAmbientOcclusion(model.volume, facePos, -du, dw);
+				const float ao11 = vertexAmbientOcclusion(model.volume, facePos, du, dw);
+				const float ao = glm::mix(glm::mix(ao00, ao10, fu), glm::mix(ao01, ao11, fu), fw);
+
+				glm::vec3 normal(0.0f);
+				normal[hit.axis] = (float)hit.sign;
+				normal = glm::normalize(model.normalMatrix * normal);
+				const float light = AmbientLight + DiffuseLight * glm::abs(glm::dot(normal, lightDir));
+				pixel = core::Color::getRGBA(glm::vec4(glm::vec3(color) * ao * light, 1.0f));
+			}
+		}
+	});
+
+	image->loadRGBA((const uint8_t *)pixels.data(), size.x, size.y);
+	return image;
+}
+
+void SoftwareRenderer::shutdown() {
+	_models.clear();
+	_occupancies.clear();
+}
+
+} // namespace voxelrender
@@ -0,0 +1,69 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/NonCopyable.h"
+#include "core/collection/DynamicArray.h"
+#include "image/Image.h"
+#include "scenegraph/SceneGraphAnimation.h"
+#include "voxelutil/BrickOccupancy.h"
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+
+namespace scenegraph {
+class SceneGraph;
+}
+
+namespace palette {
+class Palette;
+}
+
+namespace video {
+class Camera;
+}
+
+namespace voxelrender {
+
+/**
+ * @brief Renders the model nodes of a scene graph on the cpu - there is no OpenGL context needed
+ *
+ * Every pixel casts a ray through the volumes and skips the empty bricks of the volumes. The image rows are distributed
+ * over the threads of the application thread pool. The hit voxels are shaded with their palette color, the same
+ * ambient occlusion values as the mesh renderer and a simple directional light.
+ *
+ * @note Transparent voxels are rendered as opaque voxels
+ */
+class SoftwareRenderer : public core::NonCopyable {
+private:
+	struct Model {
+		const voxel::RawVolume *volume = nullptr;
+		const palette::Palette *palette = nullptr;
+		// from world space into the voxel coordinates of the volume
+		glm::mat4 worldToLocal{1.0f};
+		// transforms the face normals of the volume into world space
+		glm::mat3 normalMatrix{1.0f};
+		int occupancyIdx = -1;
+	};
+
+	core::DynamicArray<Model> _models;
+	// referenced volumes share the empty space information - all bricks are evaluated in prepare(), the render
+	// threads only read them
+	mutable core::DynamicArray<voxelutil::BrickOccupancy> _occupancies;
+
+public:
+	/**
+	 * @brief Collects the visible model nodes and evaluates the empty space of their volumes
+	 * @note The volumes are not copied - the scene graph must not be modified until the rendering is done
+	 */
+	void prepare(const scenegraph::SceneGraph &sceneGraph, scenegraph::FrameIndex frameIdx = 0);
+	/**
+	 * @return RGBA image in the size of the camera - the pixels that don't hit any voxel get the clear color
+	 */
+	image::ImagePtr render(const video::Camera &camera, const glm::vec4 &clearColor) const;
+	void shutdown();
+};
+
+} // namespace voxelrender
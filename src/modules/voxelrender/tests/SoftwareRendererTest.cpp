@@ -0,0 +1,75 @@
+/**
+ * @file
+ */
+
+#include "app/tests/AbstractTest.h"
+#include "core/Color.h"
+#include "scenegraph/SceneGraph.h"
+#include "scenegraph/SceneGraphNode.h"
+#include "video/Camera.h"
+#include "voxel/RawVolume.h"
+#include "voxelrender/SoftwareRenderer.h"
+
+namespace voxelrender {
+
+class SoftwareRendererTest : public app::AbstractTest {
+protected:
+	const glm::vec4 _clearColor{0.0f, 0.0f, 1.0f, 1.0f};
+
+	int addModel(scenegraph::SceneGraph &sceneGraph, bool visible = true) {
+		voxel::RawVolume *volume = new voxel::RawVolume(voxel::Region(0, 7));
+		for (int z = 2; z <= 5; ++z) {
+			for (int y = 2; y <= 5; ++y) {
+				for (int x = 2; x <= 5; ++x) {
+					volume->setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+				}
+			}
+		}
+		scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+		node.setVolume(volume, true);
+		node.setVisible(visible);
+		return sceneGraph.emplace(core::move(node));
+	}
+
+	video::Camera camera() const {
+		video::Camera camera;
+		camera.setSize(glm::ivec2(32));
+		camera.setFarPlane(100.0f);
+		camera.setWorldPosition(glm::vec3(4.0f, 4.0f, 40.0f));
+		camera.lookAt(glm::vec3(4.0f, 4.0f, 4.0f));
+		camera.update(0.0);
+		return camera;
+	}
+};
+
+TEST_F(SoftwareRendererTest, testRenderModel) {
+	scenegraph::SceneGraph sceneGraph;
+	ASSERT_NE(InvalidNodeId, addModel(sceneGraph));
+	SoftwareRenderer renderer;
+	renderer.prepare(sceneGraph);
+	const image::ImagePtr &image = renderer.render(camera(), _clearColor);
+	ASSERT_TRUE(image && image->isLoaded());
+	ASSERT_EQ(32, image->width());
+	ASSERT_EQ(32, image->height());
+	const core::RGBA clearColor = core::Color::getRGBA(_clearColor);
+	EXPECT_EQ(clearColor, image->colorAt(0, 0));
+	EXPECT_EQ(clearColor, image->colorAt(31, 31));
+	const core::RGBA center = image->colorAt(16, 16);
+	EXPECT_NE(clearColor, center);
+	EXPECT_EQ(255, center.a);
+	renderer.shutdown();
+}
+
+TEST_F(SoftwareRendererTest, testHiddenModel) {
+	scenegraph::SceneGraph sceneGraph;
+	ASSERT_NE(InvalidNodeId, addModel(sceneGraph, false));
+	SoftwareRenderer renderer;
+	renderer.prepare(sceneGraph);
+	const image::ImagePtr &image = renderer.render(camera(), _clearColor);
+	ASSERT_TRUE(image && image->isLoaded());
+	const core::RGBA clearColor = core::Color::getRGBA(_clearColor);
+	EXPECT_EQ(clearColor, image->colorAt(16, 16));
+	renderer.shutdown();
+}
+
+} // namespace voxelrender
@@ -0,0 +1,92 @@
+/**
+ * @file
+ */
+
+#include "BrickOccupancy.h"
+#include "voxel/RawVolume.h"
+
+namespace voxelutil {
+
+bool BrickOccupancy::validBrick(const glm::ivec3 &brick) const {
+	const glm::ivec3 b = brick - _brickMins;
+	return b.x >= 0 && b.y >= 0 && b.z >= 0 && b.x < _brickDims.x && b.y < _brickDims.y && b.z < _brickDims.z;
+}
+
+size_t BrickOccupancy::brickIndex(const glm::ivec3 &brick) const {
+	const glm::ivec3 b = brick - _brickMins;
+	return ((size_t)b.z * _brickDims.y + b.y) * _brickDims.x + b.x;
+}
+
+void BrickOccupancy::setVolume(const voxel::RawVolume *volume) {
+	if (volume == _volume && (volume == nullptr || volume->region() == _region)) {
+		return;
+	}
+	_volume = volume;
+	if (_volume == nullptr) {
+		_region = voxel::Region::InvalidRegion;
+		_brickMins = _brickDims = glm::ivec3(0);
+		_states.clear();
+		return;
+	}
+	_region = _volume->region();
+	_brickMins = brick(_region.getLowerCorner());
+	_brickDims = brick(_region.getUpperCorner()) - _brickMins + 1;
+	_states.resize((size_t)_brickDims.x * _brickDims.y * _brickDims.z);
+	markDirty();
+}
+
+void BrickOccupancy::markDirty() {
+	_states.fill(Unknown);
+}
+
+void BrickOccupancy::markDirty(const voxel::Region &region) {
+	voxel::Region cropped = region;
+	if (_volume == nullptr || !cropped.isValid() || !cropped.cropTo(_region)) {
+		return;
+	}
+	const glm::ivec3 mins = brick(cropped.getLowerCorner());
+	const glm::ivec3 maxs = brick(cropped.getUpperCorner());
+	for (int z = mins.z; z <= maxs.z; ++z) {
+		for (int y = mins.y; y <= maxs.y; ++y) {
+			for (int x = mins.x; x <= maxs.x; ++x) {
+				_states[brickIndex(glm::ivec3(x, y, z))] = Unknown;
+			}
+		}
+	}
+}
+
+BrickOccupancy::State BrickOccupancy::evaluate(const glm::ivec3 &brick) const {
+	const voxel::Region region(brick * BrickSize, brick * BrickSize + (BrickSize - 1));
+	// answered by the occupancy summary of the volume
+	return _volume->isEmpty(region) ? Empty : Occupied;
+}
+
+void BrickOccupancy::update() {
+	if (_volume == nullptr) {
+		return;
+	}
+	for (int z = 0; z < _brickDims.z; ++z) {
+		for (int y = 0; y < _brickDims.y; ++y) {
+			for (int x = 0; x < _brickDims.x; ++x) {
+				const glm::ivec3 brick = _brickMins + glm::ivec3(x, y, z);
+				uint8_t &state = _states[brickIndex(brick)];
+				if (state == Unknown) {
+					state = evaluate(brick);
+				}
+			}
+		}
+	}
+}
+
+bool BrickOccupancy::emptyBrick(const glm::ivec3 &brick) {
+	if (_volume == nullptr || !validBrick(brick)) {
+		return false;
+	}
+	uint8_t &state = _states[brickIndex(brick)];
+	if (state == Unknown) {
+		state = evaluate(brick);
+	}
+	return state == Empty;
+}
+
+} // namespace voxelutil
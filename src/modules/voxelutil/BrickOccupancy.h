@@ -0,0 +1,78 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/collection/DynamicArray.h"
+#include "voxel/Region.h"
+#include <stdint.h>
+
+namespace voxel {
+class RawVolume;
+}
+
+namespace voxelutil {
+
+/**
+ * @brief Remembers which bricks of 16x16x16 voxels of a volume contain only air
+ *
+ * The bricks are evaluated lazily the first time they are queried by using the occupancy summary of the volume.
+ * After a modification, @c markDirty() must be called for the modified region to evaluate the affected bricks again.
+ *
+ * This is used by the raycast to skip empty space.
+ */
+class BrickOccupancy {
+public:
+	static constexpr int BrickBits = 4;
+	static constexpr int BrickSize = 1 << BrickBits;
+
+private:
+	enum State : uint8_t { Unknown, Empty, Occupied };
+
+	const voxel::RawVolume *_volume = nullptr;
+	voxel::Region _region = voxel::Region::InvalidRegion;
+	glm::ivec3 _brickMins{0};
+	glm::ivec3 _brickDims{0};
+	core::DynamicArray<uint8_t> _states;
+
+	bool validBrick(const glm::ivec3 &brick) const;
+	size_t brickIndex(const glm::ivec3 &brick) const;
+	State evaluate(const glm::ivec3 &brick) const;
+
+public:
+	/**
+	 * @brief Assigns the volume - all bricks are evaluated again if the volume or its region changed
+	 */
+	void setVolume(const voxel::RawVolume *volume);
+
+	inline const voxel::RawVolume *volume() const {
+		return _volume;
+	}
+
+	/**
+	 * @brief All bricks that intersect the given region are evaluated again on the next query
+	 */
+	void markDirty(const voxel::Region &region);
+	/**
+	 * @brief All bricks are evaluated again on the next query
+	 */
+	void markDirty();
+	/**
+	 * @brief Evaluates all bricks that are not yet known. Afterwards @c emptyBrick() doesn't modify the instance
+	 * anymore and can be used from several threads until the next @c markDirty() or @c setVolume() call.
+	 */
+	void update();
+
+	/**
+	 * @return @c true if the brick only contains air voxels. Bricks outside of the volume are never reported as
+	 * empty, because the voxels there are not known.
+	 */
+	bool emptyBrick(const glm::ivec3 &brick);
+
+	static inline glm::ivec3 brick(const glm::ivec3 &pos) {
+		return pos >> BrickBits;
+	}
+};
+
+} // namespace voxelutil
@@ -0,0 +1,119 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/collection/BitSet.h"
+#include "core/collection/DynamicArray.h"
+#include "voxel/Region.h"
+#include "voxel/Voxel.h"
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+namespace voxelutil {
+
+/**
+ * @brief Stores one bit per voxel of a region to mark the positions that were already visited by a flood fill
+ */
+class VisitedMask {
+private:
+	const voxel::Region _region;
+	const glm::ivec3 _mins;
+	const int _width;
+	const int _sliceSize;
+	core::BitSet _bits;
+
+	inline size_t index(int x, int y, int z) const {
+		return (size_t)(z - _mins.z) * _sliceSize + (size_t)(y - _mins.y) * _width + (size_t)(x - _mins.x);
+	}
+
+public:
+	VisitedMask(const voxel::Region &region)
+		: _region(region), _mins(region.getLowerCorner()), _width(region.getWidthInVoxels()),
+		  _sliceSize(region.getWidthInVoxels() * region.getHeightInVoxels()), _bits(region.voxels()) {
+	}
+
+	inline const voxel::Region &region() const {
+		return _region;
+	}
+
+	inline bool get(int x, int y, int z) const {
+		return _bits[index(x, y, z)];
+	}
+
+	inline void set(int x, int y, int z) {
+		_bits.set(index(x, y, z), true);
+	}
+};
+
+/**
+ * @brief Scanline flood fill for the 6-connected voxels that match the given condition
+ *
+ * Instead of pushing every voxel, the fill extends each seed to a span along the x axis and only pushes one seed per
+ * run of fillable voxels in the four neighbouring rows. There is no recursion and the seed stack stays small.
+ *
+ * @param visited The fill doesn't leave the region of the mask. Positions that are already marked are not filled
+ * again - all filled positions get marked.
+ * @param start The position to start the fill at
+ * @param condition Returns @c true if the voxel can get filled: @code bool(const voxel::Voxel &voxel) @endcode
+ * @param func Called for each filled span from @c x0 to @c x1 (inclusive): @code void(int x0, int x1, int y, int z) @endcode
+ * @return The amount of filled voxels
+ */
+template<class Volume, class CONDITION, class FUNC>
+int floodFill(const Volume &volume, VisitedMask &visited, const glm::ivec3 &start, CONDITION &&condition,
+			  FUNC &&func) {
+	const voxel::Region &region = visited.region();
+	if (!region.containsPoint(start)) {
+		return 0;
+	}
+	const glm::ivec3 &mins = region.getLowerCorner();
+	const glm::ivec3 &maxs = region.getUpperCorner();
+	auto fillable = [&](int x, int y, int z) { return !visited.get(x, y, z) && condition(volume.voxel(x, y, z)); };
+
+	int filled = 0;
+	core::DynamicArray<glm::ivec3> seeds;
+	seeds.push_back(start);
+	while (!seeds.empty()) {
+		const glm::ivec3 seed = seeds.back();
+		seeds.pop();
+		if (!fillable(seed.x, seed.y, seed.z)) {
+			continue;
+		}
+		int x0 = seed.x;
+		while (x0 > mins.x && fillable(x0 - 1, seed.y, seed.z)) {
+			--x0;
+		}
+		int x1 = seed.x;
+		while (x1 < maxs.x && fillable(x1 + 1, seed.y, seed.z)) {
+			++x1;
+		}
+		for (int x = x0; x <= x1; ++x) {
+			visited.set(x, seed.y, seed.z);
+		}
+		filled += x1 - x0 + 1;
+		func(x0, x1, seed.y, seed.z);
+
+		const glm::ivec2 rows[4] = {glm::ivec2(seed.y - 1, seed.z), glm::ivec2(seed.y + 1, seed.z),
+									glm::ivec2(seed.y, seed.z - 1), glm::ivec2(seed.y, seed.z + 1)};
+		for (const glm::ivec2 &row : rows) {
+			if (row.x < mins.y || row.x > maxs.y || row.y < mins.z || row.y > maxs.z) {
+				continue;
+			}
+			bool inRun = false;
+			for (int x = x0; x <= x1; ++x) {
+				if (!fillable(x, row.x, row.y)) {
+					inRun = false;
+					continue;
+				}
+				if (!inRun) {
+					seeds.emplace_back(x, row.x, row.y);
+					inRun = true;
+				}
+			}
+		}
+	}
+	return filled;
+}
+
+} // namespace voxelutil
@@ -6,9 +6,11 @@
 
 #include "core/Trace.h"
 #include "voxel/RawVolume.h"
+#include "voxelutil/BrickOccupancy.h"
 #include "core/Common.h"
 #include <glm/ext/scalar_constants.hpp>
 #include <glm/common.hpp>
+#include <float.h>
 
 namespace voxelutil {
 namespace RaycastResults {
@@ -193,6 +195,175 @@ inline RaycastResult raycastWithEndpointsVolume(voxel::RawVolume* volData, const
 	return raycastWithEndpoints(volData, v3dStart, v3dEnd, callback);
 }
 
+namespace detail {
+
+/**
+ * Clips the line segment to the given region grown by one voxel. The voxels around the region are kept to allow the
+ * callback to detect the position where the ray enters or leaves the volume.
+ *
+ * @return @c false if the line segment doesn't touch the region at all
+ */
+inline bool clipToRegion(const voxel::Region &region, glm::vec3 &v3dStart, glm::vec3 &v3dEnd) {
+	const glm::vec3 mins = glm::vec3(region.getLowerCorner()) - 1.0f;
+	const glm::vec3 maxs = glm::vec3(region.getUpperCorner()) + 2.0f;
+	const glm::vec3 dir = v3dEnd - v3dStart;
+	float tnear = 0.0f;
+	float tfar = 1.0f;
+	for (int i = 0; i < 3; ++i) {
+		if (glm::abs(dir[i]) < glm::epsilon<float>()) {
+			if (v3dStart[i] < mins[i] || v3dStart[i] >= maxs[i]) {
+				return false;
+			}
+			continue;
+		}
+		float t1 = (mins[i] - v3dStart[i]) / dir[i];
+		float t2 = (maxs[i] - v3dStart[i]) / dir[i];
+		if (t1 > t2) {
+			core::exchange(t1, t2);
+		}
+		tnear = core_max(tnear, t1);
+		tfar = core_min(tfar, t2);
+		if (tnear > tfar) {
+			return false;
+		}
+	}
+	const glm::vec3 origin = v3dStart;
+	v3dStart = origin + dir * tnear;
+	v3dEnd = origin + dir * tfar;
+	return true;
+}
+
+}
+
+/**
+ * Cast a ray through a volume by specifying the start and end positions and skip the empty space
+ *
+ * This visits the same voxels as the other raycastWithEndpoints() function, but the segment is clipped to the volume
+ * region (grown by one voxel) and the voxels inside of bricks that only contain air are not reported to the callback.
+ * Only the first and the last voxel of the ray inside such a brick are handed to the callback. This means that the
+ * callback must treat air voxels as pass-through and may not rely on seeing every empty voxel - e.g. a callback that
+ * stops at a certain plane must use the other raycast function.
+ *
+ * @param occupancy The empty brick cache for the volume - it's bound to @a volData by this function, modifications of
+ * the volume must be announced via BrickOccupancy::markDirty()
+ * @see BrickOccupancy
+ */
+template<typename Callback>
+RaycastResult raycastWithEndpoints(const voxel::RawVolume *volData, BrickOccupancy &occupancy, const glm::vec3 &v3dStart,
+								   const glm::vec3 &v3dEnd, Callback &&callback) {
+	core_trace_scoped(raycastWithEndpointsSkipEmpty);
+	occupancy.setVolume(volData);
+	const voxel::Region &region = volData->region();
+	glm::vec3 start = v3dStart;
+	glm::vec3 end = v3dEnd;
+	if (!detail::clipToRegion(region, start, end)) {
+		return RaycastResults::Completed;
+	}
+	voxel::RawVolume::Sampler sampler(volData);
+
+	const glm::ivec3 posEnd(glm::floor(end));
+	const glm::ivec3 d(glm::sign(end - start));
+
+	const glm::vec3 dist = glm::abs(end - start);
+	const float deltatx = dist.x < glm::epsilon<float>() ? 1.0f : 1.0f / dist.x;
+	const float deltaty = dist.y < glm::epsilon<float>() ? 1.0f : 1.0f / dist.y;
+	const float deltatz = dist.z < glm::epsilon<float>() ? 1.0f : 1.0f / dist.z;
+
+	const glm::vec3 floorStart(glm::floor(start));
+	const glm::vec3 maxs = floorStart + 1.0f;
+
+	// an axis the ray doesn't move along is never stepped - otherwise the ray would end early
+	float tx = d.x == 0 ? FLT_MAX : ((d.x == -1) ? (start.x - floorStart.x) : (maxs.x - start.x)) * deltatx;
+	float ty = d.y == 0 ? FLT_MAX : ((d.y == -1) ? (start.y - floorStart.y) : (maxs.y - start.y)) * deltaty;
+	float tz = d.z == 0 ? FLT_MAX : ((d.z == -1) ? (start.z - floorStart.z) : (maxs.z - start.z)) * deltatz;
+
+	glm::ivec3 pos(floorStart);
+	sampler.setPosition(pos);
+
+	// advances pos to the next voxel and returns the axis of the step or -1 if the end was reached
+	auto step = [&]() {
+		if (tx <= ty && tx <= tz) {
+			if (pos.x == posEnd.x) {
+				return -1;
+			}
+			tx += deltatx;
+			pos.x += d.x;
+			return 0;
+		}
+		if (ty <= tz) {
+			if (pos.y == posEnd.y) {
+				return -1;
+			}
+			ty += deltaty;
+			pos.y += d.y;
+			return 1;
+		}
+		if (pos.z == posEnd.z) {
+			return -1;
+		}
+		tz += deltatz;
+		pos.z += d.z;
+		return 2;
+	};
+
+	for (;;) {
+		if (!callback(sampler)) {
+			return RaycastResults::Interupted;
+		}
+
+		const glm::ivec3 brick = BrickOccupancy::brick(pos);
+		if (region.containsPoint(pos) && occupancy.emptyBrick(brick)) {
+			// walk through the brick without sampling and only report the last voxel before leaving it
+			const glm::ivec3 entry = pos;
+			glm::ivec3 last = pos;
+			int axis;
+			while ((axis = step()) != -1) {
+				if (BrickOccupancy::brick(pos) != brick || !region.containsPoint(pos)) {
+					break;
+				}
+				last = pos;
+			}
+			if (last != entry) {
+				sampler.setPosition(last);
+				if (!callback(sampler)) {
+					return RaycastResults::Interupted;
+				}
+			}
+			if (axis == -1) {
+				break;
+			}
+			sampler.setPosition(pos);
+			continue;
+		}
+
+		const int axis = step();
+		if (axis == -1) {
+			break;
+		}
+		if (axis == 0) {
+			if (d.x == 1) {
+				sampler.movePositiveX();
+			} else if (d.x == -1) {
+				sampler.moveNegativeX();
+			}
+		} else if (axis == 1) {
+			if (d.y == 1) {
+				sampler.movePositiveY();
+			} else if (d.y == -1) {
+				sampler.moveNegativeY();
+			}
+		} else {
+			if (d.z == 1) {
+				sampler.movePositiveZ();
+			} else if (d.z == -1) {
+				sampler.moveNegativeZ();
+			}
+		}
+	}
+
+	return RaycastResults::Completed;
+}
+
 /**
  * Cast a ray through a volume by specifying the start and a direction
  *
@@ -223,4 +394,14 @@ RaycastResult raycastWithDirection(Volume* volData, const glm::vec3& v3dStart, c
 	return raycastWithEndpoints<Callback, Volume>(volData, v3dStart, v3dEnd, core::forward<Callback>(callback));
 }
 
+/**
+ * @see raycastWithEndpoints() with BrickOccupancy
+ */
+template<typename Callback>
+RaycastResult raycastWithDirection(const voxel::RawVolume *volData, BrickOccupancy &occupancy, const glm::vec3 &v3dStart,
+								   const glm::vec3 &v3dDirectionAndLength, Callback &&callback) {
+	const glm::vec3 v3dEnd = v3dStart + v3dDirectionAndLength;
+	return raycastWithEndpoints(volData, occupancy, v3dStart, v3dEnd, core::forward<Callback>(callback));
+}
+
 }
@@ -44,22 +44,13 @@ template<class CropSkipCondition = CropSkipEmpty>
 		return nullptr;
 	}
 	core_trace_scoped(CropRawVolume);
-	glm::ivec3 newMins((std::numeric_limits<int>::max)() / 2);
-	glm::ivec3 newMaxs((std::numeric_limits<int>::min)() / 2);
-	if (visitVolume(
-			*volume,
-			[&newMins, &newMaxs](int x, int y, int z, const voxel::Voxel &) {
-				newMins.x = core_min(newMins.x, x);
-				newMins.y = core_min(newMins.y, y);
-				newMins.z = core_min(newMins.z, z);
-
-				newMaxs.x = core_max(newMaxs.x, x);
-				newMaxs.y = core_max(newMaxs.y, y);
-				newMaxs.z = core_max(newMaxs.z, z);
-			},
-			SkipEmpty()) == 0) {
+	// the occupancy summary of the volume is used to find the solid voxels
+	const voxel::Region &solidRegion = volume->solidRegion();
+	if (!solidRegion.isValid()) {
 		return nullptr;
 	}
+	const glm::ivec3 &newMins = solidRegion.getLowerCorner();
+	const glm::ivec3 &newMaxs = solidRegion.getUpperCorner();
 	return cropVolume(volume, newMins, newMaxs);
 }
 }
@@ -7,6 +7,7 @@
 #include "core/collection/DynamicArray.h"
 #include "voxel/RawVolume.h"
 #include "palette/Palette.h"
+#include "palette/PaletteRemap.h"
 #include "core/Trace.h"
 #include "core/Assert.h"
 #include "voxel/Voxel.h"
@@ -73,6 +74,7 @@ int mergeVolumes(Volume1 *destination, const palette::Palette &destinationPalett
 				 MergeCondition mergeCondition = MergeCondition()) {
 	core_trace_scoped(MergeRawVolumes);
 	int cnt = 0;
+	const palette::PaletteRemap remap(sourcePalette, destinationPalette);
 	typename Volume2::Sampler sourceSampler(source);
 	typename Volume1::Sampler destSampler(destination);
 	const int relX = destReg.getLowerX();
@@ -91,7 +93,7 @@ int mergeVolumes(Volume1 *destination, const palette::Palette &destinationPalett
 					destSampler.movePositiveX();
 					continue;
 				}
-				int idx = destinationPalette.getClosestMatch(sourcePalette.color(srcVoxel.getColor()));
+				int idx = remap.remap(srcVoxel.getColor());
 				if (idx == palette::PaletteColorNotFound) {
 					idx = 0;
 				}
@@ -7,65 +7,44 @@
 #include "core/Log.h"
 #include "voxel/RawVolume.h"
 #include "voxel/Voxel.h"
-#include "voxelutil/VolumeCropper.h"
+#include "voxelutil/FloodFill.h"
 #include "voxelutil/VolumeVisitor.h"
 #include "voxelutil/VoxelUtil.h"
 
 namespace voxelutil {
 
-namespace priv {
-
-const glm::ivec3 neighbours[6] = {glm::ivec3(0, 0, -1), glm::ivec3(0, 0, +1), glm::ivec3(0, -1, 0),
-								  glm::ivec3(0, +1, 0), glm::ivec3(-1, 0, 0), glm::ivec3(+1, 0, 0)};
-
-// special voxel to mark already visited voxels
-const uint8_t visitedFlag = 1u;
-const voxel::Voxel visited(voxel::VoxelType::Air, 1, visitedFlag);
-
-} // namespace priv
-
-static void processNeighbours(voxel::RawVolume &volume, voxel::RawVolume &object, const glm::ivec3 position) {
-	if (!volume.region().containsPoint(position)) {
-		return;
-	}
-	voxel::Voxel voxel = volume.voxel(position);
-	if (voxel.getFlags() == priv::visitedFlag) {
-		return;
-	}
-	if (voxel::isAir(voxel.getMaterial())) {
-		volume.setVoxelUnsafe(position, priv::visited);
-		return;
-	}
-
-	object.setVoxel(position, voxel);
-	volume.setVoxelUnsafe(position, priv::visited);
-
-	for (int i = 0; i < 6; ++i) {
-		const glm::ivec3 p = position + priv::neighbours[i];
-		processNeighbours(volume, object, p);
-	}
-}
-
 core::DynamicArray<voxel::RawVolume *> splitObjects(const voxel::RawVolume *v, VisitorOrder order) {
-	voxel::RawVolume copy(*v);
-	copy.setBorderValue(priv::visited);
+	struct Span {
+		int x0, x1, y, z;
+	};
+	auto isSolid = [](const voxel::Voxel &voxel) { return !voxel::isAir(voxel.getMaterial()); };
 
 	core::DynamicArray<voxel::RawVolume *> rawVolumes;
+	VisitedMask visited(v->region());
+	core::DynamicArray<Span> spans;
 
-	visitVolume(copy, [&](int x, int y, int z, const voxel::Voxel &voxel) {
-		if (voxel.getFlags() == priv::visitedFlag) {
+	visitVolume(*v, [&](int x, int y, int z, const voxel::Voxel &) {
+		if (visited.get(x, y, z)) {
 			return;
 		}
-		const glm::ivec3 position(x, y, z);
-		if (voxel::isAir(voxel.getMaterial())) {
-			copy.setVoxelUnsafe(position, priv::visited);
-			return;
+		// collect the spans of the connected voxels and their bounding box - the object volume is created
+		// with the final size right away
+		spans.clear();
+		glm::ivec3 mins(x, y, z);
+		glm::ivec3 maxs(x, y, z);
+		floodFill(*v, visited, glm::ivec3(x, y, z), isSolid, [&](int x0, int x1, int sy, int sz) {
+			spans.push_back({x0, x1, sy, sz});
+			mins = glm::min(mins, glm::ivec3(x0, sy, sz));
+			maxs = glm::max(maxs, glm::ivec3(x1, sy, sz));
+		});
+		voxel::RawVolume *object = new voxel::RawVolume(voxel::Region(mins, maxs));
+		for (const Span &span : spans) {
+			for (int sx = span.x0; sx <= span.x1; ++sx) {
+				object->setVoxel(sx, span.y, span.z, v->voxel(sx, span.y, span.z));
+			}
 		}
-
-		voxel::RawVolume object(copy.region());
-		processNeighbours(copy, object, position);
-		rawVolumes.push_back(voxelutil::cropVolume(&object));
-	}, VisitAll(), order);
+		rawVolumes.push_back(object);
+	}, SkipEmpty(), order);
 
 	return rawVolumes;
 }
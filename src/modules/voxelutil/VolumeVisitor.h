@@ -10,6 +10,10 @@
 #include "voxel/Face.h"
 #include "voxel/Region.h"
 
+namespace voxel {
+class RawVolume;
+}
+
 namespace voxelutil {
 
 enum class VisitorOrder {
@@ -108,6 +112,15 @@ int visitVolume(const Volume &volume, const voxel::Region &region, int xOff, int
 	core_trace_scoped(VisitVolume);
 	int cnt = 0;
 
+	// the occupancy summary of the volume allows to skip the bricks that only contain air
+	constexpr bool skipEmptyBricks = std::is_same_v<Volume, voxel::RawVolume> && std::is_same_v<Condition, SkipEmpty>;
+	if constexpr (skipEmptyBricks) {
+		if ((isAir(volume.borderValue().getMaterial()) || volume.region().containsRegion(region)) &&
+			volume.isEmpty(region)) {
+			return cnt;
+		}
+	}
+
 	typename Volume::Sampler sampler(volume);
 
 	switch (order) {
@@ -133,7 +146,20 @@ int visitVolume(const Volume &volume, const voxel::Region &region, int xOff, int
 			typename Volume::Sampler sampler2 = sampler;
 			for (int32_t y = region.getLowerY(); y <= region.getUpperY(); y += yOff) {
 				typename Volume::Sampler sampler3 = sampler2;
+				[[maybe_unused]] int32_t checkX = region.getLowerX();
 				for (int32_t x = region.getLowerX(); x <= region.getUpperX(); x += xOff) {
+					if constexpr (skipEmptyBricks) {
+						if (xOff == 1 && x >= checkX) {
+							const int32_t nextX = volume.nextOccupiedX(x, y, z, checkX);
+							if (nextX > region.getUpperX()) {
+								break;
+							}
+							if (nextX != x) {
+								sampler3.movePositiveX(nextX - x);
+								x = nextX;
+							}
+						}
+					}
 					const voxel::Voxel &voxel = sampler3.voxel();
 					sampler3.movePositiveX(xOff);
 					VISITOR_INNER_PART
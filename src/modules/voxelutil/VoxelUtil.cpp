@@ -5,20 +5,20 @@
 #include "VoxelUtil.h"
 #include "core/GLM.h"
 #include "core/Log.h"
-#include "core/collection/Array3DView.h"
-#include "core/collection/Buffer.h"
 #include "core/collection/DynamicArray.h"
 #include "core/collection/Set.h"
 #include <glm/geometric.hpp>
 #include "math/Axis.h"
 #include "palette/Palette.h"
 #include "palette/PaletteLookup.h"
+#include "palette/PaletteRemap.h"
 #include "voxel/Face.h"
 #include "voxel/ModificationRecorder.h"
 #include "voxel/RawVolume.h"
 #include "voxel/RawVolumeWrapper.h"
 #include "voxel/Region.h"
 #include "voxel/Voxel.h"
+#include "voxelutil/FloodFill.h"
 #include "voxelutil/VolumeVisitor.h"
 #include <functional>
 
@@ -202,106 +202,42 @@ bool copyIntoRegion(const voxel::RawVolume &in, voxel::RawVolume &out, const vox
 
 void fillHollow(voxel::RawVolumeWrapper &volume, const voxel::Voxel &voxel) {
 	const voxel::Region &region = volume.region();
-	const int width = region.getWidthInVoxels();
-	const int height = region.getHeightInVoxels();
-	const int depth = region.getDepthInVoxels();
-	const int size = width * height * depth;
-	const glm::ivec3 mins = volume.region().getLowerCorner();
-	core::DynamicArray<glm::ivec3> positions;
-	positions.reserve(size);
-	core::Buffer<bool> visitedData(size);
-	core::Array3DView<bool> visited(visitedData.data(), width, height, depth);
-
-	visitVolume(
-		volume, region, 1, 1, 1,
-		[&](int x, int y, int z, const voxel::Voxel &) { visited.set(x - mins.x, y - mins.y, z - mins.z, true); },
-		SkipEmpty());
-
-	for (int x = 0; x < width; ++x) {
-		for (int z = 1; z < depth - 1; ++z) {
-			const glm::ivec3 v1(x, 0, z);
-			const voxel::VoxelType m1 = volume.voxel(v1 + mins).getMaterial();
-			if (voxel::isAir(m1) || voxel::isTransparent(m1)) {
-				positions.push_back(v1);
-				visited.set(v1, true);
-			}
-			const glm::ivec3 v2(x, height - 1, z);
-			const voxel::VoxelType m2 = volume.voxel(v2 + mins).getMaterial();
-			if (voxel::isAir(m2) || voxel::isTransparent(m2)) {
-				positions.push_back(v2);
-				visited.set(v2, true);
-			}
-		}
-		for (int y = 0; y < height; ++y) {
-			const glm::ivec3 v1(x, y, 0);
-			const voxel::VoxelType m1 = volume.voxel(v1 + mins).getMaterial();
-			if (voxel::isAir(m1) || voxel::isTransparent(m1)) {
-				positions.push_back(v1);
-				visited.set(v1, true);
-			}
-			const glm::ivec3 v2(x, y, depth - 1);
-			const voxel::VoxelType m2 = volume.voxel(v2 + mins).getMaterial();
-			if (voxel::isAir(m2) || voxel::isTransparent(m2)) {
-				positions.push_back(v2);
-				visited.set(v2, true);
+	const glm::ivec3 &mins = region.getLowerCorner();
+	const glm::ivec3 &maxs = region.getUpperCorner();
+	VisitedMask visited(region);
+	auto isOpen = [](const voxel::Voxel &v) { return voxel::isAir(v.getMaterial()); };
+	auto noop = [](int, int, int, int) {};
+	auto fillFromBoundary = [&](int x, int y, int z) {
+		const glm::ivec3 pos(x, y, z);
+		const voxel::VoxelType material = volume.voxel(pos).getMaterial();
+		if (voxel::isAir(material)) {
+			floodFill(volume, visited, pos, isOpen, noop);
+		} else if (voxel::isTransparent(material)) {
+			// transparent voxels on the boundary are openings - the air behind them is not hollow
+			for (const glm::ivec3 &dir : {glm::ivec3(1, 0, 0), glm::ivec3(-1, 0, 0), glm::ivec3(0, 1, 0),
+										  glm::ivec3(0, -1, 0), glm::ivec3(0, 0, 1), glm::ivec3(0, 0, -1)}) {
+				floodFill(volume, visited, pos + dir, isOpen, noop);
 			}
 		}
-	}
-	for (int y = 1; y < height - 1; ++y) {
-		for (int z = 1; z < depth - 1; ++z) {
-			const glm::ivec3 v1(0, y, z);
-			const voxel::VoxelType m1 = volume.voxel(v1 + mins).getMaterial();
-			if (voxel::isAir(m1) || voxel::isTransparent(m1)) {
-				positions.push_back(v1);
-				visited.set(v1, true);
-			}
-			const glm::ivec3 v2(width - 1, y, z);
-			const voxel::VoxelType m2 = volume.voxel(v2 + mins).getMaterial();
-			if (voxel::isAir(m2) || voxel::isTransparent(m2)) {
-				positions.push_back(v2);
-				visited.set(v2, true);
-			}
-		}
-	}
-
-	while (!positions.empty()) {
-		const glm::ivec3 v = positions.back();
-		positions.erase(positions.size() - 1);
+	};
 
-		if (v.z > 0 && !visited.get(v.x, v.y, v.z - 1)) {
-			const glm::ivec3 v1(v.x, v.y, v.z - 1);
-			visited.set(v1, true);
-			positions.push_back(v1);
-		}
-		if (v.y > 0 && !visited.get(v.x, v.y - 1, v.z)) {
-			const glm::ivec3 v1(v.x, v.y - 1, v.z);
-			visited.set(v1, true);
-			positions.push_back(v1);
-		}
-		if (v.x > 0 && !visited.get(v.x - 1, v.y, v.z)) {
-			const glm::ivec3 v1(v.x - 1, v.y, v.z);
-			visited.set(v1, true);
-			positions.push_back(v1);
-		}
-		if (v.z < depth - 1 && !visited.get(v.x, v.y, v.z + 1)) {
-			const glm::ivec3 v1(v.x, v.y, v.z + 1);
-			visited.set(v1, true);
-			positions.push_back(v1);
-		}
-		if (v.y < height - 1 && !visited.get(v.x, v.y + 1, v.z)) {
-			const glm::ivec3 v1(v.x, v.y + 1, v.z);
-			visited.set(v1, true);
-			positions.push_back(v1);
-		}
-		if (v.x < width - 1 && !visited.get(v.x + 1, v.y, v.z)) {
-			const glm::ivec3 v1(v.x + 1, v.y, v.z);
-			visited.set(v1, true);
-			positions.push_back(v1);
+	// everything that is reachable from the boundary of the region is not hollow
+	for (int z = mins.z; z <= maxs.z; ++z) {
+		for (int y = mins.y; y <= maxs.y; ++y) {
+			const bool boundaryRow = z == mins.z || z == maxs.z || y == mins.y || y == maxs.y;
+			if (boundaryRow) {
+				for (int x = mins.x; x <= maxs.x; ++x) {
+					fillFromBoundary(x, y, z);
+				}
+			} else {
+				fillFromBoundary(mins.x, y, z);
+				fillFromBoundary(maxs.x, y, z);
+			}
 		}
 	}
 
-	auto visitor = [&](int x, int y, int z, const voxel::Voxel &) {
-		if (!visited.get(x - mins.x, y - mins.y, z - mins.z)) {
+	auto visitor = [&](int x, int y, int z, const voxel::Voxel &v) {
+		if (!visited.get(x, y, z) && isOpen(v)) {
 			volume.setVoxel(x, y, z, voxel);
 		}
 	};
@@ -636,16 +572,22 @@ voxel::Region remapToPalette(voxel::RawVolume *volume, const palette::Palette &o
 	if (volume == nullptr) {
 		return voxel::Region::InvalidRegion;
 	}
+	const palette::PaletteRemap remap(oldPalette, newPalette, skipColorIndex);
+	return remapToPalette(volume, remap);
+}
+
+voxel::Region remapToPalette(voxel::RawVolume *volume, const palette::PaletteRemap &remap) {
+	if (volume == nullptr) {
+		return voxel::Region::InvalidRegion;
+	}
 	voxel::RawVolumeWrapper wrapper(volume);
-	voxelutil::visitVolume(
-		wrapper, [&wrapper, &newPalette, skipColorIndex, &oldPalette](int x, int y, int z, const voxel::Voxel &voxel) {
-			const core::RGBA rgba = oldPalette.color(voxel.getColor());
-			const int newColor = newPalette.getClosestMatch(rgba, skipColorIndex);
-			if (newColor != palette::PaletteColorNotFound) {
-				voxel::Voxel newVoxel(voxel::VoxelType::Generic, newColor, voxel.getNormal(), voxel.getFlags());
-				wrapper.setVoxel(x, y, z, newVoxel);
-			}
-		});
+	voxelutil::visitVolume(wrapper, [&wrapper, &remap](int x, int y, int z, const voxel::Voxel &voxel) {
+		const int newColor = remap.remap(voxel.getColor());
+		if (newColor != palette::PaletteColorNotFound) {
+			voxel::Voxel newVoxel(voxel::VoxelType::Generic, newColor, voxel.getNormal(), voxel.getFlags());
+			wrapper.setVoxel(x, y, z, newVoxel);
+		}
+	});
 	return wrapper.dirtyRegion();
 }
 
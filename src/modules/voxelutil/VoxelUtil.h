@@ -16,6 +16,7 @@ class RawVolumeWrapper;
 }
 namespace palette {
 class Palette;
+class PaletteRemap;
 }
 
 namespace voxelutil {
@@ -163,6 +164,12 @@ void clear(voxel::RawVolumeWrapper &in);
  * @return The region of the volume that was changed
  */
 voxel::Region remapToPalette(voxel::RawVolume *v, const palette::Palette &oldPalette, const palette::Palette &newPalette, int skipColorIndex = -1);
+/**
+ * @brief Changes the voxel colors by the given color index table - voxels whose color is mapped to
+ * @c palette::PaletteColorNotFound are not changed
+ * @return The region of the volume that was changed
+ */
+voxel::Region remapToPalette(voxel::RawVolume *v, const palette::PaletteRemap &remap);
 
 /**
  * @brief Creates a diff between the two given volumes
@@ -0,0 +1,117 @@
+/**
+ * @file
+ */
+
+#include "app/tests/AbstractTest.h"
+#include "voxel/RawVolume.h"
+#include "voxelutil/BrickOccupancy.h"
+#include "voxelutil/Raycast.h"
+
+namespace voxelutil {
+
+class BrickOccupancyTest : public app::AbstractTest {
+protected:
+	struct TraceResult {
+		bool didHit = false;
+		glm::ivec3 hitVoxel{0};
+		bool validPreviousPosition = false;
+		glm::ivec3 previousPosition{0};
+		bool firstValidPosition = false;
+		glm::ivec3 firstPosition{0};
+	};
+
+	// same rules as the voxel cursor trace in voxedit
+	template<typename Raycast>
+	TraceResult trace(Raycast &&raycast) {
+		TraceResult result;
+		raycast([&](voxel::RawVolume::Sampler &sampler) {
+			if (!result.firstValidPosition && sampler.currentPositionValid()) {
+				result.firstPosition = sampler.position();
+				result.firstValidPosition = true;
+			}
+			if (!voxel::isAir(sampler.voxel().getMaterial())) {
+				result.didHit = true;
+				result.hitVoxel = sampler.position();
+				return false;
+			}
+			if (sampler.currentPositionValid()) {
+				result.validPreviousPosition = true;
+				result.previousPosition = sampler.position();
+			} else if (result.firstValidPosition) {
+				return false;
+			}
+			return true;
+		});
+		return result;
+	}
+
+	void expectSameTrace(const voxel::RawVolume &v, BrickOccupancy &occupancy, const glm::vec3 &start,
+						 const glm::vec3 &end) {
+		const TraceResult expected = trace([&](auto &&callback) { raycastWithEndpoints(&v, start, end, callback); });
+		const TraceResult skipped =
+			trace([&](auto &&callback) { raycastWithEndpoints(&v, occupancy, start, end, callback); });
+		EXPECT_EQ(expected.didHit, skipped.didHit);
+		EXPECT_EQ(expected.hitVoxel, skipped.hitVoxel);
+		EXPECT_EQ(expected.validPreviousPosition, skipped.validPreviousPosition);
+		EXPECT_EQ(expected.previousPosition, skipped.previousPosition);
+		EXPECT_EQ(expected.firstValidPosition, skipped.firstValidPosition);
+		EXPECT_EQ(expected.firstPosition, skipped.firstPosition);
+	}
+};
+
+TEST_F(BrickOccupancyTest, testEmptyBrick) {
+	voxel::RawVolume v(voxel::Region(-8, 40));
+	BrickOccupancy occupancy;
+	occupancy.setVolume(&v);
+	EXPECT_TRUE(occupancy.emptyBrick(glm::ivec3(0)));
+	EXPECT_TRUE(occupancy.emptyBrick(glm::ivec3(1)));
+	EXPECT_TRUE(occupancy.emptyBrick(glm::ivec3(-1)));
+	EXPECT_FALSE(occupancy.emptyBrick(glm::ivec3(-2))) << "Bricks outside of the volume are never empty";
+
+	v.setVoxel(glm::ivec3(17), voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	EXPECT_TRUE(occupancy.emptyBrick(glm::ivec3(1))) << "The modification was not announced yet";
+	occupancy.markDirty(voxel::Region(glm::ivec3(17), glm::ivec3(17)));
+	EXPECT_FALSE(occupancy.emptyBrick(glm::ivec3(1)));
+	EXPECT_TRUE(occupancy.emptyBrick(glm::ivec3(0)));
+}
+
+TEST_F(BrickOccupancyTest, testUpdate) {
+	voxel::RawVolume v(voxel::Region(0, 40));
+	v.setVoxel(glm::ivec3(17), voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	BrickOccupancy occupancy;
+	occupancy.setVolume(&v);
+	occupancy.update();
+	v.setVoxel(glm::ivec3(0), voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	EXPECT_TRUE(occupancy.emptyBrick(glm::ivec3(0))) << "All bricks should have been evaluated before the modification";
+	EXPECT_FALSE(occupancy.emptyBrick(glm::ivec3(1)));
+}
+
+TEST_F(BrickOccupancyTest, testRaycastSkipEmpty) {
+	voxel::RawVolume v(voxel::Region(glm::ivec3(-5, 0, 3), glm::ivec3(60, 45, 70)));
+	const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, 1);
+	for (int i = 0; i < 40; ++i) {
+		v.setVoxel(glm::ivec3((i * 37) % 60, (i * 13) % 45, 3 + (i * 29) % 67), voxel);
+	}
+	v.setVoxel(glm::ivec3(30, 20, 35), voxel);
+	BrickOccupancy occupancy;
+	const glm::vec3 target(30.5f, 20.5f, 35.5f);
+	for (int i = 0; i < 64; ++i) {
+		const glm::vec3 start(-100.0f + (float)(i * 7 % 23) * 11.3f, 150.0f - (float)(i % 5) * 70.0f,
+							  -80.0f + (float)(i * 3 % 11) * 23.1f);
+		const glm::vec3 end = start + (target - start) * 3.0f;
+		expectSameTrace(v, occupancy, start, end);
+	}
+	// starting inside of the volume and leaving without a hit
+	expectSameTrace(v, occupancy, glm::vec3(1.5f, 1.5f, 4.5f), glm::vec3(1.5f, 400.0f, 4.5f));
+
+	// axis aligned rays are traced up to the end
+	const TraceResult result = trace([&](auto &&callback) {
+		raycastWithEndpoints(&v, occupancy, glm::vec3(-50.0f, 20.5f, 35.5f), glm::vec3(100.0f, 20.5f, 35.5f), callback);
+	});
+	EXPECT_TRUE(result.didHit);
+	EXPECT_EQ(glm::ivec3(30, 20, 35), result.hitVoxel);
+	EXPECT_EQ(glm::ivec3(29, 20, 35), result.previousPosition);
+	EXPECT_EQ(glm::ivec3(-5, 20, 35), result.firstPosition);
+}
+
+} // namespace voxelutil
@@ -0,0 +1,44 @@
+/**
+ * @file
+ */
+
+#include "voxelutil/FloodFill.h"
+#include "app/tests/AbstractTest.h"
+#include "voxel/RawVolume.h"
+#include "voxel/Region.h"
+#include "voxel/Voxel.h"
+
+namespace voxelutil {
+
+class FloodFillTest : public app::AbstractTest {};
+
+TEST_F(FloodFillTest, testFillUntilWall) {
+	const voxel::Region region(0, 7);
+	voxel::RawVolume volume(region);
+	const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, 1);
+	for (int y = 0; y <= 7; ++y) {
+		for (int z = 0; z <= 7; ++z) {
+			volume.setVoxel(4, y, z, voxel);
+		}
+	}
+
+	VisitedMask visited(region);
+	int spans = 0;
+	auto isAir = [](const voxel::Voxel &v) { return voxel::isAir(v.getMaterial()); };
+	const int filled = floodFill(volume, visited, glm::ivec3(0, 0, 0), isAir, [&](int x0, int x1, int, int) {
+		EXPECT_EQ(0, x0);
+		EXPECT_EQ(3, x1);
+		++spans;
+	});
+	EXPECT_EQ(4 * 8 * 8, filled);
+	EXPECT_EQ(8 * 8, spans);
+	EXPECT_TRUE(visited.get(3, 7, 7));
+	EXPECT_FALSE(visited.get(4, 0, 0));
+	EXPECT_FALSE(visited.get(5, 0, 0));
+
+	// already visited positions are not filled again
+	EXPECT_EQ(0, floodFill(volume, visited, glm::ivec3(1, 1, 1), isAir, [](int, int, int, int) {}));
+	EXPECT_EQ(3 * 8 * 8, floodFill(volume, visited, glm::ivec3(7, 7, 7), isAir, [](int, int, int, int) {}));
+}
+
+} // namespace voxelutil
@@ -91,4 +91,29 @@ TEST_F(VolumeSplitterTest, testSplitObjects) {
 	}
 }
 
+TEST_F(VolumeSplitterTest, testSplitObjectsSerpentine) {
+	// a single object that winds through the whole plane - this is one long connected path
+	const voxel::Region region(0, 0, 0, 127, 0, 127);
+	const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, 1);
+	voxel::RawVolume volume(region);
+	int expectedVoxelCount = 0;
+	for (int z = 0; z <= 127; ++z) {
+		for (int x = 0; x <= 127; ++x) {
+			const bool connector = (z / 2) % 2 == 0 ? x == 127 : x == 0;
+			if (z % 2 == 0 || connector) {
+				volume.setVoxel(x, 0, z, voxel);
+				++expectedVoxelCount;
+			}
+		}
+	}
+
+	core::DynamicArray<voxel::RawVolume *> rawVolumes = voxelutil::splitObjects(&volume);
+	ASSERT_EQ(1u, rawVolumes.size());
+	EXPECT_EQ(region, rawVolumes[0]->region());
+	EXPECT_EQ(expectedVoxelCount, countVoxels(*rawVolumes[0], voxel));
+	for (voxel::RawVolume *v : rawVolumes) {
+		delete v;
+	}
+}
+
 } // namespace voxelutil
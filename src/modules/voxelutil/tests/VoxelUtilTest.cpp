@@ -64,6 +64,24 @@ TEST_F(VoxelUtilTest, testFillHollowLeak) {
 	EXPECT_EQ(0, v.voxel(region.getCenter()).getColor());
 }
 
+TEST_F(VoxelUtilTest, testFillHollowTransparentBoundary) {
+	voxel::Region region(0, 2);
+	voxel::RawVolume v(region);
+	const voxel::Voxel borderVoxel = voxel::createVoxel(voxel::VoxelType::Generic, 1);
+	voxelutil::visitVolume(
+		v, [&](int x, int y, int z, const voxel::Voxel &) { EXPECT_TRUE(v.setVoxel(x, y, z, borderVoxel)); },
+		VisitAll());
+	EXPECT_TRUE(v.setVoxel(region.getCenter(), voxel::Voxel()));
+	// a transparent voxel on the boundary is an opening like an air voxel
+	EXPECT_TRUE(v.setVoxel(1, 1, 0, voxel::createVoxel(voxel::VoxelType::Transparent, 3)));
+
+	const voxel::Voxel fillVoxel = voxel::createVoxel(voxel::VoxelType::Generic, 2);
+	voxel::RawVolumeWrapper wrapper(&v);
+	voxelutil::fillHollow(wrapper, fillVoxel);
+	EXPECT_EQ(0, v.voxel(region.getCenter()).getColor());
+	EXPECT_EQ(3, v.voxel(1, 1, 0).getColor());
+}
+
 TEST_F(VoxelUtilTest, testExtrudePlanePositiveY) {
 	voxel::Region region(0, 2);
 	voxel::RawVolume v(region);
@@ -51,6 +51,9 @@ app::AppState Thumbnailer::onConstruct() {
 		.addFlag(ARGUMENT_FLAG_MANDATORY);
 	registerArg("--turntable").setShort("-t").setDescription("Render in different angles");
 	registerArg("--fallback").setShort("-f").setDescription("Create a fallback thumbnail if an error occurs");
+	registerArg("--software")
+		.setShort("-r")
+		.setDescription("Render on the cpu - this is also used if no OpenGL context could get created");
 	registerArg("--use-scene-camera")
 		.setShort("-c")
 		.setDescription("Use the first scene camera for rendering the thumbnail");
@@ -79,6 +82,13 @@ app::AppState Thumbnailer::onInit() {
 
 	if (state != app::AppState::Running) {
 		const bool fallback = hasArg("--fallback");
+		if (fallback || hasArg("--software")) {
+			// there is no OpenGL context - but we can still render the thumbnail on the cpu
+			Log::warn("Use the software renderer");
+			if (renderThumbnail(true)) {
+				return app::AppState::Cleanup;
+			}
+		}
 		if (fallback) {
 			_outfile = getArgVal("--output");
 			if (_outfile.empty()) {
@@ -133,22 +143,17 @@ static bool volumeTurntable(const core::String &fileName, const core::String &im
 	return voxelrender::volumeTurntable(sceneGraph, imageFile, ctx, loops);
 }
 
-app::AppState Thumbnailer::onRunning() {
-	app::AppState state = Super::onRunning();
-	if (state != app::AppState::Running) {
-		return state;
-	}
-
+bool Thumbnailer::renderThumbnail(bool softwareRenderer) {
 	const core::String infile = getArgVal("--input");
 	if (infile.empty()) {
 		Log::error("No input file given");
-		return app::AppState::InitFailure;
+		return false;
 	}
 
 	_outfile = getArgVal("--output");
 	if (_outfile.empty()) {
 		Log::error("No output file given");
-		return app::AppState::InitFailure;
+		return false;
 	}
 
 	Log::debug("infile: %s", infile.c_str());
@@ -157,7 +162,7 @@ app::AppState Thumbnailer::onRunning() {
 	_infile = filesystem()->open(infile, io::FileMode::SysRead);
 	if (!_infile->exists()) {
 		Log::error("Given input file '%s' does not exist", infile.c_str());
-		return app::AppState::InitFailure;
+		return false;
 	}
 
 	const int outputSize = core::string::toInt(getArgVal("--size"));
@@ -167,6 +172,7 @@ app::AppState Thumbnailer::onRunning() {
 	ctx.useSceneCamera = hasArg("--use-scene-camera");
 	ctx.distance = core::string::toFloat(getArgVal("--distance", "-1.0"));
 	ctx.cameraMode = getArgVal("--camera-mode", "free");
+	ctx.useSoftwareRenderer = softwareRenderer;
 	ctx.useWorldPosition = hasArg("--position");
 	if (ctx.useWorldPosition) {
 		const core::String &pos = getArgVal("--position");
@@ -185,16 +191,24 @@ app::AppState Thumbnailer::onRunning() {
 
 	const bool renderTurntable = hasArg("--turntable");
 	if (renderTurntable) {
-		volumeTurntable(_infile->name(), _outfile, ctx, 16);
-	} else {
-		const io::ArchivePtr &archive = io::openFilesystemArchive(_filesystem);
-		if (!archive) {
-			Log::error("Failed to open %s for reading", _infile->name().c_str());
-			return app::AppState::Cleanup;
-		}
-		const image::ImagePtr &image = volumeThumbnail(_infile->name(), archive, ctx);
-		saveImage(image);
+		return volumeTurntable(_infile->name(), _outfile, ctx, 16);
+	}
+	const io::ArchivePtr &archive = io::openFilesystemArchive(_filesystem);
+	if (!archive) {
+		Log::error("Failed to open %s for reading", _infile->name().c_str());
+		return false;
 	}
+	const image::ImagePtr &image = volumeThumbnail(_infile->name(), archive, ctx);
+	return saveImage(image);
+}
+
+app::AppState Thumbnailer::onRunning() {
+	app::AppState state = Super::onRunning();
+	if (state != app::AppState::Running) {
+		return state;
+	}
+
+	renderThumbnail(hasArg("--software"));
 
 	requestQuit();
 	return state;
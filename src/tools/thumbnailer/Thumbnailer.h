@@ -27,6 +27,11 @@ private:
 
 protected:
 	virtual bool saveImage(const image::ImagePtr &image);
+	/**
+	 * @brief Loads the input file and writes the thumbnail or the turntable images
+	 * @param softwareRenderer Render on the cpu - this works without an OpenGL context
+	 */
+	bool renderThumbnail(bool softwareRenderer);
 	void printUsageHeader() const override;
 
 public:
@@ -13,6 +13,7 @@
 #include "core/collection/DynamicArray.h"
 #include "core/collection/Set.h"
 #include "core/collection/StringSet.h"
+#include "core/concurrent/Atomic.h"
 #include "core/concurrent/Concurrency.h"
 #include "engine-git.h"
 #include "image/Image.h"
@@ -48,6 +49,7 @@
 
 #include <glm/gtc/quaternion.hpp>
 #include <glm/trigonometric.hpp>
+#include <thread>
 
 VoxConvert::VoxConvert(const io::FilesystemPtr &filesystem, const core::TimeProviderPtr &timeProvider)
 	: Super(filesystem, timeProvider, core::cpus()) {
@@ -57,6 +59,11 @@ VoxConvert::VoxConvert(const io::FilesystemPtr &filesystem, const core::TimeProv
 
 app::AppState VoxConvert::onConstruct() {
 	const app::AppState state = Super::onConstruct();
+	registerArg("--batch").setDescription(
+		"Convert each input file on its own into a file with the given extension - in parallel");
+	registerArg("--batch-memory")
+		.setDefaultValue("1024")
+		.setDescription("The memory in megabytes the running batch conversions may use");
 	registerArg("--crop").setDescription("Reduce the models to their real voxel sizes");
 	registerArg("--json").setDescription(
 		"Print the scene graph of the input file. Give full as argument to also get mesh details");
@@ -359,6 +366,9 @@ app::AppState VoxConvert::onInit() {
 	Log::info("* export palette:    - %s", (_exportPalette ? "true" : "false"));
 	Log::info("* export models:     - %s", (_exportModels ? "true" : "false"));
 	Log::info("* resize models:     - %s", (_resizeModels ? "true" : "false"));
+	if (hasArg("--batch")) {
+		Log::info("* batch:             - %s", getArgVal("--batch").c_str());
+	}
 
 	if (core::Var::getSafe(cfg::MetricFlavor)->strVal().empty()) {
 		Log::info(
@@ -366,6 +376,22 @@ app::AppState VoxConvert::onInit() {
 		Log::info("Example: '%s -set metric_flavor json --input xxx --output yyy'", fullAppname().c_str());
 	}
 
+	if (hasArg("--batch")) {
+		if (outfiles.size() > 1u) {
+			Log::error("Only one output directory is supported in batch mode");
+			return app::AppState::InitFailure;
+		}
+		if (_exportModels || _printSceneGraph) {
+			Log::error("--export-models and --json are not supported in batch mode");
+			return app::AppState::InitFailure;
+		}
+		const core::String outdir = outfiles.empty() ? "" : outfiles[0];
+		if (!batchConvert(infiles, outdir, scriptParameters)) {
+			return app::AppState::InitFailure;
+		}
+		return state;
+	}
+
 	if (!outfiles.empty()) {
 		if (!hasArg("--force")) {
 			for (const core::String &outfile : outfiles) {
@@ -460,30 +486,10 @@ app::AppState VoxConvert::onInit() {
 		return app::AppState::InitFailure;
 	}
 
-	const bool applyFilter = hasArg("--filter");
-	if (applyFilter) {
-		if (infiles.size() == 1u) {
-			filterModels(sceneGraph);
-		} else {
-			Log::warn("Don't apply model filters for multiple input files");
-		}
-	}
-
-	const bool applyFilterProperty = hasArg("--filter-property");
-	if (applyFilterProperty) {
-		if (infiles.size() == 1u) {
-			const core::String &property = getArgVal("--filter-property");
-			core::String key = property;
-			core::String value;
-			const size_t colonPos = property.find(":");
-			if (colonPos != core::String::npos) {
-				key = property.substr(0, colonPos);
-				value = property.substr(colonPos + 1);
-			}
-			filterModelsByProperty(sceneGraph, key, value);
-		} else {
-			Log::warn("Don't apply model property filters for multiple input files");
-		}
+	if (infiles.size() == 1u) {
+		applyFilters(sceneGraph);
+	} else if (hasArg("--filter") || hasArg("--filter-property")) {
+		Log::warn("Don't apply model filters for multiple input files");
 	}
 
 	if (_exportModels) {
@@ -501,19 +507,33 @@ app::AppState VoxConvert::onInit() {
 		return state;
 	}
 
+	if (!transform(sceneGraph, scriptParameters, infilesstr)) {
+		return app::AppState::InitFailure;
+	}
+
+	for (const core::String &outfile : outfiles) {
+		if (!save(sceneGraph, outfile)) {
+			return app::AppState::InitFailure;
+		}
+	}
+	return state;
+}
+
+bool VoxConvert::transform(scenegraph::SceneGraph &sceneGraph, const core::String &scriptParameters,
+						   const core::String &name) {
 	if (_mergeModels) {
 		Log::info("Merge models");
 		const scenegraph::SceneGraph::MergeResult &merged = sceneGraph.merge();
 		if (!merged.hasVolume()) {
 			Log::error("Failed to merge models");
-			return app::AppState::InitFailure;
+			return false;
 		}
 		sceneGraph.clear();
 		scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
 		node.setVolume(merged.volume(), true);
 		node.setPalette(merged.palette);
 		node.setNormalPalette(merged.normalPalette);
-		node.setName(infilesstr);
+		node.setName(name);
 		sceneGraph.emplace(core::move(node));
 	}
 
@@ -554,28 +574,30 @@ app::AppState VoxConvert::onInit() {
 		split(getArgIvec3("--split"), sceneGraph);
 	}
 
-	for (const core::String &outfile : outfiles) {
-		if (_exportPalette || (!io::isA(outfile, voxelformat::voxelSave()) && io::isA(outfile, palette::palettes()))) {
-			// if the given format is a palette only format (some voxel formats might have the same
-			// extension - so we check that here)
-			const palette::Palette &palette = sceneGraph.mergePalettes(false);
-			if (!palette.save(outfile.c_str())) {
-				Log::error("Failed to save palette to %s", outfile.c_str());
-				return app::AppState::InitFailure;
-			}
-			Log::info("Saved palette with %i colors to %s", palette.colorCount(), outfile.c_str());
-		} else {
-			Log::debug("Save %i models", (int)sceneGraph.size());
-			voxelformat::SaveContext saveCtx;
-			const io::ArchivePtr &archive = io::openFilesystemArchive(filesystem());
-			if (!voxelformat::saveFormat(sceneGraph, outfile, nullptr, archive, saveCtx)) {
-				Log::error("Failed to write to output file '%s'", outfile.c_str());
-				return app::AppState::InitFailure;
-			}
-			Log::info("Wrote output file %s", outfile.c_str());
+	return true;
+}
+
+bool VoxConvert::save(scenegraph::SceneGraph &sceneGraph, const core::String &outfile) {
+	if (_exportPalette || (!io::isA(outfile, voxelformat::voxelSave()) && io::isA(outfile, palette::palettes()))) {
+		// if the given format is a palette only format (some voxel formats might have the same
+		// extension - so we check that here)
+		const palette::Palette &palette = sceneGraph.mergePalettes(false);
+		if (!palette.save(outfile.c_str())) {
+			Log::error("Failed to save palette to %s", outfile.c_str());
+			return false;
 		}
+		Log::info("Saved palette with %i colors to %s", palette.colorCount(), outfile.c_str());
+		return true;
 	}
-	return state;
+	Log::debug("Save %i models", (int)sceneGraph.size());
+	voxelformat::SaveContext saveCtx;
+	const io::ArchivePtr &archive = io::openFilesystemArchive(filesystem());
+	if (!voxelformat::saveFormat(sceneGraph, outfile, nullptr, archive, saveCtx)) {
+		Log::error("Failed to write to output file '%s'", outfile.c_str());
+		return false;
+	}
+	Log::info("Wrote output file %s", outfile.c_str());
+	return true;
 }
 
 core::String VoxConvert::getFilenameForModelName(const core::String &inputfile, const core::String &modelName,
@@ -628,6 +650,232 @@ bool VoxConvert::handleInputFile(const core::String &infile, const io::ArchivePt
 	return true;
 }
 
+namespace {
+
+/**
+ * @brief Serializes the access to an archive that is shared between the batch conversion threads
+ */
+class LockedArchive : public io::Archive {
+private:
+	io::ArchivePtr _archive;
+	core_trace_mutex(core::Lock, _lock, "LockedArchive");
+
+public:
+	LockedArchive(const io::ArchivePtr &archive) : _archive(archive) {
+		_files = archive->files();
+	}
+
+	io::SeekableReadStream *readStream(const core::String &filePath) override {
+		core::ScopedLock lock(_lock);
+		return _archive->readStream(filePath);
+	}
+
+	io::SeekableWriteStream *writeStream(const core::String &filePath) override {
+		core::ScopedLock lock(_lock);
+		return _archive->writeStream(filePath);
+	}
+};
+
+static double millisSince(uint64_t start) {
+	const uint64_t delta = core::TimeProvider::highResTime() - start;
+	return (double)delta * 1000.0 / (double)core::TimeProvider::highResTimeResolution();
+}
+
+} // namespace
+
+bool VoxConvert::convertBatchJob(BatchJob &job, const core::String &scriptParameters) {
+	if (!hasArg("--force") && filesystem()->exists(job.outfile)) {
+		Log::error("Given output file '%s' already exists", job.outfile.c_str());
+		return false;
+	}
+
+	// the size of the input file is reserved as memory estimate for the decoding - this is corrected to the voxel
+	// memory of the scene graph once the file was loaded
+	size_t memory = (size_t)job.fileSize;
+	{
+		// don't start to decode another file as long as the running conversions would exceed the memory budget - but
+		// there is always at least one conversion running
+		core::ScopedLock lock(_batchLock);
+		_batchCondition.wait(_batchLock, [this, memory] {
+			return _batchMemory == 0u || _batchMemory + memory <= _batchMemoryLimit;
+		});
+		_batchMemory += memory;
+	}
+	auto releaseMemory = [this](size_t bytes) {
+		{
+			core::ScopedLock lock(_batchLock);
+			_batchMemory -= bytes;
+		}
+		_batchCondition.notify_all();
+	};
+
+	uint64_t start = core::TimeProvider::highResTime();
+	scenegraph::SceneGraph sceneGraph;
+	voxelformat::LoadContext loadCtx;
+	io::FileDescription fileDesc;
+	fileDesc.set(job.infile);
+	if (!voxelformat::loadFormat(fileDesc, job.archive, sceneGraph, loadCtx)) {
+		Log::error("Failed to load %s", job.infile.c_str());
+		releaseMemory(memory);
+		return false;
+	}
+	job.loadMillis = millisSince(start);
+
+	size_t voxelMemory = 0u;
+	for (auto iter = sceneGraph.beginModel(); iter != sceneGraph.end(); ++iter) {
+		const voxel::Region &region = (*iter).region();
+		job.voxels += region.voxels();
+		voxelMemory += (size_t)region.voxels() * sizeof(voxel::Voxel);
+	}
+	{
+		core::ScopedLock lock(_batchLock);
+		_batchMemory = _batchMemory - memory + voxelMemory;
+		memory = voxelMemory;
+	}
+	_batchCondition.notify_all();
+
+	start = core::TimeProvider::highResTime();
+	applyFilters(sceneGraph);
+	bool success = transform(sceneGraph, scriptParameters, core::string::extractFilename(job.infile));
+	job.transformMillis = millisSince(start);
+
+	if (success) {
+		start = core::TimeProvider::highResTime();
+		const core::String &outdir = core::string::extractDir(job.outfile);
+		if (!outdir.empty()) {
+			filesystem()->sysCreateDir(outdir);
+		}
+		success = save(sceneGraph, job.outfile);
+		job.saveMillis = millisSince(start);
+	}
+	sceneGraph.clear();
+
+	releaseMemory(memory);
+	return success;
+}
+
+bool VoxConvert::batchConvert(const core::DynamicArray<core::String> &infiles, const core::String &outdir,
+							  const core::String &scriptParameters) {
+	const core::String &ext = getArgVal("--batch");
+	if (ext.empty()) {
+		Log::error("Missing target extension for the batch conversion");
+		return false;
+	}
+	_batchMemoryLimit = (size_t)core_max(1, getArgVal("--batch-memory", "1024").toInt()) * 1024u * 1024u;
+	_batchMemory = 0u;
+
+	// the output file is written next to the input file or into the output directory by keeping the relative path
+	auto outputFile = [&](const core::String &infile, const core::String &relativePath) {
+		if (outdir.empty()) {
+			return core::string::replaceExtension(infile, ext);
+		}
+		return core::string::path(outdir, core::string::replaceExtension(relativePath, ext));
+	};
+
+	core::DynamicArray<BatchJob> jobs;
+	core::DynamicArray<io::FileStream *> archiveStreams;
+	const io::ArchivePtr &fsArchive = io::openFilesystemArchive(filesystem());
+	const core::String filter = getArgVal("--wildcard", "");
+	for (const core::String &infile : infiles) {
+		if (filesystem()->sysIsReadableDir(infile)) {
+			core::DynamicArray<io::FilesystemEntry> entities;
+			filesystem()->list(infile, entities, filter);
+			for (const io::FilesystemEntry &entry : entities) {
+				if (entry.type != io::FilesystemEntry::Type::file) {
+					continue;
+				}
+				BatchJob job;
+				job.infile = core::string::path(infile, entry.name);
+				job.archive = fsArchive;
+				job.fileSize = entry.size;
+				job.outfile = outputFile(job.infile, entry.name);
+				jobs.push_back(job);
+			}
+		} else if (io::isZipArchive(infile)) {
+			io::FileStream *archiveStream = new io::FileStream(filesystem()->open(infile, io::FileMode::SysRead));
+			archiveStreams.push_back(archiveStream);
+			io::ArchivePtr zipArchive = io::openZipArchive(archiveStream);
+			if (!zipArchive) {
+				Log::error("Failed to open archive %s", infile.c_str());
+				continue;
+			}
+			io::ArchivePtr archive = core::make_shared<LockedArchive>(zipArchive);
+			for (const auto &entry : archive->files()) {
+				if (!entry.isFile()) {
+					continue;
+				}
+				if (!io::isA(entry.name, voxelformat::voxelLoad())) {
+					continue;
+				}
+				if (!filter.empty() && !core::string::fileMatchesMultiple(entry.name.c_str(), filter.c_str())) {
+					continue;
+				}
+				BatchJob job;
+				job.infile = entry.fullPath;
+				job.archive = archive;
+				job.fileSize = entry.size;
+				job.outfile = outputFile(filesystem()->homeWritePath(entry.fullPath), entry.fullPath);
+				jobs.push_back(job);
+			}
+		} else {
+			BatchJob job;
+			job.infile = infile;
+			job.archive = fsArchive;
+			const io::FilePtr &file = filesystem()->open(infile, io::FileMode::SysRead);
+			job.fileSize = (uint64_t)core_max(0l, file->length());
+			job.outfile = outputFile(infile, core::string::extractFilenameWithExtension(infile));
+			jobs.push_back(job);
+		}
+	}
+
+	// the conversions run on their own threads - the formats are using the thread pool and are waiting for their
+	// tasks, which would dead lock if all pool workers were busy with conversions
+	const int jobCount = (int)jobs.size();
+	const int threadCount = core_min(jobCount, (int)core::cpus());
+	Log::info("Convert %i files with %i threads", jobCount, threadCount);
+	const uint64_t start = core::TimeProvider::highResTime();
+	core::AtomicInt nextJob{0};
+	auto worker = [&]() {
+		for (;;) {
+			const int jobIdx = nextJob.increment(1);
+			if (jobIdx >= jobCount || shouldQuit()) {
+				return;
+			}
+			BatchJob &job = jobs[jobIdx];
+			job.success = convertBatchJob(job, scriptParameters);
+		}
+	};
+	core::DynamicArray<std::thread> threads;
+	threads.reserve(threadCount);
+	for (int i = 1; i < threadCount; ++i) {
+		threads.emplace_back(worker);
+	}
+	worker();
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+	const double totalMillis = millisSince(start);
+	for (io::FileStream *archiveStream : archiveStreams) {
+		delete archiveStream;
+	}
+
+	Log::info("%-50s %10s %10s %10s %12s %s", "file", "load ms", "change ms", "save ms", "voxels", "state");
+	int failed = 0;
+	int64_t voxels = 0;
+	for (const BatchJob &job : jobs) {
+		Log::info("%-50s %10.2f %10.2f %10.2f %12i %s", core::string::extractFilenameWithExtension(job.infile).c_str(),
+				  job.loadMillis, job.transformMillis, job.saveMillis, job.voxels, job.success ? "ok" : "failed");
+		if (!job.success) {
+			++failed;
+		}
+		voxels += job.voxels;
+	}
+	const double seconds = core_max(totalMillis / 1000.0, 0.001);
+	Log::info("Converted %i of %i files in %.2fs (%.2f files/s, %.0f voxels/s)", jobCount - failed, jobCount, seconds,
+			  (double)(jobCount - failed) / seconds, (double)voxels / seconds);
+	return jobCount > 0 && failed == 0;
+}
+
 static bool hasUniqueModelNames(const scenegraph::SceneGraph &sceneGraph) {
 	core::StringSet names;
 	for (const auto &entry : sceneGraph.nodes()) {
@@ -964,6 +1212,23 @@ void VoxConvert::resize(const glm::ivec3 &size, scenegraph::SceneGraph &sceneGra
 	}
 }
 
+void VoxConvert::applyFilters(scenegraph::SceneGraph &sceneGraph) {
+	if (hasArg("--filter")) {
+		filterModels(sceneGraph);
+	}
+	if (hasArg("--filter-property")) {
+		const core::String &property = getArgVal("--filter-property");
+		core::String key = property;
+		core::String value;
+		const size_t colonPos = property.find(":");
+		if (colonPos != core::String::npos) {
+			key = property.substr(0, colonPos);
+			value = property.substr(colonPos + 1);
+		}
+		filterModelsByProperty(sceneGraph, key, value);
+	}
+}
+
 void VoxConvert::filterModels(scenegraph::SceneGraph &sceneGraph) {
 	const core::String &filter = getArgVal("--filter");
 	if (filter.empty()) {
@@ -5,6 +5,8 @@
 #pragma once
 
 #include "app/CommandlineApp.h"
+#include "core/concurrent/ConditionVariable.h"
+#include "core/concurrent/Lock.h"
 #include "io/Archive.h"
 #include "scenegraph/SceneGraph.h"
 
@@ -60,6 +62,34 @@ private:
 			return *this;
 		}
 	};
+
+	/**
+	 * @brief A single input to output conversion of the batch mode
+	 */
+	struct BatchJob {
+		core::String infile;
+		/** the size of the input file - used as memory estimate while the file is decoded */
+		uint64_t fileSize = 0u;
+		io::ArchivePtr archive;
+		core::String outfile;
+
+		bool success = false;
+		int voxels = 0;
+		double loadMillis = 0.0;
+		double transformMillis = 0.0;
+		double saveMillis = 0.0;
+	};
+
+	// the voxel memory of the scene graphs of the running batch conversions
+	core_trace_mutex(core::Lock, _batchLock, "BatchConvert");
+	core::ConditionVariable _batchCondition;
+	size_t _batchMemory = 0u;
+	size_t _batchMemoryLimit = 0u;
+
+	bool convertBatchJob(BatchJob &job, const core::String &scriptParameters);
+	bool batchConvert(const core::DynamicArray<core::String> &infiles, const core::String &outdir,
+					  const core::String &scriptParameters);
+
 protected:
 	glm::ivec3 getArgIvec3(const core::String &name);
 	core::String getFilenameForModelName(const core::String &inputfile, const core::String &modelName,
@@ -80,10 +110,13 @@ protected:
 	void removeNonSurfaceVoxels(scenegraph::SceneGraph& sceneGraph);
 	NodeStats sceneGraphJsonNode_r(const scenegraph::SceneGraph& sceneGraph, int nodeId, bool printMeshDetails) const;
 	void sceneGraphJson(const scenegraph::SceneGraph& sceneGraph, bool printMeshDetails) const;
+	void applyFilters(scenegraph::SceneGraph& sceneGraph);
 	void filterModels(scenegraph::SceneGraph& sceneGraph);
 	void filterModelsByProperty(scenegraph::SceneGraph& sceneGraph, const core::String &property, const core::String &value);
 	void exportModelsIntoSingleObjects(scenegraph::SceneGraph& sceneGraph, const core::String &inputfile, const core::String &ext);
 	void split(const glm::ivec3 &size, scenegraph::SceneGraph& sceneGraph);
+	bool transform(scenegraph::SceneGraph &sceneGraph, const core::String &scriptParameters, const core::String &name);
+	bool save(scenegraph::SceneGraph &sceneGraph, const core::String &outfile);
 public:
 	VoxConvert(const io::FilesystemPtr& filesystem, const core::TimeProviderPtr& timeProvider);
 
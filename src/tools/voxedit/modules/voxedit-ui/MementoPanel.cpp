@@ -30,7 +30,11 @@ static void stateTooltip(const memento::MementoState &state) {
 		ImGui::Text(" - type: %s", scenegraph::SceneGraphNodeTypeStr[(int)state.nodeType]);
 		ImGui::Text(" - volume: %s", state.data.hasVolume() ? "volume" : "empty");
 		ImGui::Text(" - region: mins(%i:%i:%i)/maxs(%i:%i:%i)", mins.x, mins.y, mins.z, maxs.x, maxs.y, maxs.z);
-		ImGui::Text(" - size: %ib", (int)state.data.size());
+		const glm::ivec3 &modifiedMins = state.data.modifiedRegion().getLowerCorner();
+		const glm::ivec3 &modifiedMaxs = state.data.modifiedRegion().getUpperCorner();
+		ImGui::Text(" - modified region: mins(%i:%i:%i)/maxs(%i:%i:%i)", modifiedMins.x, modifiedMins.y,
+					modifiedMins.z, modifiedMaxs.x, modifiedMaxs.y, modifiedMaxs.z);
+		ImGui::Text(" - size: %ib", (int)state.data.memory());
 		ImGui::Text(" - palette: %s", palHash.c_str());
 		ImGui::Text(" - pivot: %f:%f:%f", state.pivot.x, state.pivot.y, state.pivot.z);
 		const scenegraph::SceneGraphKeyFramesMap &keyFrames = state.keyFrames;
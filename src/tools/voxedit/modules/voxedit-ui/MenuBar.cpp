@@ -30,7 +30,7 @@ void MenuBar::viewportOptions() {
 	ImGui::IconCheckboxVar(ICON_LC_FRAME, _("Plane"), cfg::VoxEditShowPlane);
 	ImGui::IconSliderVarInt(ICON_LC_GRIP, _("Plane size"), cfg::VoxEditPlaneSize, 0, 1000);
 
-	ImGui::BeginDisabled(core::Var::get(cfg::VoxelMeshMode)->intVal() != (int)voxel::SurfaceExtractionType::Cubic);
+	ImGui::BeginDisabled(!voxel::isCubicMesh((voxel::SurfaceExtractionType)core::Var::get(cfg::VoxelMeshMode)->intVal()));
 	ImGui::IconCheckboxVar(ICON_LC_BOX, _("Outlines"), cfg::RenderOutline);
 	if (core::Var::getSafe(cfg::VoxEditViewMode)->intVal() == (int)ViewMode::CommandAndConquer) {
 		ImGui::IconCheckboxVar(ICON_LC_BOX, _("Normals"), cfg::RenderNormals);
@@ -122,7 +122,7 @@ bool MenuBar::update(ui::IMGUIApp *app, command::CommandExecutionListener &liste
 				_app->languageOption();
 
 				static const core::Array<core::String, (int)voxel::SurfaceExtractionType::Max> meshModes = {
-					_("Cubes"), _("Marching cubes")};
+					_("Cubes"), _("Marching cubes"), _("Binary cubes")};
 				ImGui::ComboVar(_("Mesh mode"), cfg::VoxelMeshMode, meshModes);
 				ImGui::InputVarInt(_("Model animation speed"), cfg::VoxEditAnimationSpeed);
 				ImGui::InputVarInt(_("Autosave delay in seconds"), cfg::VoxEditAutoSaveSeconds);
@@ -150,9 +150,9 @@ void Viewport::dragAndDrop(float headerSize) {
 					ModifierFacade &modifier = _sceneMgr->modifier();
 					modifier.setCursorVoxel(voxel::createVoxel(node->palette(), dragPalIdx));
 					modifier.start();
-					auto callback = [nodeId, this](const voxel::Region &region, ModifierType type, bool markUndo) {
+					auto callback = [nodeId, this](const voxel::DirtyRegions &dirtyRegions, ModifierType type, bool markUndo) {
 						if (type != ModifierType::Select && type != ModifierType::ColorPicker) {
-							_sceneMgr->modified(nodeId, region, markUndo);
+							_sceneMgr->modified(nodeId, dirtyRegions, markUndo);
 						}
 					};
 					modifier.execute(_sceneMgr->sceneGraph(), *node, callback);
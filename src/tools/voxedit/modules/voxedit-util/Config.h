@@ -25,6 +25,7 @@ constexpr const char *VoxEditLastPalette = "ve_lastpalette";
 constexpr const char *VoxEditViewMode = "ve_viewmode";
 constexpr const char *VoxEditViewports = "ve_viewports";
 constexpr const char *VoxEditMaxSuggestedVolumeSize = "ve_maxsuggestedvolumesize";
+constexpr const char *VoxEditMaxUndoMemory = "ve_maxundomemory";
 constexpr const char *VoxEditTipOftheDay = "ve_tipoftheday";
 constexpr const char *VoxEditPopupSceneSettings = "ve_popupscenesettings";
 constexpr const char *VoxEditPopupTipOfTheDay = "ve_popuptipoftheday";
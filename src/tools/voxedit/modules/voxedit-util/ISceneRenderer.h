@@ -35,6 +35,13 @@ public:
 	}
 	virtual void updateNodeRegion(int nodeId, const voxel::Region &region, uint64_t renderRegionMillis = 0) {
 	}
+	/**
+	 * @brief Schedules the extraction of several disjoint regions of a node at once
+	 * @param bounds The bounding box of all regions - this is highlighted
+	 */
+	virtual void updateNodeRegions(int nodeId, const voxel::Region &bounds, const voxel::Region *regions,
+								   size_t regionCount, uint64_t renderRegionMillis = 0) {
+	}
 	virtual void updateGridRegion(const voxel::Region &region) {
 	}
 	virtual bool isVisible(int nodeId, bool hideEmpty = true) const {
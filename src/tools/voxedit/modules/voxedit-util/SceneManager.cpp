@@ -180,7 +180,7 @@ bool SceneManager::calculateNormals(int nodeId, voxel::Connectivity connectivity
 		if (fillAndHollow) {
 			voxelutil::hollow(wrapper);
 		}
-		modified(nodeId, wrapper.dirtyRegion());
+		modified(nodeId, wrapper.dirtyRegions());
 		return true;
 	}
 
@@ -256,7 +256,7 @@ void SceneManager::fillHollow() {
 		}
 		voxel::RawVolumeWrapper wrapper = _modifierFacade.createRawVolumeWrapper(v);
 		voxelutil::fillHollow(wrapper, _modifierFacade.cursorVoxel());
-		modified(groupNodeId, wrapper.dirtyRegion());
+		modified(groupNodeId, wrapper.dirtyRegions());
 	});
 }
 
@@ -272,7 +272,7 @@ void SceneManager::fill() {
 		}
 		voxel::RawVolumeWrapper wrapper = _modifierFacade.createRawVolumeWrapper(v);
 		voxelutil::fill(wrapper, _modifierFacade.cursorVoxel(), _modifierFacade.isMode(ModifierType::Override));
-		modified(groupNodeId, wrapper.dirtyRegion());
+		modified(groupNodeId, wrapper.dirtyRegions());
 	});
 }
 
@@ -288,7 +288,7 @@ void SceneManager::clear() {
 		}
 		voxel::RawVolumeWrapper wrapper = _modifierFacade.createRawVolumeWrapper(v);
 		voxelutil::clear(wrapper);
-		modified(groupNodeId, wrapper.dirtyRegion());
+		modified(groupNodeId, wrapper.dirtyRegions());
 	});
 }
 
@@ -304,7 +304,7 @@ void SceneManager::hollow() {
 		}
 		voxel::RawVolumeWrapper wrapper = _modifierFacade.createRawVolumeWrapper(v);
 		voxelutil::hollow(wrapper);
-		modified(groupNodeId, wrapper.dirtyRegion());
+		modified(groupNodeId, wrapper.dirtyRegions());
 	});
 }
 
@@ -322,7 +322,7 @@ void SceneManager::fillPlane(const image::ImagePtr &image) {
 	const voxel::FaceNames face = _modifierFacade.cursorFace();
 	const voxel::Voxel hitVoxel/* = hitCursorVoxel()*/; // TODO: should be an option
 	voxelutil::fillPlane(wrapper, image, hitVoxel, pos, face);
-	modified(nodeId, wrapper.dirtyRegion());
+	modified(nodeId, wrapper.dirtyRegions());
 }
 
 void SceneManager::nodeUpdateVoxelType(int nodeId, uint8_t palIdx, voxel::VoxelType newType) {
@@ -337,7 +337,7 @@ void SceneManager::nodeUpdateVoxelType(int nodeId, uint8_t palIdx, voxel::VoxelT
 		}
 		wrapper.setVoxel(x, y, z, voxel::createVoxel(newType, palIdx));
 	});
-	modified(nodeId, wrapper.dirtyRegion());
+	modified(nodeId, wrapper.dirtyRegions());
 }
 
 bool SceneManager::saveModels(const core::String& dir) {
@@ -514,21 +514,42 @@ bool SceneManager::supportsEditMode() const {
 	return node.isModelNode();
 }
 
-void SceneManager::modified(int nodeId, const voxel::Region& modifiedRegion, bool markUndo, uint64_t renderRegionMillis) {
+void SceneManager::modifiedRegions(int nodeId, const voxel::Region &bounds, const voxel::Region *regions,
+								   size_t regionCount, bool markUndo, uint64_t renderRegionMillis) {
 	Log::debug("Modified node %i, record undo state: %s", nodeId, markUndo ? "true" : "false");
-	voxel::logRegion("Modified", modifiedRegion);
+	voxel::logRegion("Modified", bounds);
 	if (markUndo) {
 		scenegraph::SceneGraphNode &node = _sceneGraph.node(nodeId);
-		_mementoHandler.markModification(_sceneGraph, node, modifiedRegion);
+		_mementoHandler.markModification(_sceneGraph, node, bounds);
 	}
-	if (modifiedRegion.isValid()) {
+	if (bounds.isValid()) {
 		Log::debug("Modify region for nodeid %i", nodeId);
-		_sceneRenderer->updateNodeRegion(nodeId, modifiedRegion, renderRegionMillis);
+		const scenegraph::SceneGraphNode *node = sceneGraphNode(nodeId);
+		const bool traced = node != nullptr && _sceneGraph.resolveVolume(*node) == _traceOccupancy.volume();
+		if (regionCount == 1u) {
+			_sceneRenderer->updateNodeRegion(nodeId, regions[0], renderRegionMillis);
+		} else {
+			_sceneRenderer->updateNodeRegions(nodeId, bounds, regions, regionCount, renderRegionMillis);
+		}
+		if (traced) {
+			for (size_t i = 0; i < regionCount; ++i) {
+				_traceOccupancy.markDirty(regions[i]);
+			}
+		}
 	}
 	markDirty();
 	resetLastTrace();
 }
 
+void SceneManager::modified(int nodeId, const voxel::Region& modifiedRegion, bool markUndo, uint64_t renderRegionMillis) {
+	modifiedRegions(nodeId, modifiedRegion, &modifiedRegion, 1, markUndo, renderRegionMillis);
+}
+
+void SceneManager::modified(int nodeId, const voxel::DirtyRegions &dirtyRegions, bool markUndo) {
+	const core::DynamicArray<voxel::Region> &regions = dirtyRegions.regions();
+	modifiedRegions(nodeId, dirtyRegions.bounds(), regions.data(), regions.size(), markUndo, 0);
+}
+
 void SceneManager::colorToNewNode(const voxel::Voxel voxelColor) {
 	const int nodeId = _sceneGraph.activeNode();
 	scenegraph::SceneGraphNode &node = _sceneGraph.node(nodeId);
@@ -545,7 +566,7 @@ void SceneManager::colorToNewNode(const voxel::Voxel voxelColor) {
 			wrapper.setVoxel(x, y, z, voxel::Voxel());
 		}
 	});
-	modified(nodeId, wrapper.dirtyRegion());
+	modified(nodeId, wrapper.dirtyRegions());
 	scenegraph::SceneGraphNode newNode(scenegraph::SceneGraphNodeType::Model);
 	copyNode(node, newNode, false, true);
 	newNode.setVolume(newVolume, true);
@@ -830,7 +851,7 @@ bool SceneManager::mementoModification(const memento::MementoState& s) {
 		}
 		node->setName(s.name);
 		node->setPalette(s.palette);
-		modified(node->id(), s.data.region(), false);
+		modified(node->id(), s.data.modifiedRegion(), false);
 		return true;
 	}
 	Log::warn("Failed to handle memento state - node id %s not found (%s)", s.nodeUUID.c_str(), s.name.c_str());
@@ -1225,6 +1246,8 @@ void SceneManager::resetSceneState() {
 	_mementoHandler.markInitialSceneState(_sceneGraph);
 	_dirty = false;
 	_result = voxelutil::PickResult();
+	_traceOccupancy.setVolume(nullptr);
+	_scenePickingDirty = true;
 	_modifierFacade.setCursorVoxel(voxel::createVoxel(node.palette(), 0));
 	setCursorPosition(cursorPosition(), voxel::FaceNames::Max, true);
 	setReferencePosition(node.region().getCenter());
@@ -1417,6 +1440,8 @@ bool SceneManager::setSceneGraphNodeVolume(scenegraph::SceneGraphNode &node, vox
 	node.setVolume(volume, true);
 	// the old volume pointer might no longer be used
 	_sceneRenderer->removeNode(node.id());
+	_traceOccupancy.setVolume(nullptr);
+	_scenePickingDirty = true;
 
 	const voxel::Region& region = volume->region();
 	_sceneRenderer->updateGridRegion(region);
@@ -1573,6 +1598,7 @@ void SceneManager::construct() {
 	_movementSpeed = core::Var::get(cfg::VoxEditMovementSpeed, "180.0f");
 	_transformUpdateChildren = core::Var::get(cfg::VoxEditTransformUpdateChildren, "true", -1, _("Update the children of a node when the transform of the node changes"));
 	_maxSuggestedVolumeSize = core::Var::getSafe(cfg::VoxEditMaxSuggestedVolumeSize);
+	_maxUndoMemory = core::Var::getSafe(cfg::VoxEditMaxUndoMemory);
 
 	command::Command::registerCommand("resizetoselection", [&](const command::CmdArgs &args) {
 		const voxel::Region &region = modifier().selectionMgr().region();
@@ -2397,6 +2423,7 @@ bool SceneManager::init() {
 
 	voxel::Region maxUndoRegion(0, _maxSuggestedVolumeSize->intVal() - 1);
 	_mementoHandler.setMaxUndoRegion(maxUndoRegion);
+	_mementoHandler.setMaxMemory((size_t)_maxUndoMemory->intVal() * 1024u * 1024u);
 
 	_modifierFacade.setLockedAxis(math::Axis::None, true);
 	return true;
@@ -2502,6 +2529,11 @@ bool SceneManager::update(double nowSeconds) {
 		_maxSuggestedVolumeSize->markClean();
 	}
 
+	if (_maxUndoMemory->isDirty()) {
+		_mementoHandler.setMaxMemory((size_t)_maxUndoMemory->intVal() * 1024u * 1024u);
+		_maxUndoMemory->markClean();
+	}
+
 	_movement.update(nowSeconds);
 	voxelgenerator::ScriptState state = _luaApi.update(nowSeconds);
 	if (state == voxelgenerator::ScriptState::Error) {
@@ -2509,9 +2541,9 @@ bool SceneManager::update(double nowSeconds) {
 		_mementoHandler.endGroup();
 		Log::error("Error in script: %s", _luaApi.error().c_str());
 	} else if (state == voxelgenerator::ScriptState::Finished) {
-		const voxel::Region dirtyRegion = _luaApi.dirtyRegion();
-		if (dirtyRegion.isValid()) {
-			modified(activeNode(), dirtyRegion, true);
+		const voxel::DirtyRegions &dirtyRegions = _luaApi.dirtyRegions();
+		if (!dirtyRegions.empty()) {
+			modified(activeNode(), dirtyRegions, true);
 		}
 		if (_sceneGraph.dirty()) {
 			markDirty();
@@ -2606,7 +2638,7 @@ void SceneManager::lsystem(const core::String &axiom, const core::DynamicArray<v
 	}
 	voxel::RawVolumeWrapper wrapper(v);
 	voxelgenerator::lsystem::generate(wrapper, referencePosition(), axiom, rules, angle, length, width, widthIncrement, iterations, random, leavesRadius);
-	modified(nodeId, wrapper.dirtyRegion());
+	modified(nodeId, wrapper.dirtyRegions());
 }
 
 void SceneManager::createTree(const voxelgenerator::TreeContext& ctx) {
@@ -2618,7 +2650,7 @@ void SceneManager::createTree(const voxelgenerator::TreeContext& ctx) {
 	}
 	voxel::RawVolumeWrapper wrapper(v);
 	voxelgenerator::tree::createTree(wrapper, ctx, random);
-	modified(nodeId, wrapper.dirtyRegion());
+	modified(nodeId, wrapper.dirtyRegions());
 }
 
 void SceneManager::setReferencePosition(const glm::ivec3& pos) {
@@ -2708,38 +2740,58 @@ bool SceneManager::trace(bool sceneMode, bool force) {
 	return mouseRayTrace(force);
 }
 
+void SceneManager::updateScenePicking() {
+	const scenegraph::FrameTransformsPtr &transforms = _sceneGraph.transformsForFrame(_currentFrameIdx);
+	if (!_scenePickingDirty && _scenePickingTransforms.get() == transforms.get()) {
+		return;
+	}
+	core_trace_scoped(UpdateScenePicking);
+	core::DynamicArray<ScenePickEntry> entries;
+	entries.reserve(_sceneGraph.nodes().size());
+	for (auto entry : _sceneGraph.nodes()) {
+		const scenegraph::SceneGraphNode &node = entry->second;
+		if (!node.isAnyModelNode()) {
+			continue;
+		}
+		const voxel::Region &region = _sceneGraph.resolveRegion(node);
+		const glm::vec3 pivot = node.pivot();
+		const scenegraph::FrameTransform &transform = (*transforms.get())[node.id()];
+		const math::OBB<float> &obb = scenegraph::toOBB(true, region, pivot, transform);
+		math::AABB<float> aabb = scenegraph::toAABB(obb);
+		// don't lose hits at the edges due to rounding errors
+		aabb.grow(0.01f);
+		entries.push_back({node.id(), obb, aabb});
+	}
+	_scenePicking.build(entries);
+	_scenePickingTransforms = transforms;
+	_scenePickingDirty = false;
+}
+
 int SceneManager::traceScene() {
 	const int previousNodeId = activeNode();
 	int nodeId = InvalidNodeId;
 	core_trace_scoped(EditorSceneOnProcessUpdateRay);
-	float intersectDist = _camera->farPlane();
+	updateScenePicking();
 	const math::Ray& ray = _camera->mouseRay(_mouseCursor);
-	for (auto entry : _sceneGraph.nodes()) {
-		const scenegraph::SceneGraphNode& node = entry->second;
-		if (previousNodeId == node.id()) {
-			continue;
-		}
-		if (!node.isAnyModelNode()) {
-			continue;
+	_scenePicking.intersect(ray.origin, ray.direction, _camera->farPlane(), [&](const ScenePickEntry &entry, float &intersectDist) {
+		if (previousNodeId == entry.nodeId) {
+			return;
 		}
-		if (!node.visible()) {
-			continue;
+		const scenegraph::SceneGraphNode *node = sceneGraphNode(entry.nodeId);
+		if (node == nullptr || !node->visible()) {
+			return;
 		}
-		if (!_sceneRenderer->isVisible(node.id(), false)) {
-			continue;
+		if (!_sceneRenderer->isVisible(entry.nodeId, false)) {
+			return;
 		}
 		float distance = 0.0f;
-		const voxel::Region& region = _sceneGraph.resolveRegion(node);
-		const glm::vec3 pivot = node.pivot();
-		const scenegraph::FrameTransform &transform = _sceneGraph.transformForFrame(node, _currentFrameIdx);
-		const math::OBB<float>& obb = scenegraph::toOBB(true, region, pivot, transform);
-		if (obb.intersect(ray.origin, ray.direction, distance)) {
+		if (entry.obb.intersect(ray.origin, ray.direction, distance)) {
 			if (distance < intersectDist) {
 				intersectDist = distance;
-				nodeId = node.id();
+				nodeId = entry.nodeId;
 			}
 		}
-	}
+	});
 	Log::debug("Hovered node: %i", nodeId);
 	return nodeId;
 }
@@ -2813,7 +2865,7 @@ bool SceneManager::mouseRayTrace(bool force) {
 	const math::Axis lockedAxis = _modifierFacade.lockedAxis();
 	// TODO: we could optionally limit the raycast to the selection
 
-	voxelutil::raycastWithDirection(v, ray.origin, dirWithLength, [&] (voxel::RawVolume::Sampler& sampler) {
+	auto callback = [&] (voxel::RawVolume::Sampler& sampler) {
 		if (!_result.firstValidPosition && sampler.currentPositionValid()) {
 			_result.firstPosition = sampler.position();
 			_result.firstValidPosition = true;
@@ -2855,7 +2907,15 @@ bool SceneManager::mouseRayTrace(bool force) {
 			return false;
 		}
 		return true;
-	});
+	};
+
+	if (lockedAxis == math::Axis::None) {
+		// only the first hit and the voxels in front of it are relevant - the empty bricks can be skipped
+		voxelutil::raycastWithDirection(v, _traceOccupancy, ray.origin, dirWithLength, callback);
+	} else {
+		// the trace must stop at the plane of the locked axis - every voxel must be visited
+		voxelutil::raycastWithDirection(v, ray.origin, dirWithLength, callback);
+	}
 
 	if (_result.firstInvalidPosition) {
 		_result.hitFace = voxel::raycastFaceDetection(ray.origin, ray.direction, _result.hitVoxel, 0.0f, 1.0f);
@@ -3278,6 +3338,7 @@ bool SceneManager::exceedsMaxSuggestedVolumeSize() const {
 
 void SceneManager::markDirty() {
 	_sceneGraph.markMaxFramesDirty();
+	_scenePickingDirty = true;
 	// we only autosave if the volumes in the scene graph are not exceeding the
 	// max suggested voxel count
 	_needAutoSave = !exceedsMaxSuggestedVolumeSize();
@@ -3314,6 +3375,8 @@ bool SceneManager::nodeRemove(scenegraph::SceneGraphNode &node, bool recursive)
 		return false;
 	}
 	_sceneRenderer->removeNode(nodeId);
+	// the volume of the node might have been deleted
+	_traceOccupancy.setVolume(nullptr);
 	if (_sceneGraph.empty()) {
 		const voxel::Region region(glm::ivec3(0), glm::ivec3(31));
 		scenegraph::SceneGraphNode newNode(scenegraph::SceneGraphNodeType::Model);
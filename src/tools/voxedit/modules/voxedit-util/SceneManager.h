@@ -14,12 +14,15 @@
 #include "core/collection/DynamicArray.h"
 #include "io/Filesystem.h"
 #include "io/FormatDescription.h"
+#include "math/BVH.h"
+#include "math/OBB.h"
 #include "modifier/ModifierFacade.h"
 #include "scenegraph/SceneGraph.h"
 #include "scenegraph/SceneGraphAnimation.h"
 #include "util/Movement.h"
 #include "voxedit-util/Clipboard.h"
 #include "voxedit-util/modifier/IModifierRenderer.h"
+#include "voxel/DirtyRegions.h"
 #include "voxel/Face.h"
 #include "voxel/RawVolume.h"
 #include "voxel/Voxel.h"
@@ -27,6 +30,7 @@
 #include "voxelgenerator/LSystem.h"
 #include "voxelgenerator/LUAApi.h"
 #include "voxelgenerator/TreeContext.h"
+#include "voxelutil/BrickOccupancy.h"
 #include "voxelutil/Picking.h"
 #include "LUAApiListener.h"
 #include <functional>
@@ -82,6 +86,7 @@ protected:
 	core::VarPtr _movementSpeed;
 	core::VarPtr _transformUpdateChildren;
 	core::VarPtr _maxSuggestedVolumeSize;
+	core::VarPtr _maxUndoMemory;
 
 	bool _dirty = false;
 	// this is basically the same as the dirty state, but we stop
@@ -120,6 +125,22 @@ protected:
 	command::ActionButton _zoomOut;
 
 	voxelutil::PickResult _result;
+	// the empty bricks of the volume that is traced in mouseRayTrace() - see modified()
+	voxelutil::BrickOccupancy _traceOccupancy;
+
+	struct ScenePickEntry {
+		int nodeId;
+		math::OBB<float> obb;
+		math::AABB<float> bounds;
+
+		inline const math::AABB<float> &aabb() const {
+			return bounds;
+		}
+	};
+	// the model nodes for traceScene() - rebuilt if the transforms of the current frame or the scene changed
+	math::BVH<ScenePickEntry> _scenePicking;
+	scenegraph::FrameTransformsPtr _scenePickingTransforms;
+	bool _scenePickingDirty = true;
 
 	/**
 	 * @note This might return @c nullptr in the case where the active node is no model node
@@ -148,6 +169,13 @@ protected:
 	bool mouseRayTrace(bool force);
 	void updateCursor();
 	int traceScene();
+	void updateScenePicking();
+	/**
+	 * @brief Records the undo state for the given bounds and schedules the given regions for the mesh extraction
+	 * @sa modified()
+	 */
+	void modifiedRegions(int nodeId, const voxel::Region &bounds, const voxel::Region *regions, size_t regionCount,
+						 bool markUndo, uint64_t renderRegionMillis);
 
 protected:
 	bool setSceneGraphNodeVolume(scenegraph::SceneGraphNode &node, voxel::RawVolume *volume);
@@ -261,6 +289,10 @@ public:
 
 	void modified(int nodeId, const voxel::Region &modifiedRegion, bool markUndo = true,
 				  uint64_t renderRegionMillis = 0);
+	/**
+	 * @brief Only the modified cells are scheduled for the mesh extraction - the undo state gets the bounding box
+	 */
+	void modified(int nodeId, const voxel::DirtyRegions &dirtyRegions, bool markUndo = true);
 	voxel::RawVolume *volume(int nodeId);
 	const voxel::RawVolume *volume(int nodeId) const;
 	palette::Palette &activePalette() const;
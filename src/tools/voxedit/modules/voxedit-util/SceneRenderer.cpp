@@ -117,6 +117,18 @@ void SceneRenderer::updateNodeRegion(int nodeId, const voxel::Region &region, ui
 	_highlightRegion = TimedRegion(region, timeProvider->tickNow(), renderRegionMillis);
 }
 
+void SceneRenderer::updateNodeRegions(int nodeId, const voxel::Region &bounds, const voxel::Region *regions,
+									  size_t regionCount, uint64_t renderRegionMillis) {
+	// the regions don't overlap each other - an extraction of a region that is already queued is cheap compared to
+	// comparing every region with the whole queue
+	_extractRegions.reserve(_extractRegions.size() + regionCount);
+	for (size_t i = 0; i < regionCount; ++i) {
+		_extractRegions.push_back({regions[i], nodeId});
+	}
+	const core::TimeProviderPtr &timeProvider = app::App::getInstance()->timeProvider();
+	_highlightRegion = TimedRegion(bounds, timeProvider->tickNow(), renderRegionMillis);
+}
+
 /**
  * @brief Return the real model node, not the reference
  */
@@ -74,6 +74,8 @@ public:
 	void updateLockedPlanes(math::Axis lockedAxis, const scenegraph::SceneGraph &sceneGraph,
 							const glm::ivec3 &cursorPosition) override;
 	void updateNodeRegion(int nodeId, const voxel::Region &region, uint64_t renderRegionMillis = 0) override;
+	void updateNodeRegions(int nodeId, const voxel::Region &bounds, const voxel::Region *regions, size_t regionCount,
+						   uint64_t renderRegionMillis = 0) override;
 	void updateGridRegion(const voxel::Region &region) override;
 	void removeNode(int nodeId) override;
 	bool isVisible(int nodeId, bool hideEmpty = true) const override;
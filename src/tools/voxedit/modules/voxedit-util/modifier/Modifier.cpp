@@ -358,7 +358,12 @@ bool Modifier::executeBrush(scenegraph::SceneGraph &sceneGraph, scenegraph::Scen
 							ModifierType modifierType, const voxel::Voxel &voxel,
 							const ModifiedRegionCallback &callback) {
 	if (Brush *brush = currentBrush()) {
-		ModifierVolumeWrapper wrapper(node, modifierType, _selectionManager.selections());
+		// the select brush extends the selection and must not be limited by it
+		const SelectionMask *selectionMask = nullptr;
+		if (modifierType != ModifierType::Select && _selectionManager.hasSelection()) {
+			selectionMask = &_selectionManager.mask();
+		}
+		ModifierVolumeWrapper wrapper(node, modifierType, selectionMask);
 		voxel::Voxel prevVoxel = _brushContext.cursorVoxel;
 		glm::ivec3 prevCursorPos = _brushContext.cursorPosition;
 		if (brush->brushClamping()) {
@@ -367,11 +372,11 @@ bool Modifier::executeBrush(scenegraph::SceneGraph &sceneGraph, scenegraph::Scen
 		}
 		_brushContext.cursorVoxel = voxel;
 		brush->execute(sceneGraph, wrapper, _brushContext);
-		const voxel::Region &modifiedRegion = wrapper.dirtyRegion();
-		if (modifiedRegion.isValid()) {
-			voxel::logRegion("Dirty region", modifiedRegion);
+		const voxel::DirtyRegions &dirtyRegions = wrapper.dirtyRegions();
+		if (!dirtyRegions.empty()) {
+			voxel::logRegion("Dirty region", dirtyRegions.bounds());
 			if (callback) {
-				callback(modifiedRegion, _brushContext.modifierType, true);
+				callback(dirtyRegions, _brushContext.modifierType, true);
 			}
 		}
 		_brushContext.cursorPosition = prevCursorPos;
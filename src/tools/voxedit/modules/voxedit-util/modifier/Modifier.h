@@ -22,6 +22,7 @@
 #include "voxedit-util/modifier/brush/StampBrush.h"
 #include "voxedit-util/modifier/brush/TextBrush.h"
 #include "voxedit-util/modifier/brush/TextureBrush.h"
+#include "voxel/DirtyRegions.h"
 #include "voxel/Face.h"
 #include "voxel/RawVolume.h"
 #include "voxel/RawVolumeWrapper.h"
@@ -44,7 +45,7 @@ class SceneManager;
  */
 class Modifier : public core::IComponent {
 public:
-	using ModifiedRegionCallback = std::function<void(const voxel::Region &region, ModifierType type, bool markUndo)>;
+	using ModifiedRegionCallback = std::function<void(const voxel::DirtyRegions &dirtyRegions, ModifierType type, bool markUndo)>;
 
 protected:
 	// TODO: SELECTION: remove member but use the selection manager as a component that's handed in
@@ -68,9 +68,9 @@ void ModifierButton::execute(bool single) {
 			if (v == nullptr) {
 				return;
 			}
-			auto modifierFunc = [&](const voxel::Region &region, ModifierType type, bool markUndo) {
+			auto modifierFunc = [&](const voxel::DirtyRegions &dirtyRegions, ModifierType type, bool markUndo) {
 				if (type != ModifierType::Select && type != ModifierType::ColorPicker) {
-					_sceneMgr->modified(nodeId, region, markUndo);
+					_sceneMgr->modified(nodeId, dirtyRegions, markUndo);
 				}
 			};
 			modifier.execute(_sceneMgr->sceneGraph(), *node, modifierFunc);
@@ -5,7 +5,7 @@
 #pragma once
 
 #include "ModifierType.h"
-#include "Selection.h"
+#include "SelectionMask.h"
 #include "scenegraph/SceneGraphNode.h"
 #include "voxel/RawVolumeWrapper.h"
 
@@ -15,13 +15,14 @@ namespace voxedit {
  * @brief A wrapper for a @c voxel::RawVolume that performs a sanity check for
  * the @c setVoxel() call and uses the @c ModifierType value to perform the
  * desired action for the @c setVoxel() call.
- * The sanity check also includes the @c Selections that are used to limit the
+ * The sanity check also includes the @c SelectionMask that is used to limit the
  * area of the @c voxel::RawVolume that is affected by the @c setVoxel() call.
  */
 class ModifierVolumeWrapper : public voxel::RawVolumeWrapper {
 private:
 	using Super = voxel::RawVolumeWrapper;
-	const Selections _selections;
+	// nullptr if there is no selection and all voxels can get modified
+	const SelectionMask *_selectionMask;
 	const ModifierType _modifierType;
 	scenegraph::SceneGraphNode &_node;
 
@@ -30,28 +31,20 @@ private:
 	bool _paint;
 	bool _force;
 
-	static bool contains(const Selections &selections, int x, int y, int z) {
-		for (const Selection &sel : selections) {
-			if (sel.containsPoint(x, y, z)) {
-				return true;
-			}
-		}
-		return false;
-	}
-
 	bool skip(int x, int y, int z) const {
 		if (!_region.containsPoint(x, y, z)) {
 			return true;
 		}
-		if (_selections.empty()) {
+		if (_selectionMask == nullptr) {
 			return false;
 		}
-		return !contains(_selections, x, y, z);
+		return !_selectionMask->contains(x, y, z);
 	}
 
 public:
-	ModifierVolumeWrapper(scenegraph::SceneGraphNode &node, ModifierType modifierType, const Selections &selections = {})
-		: Super(node.volume()), _selections(selections), _modifierType(modifierType), _node(node) {
+	ModifierVolumeWrapper(scenegraph::SceneGraphNode &node, ModifierType modifierType,
+						  const SelectionMask *selectionMask = nullptr)
+		: Super(node.volume()), _selectionMask(selectionMask), _modifierType(modifierType), _node(node) {
 		_erase = _modifierType == ModifierType::Erase;
 		_override = _modifierType == ModifierType::Override;
 		_paint = _modifierType == ModifierType::Paint;
@@ -66,15 +59,18 @@ public:
 		return _modifierType;
 	}
 
-	void addDirtyRegion(const voxel::Region &region) {
-		if (!region.isValid()) {
-			return;
-		}
-		if (_dirtyRegion.isValid()) {
-			_dirtyRegion.accumulate(region);
-		} else {
-			_dirtyRegion = region;
+	/**
+	 * @brief Allows the brushes to skip regions that are not selected at all
+	 */
+	SelectionMask::Coverage selectionCoverage(const voxel::Region &region) const {
+		if (_selectionMask == nullptr) {
+			return SelectionMask::Coverage::Full;
 		}
+		return _selectionMask->coverage(region);
+	}
+
+	void addDirtyRegion(const voxel::Region &region) {
+		_dirtyRegions.add(region);
 	}
 
 	bool setVoxel(int x, int y, int z, const voxel::Voxel &voxel) override {
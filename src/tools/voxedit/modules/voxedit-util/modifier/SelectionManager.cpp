@@ -12,11 +12,17 @@ const Selections &SelectionManager::selections() const {
 	return _selections;
 }
 
+const SelectionMask &SelectionManager::mask() const {
+	return _mask;
+}
+
 void SelectionManager::invert(voxel::RawVolume &volume) {
 	if (!hasSelection()) {
 		select(volume, volume.region().getLowerCorner(), volume.region().getUpperCorner());
 	} else {
-		// TODO: SELECTION
+		_mask.resize(volume.region());
+		_mask.invert();
+		_selections = _mask.regions();
 	}
 }
 
@@ -26,6 +32,7 @@ void SelectionManager::unselect(voxel::RawVolume &volume) {
 
 void SelectionManager::reset() {
 	_selections.clear();
+	_mask.resize(voxel::Region::InvalidRegion);
 }
 
 voxel::Region SelectionManager::region() const {
@@ -63,6 +70,14 @@ bool SelectionManager::select(voxel::RawVolume &volume, const glm::ivec3 &mins,
 		}
 	}
 	_selections.push_back(sel);
+	if (!_mask.region().isValid()) {
+		_mask.resize(sel);
+	} else if (!_mask.region().containsRegion(sel)) {
+		voxel::Region region = _mask.region();
+		region.accumulate(sel);
+		_mask.resize(region);
+	}
+	_mask.select(sel);
 	return true;
 }
 
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "Selection.h"
+#include "SelectionMask.h"
 
 namespace voxel {
 class RawVolume;
@@ -15,11 +16,14 @@ namespace voxedit {
 class SelectionManager {
 private:
 	Selections _selections;
+	// the voxels that are covered by the selections - used to check whether a voxel is selected
+	SelectionMask _mask;
 	// voxel::SparseVolume _selectionVolume;
 
 public:
 	// TODO: SELECTION: reduce access to this as much as possible
 	const Selections &selections() const;
+	const SelectionMask &mask() const;
 
 	template <typename F>
 	void visitSelections(F &&f) const {
@@ -0,0 +1,450 @@
+/**
+ * @file
+ */
+
+#include "SelectionMask.h"
+#include "core/Bits.h"
+
+namespace voxedit {
+
+SelectionMask::SelectionMask(const voxel::Region &region) {
+	resize(region);
+}
+
+voxel::Region SelectionMask::brickRegion(const glm::ivec3 &brick) {
+	const glm::ivec3 mins = brick * BrickSize;
+	return voxel::Region(mins, mins + BrickMask);
+}
+
+void SelectionMask::boxMask(const voxel::Region &box, uint64_t (&out)[BrickSize]) {
+	const glm::ivec3 lo = box.getLowerCorner() & BrickMask;
+	const glm::ivec3 hi = box.getUpperCorner() & BrickMask;
+	const uint64_t row = ((UINT64_C(1) << (hi.x - lo.x + 1)) - 1) << lo.x;
+	uint64_t slice = 0;
+	for (int y = lo.y; y <= hi.y; ++y) {
+		slice |= row << (y << BrickBits);
+	}
+	for (int z = 0; z < BrickSize; ++z) {
+		out[z] = (z >= lo.z && z <= hi.z) ? slice : 0;
+	}
+}
+
+void SelectionMask::release(size_t idx, int32_t newState) {
+	const int32_t b = _bricks[idx];
+	if (b >= 0) {
+		_freeBricks.push_back(b);
+	}
+	_bricks[idx] = newState;
+}
+
+SelectionMask::Brick &SelectionMask::materialize(size_t idx) {
+	const int32_t b = _bricks[idx];
+	if (b >= 0) {
+		return _pool[b];
+	}
+	int32_t poolIdx;
+	if (!_freeBricks.empty()) {
+		poolIdx = _freeBricks.back();
+		_freeBricks.pop();
+	} else {
+		poolIdx = (int32_t)_pool.size();
+		_pool.push_back(Brick());
+	}
+	Brick &brick = _pool[poolIdx];
+	const uint64_t fill = b == FullBrick ? ~UINT64_C(0) : UINT64_C(0);
+	for (int w = 0; w < BrickSize; ++w) {
+		brick.words[w] = fill;
+	}
+	_bricks[idx] = poolIdx;
+	return brick;
+}
+
+void SelectionMask::compact(size_t idx) {
+	const int32_t b = _bricks[idx];
+	if (b < 0) {
+		return;
+	}
+	const Brick &brick = _pool[b];
+	bool allSet = true;
+	bool allClear = true;
+	for (int w = 0; w < BrickSize; ++w) {
+		allSet &= brick.words[w] == ~UINT64_C(0);
+		allClear &= brick.words[w] == UINT64_C(0);
+	}
+	if (allSet) {
+		release(idx, FullBrick);
+	} else if (allClear) {
+		release(idx, EmptyBrick);
+	}
+}
+
+void SelectionMask::resize(const voxel::Region &region) {
+	if (!region.isValid()) {
+		_region = voxel::Region::InvalidRegion;
+		_brickMins = _brickDims = glm::ivec3(0);
+		_bricks.clear();
+		_pool.clear();
+		_freeBricks.clear();
+		return;
+	}
+	const glm::ivec3 brickMins = region.getLowerCorner() >> BrickBits;
+	const glm::ivec3 brickDims = (region.getUpperCorner() >> BrickBits) - brickMins + 1;
+	core::DynamicArray<int32_t> bricks;
+	bricks.resize((size_t)brickDims.x * brickDims.y * brickDims.z);
+	bricks.fill(EmptyBrick);
+
+	// move the bricks that are still part of the new region over
+	size_t idx = 0;
+	for (int z = 0; z < _brickDims.z; ++z) {
+		for (int y = 0; y < _brickDims.y; ++y) {
+			for (int x = 0; x < _brickDims.x; ++x, ++idx) {
+				const int32_t b = _bricks[idx];
+				if (b == EmptyBrick) {
+					continue;
+				}
+				const glm::ivec3 n = glm::ivec3(x, y, z) + _brickMins - brickMins;
+				if (n.x >= 0 && n.y >= 0 && n.z >= 0 && n.x < brickDims.x && n.y < brickDims.y && n.z < brickDims.z) {
+					bricks[((size_t)n.z * brickDims.y + n.y) * brickDims.x + n.x] = b;
+				} else if (b >= 0) {
+					_freeBricks.push_back(b);
+				}
+			}
+		}
+	}
+	_bricks = core::move(bricks);
+	_brickMins = brickMins;
+	_brickDims = brickDims;
+	_region = region;
+
+	// clear the voxels of the border bricks that are outside of the new region
+	idx = 0;
+	for (int z = 0; z < _brickDims.z; ++z) {
+		for (int y = 0; y < _brickDims.y; ++y) {
+			for (int x = 0; x < _brickDims.x; ++x, ++idx) {
+				if (_bricks[idx] == EmptyBrick) {
+					continue;
+				}
+				voxel::Region local = brickRegion(glm::ivec3(x, y, z) + _brickMins);
+				if (_region.containsRegion(local)) {
+					continue;
+				}
+				local.cropTo(_region);
+				uint64_t mask[BrickSize];
+				boxMask(local, mask);
+				Brick &brick = materialize(idx);
+				for (int w = 0; w < BrickSize; ++w) {
+					brick.words[w] &= mask[w];
+				}
+				compact(idx);
+			}
+		}
+	}
+}
+
+void SelectionMask::apply(const voxel::Region &box, Op op) {
+	voxel::Region cropped = box;
+	if (!_region.isValid() || !cropped.isValid() || !cropped.cropTo(_region)) {
+		return;
+	}
+	const glm::ivec3 bmins = cropped.getLowerCorner() >> BrickBits;
+	const glm::ivec3 bmaxs = cropped.getUpperCorner() >> BrickBits;
+	for (int z = bmins.z; z <= bmaxs.z; ++z) {
+		for (int y = bmins.y; y <= bmaxs.y; ++y) {
+			for (int x = bmins.x; x <= bmaxs.x; ++x) {
+				const glm::ivec3 brickPos(x, y, z);
+				const size_t idx = brickIndex(brickPos);
+				const int32_t b = _bricks[idx];
+				voxel::Region local = brickRegion(brickPos);
+				const bool whole = cropped.containsRegion(local);
+				if (whole) {
+					if (op == Op::Set) {
+						release(idx, FullBrick);
+						continue;
+					}
+					if (op == Op::Clear) {
+						release(idx, EmptyBrick);
+						continue;
+					}
+					if (b < 0) {
+						_bricks[idx] = b == FullBrick ? EmptyBrick : FullBrick;
+						continue;
+					}
+				} else if ((op == Op::Set && b == FullBrick) || (op == Op::Clear && b == EmptyBrick)) {
+					continue;
+				}
+				local.cropTo(cropped);
+				uint64_t mask[BrickSize];
+				boxMask(local, mask);
+				Brick &brick = materialize(idx);
+				for (int w = 0; w < BrickSize; ++w) {
+					switch (op) {
+					case Op::Set:
+						brick.words[w] |= mask[w];
+						break;
+					case Op::Clear:
+						brick.words[w] &= ~mask[w];
+						break;
+					case Op::Toggle:
+						brick.words[w] ^= mask[w];
+						break;
+					}
+				}
+				compact(idx);
+			}
+		}
+	}
+}
+
+bool SelectionMask::empty() const {
+	for (int32_t b : _bricks) {
+		if (b != EmptyBrick) {
+			return false;
+		}
+	}
+	return true;
+}
+
+SelectionMask::Coverage SelectionMask::coverage(const voxel::Region &region) const {
+	voxel::Region cropped = region;
+	if (!_region.isValid() || !cropped.isValid() || !cropped.cropTo(_region)) {
+		return Coverage::None;
+	}
+	// voxels outside of the mask region are never selected
+	bool all = cropped == region;
+	bool any = false;
+	const glm::ivec3 bmins = cropped.getLowerCorner() >> BrickBits;
+	const glm::ivec3 bmaxs = cropped.getUpperCorner() >> BrickBits;
+	for (int z = bmins.z; z <= bmaxs.z; ++z) {
+		for (int y = bmins.y; y <= bmaxs.y; ++y) {
+			for (int x = bmins.x; x <= bmaxs.x; ++x) {
+				const glm::ivec3 brickPos(x, y, z);
+				const int32_t b = _bricks[brickIndex(brickPos)];
+				if (b == EmptyBrick) {
+					all = false;
+				} else if (b == FullBrick) {
+					any = true;
+				} else {
+					voxel::Region local = brickRegion(brickPos);
+					local.cropTo(cropped);
+					uint64_t mask[BrickSize];
+					boxMask(local, mask);
+					const Brick &brick = _pool[b];
+					for (int w = 0; w < BrickSize; ++w) {
+						const uint64_t selected = brick.words[w] & mask[w];
+						any |= selected != 0;
+						all &= selected == mask[w];
+					}
+				}
+				if (any && !all) {
+					return Coverage::Partial;
+				}
+			}
+		}
+	}
+	if (all) {
+		return Coverage::Full;
+	}
+	return any ? Coverage::Partial : Coverage::None;
+}
+
+voxel::Region SelectionMask::bounds() const {
+	voxel::Region bounds = voxel::Region::InvalidRegion;
+	auto add = [&bounds](const voxel::Region &region) {
+		if (bounds.isValid()) {
+			bounds.accumulate(region);
+		} else {
+			bounds = region;
+		}
+	};
+	size_t idx = 0;
+	for (int z = 0; z < _brickDims.z; ++z) {
+		for (int y = 0; y < _brickDims.y; ++y) {
+			for (int x = 0; x < _brickDims.x; ++x, ++idx) {
+				const int32_t b = _bricks[idx];
+				if (b == EmptyBrick) {
+					continue;
+				}
+				const glm::ivec3 brickPos = glm::ivec3(x, y, z) + _brickMins;
+				if (b == FullBrick) {
+					add(brickRegion(brickPos));
+					continue;
+				}
+				const glm::ivec3 mins = brickPos * BrickSize;
+				const Brick &brick = _pool[b];
+				for (int w = 0; w < BrickSize; ++w) {
+					uint64_t bits = brick.words[w];
+					while (bits != 0) {
+						const int i = core::countTrailingZeros(bits);
+						bits &= bits - 1;
+						const glm::ivec3 pos = mins + glm::ivec3(i & BrickMask, i >> BrickBits, w);
+						add(voxel::Region(pos, pos));
+					}
+				}
+			}
+		}
+	}
+	return bounds;
+}
+
+core::DynamicArray<voxel::Region> SelectionMask::regions() const {
+	core::DynamicArray<voxel::Region> regions;
+	for (int z = 0; z < _brickDims.z; ++z) {
+		for (int y = 0; y < _brickDims.y; ++y) {
+			const size_t rowIdx = ((size_t)z * _brickDims.y + y) * _brickDims.x;
+			// runs of full bricks along the x axis are merged into one box
+			int fullStart = -1;
+			for (int x = 0; x <= _brickDims.x; ++x) {
+				const int32_t b = x < _brickDims.x ? _bricks[rowIdx + x] : EmptyBrick;
+				if (b == FullBrick) {
+					if (fullStart == -1) {
+						fullStart = x;
+					}
+					continue;
+				}
+				if (fullStart != -1) {
+					const glm::ivec3 mins = (glm::ivec3(fullStart, y, z) + _brickMins) * BrickSize;
+					const glm::ivec3 maxs = (glm::ivec3(x, y + 1, z + 1) + _brickMins) * BrickSize - 1;
+					regions.emplace_back(mins, maxs);
+					fullStart = -1;
+				}
+				if (b < 0) {
+					continue;
+				}
+				const glm::ivec3 mins = (glm::ivec3(x, y, z) + _brickMins) * BrickSize;
+				const Brick &brick = _pool[b];
+				for (int w = 0; w < BrickSize; ++w) {
+					for (int row = 0; row < BrickSize; ++row) {
+						const uint32_t bits = (uint32_t)(brick.words[w] >> (row << BrickBits)) & 0xFFu;
+						int runStart = -1;
+						for (int bx = 0; bx <= BrickSize; ++bx) {
+							const bool set = bx < BrickSize && (bits & (1u << bx)) != 0u;
+							if (set && runStart == -1) {
+								runStart = bx;
+							} else if (!set && runStart != -1) {
+								const glm::ivec3 lo = mins + glm::ivec3(runStart, row, w);
+								const glm::ivec3 hi = mins + glm::ivec3(bx - 1, row, w);
+								regions.emplace_back(lo, hi);
+								runStart = -1;
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+	return regions;
+}
+
+void SelectionMask::select(const voxel::Region &region) {
+	apply(region, Op::Set);
+}
+
+void SelectionMask::unselect(const voxel::Region &region) {
+	apply(region, Op::Clear);
+}
+
+void SelectionMask::invert() {
+	apply(_region, Op::Toggle);
+}
+
+void SelectionMask::clear() {
+	_bricks.fill(EmptyBrick);
+	_pool.clear();
+	_freeBricks.clear();
+}
+
+void SelectionMask::unite(const SelectionMask &other) {
+	if (!other._region.isValid()) {
+		return;
+	}
+	if (!_region.isValid()) {
+		*this = other;
+		return;
+	}
+	if (!_region.containsRegion(other._region)) {
+		voxel::Region region = _region;
+		region.accumulate(other._region);
+		resize(region);
+	}
+	size_t otherIdx = 0;
+	for (int z = 0; z < other._brickDims.z; ++z) {
+		for (int y = 0; y < other._brickDims.y; ++y) {
+			for (int x = 0; x < other._brickDims.x; ++x, ++otherIdx) {
+				const int32_t ob = other._bricks[otherIdx];
+				if (ob == EmptyBrick) {
+					continue;
+				}
+				const size_t idx = brickIndex(glm::ivec3(x, y, z) + other._brickMins);
+				if (ob == FullBrick) {
+					release(idx, FullBrick);
+					continue;
+				}
+				if (_bricks[idx] == FullBrick) {
+					continue;
+				}
+				Brick &brick = materialize(idx);
+				const Brick &otherBrick = other._pool[ob];
+				for (int w = 0; w < BrickSize; ++w) {
+					brick.words[w] |= otherBrick.words[w];
+				}
+				compact(idx);
+			}
+		}
+	}
+}
+
+void SelectionMask::intersect(const SelectionMask &other) {
+	size_t idx = 0;
+	for (int z = 0; z < _brickDims.z; ++z) {
+		for (int y = 0; y < _brickDims.y; ++y) {
+			for (int x = 0; x < _brickDims.x; ++x, ++idx) {
+				if (_bricks[idx] == EmptyBrick) {
+					continue;
+				}
+				const int32_t ob = other.state(glm::ivec3(x, y, z) + _brickMins);
+				if (ob == FullBrick) {
+					continue;
+				}
+				if (ob == EmptyBrick) {
+					release(idx, EmptyBrick);
+					continue;
+				}
+				Brick &brick = materialize(idx);
+				const Brick &otherBrick = other._pool[ob];
+				for (int w = 0; w < BrickSize; ++w) {
+					brick.words[w] &= otherBrick.words[w];
+				}
+				compact(idx);
+			}
+		}
+	}
+}
+
+void SelectionMask::subtract(const SelectionMask &other) {
+	size_t idx = 0;
+	for (int z = 0; z < _brickDims.z; ++z) {
+		for (int y = 0; y < _brickDims.y; ++y) {
+			for (int x = 0; x < _brickDims.x; ++x, ++idx) {
+				if (_bricks[idx] == EmptyBrick) {
+					continue;
+				}
+				const int32_t ob = other.state(glm::ivec3(x, y, z) + _brickMins);
+				if (ob == EmptyBrick) {
+					continue;
+				}
+				if (ob == FullBrick) {
+					release(idx, EmptyBrick);
+					continue;
+				}
+				Brick &brick = materialize(idx);
+				const Brick &otherBrick = other._pool[ob];
+				for (int w = 0; w < BrickSize; ++w) {
+					brick.words[w] &= ~otherBrick.words[w];
+				}
+				compact(idx);
+			}
+		}
+	}
+}
+
+} // namespace voxedit
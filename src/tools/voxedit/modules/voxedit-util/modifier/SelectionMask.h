@@ -0,0 +1,157 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/collection/DynamicArray.h"
+#include "voxel/Region.h"
+#include <stdint.h>
+
+namespace voxedit {
+
+/**
+ * @brief Bit packed selection state for every voxel of a region
+ *
+ * The region is split into bricks of 8x8x8 voxels that are aligned to the absolute voxel coordinates. A brick is
+ * either completely unselected, completely selected or stores one bit per voxel - only the last case needs memory
+ * besides the brick index. Checking a voxel is a constant time lookup, no matter how many boxes were selected.
+ *
+ * Voxels outside of the region of the mask are never selected.
+ */
+class SelectionMask {
+public:
+	static constexpr int BrickBits = 3;
+	static constexpr int BrickSize = 1 << BrickBits;
+	static constexpr int BrickMask = BrickSize - 1;
+
+	enum class Coverage { None, Partial, Full };
+
+private:
+	// one word per z slice - the bit index is y * 8 + x
+	struct Brick {
+		uint64_t words[BrickSize];
+	};
+	static constexpr int32_t EmptyBrick = -1;
+	static constexpr int32_t FullBrick = -2;
+
+	voxel::Region _region = voxel::Region::InvalidRegion;
+	glm::ivec3 _brickMins{0};
+	glm::ivec3 _brickDims{0};
+	// index into the brick pool or one of EmptyBrick and FullBrick
+	core::DynamicArray<int32_t> _bricks;
+	core::DynamicArray<Brick> _pool;
+	core::DynamicArray<int32_t> _freeBricks;
+
+	static inline int bit(int x, int y) {
+		return ((y & BrickMask) << BrickBits) | (x & BrickMask);
+	}
+
+	inline size_t brickIndex(const glm::ivec3 &brick) const {
+		const glm::ivec3 b = brick - _brickMins;
+		return ((size_t)b.z * _brickDims.y + b.y) * _brickDims.x + b.x;
+	}
+
+	inline bool validBrick(const glm::ivec3 &brick) const {
+		const glm::ivec3 b = brick - _brickMins;
+		return b.x >= 0 && b.y >= 0 && b.z >= 0 && b.x < _brickDims.x && b.y < _brickDims.y && b.z < _brickDims.z;
+	}
+
+	static voxel::Region brickRegion(const glm::ivec3 &brick);
+	/**
+	 * @brief Fills the words with the bits of the given box - the box must be inside of one brick
+	 */
+	static void boxMask(const voxel::Region &box, uint64_t (&out)[BrickSize]);
+
+	inline int32_t state(const glm::ivec3 &brick) const {
+		return validBrick(brick) ? _bricks[brickIndex(brick)] : EmptyBrick;
+	}
+
+	/**
+	 * @brief Gives the bits of a brick back to the pool and sets the new state
+	 */
+	void release(size_t idx, int32_t newState);
+	/**
+	 * @brief Converts an empty or full brick into a brick with one bit per voxel
+	 */
+	Brick &materialize(size_t idx);
+	/**
+	 * @brief Turns a brick that has all bits set or cleared into the compact state again
+	 */
+	void compact(size_t idx);
+
+	enum class Op { Set, Clear, Toggle };
+	/**
+	 * @brief Applies the operation to all voxels of the box (cropped to the region of the mask)
+	 */
+	void apply(const voxel::Region &box, Op op);
+
+public:
+	SelectionMask() = default;
+	explicit SelectionMask(const voxel::Region &region);
+
+	inline const voxel::Region &region() const {
+		return _region;
+	}
+
+	/**
+	 * @brief Changes the extents of the mask - selected voxels that are still inside of the new region are kept
+	 */
+	void resize(const voxel::Region &region);
+
+	inline bool contains(int x, int y, int z) const {
+		if (!_region.containsPoint(x, y, z)) {
+			return false;
+		}
+		const int32_t b = _bricks[brickIndex(glm::ivec3(x, y, z) >> BrickBits)];
+		if (b == EmptyBrick) {
+			return false;
+		}
+		if (b == FullBrick) {
+			return true;
+		}
+		return (_pool[b].words[z & BrickMask] >> bit(x, y)) & 1u;
+	}
+
+	inline bool contains(const glm::ivec3 &pos) const {
+		return contains(pos.x, pos.y, pos.z);
+	}
+
+	/**
+	 * @return @c true if no voxel is selected
+	 */
+	bool empty() const;
+	/**
+	 * @brief Tells whether the given region is completely selected, not selected at all or only partially selected.
+	 * This allows to skip or bulk process whole regions.
+	 */
+	Coverage coverage(const voxel::Region &region) const;
+	/**
+	 * @return The bounding box of all selected voxels or @c voxel::Region::InvalidRegion
+	 */
+	voxel::Region bounds() const;
+	/**
+	 * @return Disjoint boxes that cover exactly the selected voxels
+	 */
+	core::DynamicArray<voxel::Region> regions() const;
+
+	void select(const voxel::Region &region);
+	void unselect(const voxel::Region &region);
+	void invert();
+	void clear();
+
+	/**
+	 * @brief Selects all voxels that are selected in the other mask - the region is extended if needed
+	 */
+	void unite(const SelectionMask &other);
+	/**
+	 * @brief Only keeps the voxels that are selected in both masks
+	 */
+	void intersect(const SelectionMask &other);
+	/**
+	 * @brief Unselects all voxels that are selected in the other mask
+	 */
+	void subtract(const SelectionMask &other);
+};
+
+} // namespace voxedit
@@ -121,18 +121,26 @@ bool AABBBrush::execute(scenegraph::SceneGraph &sceneGraph, ModifierVolumeWrappe
 	setErrorReason("");
 	voxel::Region region = calcRegion(context);
 	region = extendRegionInOrthoMode(region, wrapper.region(), context);
+	auto generateSelected = [&](const voxel::Region &r) {
+		// nothing to do if no voxel of the region is selected
+		if (wrapper.selectionCoverage(r) == SelectionMask::Coverage::None) {
+			Log::debug("Skip region %s - not selected", r.toString().c_str());
+			return;
+		}
+		generate(sceneGraph, wrapper, context, r);
+	};
 	glm::ivec3 minsMirror = region.getLowerCorner();
 	glm::ivec3 maxsMirror = region.getUpperCorner();
 	if (!getMirrorAABB(minsMirror, maxsMirror)) {
-		generate(sceneGraph, wrapper, context, region);
+		generateSelected(region);
 	} else {
 		Log::debug("Execute mirror action");
 		const voxel::Region second(minsMirror, maxsMirror);
 		if (voxel::intersects(region, second)) {
-			generate(sceneGraph, wrapper, context, voxel::Region(region.getLowerCorner(), maxsMirror));
+			generateSelected(voxel::Region(region.getLowerCorner(), maxsMirror));
 		} else {
-			generate(sceneGraph, wrapper, context, region);
-			generate(sceneGraph, wrapper, context, second);
+			generateSelected(region);
+			generateSelected(second);
 		}
 	}
 	return true;
@@ -66,9 +66,9 @@ TEST_F(ModifierTest, testModifierAction) {
 	scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
 	node.setVolume(&volume, false);
 	EXPECT_TRUE(
-		modifier.execute(sceneGraph, node, [&](const voxel::Region &region, ModifierType modifierType, bool markUndo) {
+		modifier.execute(sceneGraph, node, [&](const voxel::DirtyRegions &dirtyRegions, ModifierType modifierType, bool markUndo) {
 			modifierExecuted = true;
-			EXPECT_EQ(voxel::Region(glm::ivec3(-1), glm::ivec3(1)), region);
+			EXPECT_EQ(voxel::Region(glm::ivec3(-1), glm::ivec3(1)), dirtyRegions.bounds());
 		}));
 	EXPECT_TRUE(modifierExecuted);
 	modifier.shutdown();
@@ -90,9 +90,9 @@ TEST_F(ModifierTest, testModifierSelection) {
 	node.setVolume(&volume, false);
 	int modifierExecuted = 0;
 	EXPECT_TRUE(
-		modifier.execute(sceneGraph, node, [&](const voxel::Region &region, ModifierType modifierType, bool markUndo) {
+		modifier.execute(sceneGraph, node, [&](const voxel::DirtyRegions &dirtyRegions, ModifierType modifierType, bool markUndo) {
 			++modifierExecuted;
-			EXPECT_EQ(voxel::Region(glm::ivec3(-1), glm::ivec3(1)), region);
+			EXPECT_EQ(voxel::Region(glm::ivec3(-1), glm::ivec3(1)), dirtyRegions.bounds());
 		}));
 	EXPECT_EQ(1, modifierExecuted);
 	EXPECT_EQ(glm::ivec3(-1), modifier.selectionMgr().region().getLowerCorner());
@@ -129,7 +129,7 @@ TEST_F(ModifierTest, testClamp) {
 		voxel::Region dirtyRegion;
 		EXPECT_TRUE(modifier.execute(
 			sceneGraph, node,
-			[&dirtyRegion](const voxel::Region &region, ModifierType type, bool markUndo) { dirtyRegion = region; }));
+			[&dirtyRegion](const voxel::DirtyRegions &dirtyRegions, ModifierType type, bool markUndo) { dirtyRegion = dirtyRegions.bounds(); }));
 		EXPECT_EQ(dirtyRegion.getDimensionsInVoxels(), glm::ivec3(6, 9, 1));
 	}
 	volume.clear();
@@ -138,7 +138,7 @@ TEST_F(ModifierTest, testClamp) {
 		voxel::Region dirtyRegion;
 		EXPECT_TRUE(modifier.execute(
 			sceneGraph, node,
-			[&dirtyRegion](const voxel::Region &region, ModifierType type, bool markUndo) { dirtyRegion = region; }));
+			[&dirtyRegion](const voxel::DirtyRegions &dirtyRegions, ModifierType type, bool markUndo) { dirtyRegion = dirtyRegions.bounds(); }));
 		EXPECT_EQ(dirtyRegion.getDimensionsInVoxels(), glm::ivec3(10, 9, 1));
 	}
 
@@ -87,6 +87,7 @@ protected:
 		core::Var::get(cfg::VoxEditRendershadow, "true");
 		core::Var::get(cfg::VoxEditGridsize, "1");
 		core::Var::get(cfg::VoxEditMaxSuggestedVolumeSize, "128");
+		core::Var::get(cfg::VoxEditMaxUndoMemory, "512");
 		core::Var::get(cfg::VoxelMeshMode, core::string::toString((int)voxel::SurfaceExtractionType::Cubic));
 		core::Var::get(cfg::VoxelMeshSize, "16", core::CV_READONLY);
 		core::Var::get(cfg::VoxEditShowaabb, "");
@@ -129,9 +130,9 @@ protected:
 		scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
 		node.setVolume(v, false);
 		int executed = 0;
-		auto callback = [&](const voxel::Region &region, ModifierType, bool) {
+		auto callback = [&](const voxel::DirtyRegions &dirtyRegions, ModifierType, bool) {
 			executed++;
-			_sceneMgr->modified(nodeId, region);
+			_sceneMgr->modified(nodeId, dirtyRegions);
 		};
 		if (!modifier.execute(sceneGraph, node, callback)) {
 			return false;
@@ -150,7 +151,7 @@ protected:
 		scenegraph::SceneGraph sceneGraph;
 		scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
 		node.setVolume(new voxel::RawVolume({mins, maxs}), true);
-		EXPECT_TRUE(modifier.execute(sceneGraph, node, [&](const voxel::Region &, ModifierType, bool) {}));
+		EXPECT_TRUE(modifier.execute(sceneGraph, node, [&](const voxel::DirtyRegions &, ModifierType, bool) {}));
 		modifier.setBrushType(BrushType::Shape);
 	}
 
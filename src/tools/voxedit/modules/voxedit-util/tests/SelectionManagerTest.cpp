@@ -4,6 +4,7 @@
 
 #include "../modifier/SelectionManager.h"
 #include "app/tests/AbstractTest.h"
+#include "voxel/RawVolume.h"
 
 namespace voxedit {
 
@@ -18,4 +19,27 @@ TEST_F(SelectionManagerTest, test) {
 	// TODO: SELECTION: implement test
 }
 
+TEST_F(SelectionManagerTest, testSelectMask) {
+	SelectionManager mgr;
+	voxel::RawVolume volume(voxel::Region(0, 31));
+	EXPECT_TRUE(mgr.select(volume, glm::ivec3(1), glm::ivec3(3)));
+	EXPECT_TRUE(mgr.select(volume, glm::ivec3(20), glm::ivec3(40)));
+	EXPECT_TRUE(mgr.mask().contains(2, 2, 2));
+	EXPECT_TRUE(mgr.mask().contains(40, 40, 40));
+	EXPECT_FALSE(mgr.mask().contains(10, 10, 10));
+	mgr.reset();
+	EXPECT_TRUE(mgr.mask().empty());
+}
+
+TEST_F(SelectionManagerTest, testInvert) {
+	SelectionManager mgr;
+	voxel::RawVolume volume(voxel::Region(0, 15));
+	EXPECT_TRUE(mgr.select(volume, glm::ivec3(0), glm::ivec3(15, 15, 7)));
+	mgr.invert(volume);
+	EXPECT_TRUE(mgr.hasSelection());
+	EXPECT_FALSE(mgr.mask().contains(0, 0, 0));
+	EXPECT_TRUE(mgr.mask().contains(0, 0, 8));
+	EXPECT_EQ(voxel::Region(glm::ivec3(0, 0, 8), glm::ivec3(15)), mgr.region());
+}
+
 } // namespace voxedit
@@ -0,0 +1,95 @@
+/**
+ * @file
+ */
+
+#include "../modifier/SelectionMask.h"
+#include "app/tests/AbstractTest.h"
+
+namespace voxedit {
+
+class SelectionMaskTest : public app::AbstractTest {};
+
+TEST_F(SelectionMaskTest, testSelect) {
+	SelectionMask mask(voxel::Region(-10, 20));
+	EXPECT_TRUE(mask.empty());
+	mask.select(voxel::Region(glm::ivec3(-3, 0, 1), glm::ivec3(9, 2, 17)));
+	EXPECT_FALSE(mask.empty());
+	EXPECT_TRUE(mask.contains(-3, 0, 1));
+	EXPECT_TRUE(mask.contains(9, 2, 17));
+	EXPECT_FALSE(mask.contains(10, 2, 17));
+	EXPECT_FALSE(mask.contains(-4, 0, 1));
+	EXPECT_EQ(voxel::Region(glm::ivec3(-3, 0, 1), glm::ivec3(9, 2, 17)), mask.bounds());
+
+	mask.unselect(voxel::Region(glm::ivec3(0), glm::ivec3(20)));
+	EXPECT_TRUE(mask.contains(-1, 0, 1));
+	EXPECT_FALSE(mask.contains(0, 0, 1));
+	EXPECT_EQ(voxel::Region(glm::ivec3(-3, 0, 1), glm::ivec3(-1, 2, 17)), mask.bounds());
+}
+
+TEST_F(SelectionMaskTest, testOutsideRegion) {
+	SelectionMask mask(voxel::Region(0, 7));
+	mask.select(voxel::Region(-5, 5));
+	EXPECT_FALSE(mask.contains(-1, -1, -1));
+	EXPECT_TRUE(mask.contains(0, 0, 0));
+	EXPECT_EQ(voxel::Region(0, 5), mask.bounds());
+}
+
+TEST_F(SelectionMaskTest, testCoverage) {
+	SelectionMask mask(voxel::Region(0, 31));
+	mask.select(voxel::Region(glm::ivec3(2), glm::ivec3(20)));
+	EXPECT_EQ(SelectionMask::Coverage::Full, mask.coverage(voxel::Region(glm::ivec3(2), glm::ivec3(20))));
+	EXPECT_EQ(SelectionMask::Coverage::Full, mask.coverage(voxel::Region(glm::ivec3(5), glm::ivec3(6))));
+	EXPECT_EQ(SelectionMask::Coverage::Partial, mask.coverage(voxel::Region(glm::ivec3(0), glm::ivec3(5))));
+	EXPECT_EQ(SelectionMask::Coverage::None, mask.coverage(voxel::Region(glm::ivec3(21), glm::ivec3(31))));
+	EXPECT_EQ(SelectionMask::Coverage::None, mask.coverage(voxel::Region(glm::ivec3(0), glm::ivec3(1))));
+	// voxels outside of the mask are never selected
+	mask.select(mask.region());
+	EXPECT_EQ(SelectionMask::Coverage::Partial, mask.coverage(voxel::Region(glm::ivec3(30), glm::ivec3(40))));
+}
+
+TEST_F(SelectionMaskTest, testInvert) {
+	const voxel::Region region(0, 15);
+	SelectionMask mask(region);
+	mask.select(voxel::Region(glm::ivec3(3), glm::ivec3(4)));
+	mask.invert();
+	EXPECT_FALSE(mask.contains(3, 3, 3));
+	EXPECT_TRUE(mask.contains(0, 0, 0));
+	EXPECT_TRUE(mask.contains(15, 15, 15));
+	EXPECT_EQ(region, mask.bounds());
+
+	int selected = 0;
+	for (const voxel::Region &r : mask.regions()) {
+		EXPECT_EQ(SelectionMask::Coverage::Full, mask.coverage(r));
+		selected += r.voxels();
+	}
+	EXPECT_EQ(region.voxels() - 8, selected);
+
+	mask.invert();
+	EXPECT_EQ(voxel::Region(glm::ivec3(3), glm::ivec3(4)), mask.bounds());
+}
+
+TEST_F(SelectionMaskTest, testBooleanOperations) {
+	SelectionMask a(voxel::Region(0, 15));
+	a.select(voxel::Region(glm::ivec3(0), glm::ivec3(9)));
+	SelectionMask b(voxel::Region(5, 30));
+	b.select(voxel::Region(glm::ivec3(5), glm::ivec3(25)));
+
+	SelectionMask intersection = a;
+	intersection.intersect(b);
+	EXPECT_EQ(voxel::Region(glm::ivec3(5), glm::ivec3(9)), intersection.bounds());
+
+	SelectionMask difference = a;
+	difference.subtract(b);
+	EXPECT_TRUE(difference.contains(4, 9, 9));
+	EXPECT_FALSE(difference.contains(5, 5, 5));
+
+	SelectionMask united = a;
+	united.unite(b);
+	EXPECT_EQ(voxel::Region(0, 30), united.region());
+	EXPECT_EQ(voxel::Region(glm::ivec3(0), glm::ivec3(25)), united.bounds());
+	EXPECT_TRUE(united.contains(0, 0, 0));
+	EXPECT_TRUE(united.contains(25, 25, 25));
+	EXPECT_FALSE(united.contains(12, 0, 0));
+}
+
+} // namespace voxedit